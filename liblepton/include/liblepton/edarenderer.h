@@ -70,7 +70,9 @@ enum _EdaRendererFlags
   /* Should text outlines be drawn instead of glyphs? */
   EDA_RENDERER_FLAG_TEXT_OUTLINE = 1 << 3,
   /* Should text origin markers be drawn? */
-  EDA_RENDERER_FLAG_TEXT_ORIGIN = 1 << 4
+  EDA_RENDERER_FLAG_TEXT_ORIGIN = 1 << 4,
+  /* Should details too small to be seen be simplified? */
+  EDA_RENDERER_FLAG_LEVEL_OF_DETAIL = 1 << 5
 };
 
 typedef enum _EdaRendererFlags EdaRendererFlags;
@@ -99,6 +101,9 @@ eda_renderer_get_user_bounds (EdaRenderer *renderer,
                               double *right,
                               double *bottom);
 
+void
+eda_renderer_invalidate_text (const LeptonObject *object);
+
 gboolean
 eda_renderer_get_text_user_bounds (const LeptonObject *object,
                                    gboolean enable_hidden,
@@ -22,6 +22,24 @@
 
 G_BEGIN_DECLS
 
+/*! \brief Fields of the object records exported by
+ *  lepton_object_list_export()
+ */
+typedef enum
+{
+  LEPTON_OBJECT_RECORD_TYPE,        /* The type character, e.g. OBJ_NET */
+  LEPTON_OBJECT_RECORD_ID,          /* The object id, or -1 */
+  LEPTON_OBJECT_RECORD_COLOR,       /* The colormap index */
+  LEPTON_OBJECT_RECORD_X0,          /* The first coordinate pair */
+  LEPTON_OBJECT_RECORD_Y0,
+  LEPTON_OBJECT_RECORD_X1,          /* The second coordinate pair */
+  LEPTON_OBJECT_RECORD_Y1,
+  LEPTON_OBJECT_RECORD_PARENT,      /* The index of the parent component, or -1 */
+  LEPTON_OBJECT_RECORD_ATTACHED_TO, /* The index of the attribute owner, or -1 */
+  LEPTON_OBJECT_RECORD_STRING,      /* The offset of the text string, or -1 */
+  LEPTON_OBJECT_RECORD_N_FIELDS
+} LeptonObjectRecordField;
+
 void
 lepton_object_list_delete (GList *list);
 
@@ -47,6 +65,13 @@ void
 lepton_object_list_translate (const GList *objects,
                               int dx,
                               int dy);
+guint
+lepton_object_list_export (const GList *objects,
+                           gboolean with_attribs,
+                           LeptonObject **exported,
+                           gint32 *records,
+                           gchar *strings,
+                           gsize *strings_size);
 GList*
 o_glist_copy_all (const GList *src_list,
                   GList *dest_list);
@@ -33,6 +33,12 @@ struct st_page
   LeptonObject *object_lastplace; /* the last found item */
   GList *connectible_list;  /* connectible page objects */
 
+  /* Spatial index of the objects, see s_index.c */
+  struct st_page_index *_index;
+
+  /* Trigram index of the text objects, see s_text_index.c */
+  struct st_page_text_index *_text_index;
+
   /* The page filename. You must access this field only via the
    * accessor functions lepton_page_set_filename() and
    * lepton_page_get_filename() */
@@ -168,6 +174,29 @@ lepton_page_objects_in_regions (LeptonPage *page,
                                 LeptonBox *rects,
                                 int n_rects,
                                 gboolean include_hidden);
+GList*
+lepton_page_objects_in_rect (LeptonPage *page,
+                             int left,
+                             int top,
+                             int right,
+                             int bottom,
+                             gboolean include_hidden);
+GList*
+lepton_page_objects_inside_rect (LeptonPage *page,
+                                 int left,
+                                 int top,
+                                 int right,
+                                 int bottom,
+                                 gboolean include_hidden);
+GList*
+lepton_page_objects_near_point (LeptonPage *page,
+                                int x,
+                                int y,
+                                int radius,
+                                gboolean include_hidden);
+GList*
+lepton_page_texts_containing (LeptonPage *page,
+                              const gchar *substring);
 const gchar*
 lepton_page_get_filename (const LeptonPage *page);
 
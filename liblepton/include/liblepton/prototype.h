@@ -38,6 +38,18 @@ GString*
 f_backup_message (gchar *backup_filename,
                   gboolean stat_error);
 
+/* f_watch.c */
+LeptonFileWatch*
+f_watch_new ();
+void
+f_watch_free (LeptonFileWatch *watch);
+gboolean
+f_watch_add (LeptonFileWatch *watch,
+             const gchar *filename);
+gchar**
+f_watch_wait (LeptonFileWatch *watch,
+              guint delay);
+
 /* g_basic.c */
 SCM g_scm_eval_protected (SCM exp, SCM module_or_state);
 SCM g_scm_eval_string_protected (SCM str);
@@ -168,10 +180,16 @@ const CLibSource *s_clib_add_scm (SCM listfunc, SCM getfunc,
                                   const gchar *name);
 const gchar *s_clib_source_get_name (const CLibSource *source);
 GList *s_clib_source_get_symbols (const CLibSource *source);
+const CLibSymbol *s_clib_source_get_symbol_by_name (const CLibSource *source,
+                                                    const gchar *name);
 const gchar *s_clib_symbol_get_name (const CLibSymbol *symbol);
 gchar *s_clib_symbol_get_filename (const CLibSymbol *symbol);
 const CLibSource *s_clib_symbol_get_source (const CLibSymbol *symbol);
 gchar *s_clib_symbol_get_data (const CLibSymbol *symbol);
+gchar *s_clib_symbol_get_cached_data (const CLibSymbol *symbol);
+void s_clib_symbol_set_cached_data (const CLibSymbol *symbol,
+                                    const gchar *data);
+gchar *s_clib_symbol_get_command (const CLibSymbol *symbol);
 GList *s_clib_search (const gchar *pattern, const CLibSearchMode mode);
 void s_clib_flush_search_cache ();
 void s_clib_flush_symbol_cache ();
@@ -192,6 +210,24 @@ s_conn_update_object (LeptonPage* page,
                       LeptonObject *object);
 int s_conn_net_search(LeptonObject* new_net, int whichone, GList * conn_list);
 GList *s_conn_return_others(GList *input_list, LeptonObject *object);
+LeptonConnectivity*
+s_conn_page_connectivity_new (LeptonPage *page);
+void
+s_conn_connectivity_free (LeptonConnectivity *connectivity);
+guint
+s_conn_connectivity_get_n_objects (const LeptonConnectivity *connectivity);
+guint
+s_conn_connectivity_get_n_nets (const LeptonConnectivity *connectivity);
+gpointer
+s_conn_connectivity_get_objects (const LeptonConnectivity *connectivity);
+gpointer
+s_conn_connectivity_get_offsets (const LeptonConnectivity *connectivity);
+gpointer
+s_conn_connectivity_get_targets (const LeptonConnectivity *connectivity);
+gpointer
+s_conn_connectivity_get_name_offsets (const LeptonConnectivity *connectivity);
+gpointer
+s_conn_connectivity_get_names (const LeptonConnectivity *connectivity);
 
 /* s_log.c */
 int
@@ -29,6 +29,7 @@ typedef struct _LeptonList LeptonPageList;
 
 /* lepton-schematic structures */
 typedef struct st_conn LeptonConn;
+typedef struct st_connectivity LeptonConnectivity;
 
 /* Managed text buffers */
 typedef struct _TextBuffer TextBuffer;
@@ -48,6 +49,9 @@ typedef enum { F_OPEN_RC           = 1,
                F_OPEN_RESTORE_CWD  = 8
 } FOpenFlags;
 
+/* Monitors of file changes.  See f_watch.c. */
+typedef struct st_file_watch LeptonFileWatch;
+
 
 /*! \brief Structure for connections between LeptonObjects
  *
@@ -71,6 +75,32 @@ struct st_conn {
   int other_whichone;
 };
 
+/*! \brief Connectivity of the nets and pins of a page
+ *
+ * The st_connectivity structure describes the connections between
+ * the nets and net pins of a page as compact arrays, so that they
+ * could be exported in a few calls.
+ * The objects are indexed by their position in \a objects.
+ * The connection system in s_conn.c creates this struct.
+ */
+struct st_connectivity {
+  /*! \brief Nets of the page followed by net pins of its components */
+  GPtrArray *objects;
+  /*! \brief The number of nets at the beginning of \a objects */
+  guint n_nets;
+  /*! \brief For each object, the index of its first connection in
+    \a targets, followed by the total number of connections */
+  GArray *offsets;
+  /*! \brief Indices of the objects connected to each object */
+  GArray *targets;
+  /*! \brief For each object, the offset of its netnames in \a
+    names, followed by the total size of \a names */
+  GArray *name_offsets;
+  /*! \brief NUL terminated values of the "netname=" attributes
+    attached to the objects */
+  GByteArray *names;
+};
+
 /*! \brief Type of callback function for object damage notification */
 typedef int(*ChangeNotifyFunc)(void *, LeptonObject *);
 
@@ -42,6 +42,34 @@ s_conn_add_object (LeptonPage *page,
 gchar* s_encoding_base64_encode (gchar* src, guint srclen, guint* dstlenp, gboolean strict);
 gchar* s_encoding_base64_decode (gchar* src, guint srclen, guint* dstlenp);
 
+/* s_index.c */
+struct st_page_index* s_index_new ();
+void s_index_free (struct st_page_index *index);
+void s_index_add_object (LeptonPage *page, LeptonObject *object);
+void s_index_remove_object (LeptonPage *page, LeptonObject *object);
+void
+s_index_replace_object (LeptonPage *page,
+                        LeptonObject *old_object,
+                        LeptonObject *new_object);
+void s_index_object_changed (LeptonObject *object);
+GList*
+s_index_objects_in_regions (LeptonPage *page,
+                            LeptonBox *rects,
+                            int n_rects,
+                            gboolean include_hidden);
+
+/* s_text_index.c */
+struct st_page_text_index* s_text_index_new ();
+void s_text_index_free (struct st_page_text_index *index);
+void s_text_index_add_object (LeptonPage *page, LeptonObject *object);
+void s_text_index_remove_object (LeptonPage *page, LeptonObject *object);
+void
+s_text_index_replace_object (LeptonPage *page,
+                             LeptonObject *old_object,
+                             LeptonObject *new_object);
+void s_text_index_object_changed (LeptonObject *object);
+GList* s_text_index_find (LeptonPage *page, const gchar *substring);
+
 /* s_weakref.c */
 GList *s_weakref_notify (void *dead_ptr, GList *weak_refs);
 GList *s_weakref_add (GList *weak_refs, void (*notify_func)(void *, void *), void *user_data);
@@ -0,0 +1,57 @@
+;;; Runner of Scheme benchmarks
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+
+;;; Benchmarks are not part of the test suite.  They are run on
+;;; demand by 'make bench' like this:
+;;; (bench.scm bench/file.scm ...)
+;;;
+;;; Each benchmark script reports the time taken by the code it
+;;; measures using the procedure 'benchmark' defined below.
+
+
+;;; Set location of liblepton library.
+(setenv "LIBLEPTON"
+        (string-join '(".." "src" "liblepton")
+                     file-name-separator-string))
+
+(use-modules (lepton ffi)
+             (lepton toplevel))
+
+(setenv "LEPTON_INHIBIT_RC_FILES" "yes")
+
+;;; Initialize liblepton library.
+(liblepton_init)
+
+(define (benchmark name thunk)
+  "Call THUNK, report the time it took under NAME, and return
+its result."
+  (let* ((start (get-internal-real-time))
+         (result (thunk))
+         (seconds (exact->inexact
+                   (/ (- (get-internal-real-time) start)
+                      internal-time-units-per-second))))
+    (format #t "  ~A: ~,3F s\n" name seconds)
+    result))
+
+(define (main args)
+  (with-toplevel (make-toplevel)
+    (lambda ()
+      (for-each (lambda (file)
+                  (format #t "~A\n" (basename file ".scm"))
+                  (load file))
+                (cdr args)))))
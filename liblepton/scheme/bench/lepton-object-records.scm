@@ -0,0 +1,55 @@
+;;; Benchmark per-object and bulk access to the properties of a
+;;; page.
+
+(use-modules (srfi srfi-1)
+             (srfi srfi-11)
+             (lepton object)
+             (lepton page))
+
+;;; The same accessors as in the unit test
+;;; "lepton-object-records.scm", restricted to the lines and
+;;; texts of the generated page.
+(define (object-fields object)
+  (define (coords first second)
+    (list (car first) (cdr first) (car second) (cdr second)))
+
+  `(,(object-type object)
+    ,(object-id object)
+    ,(object-color object)
+    ,@(case (object-type object)
+        ((line) (coords (line-start object) (line-end object)))
+        ((text) (coords (text-anchor object) '(0 . 0))))
+    ,(and (text? object) (text-string object))))
+
+(define (record-fields records strings index)
+  `(,@(map (lambda (field) (object-record-ref records index field))
+           '(type id color x0 y0 x1 y1))
+    ,(vector-ref strings index)))
+
+(define object-count 20000)
+
+(let ((page (make-page "/bench/page/records")))
+  (apply page-append! page
+         (append-map (lambda (i)
+                       (list (make-line (cons i 0) (cons i 100))
+                             (make-text (cons i 200) 'lower-left 0
+                                        (number->string i) 10 #t 'both)))
+                     (iota (quotient object-count 2))))
+
+  (let ((per-object
+         (benchmark (format #f "page-contents and accessors, ~A objects"
+                            object-count)
+                    (lambda ()
+                      (map object-fields (page-contents page)))))
+        (bulk
+         (benchmark (format #f "page-object-records, ~A objects"
+                            object-count)
+                    (lambda ()
+                      (let-values (((objects records strings)
+                                    (page-object-records page)))
+                        (map (lambda (i) (record-fields records strings i))
+                             (iota (vector-length objects))))))))
+    (unless (equal? per-object bulk)
+      (error "Per-object and bulk properties differ")))
+
+  (close-page! page))
@@ -0,0 +1,84 @@
+;;; Benchmark grouping of connections in the netlister.
+
+(use-modules (srfi srfi-1)
+             (srfi srfi-11)
+             (lepton object)
+             (lepton page)
+             (netlist connection-group)
+             (netlist schematic-connection))
+
+;;; Reference implementation, the same as in the unit test
+;;; "netlist-connection-group.scm": each item takes the groups it
+;;; is connected to out of the list, and the new group is
+;;; appended to the list.
+(define (fold-groups items elements probe-keys link-keys)
+  (define (connected? item group-items)
+    (any (lambda (other)
+           (any (lambda (key) (member key (link-keys other)))
+                (probe-keys item)))
+         group-items))
+  (map (lambda (group) (append-map elements group))
+       (fold (lambda (item groups)
+               (let-values (((connected unconnected)
+                             (partition (lambda (group)
+                                          (connected? item group))
+                                        groups)))
+                 `(,@unconnected
+                   ,(apply append (list item) connected))))
+             '()
+             items)))
+
+;;; Rows of chained segments, each segment being listed with its
+;;; ends as keys.
+(define (segment-items rows columns)
+  (append-map
+   (lambda (row)
+     (list-tabulate columns
+                    (lambda (column)
+                      (list (+ (* row columns) column)
+                            (cons (* column 100) (* row 200))
+                            (cons (* (1+ column) 100) (* row 200))))))
+   (iota rows)))
+
+;;; The reference fold is quadratic, so it is only compared with
+;;; group-linked on small inputs.
+(for-each
+ (lambda (rows)
+   (let* ((items (segment-items rows 100))
+          (linked (benchmark
+                   (format #f "group-linked, ~A segments" (length items))
+                   (lambda ()
+                     (group-linked items
+                                   #:elements (lambda (item) (list (car item)))
+                                   #:probe-keys cdr
+                                   #:link-keys cdr))))
+          (folded (benchmark
+                   (format #f "reference fold, ~A segments" (length items))
+                   (lambda ()
+                     (fold-groups items
+                                  (lambda (item) (list (car item)))
+                                  cdr
+                                  cdr)))))
+     (unless (equal? linked folded)
+       (error "Groups differ, number of segments:" (length items)))))
+ '(10 20 40))
+
+;;; Connections of a page of 100000 net segments.
+(let ((page (make-page "/bench/page/connection-rows"))
+      (rows 1000)
+      (columns 100))
+  (for-each
+   (lambda (row)
+     (apply page-append! page
+            (list-tabulate columns
+                           (lambda (column)
+                             (make-net (cons (* column 100) (* row 200))
+                                       (cons (* (1+ column) 100) (* row 200)))))))
+   (iota rows))
+  (let ((connections
+         (benchmark (format #f "make-page-schematic-connections, ~A segments"
+                            (* rows columns))
+                    (lambda () (make-page-schematic-connections page)))))
+    (unless (= rows (length connections))
+      (error "Wrong number of connections:" (length connections))))
+  (close-page! page))
@@ -142,6 +142,7 @@
             lepton_object_set_stroke_space_length
             lepton_object_get_type
             lepton_object_get_whichend
+            lepton_object_weak_ref
 
             lepton_object_is_arc
             lepton_object_is_attrib
@@ -328,6 +329,15 @@
             s_conn_remove_object_connections
             s_conn_return_others
             s_conn_update_object
+            s_conn_page_connectivity_new
+            s_conn_connectivity_free
+            s_conn_connectivity_get_n_objects
+            s_conn_connectivity_get_n_nets
+            s_conn_connectivity_get_objects
+            s_conn_connectivity_get_offsets
+            s_conn_connectivity_get_targets
+            s_conn_connectivity_get_name_offsets
+            s_conn_connectivity_get_names
 
             o_selection_add
 
@@ -339,6 +349,7 @@
             lepton_toplevel_search_page
 
             lepton_object_list_delete
+            lepton_object_list_export
             lepton_object_list_to_buffer
             lepton_object_list_translate
             o_glist_copy_all
@@ -374,6 +385,11 @@
 
             f_open
 
+            f_watch_new
+            f_watch_free
+            f_watch_add
+            f_watch_wait
+
             lepton_coord_snap))
 
 ;;; Simplify definition of functions by omitting the library
@@ -516,6 +532,7 @@
 (define-lff lepton_object_set_stroke_space_length void (list '* int))
 (define-lff lepton_object_get_type int '(*))
 (define-lff lepton_object_get_whichend int '(*))
+(define-lff lepton_object_weak_ref void '(* * *))
 
 (define-lff lepton_object_is_arc int '(*))
 (define-lff lepton_object_is_attrib int '(*))
@@ -686,9 +703,19 @@
 (define-lff s_conn_remove_object_connections void '(*))
 (define-lff s_conn_return_others '* '(* *))
 (define-lff s_conn_update_object void '(* *))
+(define-lff s_conn_page_connectivity_new '* '(*))
+(define-lff s_conn_connectivity_free void '(*))
+(define-lff s_conn_connectivity_get_n_objects unsigned-int '(*))
+(define-lff s_conn_connectivity_get_n_nets unsigned-int '(*))
+(define-lff s_conn_connectivity_get_objects '* '(*))
+(define-lff s_conn_connectivity_get_offsets '* '(*))
+(define-lff s_conn_connectivity_get_targets '* '(*))
+(define-lff s_conn_connectivity_get_name_offsets '* '(*))
+(define-lff s_conn_connectivity_get_names '* '(*))
 
 ;;; object_list.c
 (define-lff lepton_object_list_delete void '(*))
+(define-lff lepton_object_list_export unsigned-int (list '* int '* '* '* '*))
 (define-lff lepton_object_list_to_buffer '* '(*))
 (define-lff o_glist_copy_all '* '(* *))
 (define-lff lepton_object_list_translate void  (list '* int int))
@@ -728,6 +755,12 @@
 ;;; f_basic.c
 (define-lff f_open int (list '* '* '* int '*))
 
+;;; f_watch.c
+(define-lff f_watch_new '* '())
+(define-lff f_watch_free void '(*))
+(define-lff f_watch_add int '(* *))
+(define-lff f_watch_wait '* (list '* unsigned-int))
+
 ;;; export.c
 (define-lff export_config void '())
 (define-lff lepton_export_eps void '(*))
@@ -27,9 +27,11 @@
             g_list_append
             g_list_copy
             g_list_free
+            g_list_prepend
             g_list_remove
             g_list_remove_all
             g_log
+            g_strfreev
 
             ;; Mock glib functions.
 
@@ -56,6 +58,7 @@
 (define-lff g_list_copy '* '(*))
 (define-lff g_list_free void '(*))
 (define-lff g_list_free_full void '(*))
+(define-lff g_list_prepend '* '(* *))
 (define-lff g_list_remove '* '(* *))
 (define-lff g_list_remove_all '* '(* *))
 
@@ -63,6 +66,8 @@
 
 (define-lff g_slist_free_full void '(*))
 
+(define-lff g_strfreev void '(*))
+
 
 ;;; GSList: singly-linked list.
 
@@ -18,6 +18,8 @@
 
 (define-module (lepton object foreign)
   #:use-module (ice-9 format)
+  #:use-module (srfi srfi-9)
+  #:use-module (srfi srfi-9 gnu)
   #:use-module (system foreign)
 
   #:use-module (lepton ffi check-args)
@@ -28,13 +30,47 @@
             pointer->object
             check-object))
 
-(define-wrapped-pointer-type <object>
+(define-record-type <object>
+  (make-object-wrapper pointer)
   is-object?
-  wrap-object
-  unwrap-object
-  (lambda (object port)
-    (format port "#<object-0x~x>"
-            (pointer-address (unwrap-object object)))))
+  (pointer unwrap-object set-object-wrapper-pointer!))
+
+(set-record-type-printer!
+ <object>
+ (lambda (object port)
+   (format port "#<object-0x~x>"
+           (pointer-address (unwrap-object object)))))
+
+
+;;; Wrappers of C objects indexed by their addresses.  A wrapper
+;;; is kept as long as its C object exists, so that the same
+;;; wrapper is always returned for the same object and properties
+;;; defined with make-object-property() are not lost when Scheme
+;;; code drops its references to the wrapper.  The entry is
+;;; removed, and the wrapper is invalidated, when the C object is
+;;; destroyed, since a new object may be allocated at the same
+;;; address afterwards.
+(define %object-wrappers (make-hash-table))
+
+(define (forget-object-wrapper! dead-pointer user-data)
+  (let* ((address (pointer-address dead-pointer))
+         (object (hashv-ref %object-wrappers address)))
+    (when object
+      (hashv-remove! %object-wrappers address)
+      (set-object-wrapper-pointer! object %null-pointer))))
+
+(define %forget-object-wrapper
+  (procedure->pointer void forget-object-wrapper! '(* *)))
+
+(define (wrap-object pointer)
+  (let ((address (pointer-address pointer)))
+    (or (hashv-ref %object-wrappers address)
+        (let ((object (make-object-wrapper pointer)))
+          (hashv-set! %object-wrappers address object)
+          (lepton_object_weak_ref pointer
+                                  %forget-object-wrapper
+                                  %null-pointer)
+          object))))
 
 
 ;;; Helper transformers between the <object> type and C object
@@ -0,0 +1,160 @@
+;;; Lepton EDA library - Scheme API
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Bulk export of object properties.
+
+(define-module (lepton object record)
+  #:use-module (rnrs bytevectors)
+  #:use-module (system foreign)
+
+  #:use-module (lepton ffi)
+  #:use-module (lepton object foreign)
+
+  #:export (glist->object-records
+            object-record-count
+            object-record-ref))
+
+;;; The order of fields must match LeptonObjectRecordField in
+;;; object_list.h.
+(define %record-fields
+  '(type id color x0 y0 x1 y1 parent attached-to string))
+
+(define %record-size
+  (* 4 (length %record-fields)))
+
+(define %record-types
+  `((#\A . arc)
+    (#\B . box)
+    (#\U . bus)
+    (#\V . circle)
+    (#\C . complex)
+    (#\L . line)
+    (#\N . net)
+    (#\H . path)
+    (#\G . picture)
+    (#\P . pin)
+    (#\T . text)))
+
+
+(define (glist->object-records glist with-attribs?)
+  "Exports the objects of the GList pointed to by GLIST, followed
+by the contents of components and, if WITH-ATTRIBS? is true, by
+their attached attributes, using lepton_object_list_export().
+Returns three values: a vector of the objects, a bytevector of
+their records, and a vector of the strings of text objects, #f
+for other objects."
+  (define flag (if with-attribs? 1 0))
+  (define size (make-bytevector (sizeof size_t) 0))
+
+  (define (export objects records strings)
+    (lepton_object_list_export glist
+                               flag
+                               objects
+                               records
+                               strings
+                               (bytevector->pointer size)))
+
+  (let ((count (export %null-pointer %null-pointer %null-pointer)))
+    (if (zero? count)
+        (values #() (make-bytevector 0) #())
+        (let* ((strings-size (bytevector-uint-ref size
+                                                  0
+                                                  (native-endianness)
+                                                  (sizeof size_t)))
+               (pointers (make-bytevector (* count (sizeof '*))))
+               (records (make-bytevector (* count %record-size)))
+               (strings (make-bytevector (max 1 strings-size)))
+               (objects (make-vector count #f))
+               (texts (make-vector count #f)))
+          (export (bytevector->pointer pointers)
+                  (bytevector->pointer records)
+                  (bytevector->pointer strings))
+          ;; Text strings are stored in the order of objects.
+          (let loop ((i 0)
+                     (string-list (if (zero? strings-size)
+                                      '()
+                                      (string-split
+                                       (utf8->string
+                                        (bytevector-slice strings
+                                                          (1- strings-size)))
+                                       #\nul))))
+            (when (< i count)
+              (vector-set! objects
+                           i
+                           (pointer->object
+                            (make-pointer
+                             (bytevector-uint-ref pointers
+                                                  (* i (sizeof '*))
+                                                  (native-endianness)
+                                                  (sizeof '*)))))
+              (if (negative? (record-field records i 'string))
+                  (loop (1+ i) string-list)
+                  (begin
+                    (vector-set! texts i (car string-list))
+                    (loop (1+ i) (cdr string-list))))))
+          (values objects records texts)))))
+
+
+;;; Returns the first LENGTH bytes of BV.
+(define (bytevector-slice bv length)
+  (let ((result (make-bytevector length)))
+    (bytevector-copy! bv 0 result 0 length)
+    result))
+
+
+(define (record-field records index field)
+  (bytevector-s32-native-ref
+   records
+   (+ (* index %record-size)
+      (* 4 (list-index-of field %record-fields)))))
+
+(define (list-index-of x ls)
+  (let loop ((ls ls) (i 0))
+    (cond
+     ((null? ls) (error "Unknown object record field: ~A" x))
+     ((eq? x (car ls)) i)
+     (else (loop (cdr ls) (1+ i))))))
+
+
+(define (object-record-count records)
+  "Returns the number of object records in the bytevector RECORDS."
+  (quotient (bytevector-length records) %record-size))
+
+
+(define (object-record-ref records index field)
+  "Returns the value of FIELD in the object record with INDEX in
+the bytevector RECORDS.  FIELD may be one of the symbols:
+- 'type: the type of the object, as returned by object-type();
+- 'id: the id of the object, or #f if it has no id;
+- 'color: the colormap index of the color of the object;
+- 'x0, 'y0, 'x1, 'y1: coordinates of the object.  For lines,
+  nets, buses, and pins, these are the coordinates of the start
+  and the end of the object, as returned by line-start() and
+  line-end().  For boxes and pictures, these are the coordinates
+  of the upper left and lower right corners.  For circles and
+  arcs, 'x0 and 'y0 are the coordinates of the center, and 'x1 is
+  the radius.  For other objects, 'x0 and 'y0 are the coordinates
+  of their position.  Unused coordinates are 0;
+- 'parent: the index of the record of the component containing
+  the object, or #f;
+- 'attached-to: the index of the record of the object the object
+  is attached to as an attribute, or #f."
+  (let ((value (record-field records index field)))
+    (case field
+      ((type) (assv-ref %record-types (integer->char value)))
+      ((id parent attached-to) (and (>= value 0) value))
+      (else value))))
@@ -34,6 +34,7 @@
   #:use-module (lepton gerror)
   #:use-module (lepton object type)
   #:use-module (lepton object foreign)
+  #:use-module (lepton object record)
   #:use-module (lepton os)
   #:use-module (lepton page foreign)
   #:use-module (lepton toplevel foreign)
@@ -48,6 +49,8 @@
             page-append!
             page-remove!
             page-contents
+            page-object-records
+            page-connectivity
             page-dirty?
             set-page-dirty!
             page-filename
@@ -137,6 +140,95 @@ PAGE after calling this function will cause an error."
   (glist->list (lepton_page_objects pointer) pointer->object))
 
 
+(define (page-object-records page)
+  "Returns the properties of the objects of PAGE and of the
+contents of its components using one foreign call for the whole
+page instead of several calls for each object.  Returns three
+values:
+- a vector of the objects of PAGE, in the order of its contents,
+  where each component is followed by its contents;
+- a bytevector of the records of the objects, whose fields may be
+  obtained with object-record-ref() from the module
+  (lepton object);
+- a vector of the strings of text objects, #f for other objects."
+  (define pointer (check-page page 1))
+
+  (glist->object-records (lepton_page_objects pointer) #f))
+
+
+(define (page-connectivity page)
+  "Returns the connectivity of the nets and net pins of PAGE as
+five values:
+- a vector of the nets of PAGE, in the order of its contents,
+  followed by the net pins of its components;
+- the number of nets at the beginning of the vector;
+- a bytevector of native signed 32-bit integers, where the
+  elements I and I+1 are the bounds of the connections of the
+  object with index I in the next bytevector;
+- a bytevector of native signed 32-bit integers containing the
+  indices of the objects connected to each object;
+- a vector of the lists of the values of the \"netname=\"
+  attributes attached to each object.
+The connectivity is obtained with a few foreign calls, whatever
+the number of objects on PAGE."
+  (define pointer (check-page page 1))
+
+  (define (s32-bytevector data count)
+    (if (zero? count)
+        (make-bytevector 0)
+        (bytevector-copy (pointer->bytevector data (* 4 count)))))
+
+  (let* ((*connectivity (s_conn_page_connectivity_new pointer))
+         (count (s_conn_connectivity_get_n_objects *connectivity))
+         (n-nets (s_conn_connectivity_get_n_nets *connectivity))
+         (offsets (s32-bytevector
+                   (s_conn_connectivity_get_offsets *connectivity)
+                   (1+ count)))
+         (targets (s32-bytevector
+                   (s_conn_connectivity_get_targets *connectivity)
+                   (bytevector-s32-native-ref offsets (* 4 count))))
+         (name-offsets (s32-bytevector
+                        (s_conn_connectivity_get_name_offsets *connectivity)
+                        (1+ count)))
+         (names-size (bytevector-s32-native-ref name-offsets (* 4 count)))
+         (names (if (zero? names-size)
+                    (make-bytevector 0)
+                    (bytevector-copy
+                     (pointer->bytevector
+                      (s_conn_connectivity_get_names *connectivity)
+                      names-size))))
+         (object-pointers (if (zero? count)
+                              (make-bytevector 0)
+                              (pointer->bytevector
+                               (s_conn_connectivity_get_objects *connectivity)
+                               (* count (sizeof '*)))))
+         (objects (make-vector count #f))
+         (netnames (make-vector count '())))
+
+    (do ((i 0 (1+ i)))
+        ((= i count))
+      (vector-set! objects
+                   i
+                   (pointer->object
+                    (make-pointer
+                     (bytevector-uint-ref object-pointers
+                                          (* i (sizeof '*))
+                                          (native-endianness)
+                                          (sizeof '*)))))
+      (let ((start (bytevector-s32-native-ref name-offsets (* 4 i)))
+            (end (bytevector-s32-native-ref name-offsets (* 4 (1+ i)))))
+        (unless (= start end)
+          (let ((bv (make-bytevector (- end start 1))))
+            (bytevector-copy! names start bv 0 (- end start 1))
+            (vector-set! netnames
+                         i
+                         (string-split (utf8->string bv) #\nul))))))
+
+    (s_conn_connectivity_free *connectivity)
+
+    (values objects n-nets offsets targets netnames)))
+
+
 (define (page-dirty? page)
   "Returns #t if PAGE has been flagged as having been modified,
 otherwise returns #f."
@@ -0,0 +1,377 @@
+;;; Lepton EDA library - Scheme API
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Server running Lepton EDA programs on requests of clients
+;;; connected to a Unix domain socket.
+;;;
+;;; Each request is run in a process forked from the server, so it
+;;; starts with the modules, configuration, and component library
+;;; already loaded by the server, and whatever it changes does not
+;;; affect the server and other requests.
+
+(define-module (lepton server)
+  #:use-module (ice-9 binary-ports)
+  #:use-module (ice-9 match)
+  #:use-module (rnrs bytevectors)
+  #:use-module (srfi srfi-1)
+  #:use-module (srfi srfi-9)
+  #:use-module (srfi srfi-11)
+
+  #:use-module (lepton gettext)
+  #:use-module (lepton log)
+  #:use-module (lepton server protocol)
+
+  #:export (run-server))
+
+
+(define-record-type <job>
+  (make-job id command client pid out err start)
+  job?
+  (id job-id)
+  (command job-command)
+  (client job-client set-job-client!)
+  (pid job-pid)
+  (out job-out set-job-out!)
+  (err job-err set-job-err!)
+  (start job-start))
+
+
+;;; Client whose request is being received.
+(define-record-type <pending-client>
+  (make-pending-client port data start)
+  pending-client?
+  (port pending-client-port)
+  (data pending-client-data set-pending-client-data!)
+  (start pending-client-start))
+
+
+;;; Maximum size of a request frame in bytes, and the time in
+;;; seconds a client may take to send it.
+(define %max-request-size (* 1024 1024))
+(define %request-timeout 10)
+
+
+(define (job-ports job)
+  (filter identity (list (job-client job) (job-out job) (job-err job))))
+
+
+(define (seconds-since time)
+  (exact->inexact (/ (- (get-internal-real-time) time)
+                     internal-time-units-per-second)))
+
+
+(define (server-running? filename)
+  (let ((sock (socket PF_UNIX SOCK_STREAM 0)))
+    (catch 'system-error
+      (lambda ()
+        (connect sock AF_UNIX filename)
+        (close-port sock)
+        #t)
+      (lambda args
+        (close-port sock)
+        #f))))
+
+
+;;; Creates a socket listening on FILENAME, which is accessible
+;;; only to the current user.  A stale socket file left by a
+;;; server which has not exited properly is removed.
+(define (open-server-socket filename)
+  (when (file-exists? filename)
+    (if (server-running? filename)
+        (scm-error 'misc-error
+                   "run-server"
+                   (G_ "Another server is listening on ~S.")
+                   (list filename)
+                   #f)
+        (delete-file filename)))
+
+  (let ((sock (socket PF_UNIX SOCK_STREAM 0))
+        (mask (umask #o077)))
+    (bind sock AF_UNIX filename)
+    (umask mask)
+    (listen sock 128)
+    sock))
+
+
+(define (bytevector-append a b)
+  (let ((result (make-bytevector (+ (bytevector-length a)
+                                    (bytevector-length b)))))
+    (bytevector-copy! a 0 result 0 (bytevector-length a))
+    (bytevector-copy! b 0 result (bytevector-length a) (bytevector-length b))
+    result))
+
+
+;;; Returns the request in the complete frame DATA, or #f if it is
+;;; invalid.
+(define (read-request data)
+  (false-if-exception
+   (let-values (((type payload)
+                 (read-frame (open-bytevector-input-port data))))
+     (and (eq? type 'request)
+          (frame-datum payload)))))
+
+
+;;; Converts the exit value returned by the 'quit exception, that
+;;; is, by exit(), into a process exit status.
+(define (quit-status args)
+  (match args
+    (() 0)
+    ((#t) 0)
+    ((#f) 1)
+    (((? integer? status)) status)
+    (_ 1)))
+
+
+;;; Runs the program SCRIPT with arguments ARGS in the directory
+;;; CWD and the environment ENV.  It is run in the process of the
+;;; job, and never returns.
+(define (run-script script args cwd env)
+  (catch #t
+    (lambda ()
+      (chdir cwd)
+      (environ env)
+      (set-program-arguments (cons script args))
+      (save-module-excursion
+       (lambda ()
+         (set-current-module (make-fresh-user-module))
+         (load script)))
+      (flush-all-ports)
+      (primitive-exit 0))
+    (lambda (key . args)
+      (unless (eq? key 'quit)
+        (format (current-error-port)
+                (G_ "ERROR: ~A: ~S\n")
+                key
+                args))
+      (flush-all-ports)
+      (primitive-exit (if (eq? key 'quit) (quit-status args) 1)))))
+
+
+(define* (run-server filename commands
+                     #:key (max-jobs (current-processor-count)))
+  "Runs lepton-cli server listening on the socket FILENAME.
+COMMANDS is an association list of the names of the commands
+clients may request and the file names of the Scheme programs
+running them.  At most MAX-JOBS requests are run at the same time.
+Never returns.
+
+Requests are received without blocking the server: the data sent
+by each client is collected as it arrives, and the request is only
+parsed once its whole frame has been received.  Clients which do
+not send a request within %request-timeout seconds are
+disconnected."
+  (define server (open-server-socket filename))
+  (define jobs '())
+  (define job-count 0)
+  ;; Clients whose request has not been received completely yet.
+  (define pending '())
+  ;; Pairs (CLIENT . REQUEST) of received requests waiting for a
+  ;; free job slot.
+  (define queued '())
+
+  (define (stop-server signal)
+    (false-if-exception (delete-file filename))
+    (primitive-exit 0))
+
+  (define (close-client! job)
+    (false-if-exception (close-port (job-client job)))
+    (set-job-client! job #f))
+
+  ;; Sends a frame to the client of JOB using WRITE-FRAME!.  If
+  ;; the client has gone, the job is stopped.
+  (define (send! job write-frame!)
+    (when (job-client job)
+      (catch 'system-error
+        (lambda () (write-frame! (job-client job)))
+        (lambda args
+          (close-client! job)
+          (false-if-exception (kill (job-pid job) SIGTERM))))))
+
+  (define (reject! client fmt . args)
+    (false-if-exception
+     (begin
+       (write-frame client
+                    'stderr
+                    (string->utf8 (format #f "~?\n" fmt args)))
+       (write-datum-frame client 'exit '(1 0))))
+    (false-if-exception (close-port client)))
+
+  (define (start-job! client command script args cwd env)
+    (let ((out (pipe))
+          (err (pipe)))
+      (set! job-count (1+ job-count))
+      (flush-all-ports)
+      (let ((pid (primitive-fork)))
+        (if (zero? pid)
+            (begin
+              (for-each (lambda (signal) (sigaction signal SIG_DFL))
+                        (list SIGINT SIGTERM SIGPIPE))
+              (close-port server)
+              (for-each close-port (append-map job-ports jobs))
+              (for-each close-port (map pending-client-port pending))
+              (for-each close-port (map car queued))
+              (close-port client)
+              (close-port (car out))
+              (close-port (car err))
+              (dup2 (port->fdes (open-input-file "/dev/null")) 0)
+              (dup2 (port->fdes (cdr out)) 1)
+              (dup2 (port->fdes (cdr err)) 2)
+              (run-script script args cwd env))
+            (begin
+              (close-port (cdr out))
+              (close-port (cdr err))
+              (set! jobs
+                    (append jobs
+                            (list (make-job job-count
+                                            (cons command args)
+                                            client
+                                            pid
+                                            (car out)
+                                            (car err)
+                                            (get-internal-real-time))))))))))
+
+  (define (start-request! client request)
+    (match request
+      (((? string? cwd)
+        ((? string? env) ...)
+        ((? string? command) (? string? args) ...))
+       (let ((script (assoc-ref commands command)))
+         (if script
+             (start-job! client command script args cwd env)
+             (reject! client (G_ "ERROR: Unknown command ~S.") command))))
+      (_ (reject! client (G_ "ERROR: Invalid request.")))))
+
+  (define (accept-client!)
+    (let ((client (car (accept server))))
+      (set! pending
+            (append pending
+                    (list (make-pending-client client
+                                               (make-bytevector 0)
+                                               (get-internal-real-time)))))))
+
+  ;; Reads the data available from the pending client P.  The
+  ;; select() call has reported it as readable, so this does not
+  ;; block.
+  (define (receive-request! p)
+    (let* ((client (pending-client-port p))
+           (data (false-if-exception (get-bytevector-some client))))
+      (if (or (not data) (eof-object? data))
+          (begin
+            (set! pending (delete p pending eq?))
+            (false-if-exception (close-port client)))
+          (let* ((data (bytevector-append (pending-client-data p) data))
+                 (size (frame-size data)))
+            (cond
+             ((and size (> size %max-request-size))
+              (set! pending (delete p pending eq?))
+              (reject! client (G_ "ERROR: Invalid request.")))
+             ((and size (>= (bytevector-length data) size))
+              (set! pending (delete p pending eq?))
+              (set! queued
+                    (append queued
+                            (list (cons client (read-request data))))))
+             (else
+              (set-pending-client-data! p data)))))))
+
+  (define (expire-pending!)
+    (let-values (((expired waiting)
+                  (partition (lambda (p)
+                               (> (seconds-since (pending-client-start p))
+                                  %request-timeout))
+                             pending)))
+      (set! pending waiting)
+      (for-each (lambda (p)
+                  (reject! (pending-client-port p)
+                           (G_ "ERROR: Request timed out.")))
+                expired)))
+
+  (define (start-queued!)
+    (when (and (pair? queued) (< (length jobs) max-jobs))
+      (let ((request (car queued)))
+        (set! queued (cdr queued))
+        (start-request! (car request) (cdr request))
+        (start-queued!))))
+
+  (define (forward-output! job port type)
+    (let ((data (get-bytevector-some port)))
+      (if (eof-object? data)
+          (begin
+            (close-port port)
+            (if (eq? type 'stdout)
+                (set-job-out! job #f)
+                (set-job-err! job #f)))
+          (send! job (lambda (client) (write-frame client type data))))))
+
+  (define (finish-job! job)
+    (let* ((status (cdr (waitpid (job-pid job))))
+           (code (or (status:exit-val status)
+                     (+ 128 (or (status:term-sig status) 0))))
+           (seconds (seconds-since (job-start job))))
+      (send! job (lambda (client)
+                   (write-datum-frame client 'exit (list code seconds))))
+      (when (job-client job)
+        (close-client! job))
+      (log! 'message
+            (G_ "Job ~A (~A) finished with status ~A in ~,3F s.")
+            (job-id job)
+            (string-join (job-command job))
+            code
+            seconds)))
+
+  (define (running? job)
+    (or (job-out job) (job-err job)))
+
+  (sigaction SIGPIPE SIG_IGN)
+  (sigaction SIGINT stop-server)
+  (sigaction SIGTERM stop-server)
+
+  (log! 'message (G_ "Listening on ~S.") filename)
+
+  (let loop ()
+    (let* ((outputs (append-map (lambda (job)
+                                  (filter identity
+                                          (list (job-out job) (job-err job))))
+                                jobs))
+           (clients (map pending-client-port pending))
+           (ready (car (select (if (< (length jobs) max-jobs)
+                                   (cons server (append clients outputs))
+                                   (append clients outputs))
+                               '()
+                               '()
+                               ;; Wake up to disconnect clients
+                               ;; which are too slow.
+                               (and (pair? pending) 1)))))
+      (for-each
+       (lambda (job)
+         (for-each (lambda (port type)
+                     (when (and port (memq port ready))
+                       (forward-output! job port type)))
+                   (list (job-out job) (job-err job))
+                   '(stdout stderr)))
+       jobs)
+      (let-values (((running finished) (partition running? jobs)))
+        (for-each finish-job! finished)
+        (set! jobs running))
+      (for-each (lambda (p)
+                  (when (memq (pending-client-port p) ready)
+                    (receive-request! p)))
+                pending)
+      (expire-pending!)
+      (start-queued!)
+      (when (memq server ready)
+        (accept-client!))
+      (loop))))
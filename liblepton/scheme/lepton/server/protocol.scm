@@ -0,0 +1,122 @@
+;;; Lepton EDA library - Scheme API
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Messages exchanged by lepton-cli server and its clients.
+;;;
+;;; Each message is a frame consisting of one byte of its type,
+;;; four bytes of the size of its payload in big-endian order, and
+;;; the payload.  The client sends a 'request frame containing the
+;;; list (CWD ENVIRONMENT ARGUMENTS).  The server answers with
+;;; 'stdout and 'stderr frames containing the output of the
+;;; command, and, finally, with an 'exit frame containing the list
+;;; (STATUS SECONDS).
+;;;
+;;; This module does not depend on liblepton so that clients can
+;;; start quickly.
+
+(define-module (lepton server protocol)
+  #:use-module (ice-9 binary-ports)
+  #:use-module (rnrs bytevectors)
+  #:use-module (srfi srfi-1)
+
+  #:export (default-server-socket
+            frame-size
+            read-frame
+            write-frame
+            write-datum-frame
+            frame-datum))
+
+(define %frame-types
+  '((request . 0)
+    (stdout . 1)
+    (stderr . 2)
+    (exit . 3)))
+
+(define %frame-header-size 5)
+
+
+(define (default-server-socket)
+  "Returns the default file name of the socket of lepton-cli
+server.  It is taken from the environment variable
+LEPTON_SERVER_SOCKET if it is set, otherwise the socket is placed
+in XDG_RUNTIME_DIR or, if that is not set, in /tmp."
+  (or (getenv "LEPTON_SERVER_SOCKET")
+      (string-append (or (getenv "XDG_RUNTIME_DIR") "/tmp")
+                     file-name-separator-string
+                     (format #f "lepton-server-~A.socket" (getuid)))))
+
+
+(define (write-frame port type payload)
+  "Writes a frame of TYPE with bytevector PAYLOAD to PORT, and
+flushes PORT."
+  (let ((header (make-bytevector %frame-header-size)))
+    (bytevector-u8-set! header 0 (assq-ref %frame-types type))
+    (bytevector-u32-set! header 1
+                         (bytevector-length payload)
+                         (endianness big))
+    (put-bytevector port header)
+    (put-bytevector port payload)
+    (force-output port)))
+
+
+(define (write-datum-frame port type datum)
+  "Writes a frame of TYPE containing the written representation
+of DATUM to PORT."
+  (write-frame port
+               type
+               (string->utf8 (with-output-to-string
+                               (lambda () (write datum))))))
+
+
+(define (frame-size data)
+  "Returns the size, including the header, of the frame at the
+start of bytevector DATA, or #f if DATA is shorter than the frame
+header."
+  (and (>= (bytevector-length data) %frame-header-size)
+       (+ %frame-header-size
+          (bytevector-u32-ref data 1 (endianness big)))))
+
+
+(define (read-frame port)
+  "Reads a frame from PORT.  Returns two values, the type of the
+frame and its payload.  If the input ends before a complete frame
+has been read, returns the end-of-file object and #f.  The type of
+an unknown frame is #f."
+  (define (short? bv size)
+    (or (eof-object? bv)
+        (< (bytevector-length bv) size)))
+
+  (let ((header (get-bytevector-n port %frame-header-size)))
+    (if (short? header %frame-header-size)
+        (values (eof-object) #f)
+        (let* ((code (bytevector-u8-ref header 0))
+               (size (bytevector-u32-ref header 1 (endianness big)))
+               (payload (if (zero? size)
+                            (make-bytevector 0)
+                            (get-bytevector-n port size))))
+          (if (short? payload size)
+              (values (eof-object) #f)
+              (values (and=> (find (lambda (x) (= (cdr x) code))
+                                   %frame-types)
+                             car)
+                      payload))))))
+
+
+(define (frame-datum payload)
+  "Returns the datum written in the frame PAYLOAD by
+write-datum-frame()."
+  (call-with-input-string (utf8->string payload) read))
@@ -44,11 +44,13 @@
   #:use-module (netlist net)
   #:use-module (netlist option)
   #:use-module (netlist package-pin)
+  #:use-module (netlist page-load)
   #:use-module (netlist schematic toplevel)
   #:use-module (netlist schematic)
   #:use-module (netlist schematic-component)
   #:use-module (netlist schematic-connection)
   #:use-module (netlist verbose)
+  #:use-module (netlist watch)
 
   #:export (main
             calling-flag?
@@ -178,17 +180,10 @@ symbol instances within gnetlist (the first element is the value
 associated with the first symbol instance)."
   (define sname (string->symbol attribute-name))
 
-  (define (found-package? package)
-    (let ((name (schematic-component-refdes package)))
-      (and name
-           (string=? name package-name)
-           package)))
-
   (map
    (lambda (package)
      (schematic-component-attribute package sname))
-   (filter-map found-package?
-               (schematic-components (toplevel-schematic)))))
+   (schematic-refdes-components (toplevel-schematic) package-name)))
 
 
 (define (gnetlist:get-package-attribute refdes name)
@@ -334,12 +329,6 @@ REFDES. As a result, slots may be repeated in the returned list."
 (define (get-connections netname schematic)
   "Returns all connections in the form of ((refdes pin) ...) for
 NETNAME in SCHEMATIC."
-  (define (found? x)
-    (and x
-         (string=? x netname)))
-
-  (define netlist (schematic-components schematic))
-
   (define (pin->refdes-pinnumber-pair pin)
     (let* ((component (package-pin-parent pin))
            (refdes (hierarchical-refdes->string
@@ -351,20 +340,13 @@ NETNAME in SCHEMATIC."
            (cons refdes pinnumber))))
 
   (define (get-found-pin-connections pin)
-    (if (found? (package-pin-name pin))
-        (filter-map pin->refdes-pinnumber-pair
-                    (if (package-pin-connection pin)
-                        (schematic-connection-pins (package-pin-connection pin))
-                        '()))
-        '()))
-
-  (define (get-netlist-connections netlist)
-    (append-map
-     (lambda (package)
-       (append-map get-found-pin-connections (schematic-component-pins package)))
-     netlist))
+    (filter-map pin->refdes-pinnumber-pair
+                (if (package-pin-connection pin)
+                    (schematic-connection-pins (package-pin-connection pin))
+                    '())))
 
-  (sort-remove-duplicates (get-netlist-connections netlist)
+  (sort-remove-duplicates (append-map get-found-pin-connections
+                                      (schematic-netname-pins schematic netname))
                           pair<?))
 
 (define (get-all-connections netname)
@@ -376,10 +358,6 @@ NETNAME."
 (define (get-pins-nets refdes)
   "For specified REFDES, returns a list of strings defining
 connection pairs in the form (\"pin-number\" . \"net-name\")."
-
-  (define (found? x)
-    (string= x refdes))
-
   (define (get-pin-netname-pair pin)
     (let ((pin-number (package-pin-number pin))
           (pin-name (package-pin-name pin)))
@@ -388,14 +366,13 @@ connection pairs in the form (\"pin-number\" . \"net-name\")."
            (cons pin-number pin-name))))
 
   (define (get-pin-netname-list component)
-     (if (and=> (schematic-component-refdes component) found?)
-         (filter-map get-pin-netname-pair (schematic-component-pins component))
-         '()))
+    (filter-map get-pin-netname-pair (schematic-component-pins component)))
 
   ;; Currently, netlist can contain many `packages' with the same
   ;; name, so we have to deal with this.
   (let ((result-list (append-map get-pin-netname-list
-                                 (schematic-components (toplevel-schematic)))))
+                                 (schematic-refdes-components (toplevel-schematic)
+                                                              refdes))))
     (sort-remove-duplicates result-list pair<?)))
 
 
@@ -423,33 +400,19 @@ connection pairs in the form (\"pin-number\" . \"net-name\")."
            (member (cons package pin-number) connections)
            connections)))
 
-  (define (found-pin-number? x)
-    (and x
-         (string=? x pin-number)))
-
   (define (lookup-through-pins pins)
-    (filter-map
+    (map
      (lambda (pin)
-       (and (found-pin-number? (package-pin-number pin))
-            (cons (package-pin-name pin)
-                  (lookup-through-connections pin
-                                              package
-                                              pin-number))))
+       (cons (package-pin-name pin)
+             (lookup-through-connections pin
+                                         package
+                                         pin-number)))
      pins))
 
-  (define (found-package? x)
-    (and x
-         (string=? x package)))
-
-  (define (lookup-through-netlist netlist)
-    (append-map
-     (lambda (package)
-       (if (found-package? (schematic-component-refdes package))
-           (lookup-through-pins (schematic-component-pins package))
-           '()))
-     netlist))
-
-  (let ((found (lookup-through-netlist (schematic-components (toplevel-schematic)))))
+  (let ((found (lookup-through-pins
+                (schematic-refdes-pinnumber-pins (toplevel-schematic)
+                                                 package
+                                                 pin-number))))
     (match found
       (((netname . rest) ..1)
        (cons (car netname) (apply append (delq #f rest))))
@@ -457,8 +420,20 @@ connection pairs in the form (\"pin-number\" . \"net-name\")."
 
 
 (define (pin-netname package pinnumber)
-  (or (assoc-ref (get-pins-nets package) pinnumber)
-      "ERROR_INVALID_PIN"))
+  "Returns the name of the net connected to the pin PINNUMBER of
+PACKAGE.  If there are several such nets, returns the first one in
+the order of the output of get-pins-nets()."
+  (define (get-pin-netname-pair pin)
+    (and=> (package-pin-name pin)
+           (cut cons pinnumber <>)))
+
+  (let ((pairs (filter-map get-pin-netname-pair
+                           (schematic-refdes-pinnumber-pins (toplevel-schematic)
+                                                            package
+                                                            pinnumber))))
+    (if (null? pairs)
+        "ERROR_INVALID_PIN"
+        (cdar (sort-remove-duplicates pairs pair<?)))))
 
 
 (define (gnetlist:get-toplevel-attribute attrib)
@@ -490,8 +465,16 @@ connection pairs in the form (\"pin-number\" . \"net-name\")."
 (define (gnetlist:get-all-connections netname)
   (map (lambda (pair) (list (car pair) (cdr pair)))
        (get-all-connections netname)))
+;;; The name of the backend being loaded or run, and the names of
+;;; all backends requested with '-g', used to select the '-O'
+;;; options of each backend.
+(define %backend-name (make-parameter #f))
+(define %backend-names (make-parameter '()))
+
 (define (gnetlist:get-backend-arguments)
-  (netlist-option-ref 'backend-option))
+  (backend-arguments (netlist-option-ref 'backend-option)
+                     (%backend-name)
+                     (%backend-names)))
 
 
 ;; Returns the least joint coordinate of CONNECTION.  A simple
@@ -680,10 +663,6 @@ other limitations imposed by this netlist format.
                                               pin-attrib-value
                                               name
                                               func)
-  (define (found-refdes? x)
-    (and x
-         (string=? x refdes)))
-
   (define (find-pin-by-attrib pins name value)
     (and (not (null? pins))
          (let* ((pin (car pins))
@@ -694,19 +673,18 @@ other limitations imposed by this netlist format.
                pin
                (find-pin-by-attrib (cdr pins) name value)))))
 
-  (let loop ((netlist (schematic-components (toplevel-schematic))))
+  (let loop ((netlist (schematic-refdes-components (toplevel-schematic) refdes)))
     (if (null? netlist)
         "unknown"
-        (or (and (found-refdes? (schematic-component-refdes (car netlist)))
-                 (let ((pin (find-pin-by-attrib (schematic-component-pins (car netlist))
-                                                (string->symbol pin-attrib-name)
-                                                pin-attrib-value)))
-                   (if pin
-                       (assq-ref (package-pin-attribs pin)
-                                 (string->symbol name))
-                       (and func (func (schematic-component-pins (car netlist))
-                                       name
-                                       pin-attrib-value)))))
+        (or (let ((pin (find-pin-by-attrib (schematic-component-pins (car netlist))
+                                           (string->symbol pin-attrib-name)
+                                           pin-attrib-value)))
+              (if pin
+                  (assq-ref (package-pin-attribs pin)
+                            (string->symbol name))
+                  (and func (func (schematic-component-pins (car netlist))
+                                  name
+                                  pin-attrib-value))))
             (loop (cdr netlist))))))
 
 
@@ -738,16 +716,6 @@ other limitations imposed by this netlist format.
 ;; the given attribute of all the graphical objects connected to that
 ;; net name
 (define (gnetlist:graphical-objs-in-net-with-attrib-get-attrib netname in-attrib out-attrib-name)
-  (define (has-netname? pin)
-    (let ((name (package-pin-name pin)))
-      (and name
-           (string=? name netname))))
-
-  (define (have-netname? pins)
-    (and (not (null? pins))
-         (or (has-netname? (car pins))
-             (have-netname? (cdr pins)))))
-
   (define (parse-attrib-string s)
     (let ((position (string-index s #\=)))
       (and position
@@ -769,11 +737,10 @@ other limitations imposed by this netlist format.
     (and netname
         (append-map
          (lambda (package)
-           (if (and (have-netname? (schematic-component-pins package))
-                    (have-attrib? (schematic-component-attribs package) in-attrib))
+           (if (have-attrib? (schematic-component-attribs package) in-attrib)
                (assq-ref (schematic-component-attribs package) out-attrib)
                '()))
-         (schematic-graphicals (toplevel-schematic))))))
+         (schematic-netname-graphicals (toplevel-schematic) netname)))))
 
 (define (netlist-output-filename)
   ;; Name is file name or "-" which means stdout.
@@ -793,14 +760,20 @@ General options:
   -v, --verbose           Verbose mode.
   -o, --output=FILE       Filename for netlist data output.
   -L, --load-path=DIR     Add DIR to Scheme search path.
-  -g, --backend=BACKEND   Specify netlist backend to use.
+  -g, --backend=BACKEND[:FILE]
+                          Specify netlist backend to use, and
+                          optionally its output file.  May be given
+                          several times to run several backends.
   -f, --file-backend=FILE Specify path to netlist backend file to use.
-  -O, --backend-option=STRING
-                          Pass an option string to backend.
+  -O, --backend-option=[BACKEND:]STRING
+                          Pass an option string to all backends, or
+                          only to BACKEND.
   -l, --pre-load=FILE     Load Scheme file before loading backend.
   -m, --post-load=FILE    Load Scheme file after loading backend.
   -c, --eval-code=EXPR    Evaluate Scheme expression at startup.
   -i, --interactive       Enter interactive Scheme REPL after loading.
+  -j, --jobs=N            Use N threads for reading schematic files.
+  --watch                 Create the netlist again when input files change.
   -b, --list-backends     Print a list of available netlist backends.
   -h, --help              Help; this message.
   -V, --version           Show version information.
@@ -827,16 +800,23 @@ Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
   (primitive-exit 0))
 
 
-;;; Set lepton-netlist toplevel schematic based on schematic FILES
-;;; and current netlist mode specified somewhere else.  Currently,
-;;; the netlist mode can be either "'geda", or "'spice".
-(define (set-ln-toplevel-schematic! files)
+;;; Prepare creating lepton-netlist toplevel schematic for
+;;; schematic FILES and current netlist mode specified somewhere
+;;; else.  Currently, the netlist mode can be either "'geda", or
+;;; "'spice".
+(define (prepare-ln-toplevel-schematic! files)
   (define (process-gafrc* name)
     (process-gafrc "lepton-netlist" name))
 
   (and (eq? (netlist-mode) 'spice)
        (set! get-uref get-spice-refdes))
-  (for-each process-gafrc* files)
+  (for-each process-gafrc* files))
+
+
+;;; Set lepton-netlist toplevel schematic based on schematic FILES
+;;; and current netlist mode.
+(define (set-ln-toplevel-schematic! files)
+  (prepare-ln-toplevel-schematic! files)
   (catch 'system-error
     (lambda () (set-toplevel-schematic! (make-toplevel-schematic files)))
     (lambda (key subr message args rest)
@@ -869,9 +849,11 @@ Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
 ( define ( main )
   (define output-filename   (netlist-output-filename))
   (define files             (netlist-option-ref '()))            ; schematics
-  (define opt-backend       (netlist-option-ref 'backend))       ; -g
+  (define opt-backends      (netlist-option-ref 'backend))       ; -g
   (define opt-file-backend  (netlist-option-ref 'file-backend))  ; -f
   (define opt-interactive   (netlist-option-ref 'interactive))   ; -i
+  (define opt-jobs          (netlist-option-ref 'jobs))          ; --jobs (-j)
+  (define opt-watch         (netlist-option-ref 'watch))         ; --watch
   (define opt-verbose       (netlist-option-ref 'verbose))       ; --verbose (-v)
   (define opt-code-to-eval  (netlist-option-ref 'eval-code))     ; -c
   (define opt-help          (netlist-option-ref 'help))          ; --help (-h)
@@ -880,6 +862,23 @@ Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
   (define opt-pre-load      (netlist-option-ref 'pre-load))      ; -l
   (define opt-post-load     (netlist-option-ref 'post-load))     ; -m
 
+  ;; Backends to run, as pairs (NAME . OUTPUT-FILENAME).  '-f'
+  ;; has priority over '-g'.  Backends given as "-g NAME" output
+  ;; to the file specified by '-o', and backends given as
+  ;; "-g NAME:FILE" to FILE.  "-" means standard output, which is
+  ;; denoted by #f.
+  (define backend-specs
+    (if opt-file-backend
+        (list (cons #f output-filename))
+        (map (lambda (spec)
+               (let ((name+file (parse-backend-spec spec)))
+                 (cons (car name+file)
+                       (match (cdr name+file)
+                         (#f output-filename)
+                         ("-" #f)
+                         (filename filename)))))
+             opt-backends)))
+
   ; local functions:
 
   ( define ( error-no-backend )
@@ -892,6 +891,31 @@ Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
                      (car (program-arguments)))
   )
 
+  ( define ( error-jobs )
+    (netlist-error 1 (G_ "Invalid number of jobs: ~S.\n~
+                         It must be a positive integer.\n")
+                     opt-jobs)
+  )
+
+  ( define ( error-watch-interactive )
+    (netlist-error 1 (G_ "The options --watch and --interactive cannot be used together.\n"))
+  )
+
+  ( define ( error-same-output filename )
+    (netlist-error 1 (G_ "Several backends cannot output to the same file ~S.\n~
+                         Use `-g BACKEND:FILE' to specify their output files.\n")
+                     filename)
+  )
+
+  ;; Returns the first output file name used by several backends,
+  ;; or #f if there is no such file.
+  (define (same-output-filename)
+    (let loop ((filenames (filter-map cdr backend-specs)))
+      (and (not (null? filenames))
+           (if (member (car filenames) (cdr filenames))
+               (car filenames)
+               (loop (cdr filenames))))))
+
   ; Parse configuration:
   ;
   (parse-rc "lepton-netlist" "gnetlistrc")
@@ -907,42 +931,105 @@ Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
    (opt-help (usage))
    (opt-version (version))
    (opt-list-backends (display-backend-list))
+   ;; Check the number of jobs (-j).
+   ((not (netlist-jobs)) (error-jobs))
+   ;; Check watch mode (--watch).
+   ((and opt-watch opt-interactive) (error-watch-interactive))
    ;; Check input schematics.
    ((and (null? files)
          (not opt-interactive))
     (error-no-sch))
    ;; Neither backend (-g or -f), nor interactive mode (-i)
    ;; specified.
-   ((not (or opt-backend opt-file-backend opt-interactive))
-    (error-no-backend)))
-
-  ;; Make and load backend.
-  (let ((backend (cond
-                  ;; '-f' has priority over '-g'.
-                  (opt-file-backend (make-legacy-backend #:path opt-file-backend
-                                                         #:pre-load opt-pre-load
-                                                         #:post-load opt-post-load))
-                  ;; Load module backend first if it is available.
-                  (opt-backend (or (make-module-backend #:name opt-backend
-                                                        #:pre-load opt-pre-load
-                                                        #:post-load opt-post-load)
-                                   ;; Fallback to legacy backend.
-                                   (make-legacy-backend #:name opt-backend
-                                                        #:pre-load opt-pre-load
-                                                        #:post-load opt-post-load)))
-                  (else #f))))
-
-    ;; This sets [toplevel-schematic] global variable.
-    (set-ln-toplevel-schematic! files)
-
-    ;; Verbose mode (-v).
-    (when opt-verbose
-      ;; Print configuration.
-      (print-netlist-config)
-      ;; Print internal netlist representation.
-      (verbose-print-netlist (schematic-components (toplevel-schematic))))
-
-    ;; Do actual work.
-    (if opt-interactive
-        (lepton-repl)
-        (run-backend backend output-filename))))
+   ((and (null? backend-specs)
+         (not opt-interactive))
+    (error-no-backend))
+   ;; Check output files of several backends (-g).
+   ((same-output-filename) => error-same-output))
+
+  (let ((mode (netlist-mode)))
+
+    ;; Make and load the backend NAME.  Returns a list of the
+    ;; backend, its name, and the netlist mode it requests.  When
+    ;; several backends are given, each one is loaded into its own
+    ;; module.
+    (define (load-backend name)
+      (define (make-backend)
+        (if opt-file-backend
+            (make-legacy-backend #:path opt-file-backend
+                                 #:pre-load opt-pre-load
+                                 #:post-load opt-post-load)
+            ;; Load module backend first if it is available.
+            (or (make-module-backend #:name name
+                                     #:pre-load opt-pre-load
+                                     #:post-load opt-post-load)
+                ;; Fallback to legacy backend.
+                (make-legacy-backend #:name name
+                                     #:pre-load opt-pre-load
+                                     #:post-load opt-post-load))))
+
+      (set-netlist-mode! mode)
+      (parameterize ((%backend-name name))
+        (let ((backend (if (null? (cdr backend-specs))
+                           (make-backend)
+                           (save-module-excursion
+                            (lambda ()
+                              (set-current-module (make-backend-module))
+                              (make-backend))))))
+          (list backend name (netlist-mode)))))
+
+    (parameterize ((%backend-names (filter-map car backend-specs)))
+      (let ((backends (map (lambda (spec)
+                             (append (load-backend (car spec))
+                                     (list (cdr spec))))
+                           backend-specs)))
+
+        (define (verbose-print!)
+          ;; Verbose mode (-v).
+          (when opt-verbose
+            ;; Print configuration.
+            (print-netlist-config)
+            ;; Print internal netlist representation.
+            (verbose-print-netlist (schematic-components (toplevel-schematic)))))
+
+        ;; Runs BACKENDS in turn.  The toplevel schematic is
+        ;; created by MAKE-SCHEMATIC! only once for each netlist
+        ;; mode requested by the backends, and is shared by them.
+        (define (run-backends! make-schematic!)
+          (let loop ((backends backends)
+                     (schematics '()))
+            (match backends
+              (() #t)
+              (((backend name mode output) . rest)
+               (set-netlist-mode! mode)
+               (let ((schematic (assq-ref schematics mode)))
+                 (if schematic
+                     (set-toplevel-schematic! schematic)
+                     (begin
+                       (make-schematic!)
+                       (verbose-print!)))
+                 (parameterize ((%backend-name name))
+                   (run-backend backend output))
+                 (loop rest
+                       (if schematic
+                           schematics
+                           (acons mode (toplevel-schematic) schematics))))))))
+
+        (cond
+         ;; Watch mode (--watch): create the netlist again each
+         ;; time input files change.
+         (opt-watch
+          (prepare-ln-toplevel-schematic! files)
+          (watch-netlist files
+                         (lambda ()
+                           (run-backends!
+                            (lambda ()
+                              (set-toplevel-schematic!
+                               (make-toplevel-schematic files)))))))
+         (opt-interactive
+          ;; This sets [toplevel-schematic] global variable.
+          (set-ln-toplevel-schematic! files)
+          (verbose-print!)
+          (lepton-repl))
+         (else
+          (run-backends! (lambda () (set-ln-toplevel-schematic! files)))))))))
@@ -33,8 +33,11 @@
   #:export (lookup-legacy-backends
             lookup-module-backends
             run-backend
+            make-backend-module
             make-legacy-backend
-            make-module-backend))
+            make-module-backend
+            parse-backend-spec
+            backend-arguments))
 
 (define-record-type <backend>
   (backend path name runner legacy)
@@ -264,6 +267,44 @@ redirection is carried out."
       (thunk)))
 
 
+;;; Splits the argument SPEC of the option '-g', which has the
+;;; form "NAME" or "NAME:FILE", into a pair (NAME . FILE).  FILE
+;;; is #f if it is not given.
+(define (parse-backend-spec spec)
+  (let ((index (string-index spec #\:)))
+    (if index
+        (cons (string-take spec index)
+              (string-drop spec (1+ index)))
+        (cons spec #f))))
+
+
+(define (backend-arguments options name names)
+  "Returns the strings of the list OPTIONS, given with the option
+'-O', which apply to the backend NAME.  Options of the form
+\"BACKEND:OPTION\", where BACKEND is one of the backends NAMES,
+only apply to that backend, and are returned without the prefix.
+Other options apply to all backends."
+  (filter-map
+   (lambda (option)
+     (let* ((index (string-index option #\:))
+            (prefix (and index (string-take option index))))
+       (if (and prefix (member prefix names))
+           (and (equal? prefix name)
+                (string-drop option (1+ index)))
+           option)))
+   options))
+
+
+(define (make-backend-module)
+  "Returns a new module for loading a legacy backend in.  The
+module sees the bindings of the current module, while the
+definitions of the backend stay in it, so that several backends
+loaded at once don't override each other's procedures."
+  (let ((module (make-module)))
+    (module-use! module (current-module))
+    module))
+
+
 (define (lookup-module-backends)
   (define (build-filename path filename)
     (string-append path file-name-separator-string filename))
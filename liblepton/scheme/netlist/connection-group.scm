@@ -0,0 +1,135 @@
+;;; Lepton EDA netlister
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Grouping of connected items using a disjoint-set forest.
+
+(define-module (netlist connection-group)
+  #:use-module (srfi srfi-1)
+
+  #:export (group-linked))
+
+
+(define* (group-linked items
+                       #:key
+                       (elements list)
+                       (probe-keys list)
+                       (link-keys list)
+                       (table-ref hash-ref)
+                       (table-set! hash-set!))
+  "Group ITEMS connected to each other.  Returns a list of groups,
+each group being the list of the elements of its items.
+
+ELEMENTS is a procedure returning the list of elements of an
+item.  An item is connected to the items processed before it if
+any of the keys returned for it by PROBE-KEYS is amongst the keys
+returned for them by LINK-KEYS.  Keys are compared using the
+hash table procedures TABLE-REF and TABLE-SET!, that is, using
+equal? by default.
+
+The result is the same as the one of folding the items over the
+list of groups, where each item takes the groups it is connected
+to out of the list, and the new group made of the elements of the
+item followed by the elements of these groups is appended to the
+list.  However, the time taken is about linear in the number of
+items and keys instead of being quadratic."
+
+  (define count (length items))
+  ;; Disjoint-set forest of the items indexed by their order.
+  ;; The root of each tree is the last item merged into the
+  ;; group, so the order of roots is the order of the groups in
+  ;; the folded list.
+  (define parents (make-vector count #f))
+  ;; Elements of each item.
+  (define item-elements (make-vector count '()))
+  ;; Roots of the groups merged by each item, in the order of
+  ;; groups.
+  (define children (make-vector count '()))
+  ;; Link key -> indices of the items having it.
+  (define key-items (make-hash-table))
+
+  (define (find index)
+    (let ((root (let loop ((index index))
+                  (let ((parent (vector-ref parents index)))
+                    (if (= parent index)
+                        index
+                        (loop parent))))))
+      ;; Path compression.
+      (let loop ((index index))
+        (unless (= index root)
+          (let ((parent (vector-ref parents index)))
+            (vector-set! parents index root)
+            (loop parent))))
+      root))
+
+  (define (connected-roots index item)
+    (let loop ((keys (probe-keys item))
+               (roots '()))
+      (if (null? keys)
+          roots
+          (let* ((key (car keys))
+                 (linked (or (table-ref key-items key) '())))
+            (unless (null? linked)
+              ;; All the items having the key are now in the
+              ;; group of this item, which is enough to find it.
+              (table-set! key-items key (list index)))
+            (loop (cdr keys)
+                  (fold (lambda (other roots)
+                          (let ((root (find other)))
+                            (if (or (= root index) (memv root roots))
+                                roots
+                                (cons root roots))))
+                        roots
+                        linked))))))
+
+  (define (add-item! index item)
+    (vector-set! parents index index)
+    (vector-set! item-elements index (elements item))
+    (let ((roots (sort (connected-roots index item) <)))
+      (for-each (lambda (root) (vector-set! parents root index)) roots)
+      (vector-set! children index roots))
+    (for-each (lambda (key)
+                (table-set! key-items
+                            key
+                            (cons index (or (table-ref key-items key) '()))))
+              (link-keys item)))
+
+  ;; Lists the elements of the group of ROOT: the elements of
+  ;; the root item followed by the ones of the groups it merged.
+  (define (group-elements root)
+    (let loop ((stack (list root))
+               (result '()))
+      (if (null? stack)
+          (reverse result)
+          (let ((index (car stack)))
+            (loop (append (vector-ref children index) (cdr stack))
+                  (append-reverse (vector-ref item-elements index)
+                                  result))))))
+
+  (let loop ((ls items)
+             (index 0))
+    (unless (null? ls)
+      (add-item! index (car ls))
+      (loop (cdr ls) (1+ index))))
+
+  (let loop ((index (1- count))
+             (groups '()))
+    (if (< index 0)
+        groups
+        (loop (1- index)
+              (if (= index (vector-ref parents index))
+                  (cons (group-elements index) groups)
+                  groups)))))
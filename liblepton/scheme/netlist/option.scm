@@ -33,7 +33,7 @@
   '((quiet . #f)
     (verbose . #f)
     (load-path . ())
-    (backend . #f)
+    (backend . ())
     (file-backend . #f)
     (backend-option . ())
     (list-backends . #f)
@@ -42,6 +42,8 @@
     (post-load . ())
     (eval-code . ())
     (interactive . #f)
+    (jobs . #f)
+    (watch . #f)
     (help . #f)
     (version . #f)))
 
@@ -0,0 +1,96 @@
+;;; Lepton EDA netlister
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Loading of schematic pages using several threads.
+
+(define-module (netlist page-load)
+  #:use-module (ice-9 rdelim)
+  #:use-module (ice-9 threads)
+  #:use-module (srfi srfi-1)
+
+  #:use-module (lepton os)
+  #:use-module (lepton page)
+  #:use-module (netlist option)
+
+  #:export (netlist-jobs
+            file-name-list->pages))
+
+
+(define (netlist-jobs)
+  "Returns the number of threads the netlister may use for loading
+files as set by the option \"--jobs\", or #f if the value of the
+option is not a positive integer."
+  (let ((jobs (netlist-option-ref 'jobs)))
+    (if jobs
+        (let ((n (string->number jobs)))
+          (and (exact-integer? n)
+               (positive? n)
+               n))
+        1)))
+
+
+;;; Returns the contents of the file FILENAME as a string.  If
+;;; the file cannot be read, returns the list of the key and
+;;; arguments of the error raised, so that it could be re-raised
+;;; in the main thread.
+(define (read-file-contents filename)
+  (catch #t
+    (lambda () (call-with-input-file filename read-string))
+    (lambda args args)))
+
+
+(define* (file-name-list->pages filenames #:key new-page?)
+  "Returns the list of pages for FILENAMES.  If NEW-PAGE? is #f,
+already opened pages are reused, otherwise new pages are always
+created, as for file->page().
+
+The contents of the files are read concurrently by up to the
+number of threads returned by netlist-jobs().  The pages are
+created from them one by one in the current thread, in the order
+of FILENAMES, since parsing files and looking up symbols in the
+component library are not thread-safe.  Errors raised while
+reading a file are re-raised when its page is being created."
+  (define (opened-page filename)
+    (and (not new-page?)
+         (find (lambda (page) (string= filename (page-filename page)))
+               (active-pages))))
+
+  ;; Opened pages are looked up in the current thread, only the
+  ;; files are read concurrently.
+  (let* ((filenames (map expand-env-variables filenames))
+         (jobs (or (netlist-jobs) 1))
+         (unopened (delete-duplicates (remove opened-page filenames)
+                                      string=))
+         (contents (if (and (> jobs 1)
+                            (not (null? unopened))
+                            (not (null? (cdr unopened))))
+                       (n-par-map jobs read-file-contents unopened)
+                       (map read-file-contents unopened)))
+         (file-contents (map cons unopened contents)))
+    (map-in-order
+     (lambda (filename)
+       (cond
+        ((opened-page filename))
+        ((assoc-ref file-contents filename)
+         => (lambda (contents)
+              (if (string? contents)
+                  (string->page filename contents)
+                  (apply throw contents))))
+        ;; The page was opened when the opened pages were looked
+        ;; up but has been closed since then.
+        (else (file->page filename new-page?))))
+     filenames)))
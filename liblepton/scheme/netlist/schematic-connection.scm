@@ -1,5 +1,5 @@
 ;;; Lepton EDA netlister
-;;; Copyright (C) 2017-2021 Lepton EDA Contributors
+;;; Copyright (C) 2017-2022 Lepton EDA Contributors
 ;;;
 ;;; This program is free software; you can redistribute it and/or modify
 ;;; it under the terms of the GNU General Public License as published by
@@ -17,15 +17,15 @@
 
 (define-module (netlist schematic-connection)
   #:use-module (ice-9 match)
-  #:use-module (ice-9 receive)
+  #:use-module (rnrs bytevectors)
   #:use-module (srfi srfi-1)
   #:use-module (srfi srfi-9)
   #:use-module (srfi srfi-9 gnu)
   #:use-module (srfi srfi-11)
   #:use-module (srfi srfi-26)
-  #:use-module (lepton attrib)
   #:use-module (lepton object)
   #:use-module (lepton page)
+  #:use-module (netlist connection-group)
   #:use-module (netlist package-pin)
 
   #:export-syntax (make-schematic-connection schematic-connection?
@@ -38,6 +38,7 @@
                    schematic-connection-pins set-schematic-connection-pins!)
 
   #:export (make-page-schematic-connections
+            page-connection-groups
             schematic-connection-add-pin!
             set-schematic-connection-printer!))
 
@@ -101,48 +102,6 @@ Example usage:
                  (_ #\?)))
              args)))))
 
-;;; This is a helper object property to get object connections
-;;; once.
-(define object-conns (make-object-property))
-
-(define (connected-to? object1 object2)
-  (not (not (memv object1 (object-conns object2)))))
-
-(define (connected-to-ls? object1 ls)
-  (and (not (null? ls))
-       (or (connected-to? object1 (car ls))
-           (connected-to-ls? object1 (cdr ls)))))
-
-(define (reconnect-groups object groups)
-  (define (object-connected-to? group)
-    (connected-to-ls? object group))
-
-  (receive (connected unconnected)
-      (partition object-connected-to? groups)
-    (let ((result
-           `(,@unconnected
-             ,(if (null? connected)
-                  (list object)
-                  (apply append (list object) connected)))))
-      result)))
-
-;;; Transforms list of objects LS into the list of lists of
-;;; interconnected objects.
-(define (group-connections ls)
-  (fold reconnect-groups '() ls))
-
-
-(define (schematic-connection->netnames schematic-connection)
-  (filter-map (lambda (attrib)
-                (and (string=? (attrib-name attrib) "netname")
-                     (attrib-value attrib)))
-              (append-map object-attribs schematic-connection)))
-
-(define (connections->netname-groups connections)
-  (map (lambda (schematic-connection)
-         (cons (schematic-connection->netnames schematic-connection) schematic-connection))
-       connections))
-
 (define (get-schematic-connection-netname netnames)
   (match netnames
     ((c) c)
@@ -165,49 +124,50 @@ Example usage:
                                objects
                                '())))
 
-;;; Return the list of COMPONENT pins.
-(define (component-pins component)
-  (let loop ((ls (component-contents component))
-             (pins '()))
-    (if (null? ls)
-        pins
-        (let ((object (car ls))
-              (rest (cdr ls)))
-          (loop rest
-                (if (net-pin? object)
-                    (cons object pins)
-                    pins))))))
-
-(define (make-page-schematic-connections page)
-  "Create <schematic-connection> records from PAGE primitives."
-
-  (define (page-connectable-objects page)
-    (let loop ((ls (page-contents page))
-               (nets '())
-               (components '()))
-      (if (null? ls)
-          (values nets
-                  ;; pins
-                  (append-map component-pins components))
-          (let ((object (car ls)))
-            (loop (cdr ls)
-                  (if (net? object)
-                      (cons object nets)
-                      nets)
-                  (if (component? object)
-                      (cons object components)
-                      components))))))
-
-  (define (populate-object-connections object)
-    (set! (object-conns object)
-          (object-connections object)))
-
-  (let-values (((nets pins) (page-connectable-objects page)))
-    (for-each populate-object-connections nets)
-    (for-each populate-object-connections pins)
-    (map (cut get-schematic-connection page <>)
-         (connections->netname-groups
-          (group-connections (append nets pins))))))
+;;; Returns the list of indices from START to END excluded in
+;;; reverse order.
+(define (reverse-range start end)
+  (iota (- end start) (1- end) -1))
+
+
+(define (page-connection-groups page)
+  "Returns the list of groups of interconnected net and pin objects
+of PAGE.  Each group is a pair of the list of its netnames and the
+list of its objects.
+
+The connectivity of the page is obtained at once using
+page-connectivity().  Nets are processed in the reverse order of
+page contents, followed by pins in the reverse order of components
+and of their contents.  An object joins the groups of the objects
+processed before it if it is amongst their connections."
+  (let-values (((objects n-nets offsets targets netnames)
+                (page-connectivity page)))
+    (define (connected-indices index)
+      (let loop ((i (1- (bytevector-s32-native-ref offsets (* 4 (1+ index)))))
+                 (result '()))
+        (if (< i (bytevector-s32-native-ref offsets (* 4 index)))
+            result
+            (loop (1- i)
+                  (cons (bytevector-s32-native-ref targets (* 4 i))
+                        result)))))
+
+    (map (lambda (group)
+           (cons (append-map (cut vector-ref netnames <>) group)
+                 (map (cut vector-ref objects <>) group)))
+         (group-linked (append (reverse-range 0 n-nets)
+                               (reverse-range n-nets (vector-length objects)))
+                       #:link-keys connected-indices
+                       #:table-ref hashv-ref
+                       #:table-set! hashv-set!))))
+
+
+(define* (make-page-schematic-connections page
+                                          #:optional
+                                          (groups (page-connection-groups page)))
+  "Create <schematic-connection> records from PAGE primitives.  If
+GROUPS is specified, it is used as the result of
+page-connection-groups() for PAGE instead of computing it."
+  (map (cut get-schematic-connection page <>) groups))
 
 
 (define (schematic-connection-add-pin! connection pin)
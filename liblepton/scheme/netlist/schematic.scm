@@ -1,6 +1,6 @@
 ;;; Lepton EDA netlister
 ;;; Copyright (C) 2016-2017 gEDA Contributors
-;;; Copyright (C) 2017-2020 Lepton EDA Contributors
+;;; Copyright (C) 2017-2022 Lepton EDA Contributors
 ;;;
 ;;; This program is free software; you can redistribute it and/or modify
 ;;; it under the terms of the GNU General Public License as published by
@@ -33,6 +33,7 @@
   #:use-module (netlist duplicate)
   #:use-module (netlist hierarchy)
   #:use-module (netlist package)
+  #:use-module (netlist page-load)
   #:use-module (netlist schematic-component)
   #:use-module (netlist schematic-connection)
   #:use-module (netlist schematic-port)
@@ -62,7 +63,11 @@
             schematic-ports
             schematic-tree
             schematic-name-tree
-            schematic-components*))
+            schematic-components*
+            schematic-refdes-components
+            schematic-netname-pins
+            schematic-refdes-pinnumber-pins
+            schematic-netname-graphicals))
 
 (define-record-type <schematic>
   (make-schematic id
@@ -75,7 +80,11 @@
                   non-unique-nets
                   nets
                   nc-nets
-                  connections)
+                  connections
+                  refdes-index
+                  netname-index
+                  pin-index
+                  graphical-index)
   schematic?
   (id schematic-id set-schematic-id!)
   (subschematic schematic-subschematic set-schematic-subschematic!)
@@ -87,7 +96,11 @@
   (non-unique-nets schematic-non-unique-nets set-schematic-non-unique-nets!)
   (nets schematic-nets set-schematic-nets!)
   (nc-nets schematic-nc-nets set-schematic-nc-nets!)
-  (connections schematic-connections set-schematic-connections!))
+  (connections schematic-connections set-schematic-connections!)
+  (refdes-index schematic-refdes-index)
+  (netname-index schematic-netname-index)
+  (pin-index schematic-pin-index)
+  (graphical-index schematic-graphical-index))
 
 (set-record-type-printer!
  <schematic>
@@ -257,6 +270,47 @@
   (any wanted-package-pin-netname=? packages))
 
 
+(define (make-index items item-keys)
+  "Returns a hash table mapping each key returned by ITEM-KEYS for
+the items of the list ITEMS to the list of items having it.  The
+items are listed in the order of ITEMS."
+  (let ((index (make-hash-table)))
+    (for-each
+     (lambda (item)
+       (for-each (lambda (key)
+                   (hash-set! index key (cons item (hash-ref index key '()))))
+                 (item-keys item)))
+     (reverse items))
+    index))
+
+
+;;; Returns the list of the string refdes of COMPONENT, or the
+;;; empty list if it has no refdes.
+(define (component-refdes-keys component)
+  (let ((refdes (schematic-component-refdes component)))
+    (if (string? refdes) (list refdes) '())))
+
+;;; Returns the list of the netname of PIN, or the empty list if
+;;; it is not set.
+(define (pin-netname-keys pin)
+  (let ((netname (package-pin-name pin)))
+    (if (string? netname) (list netname) '())))
+
+;;; Returns the list of the (refdes . pinnumber) pair of PIN, or
+;;; the empty list if any of them is not set.
+(define (pin-refdes-pinnumber-keys pin)
+  (let ((refdes (schematic-component-refdes (package-pin-parent pin)))
+        (pinnumber (package-pin-number pin)))
+    (if (and (string? refdes) pinnumber)
+        (list (cons refdes pinnumber))
+        '())))
+
+;;; Returns the list of unique netnames of the pins of COMPONENT.
+(define (component-netname-keys component)
+  (delete-duplicates
+   (append-map pin-netname-keys (schematic-component-pins component))))
+
+
 (define (collect-components-recursively subschematic)
   (let* ((components (subschematic-components subschematic))
          (subschematics (filter-map schematic-component-subschematic components)))
@@ -282,12 +336,13 @@ of schematic pages."
          (packages (make-package-list netlist))
          (graphicals (filter schematic-component-graphical? full-netlist))
          (nu-nets (get-all-nets netlist))
-         (unique-nets (get-nets netlist)))
+         (unique-nets (get-nets netlist))
+         (nc-packages (filter schematic-component-nc? full-netlist))
+         (pins (append-map schematic-component-pins netlist)))
     ;; Partition all unique net names into 'no-connection' nets
     ;; and plain nets.
     (receive (nc-nets nets)
-        (partition (lambda (x)
-                     (nc-net? x (filter schematic-component-nc? full-netlist)))
+        (partition (cut nc-net? <> nc-packages)
                    unique-nets)
       (make-schematic id
                       subschematic
@@ -300,13 +355,16 @@ of schematic pages."
                       nets
                       nc-nets
                       connections
-                      ))))
+                      (make-index netlist component-refdes-keys)
+                      (make-index pins pin-netname-keys)
+                      (make-index pins pin-refdes-pinnumber-keys)
+                      (make-index graphicals component-netname-keys)))))
 
 
 (define (file-name-list->schematic filenames)
   "Creates a new schematic record from FILENAMES, which must be a
 list of strings representing file names."
-  (let ((pages (map file->page filenames)))
+  (let ((pages (file-name-list->pages filenames)))
     (page-list->schematic pages)))
 
 
@@ -337,3 +395,25 @@ list of strings representing file names."
   "Returns a list of all component pins in SCHEMATIC."
   (append-map schematic-component-pins
               (schematic-components schematic)))
+
+
+(define (schematic-refdes-components schematic refdes)
+  "Returns the list of the non-graphical components of SCHEMATIC
+having REFDES, in the order of the component list."
+  (hash-ref (schematic-refdes-index schematic) refdes '()))
+
+(define (schematic-netname-pins schematic netname)
+  "Returns the list of the pins of the non-graphical components of
+SCHEMATIC connected to the net NETNAME."
+  (hash-ref (schematic-netname-index schematic) netname '()))
+
+(define (schematic-refdes-pinnumber-pins schematic refdes pinnumber)
+  "Returns the list of the pins having PINNUMBER of the
+non-graphical components of SCHEMATIC having REFDES."
+  (hash-ref (schematic-pin-index schematic) (cons refdes pinnumber) '()))
+
+(define (schematic-netname-graphicals schematic netname)
+  "Returns the list of the graphical components of SCHEMATIC
+having pins connected to the net NETNAME, in the order of the list
+of graphical components."
+  (hash-ref (schematic-graphical-index schematic) netname '()))
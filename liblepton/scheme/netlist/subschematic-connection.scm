@@ -16,9 +16,9 @@
 ;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 
 (define-module (netlist subschematic-connection)
-  #:use-module (ice-9 receive)
   #:use-module (srfi srfi-1)
   #:use-module (srfi srfi-26)
+  #:use-module (netlist connection-group)
   #:use-module (netlist package-pin)
   #:use-module (netlist schematic-component)
   #:use-module (netlist schematic-connection)
@@ -33,38 +33,11 @@
                            (any->ls (schematic-connection-override-name conn)))))
 
 
-(define (connected-netname? conn1 conn2)
-  (define (is-member? x)
-    (not (not (member x (connection-netnames conn1)))))
-  (any is-member? (connection-netnames conn2)))
-
-
-(define (connected? c ls)
-  (any (lambda (x) (connected-netname? c x)) ls))
-
-
-(define (connected-lists? ls1 ls2)
-  (and (not (null? ls1))
-       (or (connected? (car ls1) ls2)
-           (connected-lists? (cdr ls1) ls2))))
-
-
-(define (reconnect-connections ls groups)
-  (define (is-ls-connected-to? group)
-    (connected-lists? ls group))
-
-  (receive (connected unconnected)
-      (partition is-ls-connected-to? groups)
-    (let ((result
-           `(,@unconnected
-             ,(if (null? connected)
-                  ls
-                  (apply append ls connected)))))
-      result)))
-
-
+;;; Groups connections having common net names.
 (define (group-connections ls)
-  (fold reconnect-connections '() (map list ls)))
+  (group-linked ls
+                #:probe-keys connection-netnames
+                #:link-keys connection-netnames))
 
 
 (define (make-netname-connection group)
@@ -19,7 +19,6 @@
 ;;; in the "source=" attributes of a component.
 
 (define-module (netlist subschematic)
-  #:use-module (ice-9 receive)
   #:use-module (srfi srfi-1)
   #:use-module (srfi srfi-9)
   #:use-module (srfi srfi-9 gnu)
@@ -33,8 +32,10 @@
   #:use-module (netlist attrib refdes)
   #:use-module (netlist attrib compare)
   #:use-module (netlist config)
+  #:use-module (netlist connection-group)
   #:use-module (netlist option)
   #:use-module (netlist package-pin)
+  #:use-module (netlist page-load)
   #:use-module (netlist schematic-component)
   #:use-module (netlist schematic-connection)
   #:use-module (netlist schematic-port)
@@ -50,6 +51,9 @@
                    subschematic-connections set-subschematic-connections!)
 
   #:export (page-list->hierarchical-subschematic
+            make-hierarchy-cache
+            call-with-hierarchy-cache
+            hierarchy-cache-forget-pages!
             schematic-component-ports
             make-hierarchical-connections
             make-hierarchical-connection-name))
@@ -133,9 +137,41 @@
   (for-each set-connection-properties! (schematic-component-pins component)))
 
 
+;;; Subcircuit pages loaded while creating the current
+;;; hierarchical subschematic, by file name.  Each subcircuit file
+;;; is loaded once and its page is shared by all the components
+;;; using it as a source, since the netlister does not modify
+;;; pages.
+(define %subcircuit-pages (make-parameter #f))
+
+;;; Full file names of subcircuits found in the source library
+;;; while creating the current hierarchical subschematic, by
+;;; basename.
+(define %subcircuit-file-names (make-parameter #f))
+
+;;; Connection groups of the pages used in the current
+;;; hierarchical subschematic.
+(define %page-connection-groups (make-parameter #f))
+
+
+;;; Returns the connection groups of PAGE, computing them only
+;;; once for each page used in the current hierarchical
+;;; subschematic.
+(define (cached-page-connection-groups page)
+  (let ((cache (%page-connection-groups)))
+    (if cache
+        (or (hashq-ref cache page)
+            (let ((groups (page-connection-groups page)))
+              (hashq-set! cache page groups)
+              groups))
+        (page-connection-groups page))))
+
+
 (define (page->subschematic page)
   "Creates a new subschematic record from PAGE."
-  (let* ((connections (make-page-schematic-connections page))
+  (let* ((connections (make-page-schematic-connections
+                       page
+                       (cached-page-connection-groups page)))
          (components (map component->schematic-component
                           (filter component? (page-contents page))))
          (subschematic
@@ -190,13 +226,41 @@
     (netlist-config-ref 'mangle-refdes))))
 
 
+(define (make-instance-id id hierarchy-tag)
+  (and id (cons id hierarchy-tag)))
+
+
+;;; Subcircuit pages are shared by all the instances of a
+;;; subcircuit, so the ids of their objects are not unique in the
+;;; hierarchy.  The ids of the COMPONENTS of an instance, of their
+;;; pins, and of its page CONNECTIONS are made unique by appending
+;;; HIERARCHY-TAG to them, the same way hierarchical refdeses are
+;;; formed.  All the state of an instance is thus kept in its
+;;; records, and nothing is stored in the shared objects.
+(define (set-instance-ids! components connections hierarchy-tag)
+  (define (update-id! get-id set-id! record)
+    (set-id! record (make-instance-id (get-id record) hierarchy-tag)))
+
+  (for-each (cut update-id! schematic-component-id set-schematic-component-id! <>)
+            components)
+  (for-each (cut update-id! package-pin-id set-package-pin-id! <>)
+            (append-map schematic-component-pins components))
+  (for-each (cut update-id! schematic-connection-id set-schematic-connection-id! <>)
+            connections))
+
+
 (define* (page-list->subschematic pages #:optional name)
   "Creates a new subschematic from the PAGES list.  If specified,
-NAME is used as its hierarchical name."
+NAME is used as its hierarchical name, and as the hierarchy tag
+of the ids of its components, pins, and connections."
   (let* ((subschematics (map page->subschematic pages))
          (components (append-map subschematic-components subschematics))
          (connections (make-subschematic-connections components))
          (subschematic (make-subschematic name #f pages components connections)))
+    (when (pair? name)
+      (set-instance-ids! components
+                         (append-map subschematic-connections subschematics)
+                         name))
     (for-each (cut set-schematic-connection-parent! <> subschematic)
               connections)
     (for-each (cut set-schematic-component-parent! <> subschematic)
@@ -205,21 +269,63 @@ NAME is used as its hierarchical name."
     subschematic))
 
 
-(define (hierarchy-down-schematic name)
-  (define quiet-mode (netlist-option-ref 'quiet))
-
-  (let ((filename (get-source-library-file name)))
-    (if filename
-        (begin
-          (unless quiet-mode
-            (log! 'message (G_ "Loading subcircuit ~S.") filename))
-          (file->page filename 'new-page))
-        (begin
-          (log! 'critical (G_ "Failed to load subcircuit ~S.") name)
-          #f))))
+(define (subcircuit-file-name name)
+  (let ((cache (%subcircuit-file-names)))
+    (if cache
+        (let ((handle (hash-get-handle cache name)))
+          (if handle
+              (cdr handle)
+              (let ((filename (get-source-library-file name)))
+                (hash-set! cache name filename)
+                filename)))
+        (get-source-library-file name))))
+
+
+(define (load-subcircuits filenames)
+  (unless (netlist-option-ref 'quiet)
+    (for-each (cut log! 'message (G_ "Loading subcircuit ~S.") <>)
+              filenames))
+  (file-name-list->pages filenames #:new-page? #t))
+
+
+;;; Loads at once all subcircuit files not loaded yet that are
+;;; referred to in the "source=" attributes of COMPONENTS, so
+;;; that their contents may be read concurrently.
+(define (load-component-sources! components)
+  (let ((cache (%subcircuit-pages)))
+    (when cache
+      (let ((filenames
+             (delete-duplicates
+              (filter-map
+               (lambda (name)
+                 (let ((filename (subcircuit-file-name name)))
+                   (and filename
+                        (not (hash-ref cache filename))
+                        filename)))
+               (append-map (lambda (component)
+                             (or (schematic-component-sources component) '()))
+                           components)))))
+        (for-each (cut hash-set! cache <> <>)
+                  filenames
+                  (load-subcircuits filenames))))))
 
 
-(define (page-list->hierarchical-subschematic pages hierarchy-tag)
+(define (hierarchy-down-schematic name)
+  (let ((filename (subcircuit-file-name name))
+        (cache (%subcircuit-pages)))
+    (cond
+     ((not filename)
+      (log! 'critical (G_ "Failed to load subcircuit ~S.") name)
+      #f)
+     ((not cache) (car (load-subcircuits (list filename))))
+     (else
+      (or (hash-ref cache filename)
+          (let ((page (car (load-subcircuits (list filename)))))
+            (hash-set! cache filename page)
+            page))))))
+
+
+(define (make-hierarchical-subschematic pages hierarchy-tag)
   (define (traverse-component-sources component)
     (and (schematic-component-sources component)
          (let* ((hierarchy-tag (make-schematic-component-refdes* component
@@ -227,18 +333,84 @@ NAME is used as its hierarchical name."
                 (source-pages (filter-map hierarchy-down-schematic
                                           (schematic-component-sources component)))
                 ;; Recursive processing of sources.
-                (subschematic (page-list->hierarchical-subschematic source-pages hierarchy-tag)))
+                (subschematic (make-hierarchical-subschematic source-pages hierarchy-tag)))
            (set-schematic-component-subschematic! component subschematic)
            (set-subschematic-parent! subschematic component)
            component)))
 
   (let ((subschematic (page-list->subschematic pages hierarchy-tag)))
+    (load-component-sources! (subschematic-components subschematic))
     ;; Traverse pages obtained from files defined in the 'source='
     ;; attributes of schematic components.
     (for-each traverse-component-sources
               (subschematic-components subschematic))
 
     subschematic))
+
+
+(define (page-list->hierarchical-subschematic pages hierarchy-tag)
+  "Creates a new subschematic from the PAGES list, using
+HIERARCHY-TAG as its hierarchical name, and recursively creates
+subschematics for the sources of its components.  Subcircuit files
+used by several components are loaded and have their connections
+computed only once.  If the procedure is called within
+call-with-hierarchy-cache(), the pages and connections obtained in
+previous calls are reused as well."
+  (if (%subcircuit-pages)
+      (make-hierarchical-subschematic pages hierarchy-tag)
+      (call-with-hierarchy-cache
+       (make-hierarchy-cache)
+       (lambda ()
+         (make-hierarchical-subschematic pages hierarchy-tag)))))
+
+
+(define-record-type <hierarchy-cache>
+  (%make-hierarchy-cache pages file-names connection-groups)
+  hierarchy-cache?
+  (pages hierarchy-cache-pages)
+  (file-names hierarchy-cache-file-names)
+  (connection-groups hierarchy-cache-connection-groups))
+
+(define (make-hierarchy-cache)
+  "Returns a new empty cache of subcircuit pages and page
+connections for use in call-with-hierarchy-cache()."
+  (%make-hierarchy-cache (make-hash-table)
+                         (make-hash-table)
+                         (make-hash-table)))
+
+
+(define (call-with-hierarchy-cache cache thunk)
+  "Calls THUNK so that hierarchical subschematics created in it
+share the subcircuit pages and page connections stored in CACHE,
+and store there the ones they compute.  Keeping the cache between
+several runs of the netlister avoids loading subcircuits and
+computing connections of unchanged pages again."
+  (parameterize ((%subcircuit-pages (hierarchy-cache-pages cache))
+                 (%subcircuit-file-names (hierarchy-cache-file-names cache))
+                 (%page-connection-groups
+                  (hierarchy-cache-connection-groups cache)))
+    (thunk)))
+
+
+(define (hierarchy-cache-forget-pages! cache pages)
+  "Removes the subcircuit pages and page connections for PAGES
+from CACHE, so that they are computed again the next time they
+are needed.  This must be done before PAGES are closed."
+  (let ((subcircuit-pages (hierarchy-cache-pages cache))
+        (connection-groups (hierarchy-cache-connection-groups cache)))
+    (for-each (cut hashq-remove! connection-groups <>) pages)
+    (for-each (lambda (filename) (hash-remove! subcircuit-pages filename))
+              (hash-fold (lambda (filename page ls)
+                           (if (memq page pages)
+                               (cons filename ls)
+                               ls))
+                         '()
+                         subcircuit-pages))
+    ;; Locations of subcircuits in the source library may have
+    ;; changed as well.
+    (hash-clear! (hierarchy-cache-file-names cache))))
+
+
 (define (warn-no-pinlabel pin)
   (or (package-pin-label pin)
       (begin
@@ -388,28 +560,14 @@ NAME is used as its hierarchical name."
                       (collect-components subschematic))))
 
 
-(define (connected-port-connections? ls1 ls2)
-  (define (connected-to-ls2? x)
-    (member x ls2))
-  (any connected-to-ls2? ls1))
-
-
-(define (reconnect-connections ls groups)
-  (define (is-ls-connected-to? group)
-    (connected-port-connections? ls group))
-
-  (receive (connected unconnected)
-      (partition is-ls-connected-to? groups)
-    (let ((result
-           `(,@unconnected
-             ,(if (null? connected)
-                  ls
-                  (apply append ls connected)))))
-      result)))
-
-
+;;; Groups lists of connections having common members.
 (define (group-connections ls)
-  (fold reconnect-connections '() ls))
+  (group-linked ls
+                #:elements identity
+                #:probe-keys identity
+                #:link-keys identity
+                #:table-ref hashq-ref
+                #:table-set! hashq-set!))
 
 
 (define (make-port-connection group)
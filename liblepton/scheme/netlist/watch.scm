@@ -0,0 +1,161 @@
+;;; Lepton EDA netlister
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; Repeated netlisting of schematics on changes of their files.
+
+(define-module (netlist watch)
+  #:use-module (srfi srfi-1)
+  #:use-module (srfi srfi-26)
+  #:use-module (system foreign)
+
+  #:use-module (lepton ffi glib)
+  #:use-module (lepton ffi)
+  #:use-module (lepton gettext)
+  #:use-module (lepton log)
+  #:use-module (lepton object)
+  #:use-module (lepton os)
+  #:use-module (lepton page)
+  #:use-module (netlist subschematic)
+
+  #:export (page-symbol-files
+            changed-pages
+            watch-netlist))
+
+;;; Time in milliseconds to wait for more changes after a file
+;;; has changed, so that saving several files at once results in
+;;; one run.
+(define %watch-delay 200)
+
+
+(define (page-symbol-files page)
+  "Returns the list of the symbol files used by the components of
+PAGE, in the form of pairs (FILENAME . BASENAME).  Embedded
+components and components whose symbols have not been found in
+the component library are ignored."
+  (delete-duplicates
+   (filter-map (lambda (object)
+                 (and (component? object)
+                      (not (object-embedded? object))
+                      (let ((filename (component-filename object)))
+                        (and filename
+                             (cons filename (component-basename object))))))
+               (page-contents page))))
+
+
+(define (changed-pages pages filenames page-symbols)
+  "Returns the pages of PAGES that have to be reloaded when the
+files FILENAMES change, that is, the pages read from them and the
+pages using symbols read from them.  PAGE-SYMBOLS is a procedure
+returning the symbol files of a page as page-symbol-files()
+does."
+  (filter (lambda (page)
+            (or (member (page-filename page) filenames)
+                (any (lambda (symbol) (member (car symbol) filenames))
+                     (page-symbols page))))
+          pages))
+
+
+;;; Converts a NULL terminated array of C strings to a list of
+;;; strings.
+(define (pointer->string-list *strv)
+  (let loop ((i 0)
+             (ls '()))
+    (let ((*s (dereference-pointer
+               (make-pointer (+ (pointer-address *strv)
+                                (* i (sizeof '*)))))))
+      (if (null-pointer? *s)
+          (reverse ls)
+          (loop (1+ i) (cons (pointer->string *s) ls))))))
+
+
+(define (wait-for-changes *watch)
+  (let* ((*changed (f_watch_wait *watch %watch-delay))
+         (changed (pointer->string-list *changed)))
+    (g_strfreev *changed)
+    changed))
+
+
+;;; Forces the symbols read from FILENAMES to be reloaded from the
+;;; component library.
+(define (invalidate-symbols! symbols filenames)
+  (for-each
+   (lambda (symbol)
+     (when (member (car symbol) filenames)
+       (let ((*symbol (s_clib_get_symbol_by_name (string->pointer (cdr symbol)))))
+         (unless (null-pointer? *symbol)
+           (s_clib_symbol_invalidate_data *symbol)))))
+   symbols))
+
+
+(define (watch-netlist filenames netlist!)
+  "Calls NETLIST!, a procedure creating the netlist of the
+schematics FILENAMES, then waits for changes of these files, of the
+subcircuits they use, or of the symbols of their components, and
+calls NETLIST! again after each change.  Never returns.
+
+Only the pages read from changed files, or using changed symbols,
+are read again.  Other pages, and the connections computed for
+them, are reused.  Errors raised by NETLIST! are reported, and the
+netlist is created again on the next change."
+  (define cache (make-hierarchy-cache))
+  (define *watch (f_watch_new))
+  (define symbols (make-hash-table))
+
+  (define (page-symbols page)
+    (or (hashq-ref symbols page)
+        (let ((ls (page-symbol-files page)))
+          (hashq-set! symbols page ls)
+          ls)))
+
+  (define (run!)
+    (let ((start (get-internal-real-time)))
+      (catch #t
+        (lambda ()
+          (call-with-hierarchy-cache cache netlist!)
+          (log! 'message
+                (G_ "Netlist created in ~,2F s.")
+                (exact->inexact (/ (- (get-internal-real-time) start)
+                                   internal-time-units-per-second))))
+        (lambda (key . args)
+          (log! 'warning
+                (G_ "Failed to create netlist: ~A ~S")
+                key
+                args)))))
+
+  (define (watch-files!)
+    (for-each
+     (lambda (filename)
+       (f_watch_add *watch (string->pointer filename)))
+     (delete-duplicates
+      (append (map expand-env-variables filenames)
+              (map page-filename (active-pages))
+              (append-map (lambda (page) (map car (page-symbols page)))
+                          (active-pages))))))
+
+  (let loop ()
+    (run!)
+    (watch-files!)
+    (let* ((changed (wait-for-changes *watch))
+           (pages (changed-pages (active-pages) changed page-symbols)))
+      (log! 'message (G_ "Files changed: ~A") (string-join changed ", "))
+      (for-each (lambda (page)
+                  (invalidate-symbols! (page-symbols page) changed)
+                  (hashq-remove! symbols page))
+                pages)
+      (hierarchy-cache-forget-pages! cache pages)
+      (for-each close-page! pages)
+      (loop))))
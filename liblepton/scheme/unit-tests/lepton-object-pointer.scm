@@ -0,0 +1,51 @@
+;;; Test Scheme procedures working with object wrapped foreign
+;;; pointers.
+
+(use-modules (srfi srfi-1)
+             (system foreign)
+             (lepton object foreign)
+             (lepton object)
+             (lepton page))
+
+(test-begin "object-pointer")
+
+(let* ((object (make-line '(0 . 0) '(100 . 100)))
+       (*object (object->pointer object)))
+
+  (test-assert (is-object? object))
+  (test-assert (pointer? *object))
+  (test-assert (not (null-pointer? *object)))
+
+  ;; The same wrapper is returned for the same C object.
+  (test-eq object (pointer->object *object))
+  (test-eq object (pointer->object (make-pointer (pointer-address *object))))
+  (test-eq *object (check-object object 1)))
+
+(test-end "object-pointer")
+
+
+(test-begin "object-pointer-cache")
+
+(let ((page (make-page "/test/page/object-pointer"))
+      (blame (make-object-property)))
+  (page-append! page
+                (make-line '(0 . 0) '(100 . 100))
+                (make-net '(0 . 0) '(100 . 0)))
+
+  ;; Wrappers, and thus object properties, survive garbage
+  ;; collection as long as their objects exist.
+  (for-each (lambda (object) (set! (blame object) (object-type object)))
+            (page-contents page))
+  (gc)
+  (test-equal '(line net) (map blame (page-contents page)))
+  (test-assert (every eq? (page-contents page) (page-contents page)))
+
+  ;; Wrappers are invalidated when their objects are destroyed.
+  (let ((objects (page-contents page)))
+    (close-page! page)
+    (test-assert (every is-object? objects))
+    (test-assert (every (lambda (object) (null-pointer? (object->pointer object)))
+                        objects))
+    (test-assert-thrown 'wrong-type-arg (object-type (car objects)))))
+
+(test-end "object-pointer-cache")
@@ -0,0 +1,135 @@
+;;; Test Scheme procedures for exporting object properties in bulk.
+
+(use-modules (srfi srfi-1)
+             (srfi srfi-11)
+             (lepton attrib)
+             (lepton object)
+             (lepton page))
+
+;;; Returns the fields of the record of OBJECT as obtained with
+;;; per-object accessors.
+(define (object-fields object)
+  (define (coords first second)
+    (list (car first) (cdr first) (car second) (cdr second)))
+
+  `(,(object-type object)
+    ,(object-id object)
+    ,(object-color object)
+    ,@(case (object-type object)
+        ((line net bus pin) (coords (line-start object) (line-end object)))
+        ((box) (coords (box-top-left object) (box-bottom-right object)))
+        ((circle) (coords (circle-center object)
+                          (cons (circle-radius object) 0)))
+        ((arc) (coords (arc-center object) (cons (arc-radius object) 0)))
+        ((text) (coords (text-anchor object) '(0 . 0)))
+        ((complex) (coords (component-position object) '(0 . 0))))))
+
+(define (record-fields records index)
+  (map (lambda (field) (object-record-ref records index field))
+       '(type id color x0 y0 x1 y1)))
+
+(define (record-index objects object)
+  (and object
+       (vector-index (lambda (x) (eq? x object)) objects)))
+
+(define (vector-index pred vec)
+  (list-index pred (vector->list vec)))
+
+
+(test-begin "object-records")
+
+(let ((P (make-page "/test/page/A"))
+      (C (make-component "test component" '(1 . 2) 0 #t #f))
+      (p (make-net-pin '(100 . 0) '(0 . 0)))
+      (t (make-text '(100 . 0) 'lower-left 0 "pinnumber=1" 10 #f 'both))
+      (l (make-line '(1 . 2) '(3 . 4) 5))
+      (b (make-box '(0 . 100) '(100 . 0)))
+      (c (make-circle '(10 . 20) 30))
+      (a (make-arc '(40 . 50) 60 0 90))
+      (n (make-net '(100 . 0) '(100 . 100)))
+      (r (make-text '(1 . 2) 'lower-left 0 "refdes=U1" 10 #t 'both)))
+
+  (test-group-with-cleanup "object-records-grp"
+
+    ;; Empty page.
+    (let-values (((objects records strings) (page-object-records P)))
+      (test-equal #() objects)
+      (test-equal 0 (object-record-count records))
+      (test-equal #() strings))
+
+    (component-append! C p t)
+    (attach-attribs! p t)
+    (page-append! P l C b c a n r)
+    (attach-attribs! C r)
+
+    ;; Page records: component contents follow the component.
+    (let-values (((objects records strings) (page-object-records P)))
+      (test-equal (vector l C p t b c a n r) objects)
+      (test-equal 9 (object-record-count records))
+      (for-each
+       (lambda (i)
+         (let ((object (vector-ref objects i)))
+           (test-equal (object-fields object) (record-fields records i))
+           (test-equal (record-index objects (object-component object))
+             (object-record-ref records i 'parent))
+           (test-equal (record-index objects (and (attribute? object)
+                                                   (attrib-attachment object)))
+             (object-record-ref records i 'attached-to))
+           (test-equal (and (text? object) (text-string object))
+             (vector-ref strings i))))
+       (iota 9))
+      (test-equal '(1 2 3 4) (map (lambda (field)
+                                    (object-record-ref records 0 field))
+                                  '(x0 y0 x1 y1)))
+      (test-equal 5 (object-record-ref records 0 'color)))
+
+    ;; Object records: attributes follow their owner, and objects
+    ;; are exported only once.
+    (let-values (((objects records strings) (object-records (list n C r))))
+      (test-equal (vector n C p t r) objects)
+      (test-equal 1 (object-record-ref records 2 'parent))
+      (test-equal 2 (object-record-ref records 3 'attached-to))
+      (test-equal 1 (object-record-ref records 4 'attached-to))
+      (test-equal (vector #f #f #f "pinnumber=1" "refdes=U1") strings))
+
+    (test-equal '() (call-with-values (lambda () (object-records '()))
+                      (lambda (objects records strings)
+                        (vector->list objects))))
+
+    (test-assert-thrown 'wrong-type-arg (object-records (list l 'x))))
+
+  ;; Clean up.
+  (close-page! P))
+
+(test-end "object-records")
+
+
+;;; Per-object and bulk access to the properties of a page give
+;;; the same results.
+(test-begin "object-records-page")
+
+(let ((page (make-page "/test/page/records-page")))
+  (apply page-append! page
+         (append-map (lambda (i)
+                       (list (make-line (cons i 0) (cons i 100))
+                             (make-text (cons i 200) 'lower-left 0
+                                        (number->string i) 10 #t 'both)))
+                     (iota 10)))
+
+  (let ((per-object (map (lambda (object)
+                           (append (object-fields object)
+                                   (list (and (text? object)
+                                              (text-string object)))))
+                         (page-contents page)))
+        (bulk (let-values (((objects records strings)
+                            (page-object-records page)))
+                (map (lambda (i)
+                       (append (record-fields records i)
+                               (list (vector-ref strings i))))
+                     (iota (vector-length objects))))))
+    (test-equal 20 (length bulk))
+    (test-equal per-object bulk))
+
+  (close-page! page))
+
+(test-end "object-records-page")
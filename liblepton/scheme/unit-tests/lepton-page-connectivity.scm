@@ -0,0 +1,69 @@
+;;; Test Scheme procedure for getting connectivity of pages.
+
+(use-modules (rnrs bytevectors)
+             (srfi srfi-1)
+             (srfi srfi-11)
+             (lepton attrib)
+             (lepton object)
+             (lepton page))
+
+(define (s32-list bv)
+  (map (lambda (i) (bytevector-s32-native-ref bv (* 4 i)))
+       (iota (quotient (bytevector-length bv) 4))))
+
+(test-begin "page-connectivity")
+
+(let ((P (make-page "/test/page/A"))
+      (C (make-component "test component" '(1 . 2) 0 #t #f))
+      (np (make-net-pin '(100 . 0) '(0 . 0)))
+      (bp (make-bus-pin '(100 . 200) '(0 . 200)))
+      (n1 (make-net '(100 . 0) '(100 . 100)))
+      (n2 (make-net '(100 . 100) '(200 . 100)))
+      (n3 (make-net '(500 . 500) '(600 . 500)))
+      (b1 (make-bus '(100 . 200) '(200 . 200)))
+      (t1 (make-text '(100 . 100) 'lower-left 0 "netname=one" 10 #f 'both))
+      (t2 (make-text '(100 . 100) 'lower-left 0 "netname=" 10 #f 'both)))
+
+  (test-group-with-cleanup "page-connectivity-grp"
+
+    ;; Empty page.
+    (let-values (((objects n-nets offsets targets netnames)
+                  (page-connectivity P)))
+      (test-equal #() objects)
+      (test-equal 0 n-nets)
+      (test-equal '(0) (s32-list offsets))
+      (test-equal '() (s32-list targets))
+      (test-equal #() netnames))
+
+    (component-append! C np bp)
+    (page-append! P n1 C n2 b1 n3 t1 t2)
+    (attach-attribs! n2 t1 t2)
+
+    ;; Nets come first in page order, then net pins.  Buses and
+    ;; bus pins are not exported.
+    (let-values (((objects n-nets offsets targets netnames)
+                  (page-connectivity P)))
+      (define (connected-objects i)
+        (map (lambda (j) (vector-ref objects (list-ref (s32-list targets) j)))
+             (iota (- (list-ref (s32-list offsets) (1+ i))
+                      (list-ref (s32-list offsets) i))
+                   (list-ref (s32-list offsets) i))))
+
+      (test-equal (vector n1 n2 n3 np) objects)
+      (test-equal 3 n-nets)
+      (test-equal 5 (length (s32-list offsets)))
+      ;; Connections are listed in the same order as by
+      ;; object-connections().
+      (for-each
+       (lambda (i)
+         (test-equal (filter (lambda (x) (not (bus? x)))
+                             (object-connections (vector-ref objects i)))
+           (connected-objects i)))
+       (iota 4))
+      (test-equal '() (connected-objects 2))
+      (test-equal (vector '() '("one" "") '() '()) netnames)))
+
+  ;; Clean up.
+  (close-page! P))
+
+(test-end "page-connectivity")
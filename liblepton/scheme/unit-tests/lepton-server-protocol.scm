@@ -0,0 +1,67 @@
+;;; Test messages exchanged by lepton-cli server and its clients.
+
+(use-modules (ice-9 binary-ports)
+             (rnrs bytevectors)
+             (srfi srfi-11)
+             (lepton server protocol))
+
+;;; Returns the frames written to a port by WRITE-FRAMES! as a
+;;; list of pairs (TYPE . PAYLOAD).
+(define (round-trip write-frames!)
+  (let-values (((port get-bytevector) (open-bytevector-output-port)))
+    (write-frames! port)
+    (let ((input (open-bytevector-input-port (get-bytevector))))
+      (let loop ((frames '()))
+        (let-values (((type payload) (read-frame input)))
+          (if (eof-object? type)
+              (reverse frames)
+              (loop (cons (cons type payload) frames))))))))
+
+
+(test-begin "server-protocol")
+
+(test-equal `((stdout . ,(string->utf8 "netlist"))
+              (stderr . ,(make-bytevector 0))
+              (stdout . ,(u8-list->bytevector '(0 255 10))))
+  (round-trip (lambda (port)
+                (write-frame port 'stdout (string->utf8 "netlist"))
+                (write-frame port 'stderr (make-bytevector 0))
+                (write-frame port 'stdout (u8-list->bytevector '(0 255 10))))))
+
+(let ((request '("/tmp" ("HOME=/home/user") ("netlist" "-g" "spice" "a b.sch"))))
+  (test-equal (list 'request request)
+    (let ((frame (car (round-trip (lambda (port)
+                                    (write-datum-frame port 'request request))))))
+      (list (car frame) (frame-datum (cdr frame))))))
+
+;;; Incomplete frames are treated as the end of input.
+(let ((input (open-bytevector-input-port (u8-list->bytevector '(1 0 0 0 5 1 2)))))
+  (let-values (((type payload) (read-frame input)))
+    (test-assert (eof-object? type))
+    (test-assert (not payload))))
+
+;;; Unknown frame types.
+(let ((input (open-bytevector-input-port (u8-list->bytevector '(42 0 0 0 1 7)))))
+  (let-values (((type payload) (read-frame input)))
+    (test-eq #f type)
+    (test-equal (u8-list->bytevector '(7)) payload)))
+
+;;; Size of buffered frames.
+(test-eq #f (frame-size (u8-list->bytevector '(0 0 0))))
+(test-eq 5 (frame-size (u8-list->bytevector '(0 0 0 0 0))))
+(test-eq 263 (frame-size (u8-list->bytevector '(0 0 0 1 2 7))))
+
+(test-end "server-protocol")
+
+
+(test-begin "default-server-socket")
+
+(let ((socket (getenv "LEPTON_SERVER_SOCKET")))
+  (setenv "LEPTON_SERVER_SOCKET" "/tmp/test.socket")
+  (test-equal "/tmp/test.socket" (default-server-socket))
+  (unsetenv "LEPTON_SERVER_SOCKET")
+  (test-assert (string-suffix? ".socket" (default-server-socket)))
+  (when socket
+    (setenv "LEPTON_SERVER_SOCKET" socket)))
+
+(test-end "default-server-socket")
@@ -0,0 +1,44 @@
+;;; Test selection of backends, their output files and options.
+
+(use-modules (netlist backend))
+
+(test-begin "parse-backend-spec")
+
+(test-equal '("spice-sdb" . #f) (parse-backend-spec "spice-sdb"))
+(test-equal '("bom" . "out.bom") (parse-backend-spec "bom:out.bom"))
+(test-equal '("geda" . "-") (parse-backend-spec "geda:-"))
+(test-equal '("drc2" . "c:/out.drc") (parse-backend-spec "drc2:c:/out.drc"))
+
+(test-end "parse-backend-spec")
+
+
+(test-begin "backend-arguments")
+
+(let ((options '("include_mode" "bom:attrib_file=attribs" "spice-sdb:sort_mode" "x:y")))
+  ;; Options prefixed with the name of a backend only apply to it.
+  (test-equal '("include_mode" "attrib_file=attribs" "x:y")
+    (backend-arguments options "bom" '("bom" "spice-sdb")))
+  (test-equal '("include_mode" "sort_mode" "x:y")
+    (backend-arguments options "spice-sdb" '("bom" "spice-sdb")))
+  ;; Options are passed as is if no names of backends are known.
+  (test-equal options (backend-arguments options #f '())))
+
+(test-end "backend-arguments")
+
+
+(test-begin "make-backend-module")
+
+(define backend-module-test-value 'outer)
+
+(let ((A (make-backend-module))
+      (B (make-backend-module)))
+  (eval '(define (test-backend-proc) 'A) A)
+  (eval '(define (test-backend-proc) 'B) B)
+  ;; Definitions of backends don't override each other, and the
+  ;; bindings of the current module are visible in them.
+  (test-eq 'A (eval '(test-backend-proc) A))
+  (test-eq 'B (eval '(test-backend-proc) B))
+  (test-eq 'outer (eval 'backend-module-test-value A))
+  (test-assert (not (module-defined? (current-module) 'test-backend-proc))))
+
+(test-end "make-backend-module")
@@ -0,0 +1,115 @@
+;;; Test grouping of connections in the netlister.
+
+(use-modules (srfi srfi-1)
+             (srfi srfi-11)
+             (srfi srfi-26)
+             (lepton object)
+             (lepton page)
+             (netlist connection-group)
+             (netlist schematic-connection))
+
+;;; Reference implementation: each item takes the groups it is
+;;; connected to out of the list, and the new group is appended
+;;; to the list.
+(define (fold-groups items elements probe-keys link-keys)
+  (define (connected? item group-items)
+    (any (lambda (other)
+           (any (lambda (key) (member key (link-keys other)))
+                (probe-keys item)))
+         group-items))
+  (map (lambda (group) (append-map elements group))
+       (fold (lambda (item groups)
+               (let-values (((connected unconnected)
+                             (partition (lambda (group)
+                                          (connected? item group))
+                                        groups)))
+                 `(,@unconnected
+                   ,(apply append (list item) connected))))
+             '()
+             items)))
+
+(define (random-items count nkeys state)
+  (list-tabulate count
+                 (lambda (i)
+                   (cons i
+                         (list-tabulate (random 3 state)
+                                        (lambda (j) (random nkeys state)))))))
+
+
+(test-begin "group-linked")
+
+(test-equal '() (group-linked '()))
+
+(test-equal '((a) (b))
+  (group-linked '(a b)))
+
+;;; Item 3 merges the groups of items 1 and 2, and the merged
+;;; group goes to the end of the list.
+(test-equal '((0 "x") (3 "y" "z" 1 "y" 2 "z"))
+  (group-linked '((0 "x") (1 "y") (2 "z") (3 "y" "z"))
+                #:elements identity
+                #:probe-keys cdr
+                #:link-keys cdr))
+
+(let ((state (seed->random-state 42)))
+  (for-each
+   (lambda (count)
+     (let ((items (random-items count (1+ (quotient count 2)) state)))
+       (test-equal (fold-groups items list cdr cdr)
+         (group-linked items #:probe-keys cdr #:link-keys cdr))))
+   (iota 30 1 3)))
+
+;;; Asymmetric links: an item joins the groups of the items
+;;; listing it amongst their keys.
+(let* ((state (seed->random-state 17))
+       (links (list-tabulate 40 (lambda (i)
+                                  (list-tabulate (random 3 state)
+                                                 (lambda (j) (random 40 state))))))
+       (link-keys (lambda (i) (list-ref links i))))
+  (test-equal (fold-groups (iota 40) list list link-keys)
+    (group-linked (iota 40) #:link-keys link-keys)))
+
+(test-end "group-linked")
+
+
+(test-begin "make-page-schematic-connections")
+
+;;; Nets are added in a mixed order so that several groups are
+;;; merged when the last segments are processed.
+(let* ((page (make-page "/test/page/connection-group"))
+       (a1 (make-net '(0 . 0) '(100 . 0)))
+       (b1 (make-net '(0 . 500) '(100 . 500)))
+       (a2 (make-net '(200 . 0) '(300 . 0)))
+       (c1 (make-net '(0 . 1000) '(100 . 1000)))
+       (b2 (make-net '(100 . 500) '(200 . 500)))
+       (a3 (make-net '(100 . 0) '(200 . 0))))
+  (page-append! page a1 b1 a2 c1 b2 a3)
+  (let ((groups (map schematic-connection-objects
+                     (make-page-schematic-connections page))))
+    (test-equal 3 (length groups))
+    (test-assert (lset= eq? (list a1 a2 a3) (find (cut memq a1 <>) groups)))
+    (test-assert (lset= eq? (list b1 b2) (find (cut memq b1 <>) groups)))
+    (test-equal (list (list c1)) (filter (cut memq c1 <>) groups)))
+  (close-page! page))
+
+;;; Rows of chained segments make one connection per row.
+(let ((page (make-page "/test/page/connection-rows"))
+      (rows 20)
+      (columns 10))
+  (for-each
+   (lambda (row)
+     (apply page-append! page
+            (list-tabulate columns
+                           (lambda (column)
+                             (make-net (cons (* column 100) (* row 200))
+                                       (cons (* (1+ column) 100) (* row 200)))))))
+   (iota rows))
+  (let ((connections (make-page-schematic-connections page)))
+    (test-equal rows (length connections))
+    (test-assert (every (lambda (connection)
+                          (= columns
+                             (length (schematic-connection-objects connection))))
+                        connections)))
+  (close-page! page))
+
+(test-end "make-page-schematic-connections")
@@ -0,0 +1,91 @@
+;;; Test loading of schematic pages in the netlister.
+
+(use-modules (srfi srfi-1)
+             (lepton object)
+             (lepton page)
+             (netlist option)
+             (netlist page-load))
+
+(define *testdir* (string-append (getcwd) file-name-separator-string "netlist-page-load-tmp"))
+
+(define (test-file-name n)
+  (string-append *testdir* file-name-separator-string
+                 "page" (number->string n) ".sch"))
+
+;;; Each page contains as many lines as its number.
+(define (page-load-test-setup)
+  (mkdir *testdir*)
+  (for-each
+   (lambda (n)
+     (let ((page (make-page (test-file-name n))))
+       (for-each (lambda (i) (page-append! page (make-line '(0 . 0) (cons i i))))
+                 (iota n 1))
+       (with-output-to-file (test-file-name n)
+         (lambda () (display (page->string page))))
+       (close-page! page)))
+   (iota 8 1)))
+
+(define (page-load-test-teardown)
+  (set-netlist-option! 'jobs #f)
+  (system* "rm" "-rf" *testdir*))
+
+
+(test-begin "netlist-jobs")
+
+(set-netlist-option! 'jobs #f)
+(test-equal 1 (netlist-jobs))
+(set-netlist-option! 'jobs "4")
+(test-equal 4 (netlist-jobs))
+(set-netlist-option! 'jobs "0")
+(test-equal #f (netlist-jobs))
+(set-netlist-option! 'jobs "1.5")
+(test-equal #f (netlist-jobs))
+(set-netlist-option! 'jobs "many")
+(test-equal #f (netlist-jobs))
+(set-netlist-option! 'jobs #f)
+
+(test-end "netlist-jobs")
+
+
+(test-begin "file-name-list->pages")
+(test-group-with-cleanup "file-name-list->pages-grp"
+  (page-load-test-setup)
+
+  (for-each
+   (lambda (jobs)
+     (set-netlist-option! 'jobs jobs)
+     (let* ((filenames (map test-file-name (iota 8 1)))
+            (pages (file-name-list->pages filenames #:new-page? #t)))
+       (test-equal filenames (map page-filename pages))
+       (test-equal (iota 8 1) (map (lambda (page) (length (page-contents page)))
+                                   pages))
+       ;; Opened pages are reused unless new ones are requested.
+       (test-assert (every eq? pages (file-name-list->pages filenames)))
+       (let ((new-pages (file-name-list->pages filenames #:new-page? #t)))
+         (test-assert (not (any eq? pages new-pages)))
+         (for-each close-page! new-pages))
+       (for-each close-page! pages)))
+   '("1" "4"))
+
+  ;; Already opened pages are reused amongst the pages loaded.
+  (set-netlist-option! 'jobs "4")
+  (let* ((filenames (map test-file-name (iota 8 1)))
+         (opened (file-name-list->pages (list-head filenames 4)
+                                        #:new-page? #t))
+         (pages (file-name-list->pages filenames)))
+    (test-assert (every eq? opened (list-head pages 4)))
+    (test-equal (iota 8 1) (map (lambda (page) (length (page-contents page)))
+                                pages))
+    (for-each close-page! pages))
+
+  ;; Errors are raised in the order of files.
+  (set-netlist-option! 'jobs "4")
+  (test-assert-thrown 'system-error
+                      (file-name-list->pages
+                       (list (test-file-name 1)
+                             (string-append *testdir* "/missing.sch"))
+                       #:new-page? #t))
+
+  ;; Clean up.
+  (page-load-test-teardown))
+(test-end "file-name-list->pages")
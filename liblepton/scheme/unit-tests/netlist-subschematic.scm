@@ -0,0 +1,117 @@
+;;; Test instances of subcircuits in hierarchical subschematics.
+
+(use-modules (srfi srfi-1)
+             (lepton attrib)
+             (lepton library)
+             (lepton object)
+             (lepton page)
+             (netlist package-pin)
+             (netlist schematic-component)
+             (netlist schematic-connection)
+             (netlist subschematic))
+
+(define *testdir*
+  (string-append (getcwd) file-name-separator-string "netlist-subschematic-tmp"))
+
+(define *subcircuit* "sub.sch")
+
+;;; Appends to PAGE a component with one pin at POSITION, having
+;;; the "refdes=" attribute REFDES and other ATTRIBS.
+(define (append-component! page refdes position . attribs)
+  (let ((C (make-component "test.sym" position 0 #f #f))
+        (pin (make-net-pin position (cons (+ (car position) 100)
+                                          (cdr position))))
+        (pinnumber (make-text position 'lower-left 0 "pinnumber=1" 10 #f 'both))
+        (texts (map (lambda (attrib)
+                      (make-text position 'lower-left 0 attrib 10 #t 'both))
+                    (cons (string-append "refdes=" refdes) attribs))))
+    (component-append! C pin pinnumber)
+    (attach-attribs! pin pinnumber)
+    (apply page-append! page C texts)
+    (apply attach-attribs! C texts)
+    C))
+
+;;; The subcircuit has one component connected to a net.
+(define (subschematic-test-setup)
+  (let ((filename (string-append *testdir* file-name-separator-string *subcircuit*))
+        (page (make-page "/test/page/sub.sch")))
+    (mkdir *testdir*)
+    (append-component! page "R1" '(0 . 0))
+    (page-append! page (make-net '(0 . 0) '(0 . 500)))
+    (with-output-to-file filename
+      (lambda () (display (page->string page))))
+    (close-page! page)
+    (source-library *testdir*)))
+
+(define (subschematic-test-teardown)
+  (reset-source-library)
+  (system* "rm" "-rf" *testdir*))
+
+
+(test-begin "subschematic-instances")
+(test-group-with-cleanup "subschematic-instances-grp"
+  (subschematic-test-setup)
+
+  (let* ((page (make-page "/test/page/top.sch"))
+         (S1 (append-component! page "S1" '(0 . 0)
+                                (string-append "source=" *subcircuit*)))
+         (S2 (append-component! page "S2" '(1000 . 0)
+                                (string-append "source=" *subcircuit*)))
+         (top (page-list->hierarchical-subschematic (list page) '()))
+         (components (subschematic-components top))
+         (instances (filter-map schematic-component-subschematic components))
+         (inner-components (map (lambda (subschematic)
+                                  (car (subschematic-components subschematic)))
+                                instances))
+         (inner-pins (map (lambda (component)
+                            (car (schematic-component-pins component)))
+                          inner-components))
+         (inner-connections (map package-pin-connection inner-pins)))
+
+    (test-equal 2 (length instances))
+    ;; Both instances share the page of the subcircuit.
+    (test-eq (car (subschematic-pages (first instances)))
+      (car (subschematic-pages (second instances))))
+    (test-eq (schematic-component-object (first inner-components))
+      (schematic-component-object (second inner-components)))
+
+    ;; Top level ids are the ids of objects.
+    (test-equal (list (object-id S1) (object-id S2))
+      (map schematic-component-id components))
+
+    ;; Instance ids are made of the ids of the shared objects and
+    ;; the hierarchy tags of the instances.
+    (test-equal '(("S1") ("S2")) (map subschematic-name instances))
+    (let ((object (schematic-component-object (first inner-components)))
+          (pin (package-pin-object (first inner-pins))))
+      (test-equal (list (list (object-id object) "S1")
+                        (list (object-id object) "S2"))
+        (map schematic-component-id inner-components))
+      (test-equal (list (list (object-id pin) "S1")
+                        (list (object-id pin) "S2"))
+        (map package-pin-id inner-pins)))
+
+    ;; Each instance has its own connections.
+    (test-assert (every schematic-connection? inner-connections))
+    (test-assert (not (eq? (first inner-connections)
+                           (second inner-connections))))
+    (test-assert (not (equal? (schematic-connection-id (first inner-connections))
+                              (schematic-connection-id (second inner-connections)))))
+    (test-equal (list (list (first inner-pins)) (list (second inner-pins)))
+      (map schematic-connection-pins inner-connections))
+    (test-assert (every eq?
+                        instances
+                        (map (lambda (pin)
+                               (schematic-connection-parent
+                                (package-pin-named-connection pin)))
+                             inner-pins)))
+
+    (for-each close-page! (delete-duplicates
+                           (cons page
+                                 (append-map subschematic-pages instances))
+                           eq?)))
+
+  ;; Clean up.
+  (subschematic-test-teardown))
+
+(test-end "subschematic-instances")
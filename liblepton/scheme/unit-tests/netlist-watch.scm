@@ -0,0 +1,69 @@
+;;; Test selection of pages to reload in the netlister watch mode.
+
+(use-modules (lepton object)
+             (lepton page)
+             (netlist subschematic)
+             (netlist watch))
+
+(test-begin "page-symbol-files")
+
+(let ((page (make-page "/test/page/watch"))
+      (C (make-component "not-in-library.sym" '(0 . 0) 0 #f #f)))
+  (page-append! page C (make-net '(0 . 0) '(100 . 0)))
+  ;; Components not found in the library have no symbol file.
+  (test-equal '() (page-symbol-files page))
+  (close-page! page))
+
+(test-end "page-symbol-files")
+
+
+(test-begin "changed-pages")
+
+(let* ((A (make-page "/test/page/a.sch"))
+       (B (make-page "/test/page/b.sch"))
+       (C (make-page "/test/page/c.sch"))
+       (symbols `((,A . (("/lib/r.sym" . "r.sym")))
+                  (,B . (("/lib/c.sym" . "c.sym")
+                         ("/lib/r.sym" . "r.sym")))
+                  (,C . ())))
+       (page-symbols (lambda (page) (assq-ref symbols page)))
+       (pages (list A B C)))
+
+  (test-equal '() (changed-pages pages '() page-symbols))
+  (test-equal '() (changed-pages pages '("/test/page/d.sch") page-symbols))
+  (test-equal (list C) (changed-pages pages '("/test/page/c.sch") page-symbols))
+  (test-equal (list B) (changed-pages pages '("/lib/c.sym") page-symbols))
+  (test-equal (list A B) (changed-pages pages '("/lib/r.sym") page-symbols))
+  (test-equal (list A B C)
+    (changed-pages pages '("/test/page/c.sch" "/lib/r.sym") page-symbols))
+
+  (for-each close-page! pages))
+
+(test-end "changed-pages")
+
+
+(test-begin "hierarchy-cache")
+
+(let ((cache (make-hierarchy-cache))
+      (page (make-page "/test/page/cache.sch")))
+
+  (define (page-subschematic)
+    (call-with-hierarchy-cache
+     cache
+     (lambda ()
+       (page-list->hierarchical-subschematic (list page) '()))))
+
+  (page-append! page
+                (make-net '(0 . 0) '(100 . 0))
+                (make-net '(100 . 0) '(200 . 0)))
+
+  ;; Subschematics may be created several times with the same
+  ;; cache, and after pages have been removed from it.
+  (test-equal (list page) (subschematic-pages (page-subschematic)))
+  (test-equal (list page) (subschematic-pages (page-subschematic)))
+  (hierarchy-cache-forget-pages! cache (list page))
+  (test-equal (list page) (subschematic-pages (page-subschematic)))
+
+  (close-page! page))
+
+(test-end "hierarchy-cache")
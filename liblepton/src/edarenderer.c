@@ -20,6 +20,7 @@
 #include <config.h>
 
 #include <math.h>
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 #include <gdk/gdk.h>
@@ -45,17 +46,41 @@ enum {
   PROP_OVERRIDE_COLOR,
   PROP_GRIP_SIZE,
   PROP_RENDER_FLAGS,
+  PROP_LOD_TEXT_HEIGHT,
+  PROP_LOD_COMPONENT_SIZE,
+  PROP_LOD_HATCH_PITCH,
 
   FLAG_HINTING = EDA_RENDERER_FLAG_HINTING,
   FLAG_PICTURE_OUTLINE = EDA_RENDERER_FLAG_PICTURE_OUTLINE,
   FLAG_TEXT_HIDDEN = EDA_RENDERER_FLAG_TEXT_HIDDEN,
   FLAG_TEXT_OUTLINE = EDA_RENDERER_FLAG_TEXT_OUTLINE,
   FLAG_TEXT_ORIGIN = EDA_RENDERER_FLAG_TEXT_ORIGIN,
+  FLAG_LEVEL_OF_DETAIL = EDA_RENDERER_FLAG_LEVEL_OF_DETAIL,
 
   GRIP_SQUARE,
   GRIP_CIRCLE
 };
 
+/* Shaped text layout shared by all text objects displaying the same
+ * string with the same font, size and hinting. */
+typedef struct _EdaTextLayout EdaTextLayout;
+
+struct _EdaTextLayout
+{
+  gchar *key;
+  gchar *font_name;
+  gboolean hinting;
+  int size;
+  gchar *string;
+
+  PangoLayout *layout;
+  PangoRectangle logical_rect;
+  int descent;
+
+  /* Number of text objects using the layout */
+  guint users;
+};
+
 struct _EdaRendererPrivate
 {
   cairo_t *cr;
@@ -69,10 +94,19 @@ struct _EdaRendererPrivate
   int override_color;
   double grip_size;
 
+  /* Level of detail thresholds, in device units (pixels). */
+  double lod_text_height;
+  double lod_component_size;
+  double lod_hatch_pitch;
+
   GArray *color_map;
 
   /* Cache of font metrics for different font sizes. */
   GHashTable *metrics_cache;
+
+  /* Layout of the last text drawn in a Pango context supplied by
+   * the user, which bypasses the text layout cache. */
+  EdaTextLayout *text_layout;
 };
 
 static inline gboolean
@@ -109,12 +143,44 @@ static inline double
 EDA_RENDERER_STROKE_WIDTH0 (EdaRenderer *r, double width) {
   return (width == 0) ? 0 : EDA_RENDERER_STROKE_WIDTH (r, width);
 }
+/* Returns the length in device units of a user space distance.
+   Used for level of detail decisions. */
+static inline double
+EDA_RENDERER_DEVICE_LENGTH (EdaRenderer *r, double length) {
+  double dx = length, dy = 0;
+  cairo_user_to_device_distance (r->priv->cr, &dx, &dy);
+  return hypot (dx, dy);
+}
 
 #define DEFAULT_FONT_NAME "Sans"
+#define DEFAULT_LOD_TEXT_HEIGHT 4
+#define DEFAULT_LOD_COMPONENT_SIZE 12
+#define DEFAULT_LOD_HATCH_PITCH 3
 #define GRIP_STROKE_COLOR SELECT_COLOR
 #define GRIP_FILL_COLOR BACKGROUND_COLOR
 #define TEXT_MARKER_SIZE 10
 #define TEXT_MARKER_COLOR LOCK_COLOR
+#define TEXT_LAYOUT_CACHE_MAX 16384
+
+/* Text layouts are cached per thread, as Pango objects must not be
+ * used concurrently. */
+typedef struct _EdaTextLayoutCache EdaTextLayoutCache;
+
+struct _EdaTextLayoutCache
+{
+  /* Layout key -> EdaTextLayout */
+  GHashTable *layouts;
+  /* LeptonObject -> EdaTextLayout it was last drawn with */
+  GHashTable *objects;
+  /* Font map and contexts for unhinted and hinted layouts */
+  PangoFontMap *font_map;
+  PangoContext *context[2];
+};
+
+static void eda_text_layout_cache_free (gpointer data);
+static void eda_text_layout_free (EdaTextLayout *text_layout);
+
+static GPrivate text_layout_cache = G_PRIVATE_INIT (eda_text_layout_cache_free);
 
 static GObject *eda_renderer_constructor (GType type,
                                           guint n_construct_properties,
@@ -143,8 +209,10 @@ static void eda_renderer_draw_arc (EdaRenderer *renderer, LeptonObject *object);
 static void eda_renderer_draw_circle (EdaRenderer *renderer, LeptonObject *object);
 static void eda_renderer_draw_path (EdaRenderer *renderer, LeptonObject *object);
 static void eda_renderer_draw_text (EdaRenderer *renderer, LeptonObject *object);
-static int eda_renderer_prepare_text (EdaRenderer *renderer, const LeptonObject *object);
+static EdaTextLayout *eda_renderer_prepare_text (EdaRenderer *renderer,
+                                                 const LeptonObject *object);
 static void eda_renderer_calc_text_position (EdaRenderer *renderer, const LeptonObject *object,
+                                             EdaTextLayout *text_layout,
                                              double *x, double *y);
 static void eda_renderer_draw_picture (EdaRenderer *renderer, LeptonObject *object);
 static void eda_renderer_draw_component (EdaRenderer *renderer, LeptonObject *object);
@@ -183,6 +251,7 @@ eda_renderer_flags_get_type ()
     {FLAG_TEXT_HIDDEN, "text-hidden", _("Hidden text")},
     {FLAG_TEXT_OUTLINE, "text-outline", _("Text outlines")},
     {FLAG_TEXT_ORIGIN, "text-origin", _("Text origins")},
+    {FLAG_LEVEL_OF_DETAIL, "level-of-detail", _("Level of detail")},
     {0, 0, 0},
   };
   static GType flags_type = 0;
@@ -258,6 +327,27 @@ eda_renderer_class_init (EdaRendererClass *klass)
                                                        EDA_TYPE_RENDERER_FLAGS,
                                                        FLAG_HINTING | FLAG_TEXT_ORIGIN,
                                                        param_flags));
+  g_object_class_install_property (gobject_class, PROP_LOD_TEXT_HEIGHT,
+                                   g_param_spec_double ("lod-text-height",
+                                                        _("LOD text height"),
+                                                        _("Height in pixels below which text is drawn as a bar"),
+                                                        0, G_MAXDOUBLE,
+                                                        DEFAULT_LOD_TEXT_HEIGHT,
+                                                        param_flags));
+  g_object_class_install_property (gobject_class, PROP_LOD_COMPONENT_SIZE,
+                                   g_param_spec_double ("lod-component-size",
+                                                        _("LOD component size"),
+                                                        _("Size in pixels below which components are drawn as boxes"),
+                                                        0, G_MAXDOUBLE,
+                                                        DEFAULT_LOD_COMPONENT_SIZE,
+                                                        param_flags));
+  g_object_class_install_property (gobject_class, PROP_LOD_HATCH_PITCH,
+                                   g_param_spec_double ("lod-hatch-pitch",
+                                                        _("LOD hatch pitch"),
+                                                        _("Pitch in pixels below which hatch fills are skipped"),
+                                                        0, G_MAXDOUBLE,
+                                                        DEFAULT_LOD_HATCH_PITCH,
+                                                        param_flags));
 }
 
 static void
@@ -270,6 +360,9 @@ eda_renderer_init (EdaRenderer *renderer)
   renderer->priv->font_name = g_strdup (DEFAULT_FONT_NAME);
   renderer->priv->override_color = -1;
   renderer->priv->grip_size = 100;
+  renderer->priv->lod_text_height = DEFAULT_LOD_TEXT_HEIGHT;
+  renderer->priv->lod_component_size = DEFAULT_LOD_COMPONENT_SIZE;
+  renderer->priv->lod_hatch_pitch = DEFAULT_LOD_HATCH_PITCH;
 
   /* Font metrics are expensive to compute, so we need to cache them. */
   renderer->priv->metrics_cache =
@@ -306,6 +399,11 @@ eda_renderer_dispose (GObject *object)
     renderer->priv->pl = NULL;
   }
 
+  if (renderer->priv->text_layout != NULL) {
+    eda_text_layout_free (renderer->priv->text_layout);
+    renderer->priv->text_layout = NULL;
+  }
+
   if (renderer->priv->pr != NULL) {
     g_object_unref (renderer->priv->pr);
     renderer->priv->pr = NULL;
@@ -369,6 +467,15 @@ eda_renderer_set_property (GObject *object, guint property_id,
   case PROP_RENDER_FLAGS:
     renderer->priv->flags = g_value_get_flags (value);
     break;
+  case PROP_LOD_TEXT_HEIGHT:
+    renderer->priv->lod_text_height = g_value_get_double (value);
+    break;
+  case PROP_LOD_COMPONENT_SIZE:
+    renderer->priv->lod_component_size = g_value_get_double (value);
+    break;
+  case PROP_LOD_HATCH_PITCH:
+    renderer->priv->lod_hatch_pitch = g_value_get_double (value);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -402,6 +509,15 @@ eda_renderer_get_property (GObject *object, guint property_id,
   case PROP_RENDER_FLAGS:
     g_value_set_flags (value, renderer->priv->flags);
     break;
+  case PROP_LOD_TEXT_HEIGHT:
+    g_value_set_double (value, renderer->priv->lod_text_height);
+    break;
+  case PROP_LOD_COMPONENT_SIZE:
+    g_value_set_double (value, renderer->priv->lod_component_size);
+    break;
+  case PROP_LOD_HATCH_PITCH:
+    g_value_set_double (value, renderer->priv->lod_hatch_pitch);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -601,6 +717,18 @@ eda_renderer_draw_hatch (EdaRenderer *renderer, LeptonObject *object)
     g_return_val_if_reached (FALSE);
   }
 
+  /* Skip hatch lines which would be too dense to be seen */
+  if (EDA_RENDERER_CHECK_FLAG (renderer, FLAG_LEVEL_OF_DETAIL)) {
+    int pitch = lepton_object_get_fill_pitch1 (object);
+    if (lepton_fill_type_draw_second_hatch (lepton_object_get_fill_type (object))) {
+      pitch = MIN (pitch, lepton_object_get_fill_pitch2 (object));
+    }
+    if (EDA_RENDERER_DEVICE_LENGTH (renderer, pitch)
+        < renderer->priv->lod_hatch_pitch) {
+      return FALSE;
+    }
+  }
+
   /* Handle mesh and hatch fill types */
   fill_lines = g_array_new (FALSE, FALSE, sizeof (LeptonLine));
   if (lepton_fill_type_draw_first_hatch (lepton_object_get_fill_type (object)))
@@ -643,10 +771,50 @@ eda_renderer_draw_hatch (EdaRenderer *renderer, LeptonObject *object)
   return FALSE;
 }
 
+/* Draw a component which is too small on screen for its details to
+ * be visible.  Only its bounding box and its pins are drawn. */
+static void
+eda_renderer_draw_component_box (EdaRenderer *renderer, LeptonObject *object)
+{
+  GList *iter;
+
+  if (eda_renderer_is_drawable_color (renderer, GRAPHIC_COLOR, TRUE)) {
+    eda_renderer_set_color (renderer, GRAPHIC_COLOR);
+    eda_cairo_box (renderer->priv->cr, EDA_RENDERER_CAIRO_FLAGS (renderer),
+                   0, object->bounds.min_x, object->bounds.max_y,
+                   object->bounds.max_x, object->bounds.min_y);
+    eda_cairo_stroke (renderer->priv->cr, EDA_RENDERER_CAIRO_FLAGS (renderer),
+                      TYPE_SOLID, END_SQUARE,
+                      EDA_RENDERER_STROKE_WIDTH (renderer, 0),
+                      -1, -1);
+  }
+
+  for (iter = lepton_component_object_get_contents (object);
+       iter != NULL;
+       iter = g_list_next (iter)) {
+    LeptonObject *sub = (LeptonObject *) iter->data;
+    if (lepton_object_is_pin (sub)) {
+      eda_renderer_draw (renderer, sub);
+    }
+  }
+}
+
 static void
 eda_renderer_draw_component (EdaRenderer *renderer, LeptonObject *object)
 {
   GList *primitives = lepton_component_object_get_contents (object);
+
+  if (EDA_RENDERER_CHECK_FLAG (renderer, FLAG_LEVEL_OF_DETAIL)
+      && !lepton_bounds_empty (&object->bounds)) {
+    int size = MAX (object->bounds.max_x - object->bounds.min_x,
+                    object->bounds.max_y - object->bounds.min_y);
+    if (EDA_RENDERER_DEVICE_LENGTH (renderer, size)
+        < renderer->priv->lod_component_size) {
+      eda_renderer_draw_component_box (renderer, object);
+      return;
+    }
+  }
+
   /* Recurse */
   eda_renderer_draw_list (renderer, primitives);
 }
@@ -806,6 +974,7 @@ eda_renderer_draw_path (EdaRenderer *renderer, LeptonObject *object)
 static void
 eda_renderer_draw_text (EdaRenderer *renderer, LeptonObject *object)
 {
+  EdaTextLayout *text_layout;
   double x, y;
   double dummy = 0, small_dist = TEXT_MARKER_SIZE;
 
@@ -834,10 +1003,34 @@ eda_renderer_draw_text (EdaRenderer *renderer, LeptonObject *object)
     return;
   }
 
+  /* If the text is too small to be readable, draw a bar in place
+   * of it, or nothing at all if even the bar would be invisible. */
+  if (EDA_RENDERER_CHECK_FLAG (renderer, FLAG_LEVEL_OF_DETAIL)) {
+    double height =
+      EDA_RENDERER_DEVICE_LENGTH (renderer,
+                                  lepton_text_object_get_size_in_points (object)
+                                  * 1000 / 72);
+    if (height < renderer->priv->lod_text_height) {
+      if (height >= 1 && !lepton_bounds_empty (&object->bounds)) {
+        double middle = (object->bounds.min_y + object->bounds.max_y) / 2.;
+        eda_cairo_line (renderer->priv->cr, EDA_RENDERER_CAIRO_FLAGS (renderer),
+                        END_NONE, 0,
+                        object->bounds.min_x, middle,
+                        object->bounds.max_x, middle);
+        eda_cairo_stroke (renderer->priv->cr, EDA_RENDERER_CAIRO_FLAGS (renderer),
+                          TYPE_SOLID, END_NONE,
+                          EDA_RENDERER_STROKE_WIDTH (renderer, 0),
+                          -1, -1);
+      }
+      return;
+    }
+  }
+
   /* Otherwise, actually draw the text */
   cairo_save (renderer->priv->cr);
-  if (eda_renderer_prepare_text (renderer, object)) {
-    eda_pango_renderer_show_layout (renderer->priv->pr, renderer->priv->pl,
+  text_layout = eda_renderer_prepare_text (renderer, object);
+  if (text_layout != NULL) {
+    eda_pango_renderer_show_layout (renderer->priv->pr, text_layout->layout,
                                     0, 0);
     cairo_restore (renderer->priv->cr);
   } else {
@@ -885,55 +1078,297 @@ eda_renderer_draw_text (EdaRenderer *renderer, LeptonObject *object)
                     -1, -1);
 }
 
-static int
-eda_renderer_prepare_text (EdaRenderer *renderer, const LeptonObject *object)
+/* ================================================================
+ * TEXT LAYOUT CACHE
+ * ================================================================ */
+
+/* Shaping text with Pango is by far the most expensive part of
+ * drawing a schematic, so shaped layouts are cached.  The layouts
+ * are created in one of two private Pango contexts, which don't
+ * depend on any Cairo context, so they can be shared between all
+ * renderers of a thread.  Each text object remembers the layout it
+ * was last drawn with, and releases it when the text changes (see
+ * eda_renderer_invalidate_text()).  A layout is freed when no text
+ * object uses it anymore.
+ *
+ * Renderers running in worker threads get their own cache with its
+ * own font map.  Text changes are only ever notified to the cache
+ * of the thread modifying the objects, so the caches of the other
+ * threads rely on verifying the layout of each object before using
+ * it, and on the size limit of the cache.
+ *
+ * Renderers given a Pango context through the "pango-context"
+ * property bypass the cache, see eda_renderer_get_text_layout(). */
+
+static void
+eda_text_layout_cache_free (gpointer data)
 {
-  gint angle;
-  double points_size, dx, dy;
-  int size;
-  char *draw_string;
-  cairo_font_options_t *options;
-  PangoFontDescription *desc;
-  PangoAttrList *attrs;
+  EdaTextLayoutCache *cache = (EdaTextLayoutCache *) data;
 
-  points_size = lepton_text_object_get_size_in_points (object);
-  size = lrint (points_size * PANGO_SCALE);
+  g_hash_table_destroy (cache->objects);
+  g_hash_table_destroy (cache->layouts);
+  if (cache->context[0] != NULL) {
+    g_object_unref (cache->context[0]);
+  }
+  if (cache->context[1] != NULL) {
+    g_object_unref (cache->context[1]);
+  }
+  g_object_unref (cache->font_map);
+  g_free (cache);
+}
 
-  /* Set hinting as appropriate */
-  options = cairo_font_options_create ();
-  cairo_font_options_set_hint_metrics (options, CAIRO_HINT_METRICS_OFF);
-  if (EDA_RENDERER_CHECK_FLAG (renderer, FLAG_HINTING)) {
-    cairo_font_options_set_hint_style (options, CAIRO_HINT_STYLE_MEDIUM);
-  } else {
-    cairo_font_options_set_hint_style (options, CAIRO_HINT_STYLE_NONE);
+static EdaTextLayoutCache *
+eda_text_layout_cache_get (void)
+{
+  EdaTextLayoutCache *cache =
+    (EdaTextLayoutCache *) g_private_get (&text_layout_cache);
+
+  if (cache == NULL) {
+    cache = g_new0 (EdaTextLayoutCache, 1);
+    cache->layouts =
+      g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                             (GDestroyNotify) eda_text_layout_free);
+    cache->objects = g_hash_table_new (g_direct_hash, g_direct_equal);
+    cache->font_map = pango_cairo_font_map_new ();
+    g_private_set (&text_layout_cache, cache);
   }
-  pango_cairo_context_set_font_options (renderer->priv->pc, options);
+
+  return cache;
+}
+
+/* Set up hinting and resolution of a Pango context for text
+ * layouts. */
+static void
+eda_text_layout_setup_context (PangoContext *pc, gboolean hinting)
+{
+  cairo_font_options_t *options = cairo_font_options_create ();
+  cairo_font_options_set_hint_metrics (options, CAIRO_HINT_METRICS_OFF);
+  cairo_font_options_set_hint_style (options,
+                                     hinting
+                                     ? CAIRO_HINT_STYLE_MEDIUM
+                                     : CAIRO_HINT_STYLE_NONE);
+
+  pango_cairo_context_set_font_options (pc, options);
+  pango_cairo_context_set_resolution (pc, 1000);
   cairo_font_options_destroy (options);
+}
+
+static PangoContext *
+eda_text_layout_get_context (EdaTextLayoutCache *cache, gboolean hinting)
+{
+  PangoContext *pc = cache->context[hinting ? 1 : 0];
+
+  if (pc == NULL) {
+    pc = pango_font_map_create_context (cache->font_map);
+    eda_text_layout_setup_context (pc, hinting);
+
+    cache->context[hinting ? 1 : 0] = pc;
+  }
+
+  return pc;
+}
+
+static EdaTextLayout *
+eda_text_layout_new (PangoContext *pc,
+                     const gchar *font_name,
+                     gboolean hinting,
+                     int size,
+                     const gchar *string)
+{
+  EdaTextLayout *text_layout;
+  PangoFontDescription *desc;
+  PangoFontMetrics *fmetrics;
+  PangoAttrList *attrs;
+  char *draw_string;
 
-  pango_cairo_context_set_resolution (renderer->priv->pc, 1000);
+  /* Extract text to display and Pango text attributes */
+  if (!eda_pango_parse_overbars (string, -1, &attrs, &draw_string)) {
+    return NULL;
+  }
+
+  text_layout = g_new0 (EdaTextLayout, 1);
+  text_layout->font_name = g_strdup (font_name);
+  text_layout->hinting = hinting;
+  text_layout->size = size;
+  text_layout->string = g_strdup (string);
+  text_layout->layout = pango_layout_new (pc);
 
   /* Set font name and size, and obtain descent metric */
-  desc = pango_font_description_from_string (renderer->priv->font_name);
+  desc = pango_font_description_from_string (font_name);
   pango_font_description_set_size (desc, size);
-  pango_layout_set_font_description (renderer->priv->pl, desc);
+  pango_layout_set_font_description (text_layout->layout, desc);
+
+  fmetrics = pango_context_get_metrics (pc, desc, NULL);
+  text_layout->descent = pango_font_metrics_get_descent (fmetrics);
+  pango_font_metrics_unref (fmetrics);
   pango_font_description_free (desc);
 
-  /* Extract text to display and Pango text attributes, and then set
-   * up layout. */
-  if (!eda_pango_parse_overbars (lepton_text_object_visible_string (object),
-                                 -1,
-                                 &attrs,
-                                 &draw_string))
-  {
-    return FALSE;
-  }
-  pango_layout_set_text (renderer->priv->pl, draw_string, -1);
-  pango_layout_set_attributes (renderer->priv->pl, attrs);
+  pango_layout_set_text (text_layout->layout, draw_string, -1);
+  pango_layout_set_attributes (text_layout->layout, attrs);
   g_free (draw_string);
   pango_attr_list_unref (attrs);
 
+  pango_layout_get_extents (text_layout->layout,
+                            NULL, &text_layout->logical_rect);
+
+  return text_layout;
+}
+
+static void
+eda_text_layout_free (EdaTextLayout *text_layout)
+{
+  g_object_unref (text_layout->layout);
+  g_free (text_layout->key);
+  g_free (text_layout->font_name);
+  g_free (text_layout->string);
+  g_free (text_layout);
+}
+
+static gboolean
+eda_text_layout_matches (EdaTextLayout *text_layout,
+                         const gchar *font_name,
+                         gboolean hinting,
+                         int size,
+                         const gchar *string)
+{
+  return (text_layout->size == size
+          && text_layout->hinting == hinting
+          && strcmp (text_layout->string, string) == 0
+          && strcmp (text_layout->font_name, font_name) == 0);
+}
+
+static void
+eda_text_layout_release (EdaTextLayoutCache *cache, const LeptonObject *object)
+{
+  EdaTextLayout *text_layout =
+    (EdaTextLayout *) g_hash_table_lookup (cache->objects, object);
+
+  if (text_layout == NULL) {
+    return;
+  }
+
+  g_hash_table_remove (cache->objects, object);
+
+  text_layout->users--;
+  if (text_layout->users == 0) {
+    g_hash_table_remove (cache->layouts, text_layout->key);
+  }
+}
+
+/* Find or create the shaped layout for a text object. */
+static EdaTextLayout *
+eda_renderer_get_text_layout (EdaRenderer *renderer, const LeptonObject *object)
+{
+  EdaTextLayoutCache *cache;
+  EdaTextLayout *text_layout;
+  const gchar *string = lepton_text_object_visible_string (object);
+  const gchar *font_name = (renderer->priv->font_name != NULL)
+    ? renderer->priv->font_name : DEFAULT_FONT_NAME;
+  gboolean hinting = EDA_RENDERER_CHECK_FLAG (renderer, FLAG_HINTING) ? TRUE : FALSE;
+  int size = lrint (lepton_text_object_get_size_in_points (object) * PANGO_SCALE);
+
+  if (string == NULL) {
+    return NULL;
+  }
+
+  /* Text is shaped in the Pango context supplied by the user, for
+   * example, the one of a print context, as is.  Its layouts are
+   * not cached, since they depend on its font map and font
+   * options. */
+  if ((renderer->priv->pc != NULL) && !renderer->priv->pc_from_cr) {
+    if (renderer->priv->text_layout != NULL) {
+      eda_text_layout_free (renderer->priv->text_layout);
+    }
+    eda_text_layout_setup_context (renderer->priv->pc, hinting);
+    renderer->priv->text_layout =
+      eda_text_layout_new (renderer->priv->pc, font_name, hinting, size, string);
+    return renderer->priv->text_layout;
+  }
+
+  cache = eda_text_layout_cache_get ();
+
+  /* Fast path: the object is drawn with the same layout as last
+   * time. */
+  text_layout =
+    (EdaTextLayout *) g_hash_table_lookup (cache->objects, object);
+
+  if ((text_layout != NULL)
+      && !eda_text_layout_matches (text_layout, font_name, hinting, size, string)) {
+    eda_text_layout_release (cache, object);
+    text_layout = NULL;
+  }
+
+  if (text_layout == NULL) {
+    gchar *key = g_strdup_printf ("%s\n%d\n%d\n%s",
+                                  font_name, hinting, size, string);
+
+    text_layout = (EdaTextLayout *) g_hash_table_lookup (cache->layouts, key);
+
+    if (text_layout == NULL) {
+      text_layout = eda_text_layout_new (eda_text_layout_get_context (cache, hinting),
+                                         font_name, hinting, size, string);
+      if (text_layout == NULL) {
+        g_free (key);
+        return NULL;
+      }
+
+      /* Don't let layouts of text objects which were never
+       * invalidated accumulate forever. */
+      if (g_hash_table_size (cache->layouts) >= TEXT_LAYOUT_CACHE_MAX) {
+        g_hash_table_remove_all (cache->objects);
+        g_hash_table_remove_all (cache->layouts);
+      }
+
+      text_layout->key = key;
+      g_hash_table_insert (cache->layouts, key, text_layout);
+    } else {
+      g_free (key);
+    }
+
+    text_layout->users++;
+    g_hash_table_insert (cache->objects, (gpointer) object, text_layout);
+  }
+
+  return text_layout;
+}
+
+/*! \brief Drop the cached text layout of a text object.
+ *  \par Function Description
+ *  Must be called whenever a text object changes or is destroyed,
+ *  so that its shaped layout is released.  The layout itself is
+ *  freed if no other text object uses it.  Only the cache of the
+ *  calling thread is affected.
+ *
+ *  \param [in] object The text object.
+ */
+void
+eda_renderer_invalidate_text (const LeptonObject *object)
+{
+  EdaTextLayoutCache *cache;
+
+  g_return_if_fail (object != NULL);
+
+  cache = (EdaTextLayoutCache *) g_private_get (&text_layout_cache);
+
+  if (cache != NULL) {
+    eda_text_layout_release (cache, object);
+  }
+}
+
+static EdaTextLayout *
+eda_renderer_prepare_text (EdaRenderer *renderer, const LeptonObject *object)
+{
+  gint angle;
+  double dx, dy;
+  EdaTextLayout *text_layout;
+
+  text_layout = eda_renderer_get_text_layout (renderer, object);
+  if (text_layout == NULL) {
+    return NULL;
+  }
+
   /* Calculate text position. */
-  eda_renderer_calc_text_position (renderer, object, &dx, &dy);
+  eda_renderer_calc_text_position (renderer, object, text_layout, &dx, &dy);
 
   cairo_translate (renderer->priv->cr,
                    lepton_text_object_get_x (object),
@@ -958,48 +1393,34 @@ eda_renderer_prepare_text (EdaRenderer *renderer, const LeptonObject *object)
     cairo_translate (renderer->priv->cr, dx, dy);
   }
 
-  return TRUE;
+  return text_layout;
 }
 
 /* Calculate position to draw text relative to text origin marker, in
  * world coordinates. */
 static void
 eda_renderer_calc_text_position (EdaRenderer *renderer, const LeptonObject *object,
+                                 EdaTextLayout *text_layout,
                                  double *x, double *y)
 {
-  PangoRectangle inked_rect, logical_rect;
-  PangoContext *pcontext;
+  const PangoRectangle *logical_rect = &text_layout->logical_rect;
   double temp;
   double y_lower, y_middle, y_upper;
   double x_left, x_middle, x_right;
-  const PangoFontDescription *fdesc;
-  PangoFontMetrics *fmetrics;
-  gint descent;
-
-  cairo_save (renderer->priv->cr);
-  cairo_identity_matrix (renderer->priv->cr);
-  pango_cairo_update_layout (renderer->priv->cr, renderer->priv->pl);
-  pango_layout_get_extents (renderer->priv->pl,
-                            &inked_rect, &logical_rect);
-
-  pcontext = pango_layout_get_context (renderer->priv->pl);
-  fdesc = pango_layout_get_font_description (renderer->priv->pl);
-  fmetrics = pango_context_get_metrics (pcontext, fdesc, NULL);
-  descent = pango_font_metrics_get_descent (fmetrics);
 
   x_left = 0;
-  x_middle = -logical_rect.width / 2.0;
-  x_right = -logical_rect.width;
+  x_middle = -logical_rect->width / 2.0;
+  x_right = -logical_rect->width;
 
-  y_upper  = -logical_rect.y;                     /* Top of inked extents */
-  y_middle = y_upper - logical_rect.height / 2.;  /* Middle of inked extents */
-  y_lower  = y_upper - logical_rect.height;       /* Baseline of bottom line */
+  y_upper  = -logical_rect->y;                     /* Top of inked extents */
+  y_middle = y_upper - logical_rect->height / 2.;  /* Middle of inked extents */
+  y_lower  = y_upper - logical_rect->height;       /* Baseline of bottom line */
 
   switch (lepton_text_object_get_alignment (object)) {
     case LOWER_LEFT:
     case LOWER_MIDDLE:
     case LOWER_RIGHT:
-      y_lower += descent; break;
+      y_lower += text_layout->descent; break;
     default: break;
   }
 
@@ -1028,7 +1449,6 @@ eda_renderer_calc_text_position (EdaRenderer *renderer, const LeptonObject *obje
 
   *x /= PANGO_SCALE;
   *y /= PANGO_SCALE;
-  cairo_restore (renderer->priv->cr);
 }
 
 static void
@@ -1582,6 +2002,7 @@ eda_renderer_get_text_user_bounds (const LeptonObject *object,
   g_return_val_if_fail (object->text != NULL, FALSE);
 
   PangoRectangle inked_rect, logical_rect;
+  EdaTextLayout *text_layout;
   gboolean result = FALSE;
 
   /* First check if this is hidden text. */
@@ -1614,11 +2035,12 @@ eda_renderer_get_text_user_bounds (const LeptonObject *object,
   cairo_save (renderer->priv->cr);
 
   /* Set up the text and check it worked. */
-  if (eda_renderer_prepare_text (renderer, object)) {
+  text_layout = eda_renderer_prepare_text (renderer, object);
+  if (text_layout != NULL) {
 
     /* Figure out the bounds, send them back.  Note that Pango thinks in
      * device coordinates, but we need world coordinates. */
-    pango_layout_get_pixel_extents (renderer->priv->pl,
+    pango_layout_get_pixel_extents (text_layout->layout,
                                     &inked_rect, &logical_rect);
     *left = (double) logical_rect.x;
     *top = (double) logical_rect.y;
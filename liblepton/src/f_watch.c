@@ -0,0 +1,224 @@
+/* Lepton EDA library
+ * Copyright (C) 2022 Lepton EDA Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include <config.h>
+
+#include <gio/gio.h>
+
+#include "liblepton_priv.h"
+
+/*!
+ * \file f_watch.c
+ * \brief Monitoring of changes of files.
+ *
+ * A LeptonFileWatch keeps a GFileMonitor for each file added to
+ * it, and collects the names of the files changed while waiting
+ * in f_watch_wait().  Programs which don't run a main loop, such
+ * as lepton-netlist, can thus wait for changes of the files they
+ * read.
+ */
+
+struct st_file_watch
+{
+  GHashTable *monitors;  /* File name -> GFileMonitor */
+  GPtrArray *changed;    /* Names of the changed files, in order */
+  GHashTable *pending;   /* Set of the names in changed */
+};
+
+
+/*! \brief Record a change of a watched file.
+ *  \par Function Description
+ *  Handler of the "changed" signal of the file monitors.  Adds
+ *  the name the file was added with to the list of changed files,
+ *  unless it is already there.
+ */
+static void
+f_watch_changed_cb (GFileMonitor *monitor,
+                    GFile *file,
+                    GFile *other_file,
+                    GFileMonitorEvent event,
+                    gpointer user_data)
+{
+  LeptonFileWatch *watch = (LeptonFileWatch *) user_data;
+  gchar *filename;
+
+  switch (event) {
+  case G_FILE_MONITOR_EVENT_CHANGED:
+  case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+  case G_FILE_MONITOR_EVENT_CREATED:
+  case G_FILE_MONITOR_EVENT_DELETED:
+    break;
+  default:
+    return;
+  }
+
+  filename = (gchar *) g_object_get_data (G_OBJECT (monitor),
+                                          "lepton-watch-filename");
+
+  if (filename != NULL && !g_hash_table_contains (watch->pending, filename)) {
+    g_hash_table_add (watch->pending, filename);
+    g_ptr_array_add (watch->changed, filename);
+  }
+}
+
+
+/*! \brief Create a new file watch.
+ *  \return A newly allocated LeptonFileWatch which must be freed
+ *          with f_watch_free().
+ */
+LeptonFileWatch*
+f_watch_new ()
+{
+  LeptonFileWatch *watch = g_new0 (LeptonFileWatch, 1);
+
+  watch->monitors = g_hash_table_new_full (g_str_hash,
+                                           g_str_equal,
+                                           g_free,
+                                           g_object_unref);
+  watch->changed = g_ptr_array_new ();
+  watch->pending = g_hash_table_new (g_str_hash, g_str_equal);
+
+  return watch;
+}
+
+
+/*! \brief Free a file watch.
+ *  \param [in] watch The LeptonFileWatch to free.
+ */
+void
+f_watch_free (LeptonFileWatch *watch)
+{
+  GHashTableIter iter;
+  gpointer monitor;
+
+  if (watch == NULL) {
+    return;
+  }
+
+  g_hash_table_iter_init (&iter, watch->monitors);
+  while (g_hash_table_iter_next (&iter, NULL, &monitor)) {
+    g_signal_handlers_disconnect_by_data (monitor, watch);
+    g_file_monitor_cancel (G_FILE_MONITOR (monitor));
+  }
+
+  g_hash_table_destroy (watch->monitors);
+  g_ptr_array_free (watch->changed, TRUE);
+  g_hash_table_destroy (watch->pending);
+  g_free (watch);
+}
+
+
+/*! \brief Start watching a file.
+ *  \par Function Description
+ *  Starts monitoring changes of the file \a filename.  Nothing is
+ *  done if the file is already watched.
+ *
+ *  \param [in] watch    The LeptonFileWatch.
+ *  \param [in] filename The name of the file.
+ *  \return TRUE if the file is watched, FALSE if its monitor could
+ *          not be created.
+ */
+gboolean
+f_watch_add (LeptonFileWatch *watch,
+             const gchar *filename)
+{
+  GFile *file;
+  GFileMonitor *monitor;
+  GError *error = NULL;
+  gchar *key;
+
+  g_return_val_if_fail (watch != NULL, FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+  if (g_hash_table_contains (watch->monitors, filename)) {
+    return TRUE;
+  }
+
+  file = g_file_new_for_path (filename);
+  monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE, NULL, &error);
+  g_object_unref (file);
+
+  if (monitor == NULL) {
+    g_warning (_("Failed to watch file %1$s: %2$s"), filename, error->message);
+    g_clear_error (&error);
+    return FALSE;
+  }
+
+  key = g_strdup (filename);
+  g_object_set_data (G_OBJECT (monitor), "lepton-watch-filename", key);
+  g_signal_connect (monitor,
+                    "changed",
+                    G_CALLBACK (f_watch_changed_cb),
+                    watch);
+  g_hash_table_insert (watch->monitors, key, monitor);
+
+  return TRUE;
+}
+
+
+/*! \brief Callback ending the wait for more changes. */
+static gboolean
+f_watch_delay_cb (gpointer user_data)
+{
+  *((gboolean *) user_data) = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/*! \brief Wait for changes of the watched files.
+ *  \par Function Description
+ *  Runs the default main context until a watched file changes,
+ *  and then for \a delay more milliseconds, so that the changes
+ *  made by saving a file, or several files at once, are reported
+ *  together.
+ *
+ *  \param [in] watch The LeptonFileWatch.
+ *  \param [in] delay The delay in milliseconds.
+ *  \return A newly allocated NULL terminated array of the names of
+ *          the changed files, in the order of their first change,
+ *          which should be freed with g_strfreev().
+ */
+gchar**
+f_watch_wait (LeptonFileWatch *watch,
+              guint delay)
+{
+  gboolean done = FALSE;
+  gchar **result;
+  guint i;
+
+  g_return_val_if_fail (watch != NULL, NULL);
+
+  while (watch->changed->len == 0) {
+    g_main_context_iteration (NULL, TRUE);
+  }
+
+  g_timeout_add (delay, f_watch_delay_cb, &done);
+  while (!done) {
+    g_main_context_iteration (NULL, TRUE);
+  }
+
+  result = g_new0 (gchar*, watch->changed->len + 1);
+  for (i = 0; i < watch->changed->len; i++) {
+    result[i] = g_strdup ((gchar *) g_ptr_array_index (watch->changed, i));
+  }
+
+  g_ptr_array_set_size (watch->changed, 0);
+  g_hash_table_remove_all (watch->pending);
+
+  return result;
+}
@@ -31,9 +31,19 @@
  *  This function is responsible for making sure that any runtime
  *  initialization is done for all the liblepton routines. It should
  *  be called before any other liblepton functions are called.
+ *  Subsequent calls do nothing, so that programs run by
+ *  lepton-cli serve keep the component library and the other
+ *  state initialized by the server.
  */
 void liblepton_init(void)
 {
+  static gboolean initialized = FALSE;
+
+  if (initialized) {
+    return;
+  }
+  initialized = TRUE;
+
 #ifdef ENABLE_NLS
   /* Initialise gettext */
   bindtextdomain (LIBLEPTON_GETTEXT_DOMAIN, LOCALEDIR);
@@ -35,6 +35,8 @@
 
 enum {
   CHANGED,
+  ITEM_ADDED,
+  ITEM_REMOVED,
   LAST_SIGNAL
 };
 
@@ -99,6 +101,35 @@ lepton_list_class_init (LeptonListClass *klass)
                   G_TYPE_NONE,
                   0     /* n_params */
                  );
+
+  /* Emitted just before "changed" when a single item has been
+   * added to or removed from the list, so that listeners may
+   * update their state incrementally. */
+  lepton_list_signals[ ITEM_ADDED ] =
+    g_signal_new ("item-added",
+                  G_OBJECT_CLASS_TYPE( gobject_class ),
+                  (GSignalFlags) 0     /*signal_flags */,
+                  0     /*class_offset */,
+                  NULL, /* accumulator */
+                  NULL, /* accu_data */
+                  g_cclosure_marshal_VOID__POINTER,
+                  G_TYPE_NONE,
+                  1,    /* n_params */
+                  G_TYPE_POINTER
+                 );
+
+  lepton_list_signals[ ITEM_REMOVED ] =
+    g_signal_new ("item-removed",
+                  G_OBJECT_CLASS_TYPE( gobject_class ),
+                  (GSignalFlags) 0     /*signal_flags */,
+                  0     /*class_offset */,
+                  NULL, /* accumulator */
+                  NULL, /* accu_data */
+                  g_cclosure_marshal_VOID__POINTER,
+                  G_TYPE_NONE,
+                  1,    /* n_params */
+                  G_TYPE_POINTER
+                 );
 }
 
 
@@ -117,7 +148,8 @@ LeptonList *lepton_list_new( void ) {
 /*! \brief Adds the given item to the LeptonList
  *
  *  \par Function Description
- *  Adds the given item to the LeptonList
+ *  Adds the given item to the LeptonList and emits the "item-added"
+ *  and "changed" signals.
  *
  *  \param [in] list Pointer to the LeptonList
  *  \param [in] item item to add to the LeptonList.
@@ -125,6 +157,7 @@ LeptonList *lepton_list_new( void ) {
 void lepton_list_add( LeptonList *list, gpointer item )
 {
   list->glist = g_list_append(list->glist, item );
+  g_signal_emit( list, lepton_list_signals[ ITEM_ADDED ], 0, item );
   g_signal_emit( list, lepton_list_signals[ CHANGED ], 0 );
 }
 
@@ -149,7 +182,8 @@ void lepton_list_add_glist( LeptonList *list, GList *items )
 /*! \brief Removes the given item from the LeptonList
  *
  *  \par Function Description
- *  Removes the given item from the LeptonList.
+ *  Removes the given item from the LeptonList and emits the
+ *  "item-removed" and "changed" signals.
  *  It's ok to call this function with an item which
  *  is not necessarily in the list.
  *
@@ -162,6 +196,7 @@ void lepton_list_remove( LeptonList *list, gpointer item )
     return;
 
   list->glist = g_list_remove(list->glist, item);
+  g_signal_emit( list, lepton_list_signals[ ITEM_REMOVED ], 0, item );
   g_signal_emit( list, lepton_list_signals[ CHANGED ], 0 );
 }
 
@@ -53,6 +53,7 @@
 #endif
 
 #include "liblepton_priv.h"
+#include <liblepton/edarenderer.h>
 
 /*! this is modified here and in o_list.c */
 int global_sid=0;
@@ -995,6 +996,9 @@ lepton_object_delete (LeptonObject *o_current)
     lepton_picture_free (o_current->picture);
     o_current->picture = NULL;
 
+    if (o_current->text != NULL) {
+      eda_renderer_invalidate_text (o_current);
+    }
     lepton_text_free (o_current->text);
     o_current->text = NULL;
 
@@ -1408,6 +1412,7 @@ lepton_object_translate (LeptonObject *object,
 
   if (func != NULL) {
     (*func) (object, dx, dy);
+    s_index_object_changed (object);
   }
 }
 
@@ -1449,6 +1454,7 @@ lepton_object_rotate (int world_centerx,
 
   if (func != NULL) {
     (*func) (world_centerx, world_centery, angle, object);
+    s_index_object_changed (object);
   }
 }
 
@@ -1488,6 +1494,7 @@ lepton_object_mirror (int world_centerx,
 
   if (func != NULL) {
     (*func) (world_centerx, world_centery, object);
+    s_index_object_changed (object);
   }
 }
 
@@ -1788,6 +1795,9 @@ lepton_object_emit_change_notify (LeptonObject *object)
 {
   GList *iter;
 
+  s_index_object_changed (object);
+  s_text_index_object_changed (object);
+
   if (object->page == NULL) {
     return;
   }
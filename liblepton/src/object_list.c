@@ -290,6 +290,221 @@ lepton_object_list_set_color (const GList *objects,
 }
 
 
+/*! \brief Fill the record of an exported object
+ *
+ *  \param [in]  object  The object.
+ *  \param [in]  indices Hash table of the indices of exported objects.
+ *  \param [out] record  The LEPTON_OBJECT_RECORD_N_FIELDS fields to fill.
+ */
+static void
+lepton_object_list_export_record (LeptonObject *object,
+                                  GHashTable *indices,
+                                  gint32 *record)
+{
+  LeptonObject *parent = lepton_object_get_parent (object);
+  LeptonObject *owner = lepton_object_get_attached_to (object);
+  gpointer index;
+  gint x = 0;
+  gint y = 0;
+
+  record[LEPTON_OBJECT_RECORD_TYPE] = lepton_object_get_type (object);
+  record[LEPTON_OBJECT_RECORD_ID] = lepton_object_get_id (object);
+  record[LEPTON_OBJECT_RECORD_COLOR] = lepton_object_get_color (object);
+  record[LEPTON_OBJECT_RECORD_X1] = 0;
+  record[LEPTON_OBJECT_RECORD_Y1] = 0;
+
+  switch (lepton_object_get_type (object))
+  {
+  case OBJ_LINE:
+  case OBJ_NET:
+  case OBJ_BUS:
+  case OBJ_PIN:
+    {
+      /* For pins, the first point is the connectible one. */
+      gint first = lepton_object_is_pin (object) ? object->whichend : 0;
+
+      record[LEPTON_OBJECT_RECORD_X0] = object->line->x[first];
+      record[LEPTON_OBJECT_RECORD_Y0] = object->line->y[first];
+      record[LEPTON_OBJECT_RECORD_X1] = object->line->x[1 - first];
+      record[LEPTON_OBJECT_RECORD_Y1] = object->line->y[1 - first];
+    }
+    break;
+
+  case OBJ_BOX:
+    record[LEPTON_OBJECT_RECORD_X0] = lepton_box_object_get_upper_x (object);
+    record[LEPTON_OBJECT_RECORD_Y0] = lepton_box_object_get_upper_y (object);
+    record[LEPTON_OBJECT_RECORD_X1] = lepton_box_object_get_lower_x (object);
+    record[LEPTON_OBJECT_RECORD_Y1] = lepton_box_object_get_lower_y (object);
+    break;
+
+  case OBJ_PICTURE:
+    record[LEPTON_OBJECT_RECORD_X0] = lepton_picture_object_get_upper_x (object);
+    record[LEPTON_OBJECT_RECORD_Y0] = lepton_picture_object_get_upper_y (object);
+    record[LEPTON_OBJECT_RECORD_X1] = lepton_picture_object_get_lower_x (object);
+    record[LEPTON_OBJECT_RECORD_Y1] = lepton_picture_object_get_lower_y (object);
+    break;
+
+  case OBJ_CIRCLE:
+    record[LEPTON_OBJECT_RECORD_X0] = lepton_circle_object_get_center_x (object);
+    record[LEPTON_OBJECT_RECORD_Y0] = lepton_circle_object_get_center_y (object);
+    record[LEPTON_OBJECT_RECORD_X1] = lepton_circle_object_get_radius (object);
+    break;
+
+  case OBJ_ARC:
+    record[LEPTON_OBJECT_RECORD_X0] = lepton_arc_object_get_center_x (object);
+    record[LEPTON_OBJECT_RECORD_Y0] = lepton_arc_object_get_center_y (object);
+    record[LEPTON_OBJECT_RECORD_X1] = lepton_arc_object_get_radius (object);
+    break;
+
+  default:
+    lepton_object_get_position (object, &x, &y);
+    record[LEPTON_OBJECT_RECORD_X0] = x;
+    record[LEPTON_OBJECT_RECORD_Y0] = y;
+  }
+
+  record[LEPTON_OBJECT_RECORD_PARENT] =
+    (parent != NULL
+     && g_hash_table_lookup_extended (indices, parent, NULL, &index))
+    ? GPOINTER_TO_INT (index) : -1;
+
+  record[LEPTON_OBJECT_RECORD_ATTACHED_TO] =
+    (owner != NULL
+     && g_hash_table_lookup_extended (indices, owner, NULL, &index))
+    ? GPOINTER_TO_INT (index) : -1;
+
+  record[LEPTON_OBJECT_RECORD_STRING] = -1;
+}
+
+
+/*! \brief Collect the objects to export
+ *  \par Function Description
+ *  Appends to \a array each object of \a objects followed by the
+ *  contents of components and, if \a with_attribs is TRUE, by the
+ *  attributes attached to the object.  Objects already in \a
+ *  indices are skipped.
+ */
+static void
+lepton_object_list_export_collect (const GList *objects,
+                                   gboolean with_attribs,
+                                   GPtrArray *array,
+                                   GHashTable *indices)
+{
+  const GList *iter;
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (g_hash_table_contains (indices, object)) {
+      continue;
+    }
+
+    g_hash_table_insert (indices, object, GINT_TO_POINTER (array->len));
+    g_ptr_array_add (array, object);
+
+    if (lepton_object_is_component (object)) {
+      lepton_object_list_export_collect (lepton_component_object_get_contents (object),
+                                         with_attribs,
+                                         array,
+                                         indices);
+    }
+
+    if (with_attribs) {
+      lepton_object_list_export_collect (lepton_object_get_attribs (object),
+                                         with_attribs,
+                                         array,
+                                         indices);
+    }
+  }
+}
+
+
+/*! \brief Export the properties of a list of objects in bulk
+ *  \par Function Description
+ *  Exports the objects of \a objects, each followed by the
+ *  contents of components and, if \a with_attribs is TRUE, by the
+ *  attributes attached to it, so that the properties of a whole
+ *  page can be obtained with a couple of calls instead of several
+ *  calls per object.
+ *
+ *  For each object, \a records receives
+ *  LEPTON_OBJECT_RECORD_N_FIELDS integers as described by
+ *  #LeptonObjectRecordField.  The coordinates are the end points
+ *  of lines, nets, buses, and pins (the connectible end first),
+ *  the upper left and lower right corners of boxes and pictures,
+ *  the center and the radius of circles and arcs, and the
+ *  position of other objects.  Unused coordinates are 0.  Parents
+ *  and attribute owners which are not exported are set to -1.
+ *  The strings of text objects are stored in \a strings as NUL
+ *  terminated strings.
+ *
+ *  The function is intended to be called twice: first with \a
+ *  exported, \a records, and \a strings set to NULL to get the
+ *  number of objects and the size of the strings, and then with
+ *  buffers large enough to hold them.
+ *
+ *  \param [in]  objects      A GList of objects.
+ *  \param [in]  with_attribs Whether to export attached attributes.
+ *  \param [out] exported     The array of exported objects, or NULL.
+ *  \param [out] records      The array of object records, or NULL.
+ *  \param [out] strings      The buffer of text strings, or NULL.
+ *  \param [out] strings_size The size of the text strings, or NULL.
+ *  \return The number of exported objects.
+ */
+guint
+lepton_object_list_export (const GList *objects,
+                           gboolean with_attribs,
+                           LeptonObject **exported,
+                           gint32 *records,
+                           gchar *strings,
+                           gsize *strings_size)
+{
+  GPtrArray *array = g_ptr_array_new ();
+  GHashTable *indices = g_hash_table_new (NULL, NULL);
+  gsize size = 0;
+  guint count;
+  guint i;
+
+  lepton_object_list_export_collect (objects, with_attribs, array, indices);
+
+  for (i = 0; i < array->len; i++) {
+    LeptonObject *object = (LeptonObject*) g_ptr_array_index (array, i);
+    gint32 *record = (records == NULL)
+      ? NULL : records + (gsize) i * LEPTON_OBJECT_RECORD_N_FIELDS;
+
+    if (exported != NULL) {
+      exported[i] = object;
+    }
+
+    if (record != NULL) {
+      lepton_object_list_export_record (object, indices, record);
+    }
+
+    if (lepton_object_is_text (object)) {
+      const gchar *string = lepton_text_object_get_string (object);
+      gsize length = (string == NULL) ? 0 : strlen (string);
+
+      if (strings != NULL) {
+        memcpy (strings + size, (string == NULL) ? "" : string, length + 1);
+      }
+      if (record != NULL) {
+        record[LEPTON_OBJECT_RECORD_STRING] = size;
+      }
+      size += length + 1;
+    }
+  }
+
+  if (strings_size != NULL) {
+    *strings_size = size;
+  }
+
+  count = array->len;
+  g_hash_table_destroy (indices);
+  g_ptr_array_free (array, TRUE);
+
+  return count;
+}
+
+
 /*! \brief "Save" a file into a string buffer
  *  \par Function Description
  *  This function saves a whole schematic into a buffer in libgeda
@@ -36,6 +36,7 @@
 
 #include <config.h>
 
+#include <math.h>
 #include <stdio.h>
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
@@ -339,6 +340,9 @@ object_added (LeptonPage *page,
   /* Update object connection tracking */
   s_conn_update_object (page, object);
 
+  s_index_add_object (page, object);
+  s_text_index_add_object (page, object);
+
   lepton_object_emit_change_notify (object);
 }
 
@@ -352,6 +356,9 @@ pre_object_removed (LeptonPage *page,
   /* Remove object from the list of connectible objects */
   s_conn_remove_object (page, object);
 
+  s_index_remove_object (page, object);
+  s_text_index_remove_object (page, object);
+
   /* Clear object parent pointer */
 #ifndef NDEBUG
   if (object->page == NULL) {
@@ -404,6 +411,8 @@ lepton_page_new (LeptonToplevel *toplevel,
 
   /* Init the object list */
   page->_object_list = NULL;
+  page->_index = s_index_new ();
+  page->_text_index = s_text_index_new ();
 
   /* new selection mechanism */
   lepton_page_set_selection_list (page, o_selection_new());
@@ -529,6 +538,10 @@ lepton_page_delete (LeptonToplevel *toplevel,
     g_list_free_full (page->major_changed_refdes, &g_free);
   }
 
+  s_index_free (page->_index);
+  page->_index = NULL;
+  s_text_index_free (page->_text_index);
+  page->_text_index = NULL;
 
   g_free (page);
 
@@ -702,6 +715,8 @@ lepton_page_replace (LeptonPage *page,
     return;
   }
 
+  s_index_replace_object (page, object1, object2);
+  s_text_index_replace_object (page, object1, object2);
   pre_object_removed (page, object1);
   iter->data = object2;
   object_added (page, object2);
@@ -760,36 +775,224 @@ lepton_page_objects_in_regions (LeptonPage *page,
                                 int n_rects,
                                 gboolean include_hidden)
 {
+  g_return_val_if_fail (page != NULL, NULL);
+
+  return s_index_objects_in_regions (page, rects, n_rects, include_hidden);
+}
+
+/*! \brief Find the objects in a given rectangle
+ *  \par Function Description
+ *  Finds the objects on the page whose visible bounds intersect
+ *  the rectangle given in world coordinates.  The search uses the
+ *  spatial index of the page, so it is fast even on pages with
+ *  many objects.  The objects are returned in the order they are
+ *  drawn.
+ *
+ *  \param [in] page           The page to search.
+ *  \param [in] left           The left coordinate of the rectangle.
+ *  \param [in] top            The top (smaller Y) coordinate of the rectangle.
+ *  \param [in] right          The right coordinate of the rectangle.
+ *  \param [in] bottom         The bottom (larger Y) coordinate of the rectangle.
+ *  \param [in] include_hidden Calculate bounds of hidden objects.
+ *  \return The GList of LeptonObjects in the rectangle.
+ */
+GList*
+lepton_page_objects_in_rect (LeptonPage *page,
+                             int left,
+                             int top,
+                             int right,
+                             int bottom,
+                             gboolean include_hidden)
+{
+  LeptonBox rect;
+
+  g_return_val_if_fail (page != NULL, NULL);
+
+  rect.lower_x = MIN (left, right);
+  rect.lower_y = MIN (top, bottom);
+  rect.upper_x = MAX (left, right);
+  rect.upper_y = MAX (top, bottom);
+
+  return s_index_objects_in_regions (page, &rect, 1, include_hidden);
+}
+
+/*! \brief Find the objects inside a given rectangle
+ *  \par Function Description
+ *  Finds the objects on the page whose visible bounds lie entirely
+ *  inside the rectangle given in world coordinates.  The objects
+ *  are returned in the order they are drawn.
+ *
+ *  \param [in] page           The page to search.
+ *  \param [in] left           The left coordinate of the rectangle.
+ *  \param [in] top            The top (smaller Y) coordinate of the rectangle.
+ *  \param [in] right          The right coordinate of the rectangle.
+ *  \param [in] bottom         The bottom (larger Y) coordinate of the rectangle.
+ *  \param [in] include_hidden Calculate bounds of hidden objects.
+ *  \return The GList of LeptonObjects inside the rectangle.
+ */
+GList*
+lepton_page_objects_inside_rect (LeptonPage *page,
+                                 int left,
+                                 int top,
+                                 int right,
+                                 int bottom,
+                                 gboolean include_hidden)
+{
+  GList *list;
   GList *iter;
-  GList *list = NULL;
-  int i;
+  GList *result = NULL;
 
-  for (iter = page->_object_list; iter != NULL; iter = g_list_next (iter)) {
+  g_return_val_if_fail (page != NULL, NULL);
+
+  list = lepton_page_objects_in_rect (page, left, top, right, bottom,
+                                      include_hidden);
+
+  for (iter = list; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+    int cleft, ctop, cright, cbottom;
+
+    if (lepton_object_calculate_visible_bounds (object,
+                                                include_hidden,
+                                                &cleft,
+                                                &ctop,
+                                                &cright,
+                                                &cbottom) &&
+        cleft   >= MIN (left, right) &&
+        cright  <= MAX (left, right) &&
+        ctop    >= MIN (top, bottom) &&
+        cbottom <= MAX (top, bottom))
+    {
+      result = g_list_prepend (result, object);
+    }
+  }
+
+  g_list_free (list);
+
+  return g_list_reverse (result);
+}
+
+
+/* Distance of an object found by lepton_page_objects_near_point(). */
+typedef struct
+{
+  LeptonObject *object;
+  double distance;
+  int order;
+} NearObject;
+
+static gint
+compare_near_objects (gconstpointer a, gconstpointer b)
+{
+  const NearObject *near_a = (const NearObject*) a;
+  const NearObject *near_b = (const NearObject*) b;
+
+  if (near_a->distance != near_b->distance) {
+    return (near_a->distance < near_b->distance) ? -1 : 1;
+  }
+
+  return near_a->order - near_b->order;
+}
+
+/*! \brief Find the objects near a given point
+ *  \par Function Description
+ *  Finds the objects on the page whose visible bounds are not
+ *  farther than \a radius from the given point.  The objects are
+ *  returned nearest first, by the distance of their bounds from the
+ *  point.  Objects at the same distance are returned in the order
+ *  they are drawn.
+ *
+ *  \param [in] page           The page to search.
+ *  \param [in] x              The X coordinate of the point.
+ *  \param [in] y              The Y coordinate of the point.
+ *  \param [in] radius         The search radius.
+ *  \param [in] include_hidden Calculate bounds of hidden objects.
+ *  \return The GList of LeptonObjects near the point.
+ */
+GList*
+lepton_page_objects_near_point (LeptonPage *page,
+                                int x,
+                                int y,
+                                int radius,
+                                gboolean include_hidden)
+{
+  GList *list;
+  GList *iter;
+  GList *result = NULL;
+  GArray *near;
+  int order = 0;
+  guint i;
+
+  g_return_val_if_fail (page != NULL, NULL);
+  g_return_val_if_fail (radius >= 0, NULL);
+
+  list = lepton_page_objects_in_rect (page,
+                                      x - radius,
+                                      y - radius,
+                                      x + radius,
+                                      y + radius,
+                                      include_hidden);
+
+  near = g_array_new (FALSE, FALSE, sizeof (NearObject));
+
+  for (iter = list; iter != NULL; iter = g_list_next (iter)) {
     LeptonObject *object = (LeptonObject*) iter->data;
     int left, top, right, bottom;
-    int visible;
-
-    visible = lepton_object_calculate_visible_bounds (object,
-                                                      include_hidden,
-                                                      &left,
-                                                      &top,
-                                                      &right,
-                                                      &bottom);
-    if (visible) {
-      for (i = 0; i < n_rects; i++) {
-        if (right  >= rects[i].lower_x &&
-            left   <= rects[i].upper_x &&
-            top    <= rects[i].upper_y &&
-            bottom >= rects[i].lower_y) {
-          list = g_list_prepend (list, object);
-          break;
-        }
-      }
+    NearObject near_object;
+
+    if (!lepton_object_calculate_visible_bounds (object,
+                                                 include_hidden,
+                                                 &left,
+                                                 &top,
+                                                 &right,
+                                                 &bottom)) {
+      continue;
+    }
+
+    near_object.object = object;
+    near_object.distance = hypot (MAX (MAX (left - x, x - right), 0),
+                                  MAX (MAX (top - y, y - bottom), 0));
+    near_object.order = order++;
+
+    if (near_object.distance <= radius) {
+      g_array_append_val (near, near_object);
     }
   }
 
-  list = g_list_reverse (list);
-  return list;
+  g_list_free (list);
+
+  g_array_sort (near, compare_near_objects);
+
+  for (i = near->len; i > 0; i--) {
+    result = g_list_prepend (result,
+                             g_array_index (near, NearObject, i - 1).object);
+  }
+
+  g_array_free (near, TRUE);
+
+  return result;
+}
+
+/*! \brief Find the text objects containing a given string
+ *  \par Function Description
+ *  Finds the text objects on the page whose string contains \a
+ *  substring.  The search uses the text index of the page, so it
+ *  is fast even on pages with many texts.  Texts inside components
+ *  are not searched.  The objects are returned in the order they
+ *  are drawn.  If \a substring is empty, all text objects of the
+ *  page are returned.
+ *
+ *  \param [in] page      The page to search.
+ *  \param [in] substring The string to search for.
+ *  \return The GList of text LeptonObjects found.
+ */
+GList*
+lepton_page_texts_containing (LeptonPage *page,
+                              const gchar *substring)
+{
+  g_return_val_if_fail (page != NULL, NULL);
+  g_return_val_if_fail (substring != NULL, NULL);
+
+  return s_text_index_find (page, substring);
 }
 
 /*! \brief Get the file path associated with a page
@@ -992,6 +992,26 @@ GList *s_clib_source_get_symbols (const CLibSource *source)
   return g_list_copy(source->symbols);
 }
 
+/*! \brief Get a symbol of a given source by name.
+ *  \par Function Description
+ *  Unlike s_clib_get_symbol_by_name(), only looks for the symbol in
+ *  \a source.
+ *
+ *  \warning The returned symbol will not be valid over a call to
+ *  s_clib_refresh().
+ *
+ *  \param source Source to be examined.
+ *  \param name   The name of the symbol.
+ *  \return The #CLibSymbol named \a name, or \b NULL if \a source
+ *          has no such symbol.
+ */
+const CLibSymbol *s_clib_source_get_symbol_by_name (const CLibSource *source,
+                                                    const gchar *name)
+{
+  if ((source == NULL) || (name == NULL)) return NULL;
+  return source_has_symbol (source, name);
+}
+
 
 /*! \brief Get the name of a symbol.
  *  \par Function Description
@@ -1098,8 +1118,7 @@ static gchar *get_data_command (const CLibSymbol *symbol)
   g_return_val_if_fail ((symbol != NULL), NULL);
   g_return_val_if_fail ((symbol->source->type == CLIB_CMD), NULL);
 
-  command = g_strdup_printf ("%s %s", symbol->source->get_cmd,
-                          symbol->name);
+  command = s_clib_symbol_get_command (symbol);
 
   result = run_source_command ( command );
 
@@ -1161,7 +1180,6 @@ gchar *s_clib_symbol_get_data (const CLibSymbol *symbol)
   CacheEntry *cached;
   gchar *data;
   gpointer symptr;
-  gint n;
 
   g_return_val_if_fail ((symbol != NULL), NULL);
   g_return_val_if_fail ((symbol->source != NULL), NULL);
@@ -1197,6 +1215,59 @@ gchar *s_clib_symbol_get_data (const CLibSymbol *symbol)
   if (data == NULL) return NULL;
 
   /* Cache the symbol data */
+  s_clib_symbol_set_cached_data (symbol, data);
+
+  return data;
+}
+
+/*! \brief Get symbol data from the symbol cache.
+ *  \par Function Description
+ *  Like s_clib_symbol_get_data(), but never fetches the data from
+ *  the symbol's data source, so that it returns at once.  The
+ *  return value should be free()'d when no longer needed.
+ *
+ *  \param symbol Symbol to get data for.
+ *  \return Allocated buffer containing symbol data, or \b NULL if
+ *          the data of the symbol is not cached.
+ */
+gchar *s_clib_symbol_get_cached_data (const CLibSymbol *symbol)
+{
+  CacheEntry *cached;
+
+  g_return_val_if_fail ((symbol != NULL), NULL);
+
+  cached = (CacheEntry*) g_hash_table_lookup (clib_symbol_cache,
+                                              (gpointer) symbol);
+  if (cached == NULL) return NULL;
+
+  cached->accessed = time(NULL);
+  return g_strdup(cached->data);
+}
+
+/*! \brief Add symbol data to the symbol cache.
+ *  \par Function Description
+ *  Stores \a data as the data of \a symbol, so that the next calls
+ *  to s_clib_symbol_get_data() return it without fetching it from
+ *  the symbol's data source.  This is used by callers fetching the
+ *  data themselves, e.g. in a worker thread.  The least recently
+ *  accessed symbols are dropped if the cache is too full.
+ *
+ *  \param symbol Symbol to set data for.
+ *  \param data   The data of the symbol.
+ */
+void s_clib_symbol_set_cached_data (const CLibSymbol *symbol,
+                                    const gchar *data)
+{
+  CacheEntry *cached;
+  gpointer symptr;
+  gint n;
+
+  g_return_if_fail ((symbol != NULL));
+  g_return_if_fail ((data != NULL));
+
+  /* Trickery to bypass effects of const */
+  symptr = (gpointer) symbol;
+
   cached = g_new (CacheEntry, 1);
   cached->ptr = (CLibSymbol *) symptr;
   cached->data = g_strdup (data);
@@ -1213,8 +1284,26 @@ gchar *s_clib_symbol_get_data (const CLibSymbol *symbol)
       g_hash_table_remove (clib_symbol_cache, cached->ptr);
     }
   }
+}
 
-  return data;
+/*! \brief Get the command printing the data of a symbol.
+ *  \par Function Description
+ *  Get the command line which prints the data of a symbol provided
+ *  by a library command source, as s_clib_symbol_get_data() runs
+ *  it.  The returned string should be freed when no longer needed.
+ *
+ *  \param symbol Symbol to be examined.
+ *  \return The command line, or \b NULL if \a symbol does not come
+ *          from a library command.
+ */
+gchar *s_clib_symbol_get_command (const CLibSymbol *symbol)
+{
+  if (symbol == NULL) return NULL;
+
+  if (symbol->source->type != CLIB_CMD) return NULL;
+
+  return g_strdup_printf ("%s %s", symbol->source->get_cmd,
+                          symbol->name);
 }
 
 /*! \brief Find all symbols matching a pattern.
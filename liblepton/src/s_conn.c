@@ -1,7 +1,7 @@
 /* Lepton EDA library
  * Copyright (C) 1998-2010 Ales Hvezda
  * Copyright (C) 1998-2015 gEDA Contributors
- * Copyright (C) 2017-2021 Lepton EDA Contributors
+ * Copyright (C) 2017-2022 Lepton EDA Contributors
  *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -24,6 +24,9 @@
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 
 #include "liblepton_priv.h"
 
@@ -750,3 +753,274 @@ s_conn_remove_object (LeptonPage* page,
 
   page->connectible_list = g_list_remove (page->connectible_list, object);
 }
+
+
+/*! \brief Add the connectivity of an object to a connectivity export
+ *  \par Function Description
+ *  Appends the indices of the objects connected to \a object, and
+ *  the values of the "netname=" attributes attached to it.
+ *  Connections to objects that are not in \a indices, such as
+ *  buses, are skipped.
+ *
+ *  \param [in] connectivity The connectivity being built.
+ *  \param [in] indices      Hash table of the object indices.
+ *  \param [in] object       The net or pin object.
+ */
+static void
+s_conn_connectivity_add (LeptonConnectivity *connectivity,
+                         GHashTable *indices,
+                         LeptonObject *object)
+{
+  GList *iter;
+  gint32 offset;
+
+  for (iter = object->conn_list; iter != NULL; iter = g_list_next (iter)) {
+    LeptonConn *conn = (LeptonConn *) iter->data;
+    gpointer index;
+
+    if (conn->other_object == NULL || conn->other_object == object) {
+      continue;
+    }
+
+    if (g_hash_table_lookup_extended (indices, conn->other_object,
+                                      NULL, &index)) {
+      gint32 target = GPOINTER_TO_INT (index);
+      g_array_append_val (connectivity->targets, target);
+    }
+  }
+
+  offset = connectivity->targets->len;
+  g_array_append_val (connectivity->offsets, offset);
+
+  for (iter = lepton_object_get_attribs (object);
+       iter != NULL;
+       iter = g_list_next (iter)) {
+    LeptonObject *attrib = (LeptonObject *) iter->data;
+    const gchar *name = lepton_text_object_get_name (attrib);
+    const gchar *value;
+
+    if (name == NULL || strcmp (name, "netname") != 0) {
+      continue;
+    }
+
+    value = lepton_text_object_get_value (attrib);
+    if (value == NULL) {
+      value = "";
+    }
+    g_byte_array_append (connectivity->names,
+                         (const guint8 *) value,
+                         strlen (value) + 1);
+  }
+
+  offset = connectivity->names->len;
+  g_array_append_val (connectivity->name_offsets, offset);
+}
+
+
+/*! \brief Export the connectivity of the nets and pins of a page
+ *  \par Function Description
+ *  Collects the nets of \a page, in the order of the page
+ *  objects, followed by the net pins of its components, in the
+ *  order of the components and of their contents.  For each of
+ *  them, records the indices of the objects of this list it is
+ *  connected to, in the order of its connections, and the values
+ *  of the "netname=" attributes attached to it.
+ *
+ *  The result allows to get the connectivity of the whole page
+ *  with a few calls instead of querying the connections and
+ *  attributes of every object.
+ *
+ *  \param [in] page The page.
+ *  \return A newly allocated LeptonConnectivity which must be
+ *          freed with s_conn_connectivity_free().
+ */
+LeptonConnectivity*
+s_conn_page_connectivity_new (LeptonPage *page)
+{
+  LeptonConnectivity *connectivity;
+  GHashTable *indices;
+  const GList *iter;
+  GList *contents;
+  gint32 offset = 0;
+  guint i;
+
+  g_return_val_if_fail (page != NULL, NULL);
+
+  connectivity = g_new0 (LeptonConnectivity, 1);
+  connectivity->objects = g_ptr_array_new ();
+  connectivity->offsets = g_array_new (FALSE, FALSE, sizeof (gint32));
+  connectivity->targets = g_array_new (FALSE, FALSE, sizeof (gint32));
+  connectivity->name_offsets = g_array_new (FALSE, FALSE, sizeof (gint32));
+  connectivity->names = g_byte_array_new ();
+
+  for (iter = lepton_page_objects (page);
+       iter != NULL;
+       iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject *) iter->data;
+
+    if (lepton_object_is_net (object)) {
+      g_ptr_array_add (connectivity->objects, object);
+    }
+  }
+
+  connectivity->n_nets = connectivity->objects->len;
+
+  for (iter = lepton_page_objects (page);
+       iter != NULL;
+       iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject *) iter->data;
+
+    if (!lepton_object_is_component (object)) {
+      continue;
+    }
+
+    for (contents = lepton_component_object_get_contents (object);
+         contents != NULL;
+         contents = g_list_next (contents)) {
+      LeptonObject *pin = (LeptonObject *) contents->data;
+
+      if (lepton_object_is_pin (pin) && lepton_pin_object_is_net_pin (pin)) {
+        g_ptr_array_add (connectivity->objects, pin);
+      }
+    }
+  }
+
+  indices = g_hash_table_new (NULL, NULL);
+  for (i = 0; i < connectivity->objects->len; i++) {
+    g_hash_table_insert (indices,
+                         g_ptr_array_index (connectivity->objects, i),
+                         GINT_TO_POINTER (i));
+  }
+
+  g_array_append_val (connectivity->offsets, offset);
+  g_array_append_val (connectivity->name_offsets, offset);
+
+  for (i = 0; i < connectivity->objects->len; i++) {
+    s_conn_connectivity_add (connectivity,
+                             indices,
+                             (LeptonObject *) g_ptr_array_index (connectivity->objects, i));
+  }
+
+  g_hash_table_destroy (indices);
+
+  return connectivity;
+}
+
+
+/*! \brief Free a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity to free.
+ */
+void
+s_conn_connectivity_free (LeptonConnectivity *connectivity)
+{
+  if (connectivity == NULL) {
+    return;
+  }
+
+  g_ptr_array_free (connectivity->objects, TRUE);
+  g_array_free (connectivity->offsets, TRUE);
+  g_array_free (connectivity->targets, TRUE);
+  g_array_free (connectivity->name_offsets, TRUE);
+  g_byte_array_free (connectivity->names, TRUE);
+  g_free (connectivity);
+}
+
+
+/*! \brief Get the number of objects of a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The number of nets and pins exported.
+ */
+guint
+s_conn_connectivity_get_n_objects (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, 0);
+
+  return connectivity->objects->len;
+}
+
+
+/*! \brief Get the number of nets of a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The number of nets at the beginning of the objects.
+ */
+guint
+s_conn_connectivity_get_n_nets (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, 0);
+
+  return connectivity->n_nets;
+}
+
+
+/*! \brief Get the objects of a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The array of the LeptonObject pointers.
+ */
+gpointer
+s_conn_connectivity_get_objects (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, NULL);
+
+  return connectivity->objects->pdata;
+}
+
+
+/*! \brief Get the connection offsets of a connectivity export
+ *  \par Function Description
+ *  The connections of the object with index \a i are the elements
+ *  of the targets array from offsets[i] to offsets[i+1] excluded.
+ *
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The array of n_objects + 1 gint32 offsets.
+ */
+gpointer
+s_conn_connectivity_get_offsets (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, NULL);
+
+  return connectivity->offsets->data;
+}
+
+
+/*! \brief Get the connections of a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The array of gint32 indices of connected objects.
+ */
+gpointer
+s_conn_connectivity_get_targets (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, NULL);
+
+  return connectivity->targets->data;
+}
+
+
+/*! \brief Get the netname offsets of a connectivity export
+ *  \par Function Description
+ *  The netnames of the object with index \a i are the NUL
+ *  terminated strings in the names array from name_offsets[i] to
+ *  name_offsets[i+1] excluded.
+ *
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The array of n_objects + 1 gint32 offsets.
+ */
+gpointer
+s_conn_connectivity_get_name_offsets (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, NULL);
+
+  return connectivity->name_offsets->data;
+}
+
+
+/*! \brief Get the netnames of a connectivity export
+ *  \param [in] connectivity The LeptonConnectivity.
+ *  \return The buffer of NUL terminated netname strings.
+ */
+gpointer
+s_conn_connectivity_get_names (const LeptonConnectivity *connectivity)
+{
+  g_return_val_if_fail (connectivity != NULL, NULL);
+
+  return connectivity->names->data;
+}
@@ -0,0 +1,518 @@
+/* Lepton EDA library
+ * Copyright (C) 2026 Lepton EDA Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include <config.h>
+
+#include "liblepton_priv.h"
+
+/*!
+ * \file s_index.c
+ * \brief Spatial index of page objects.
+ *
+ * Each page keeps its objects in a grid of square cells, so that
+ * the objects in a region can be found without walking the whole
+ * object list.  An object is listed in every cell its bounds
+ * touch.  Objects spanning too many cells are kept in a separate
+ * list which is always searched.
+ *
+ * The index is updated lazily.  Objects added to the page or
+ * changed are only marked, and their bounds are calculated on the
+ * next query.  The bounds used for indexing include hidden text,
+ * so that they cover the bounds of the object whatever the
+ * visibility settings of the query are.
+ *
+ * Every object also gets a sequence number reflecting its position
+ * in the object list of the page, so that query results can be
+ * returned in the order the objects are drawn.
+ */
+
+/* Size of an index cell in world units. */
+#define S_INDEX_CELL_SIZE 2000
+
+/* Objects spanning more cells are not put into cells. */
+#define S_INDEX_MAX_CELLS 64
+
+typedef struct
+{
+  LeptonObject *object;
+  guint64 order;          /* Position in the object list */
+  guint stamp;            /* Last query the entry was found by */
+
+  gboolean dirty;         /* Bounds have to be recalculated */
+  gboolean indexed;       /* Entry is in cells or in large list */
+  gboolean large;         /* Entry is in the large list */
+  int first_column;
+  int last_column;
+  int first_row;
+  int last_row;
+} IndexEntry;
+
+struct st_page_index
+{
+  GHashTable *entries;    /* LeptonObject -> IndexEntry */
+  GHashTable *cells;      /* Cell key -> GPtrArray of IndexEntry */
+  GPtrArray *large;       /* Entries not put into cells */
+  GPtrArray *dirty;       /* Entries to recalculate */
+  guint64 next_order;
+  guint stamp;
+};
+
+
+static int
+cell_coord (int world)
+{
+  /* Round towards negative infinity. */
+  return (world >= 0) ? world / S_INDEX_CELL_SIZE
+                      : - ((- world - 1) / S_INDEX_CELL_SIZE) - 1;
+}
+
+
+static gint64
+cell_key (int column, int row)
+{
+  return ((gint64) column << 32) | (guint32) row;
+}
+
+
+static void
+entry_free (IndexEntry *entry)
+{
+  g_slice_free (IndexEntry, entry);
+}
+
+
+/*! \brief Create a new empty spatial index.
+ *
+ * \return The new index.
+ */
+struct st_page_index*
+s_index_new ()
+{
+  struct st_page_index *index = g_new0 (struct st_page_index, 1);
+
+  index->entries = g_hash_table_new_full (NULL,
+                                          NULL,
+                                          NULL,
+                                          (GDestroyNotify) entry_free);
+  index->cells = g_hash_table_new_full (g_int64_hash,
+                                        g_int64_equal,
+                                        g_free,
+                                        (GDestroyNotify) g_ptr_array_unref);
+  index->large = g_ptr_array_new ();
+  index->dirty = g_ptr_array_new ();
+  index->next_order = 0;
+  index->stamp = 0;
+
+  return index;
+}
+
+
+/*! \brief Free a spatial index.
+ *
+ * \param [in] index The index to free.
+ */
+void
+s_index_free (struct st_page_index *index)
+{
+  if (index == NULL) {
+    return;
+  }
+
+  g_hash_table_destroy (index->cells);
+  g_hash_table_destroy (index->entries);
+  g_ptr_array_free (index->large, TRUE);
+  g_ptr_array_free (index->dirty, TRUE);
+  g_free (index);
+}
+
+
+/* Remove an entry from the cells it is listed in. */
+static void
+unlink_entry (struct st_page_index *index, IndexEntry *entry)
+{
+  int column, row;
+
+  if (!entry->indexed) {
+    return;
+  }
+
+  if (entry->large) {
+    g_ptr_array_remove_fast (index->large, entry);
+  } else {
+    for (row = entry->first_row; row <= entry->last_row; row++) {
+      for (column = entry->first_column; column <= entry->last_column; column++) {
+        gint64 key = cell_key (column, row);
+        GPtrArray *cell = (GPtrArray*) g_hash_table_lookup (index->cells, &key);
+
+        if (cell != NULL) {
+          g_ptr_array_remove_fast (cell, entry);
+          if (cell->len == 0) {
+            g_hash_table_remove (index->cells, &key);
+          }
+        }
+      }
+    }
+  }
+
+  entry->indexed = FALSE;
+}
+
+
+/* Recalculate the bounds of an entry and list it in the cells
+ * they touch. */
+static void
+link_entry (struct st_page_index *index, IndexEntry *entry)
+{
+  int left, top, right, bottom;
+  int column, row;
+
+  if (!lepton_object_calculate_visible_bounds (entry->object,
+                                               TRUE,
+                                               &left,
+                                               &top,
+                                               &right,
+                                               &bottom)) {
+    return;
+  }
+
+  entry->first_column = cell_coord (left);
+  entry->last_column = cell_coord (right);
+  entry->first_row = cell_coord (top);
+  entry->last_row = cell_coord (bottom);
+  entry->indexed = TRUE;
+
+  entry->large =
+    ((gint64) (entry->last_column - entry->first_column + 1)
+     * (entry->last_row - entry->first_row + 1)) > S_INDEX_MAX_CELLS;
+
+  if (entry->large) {
+    g_ptr_array_add (index->large, entry);
+    return;
+  }
+
+  for (row = entry->first_row; row <= entry->last_row; row++) {
+    for (column = entry->first_column; column <= entry->last_column; column++) {
+      gint64 key = cell_key (column, row);
+      GPtrArray *cell = (GPtrArray*) g_hash_table_lookup (index->cells, &key);
+
+      if (cell == NULL) {
+        gint64 *new_key = g_new (gint64, 1);
+        *new_key = key;
+        cell = g_ptr_array_new ();
+        g_hash_table_insert (index->cells, new_key, cell);
+      }
+
+      g_ptr_array_add (cell, entry);
+    }
+  }
+}
+
+
+static void
+mark_dirty (struct st_page_index *index, IndexEntry *entry)
+{
+  if (!entry->dirty) {
+    entry->dirty = TRUE;
+    g_ptr_array_add (index->dirty, entry);
+  }
+}
+
+
+/* Bring the cells up to date with the changed objects. */
+static void
+flush_dirty (struct st_page_index *index)
+{
+  guint i;
+
+  for (i = 0; i < index->dirty->len; i++) {
+    IndexEntry *entry = (IndexEntry*) g_ptr_array_index (index->dirty, i);
+
+    unlink_entry (index, entry);
+    link_entry (index, entry);
+    entry->dirty = FALSE;
+  }
+
+  g_ptr_array_set_size (index->dirty, 0);
+}
+
+
+/*! \brief Add an object to the spatial index of its page.
+ * \par Function Description
+ * Called after \a object has been appended to \a page.  If the
+ * object is already indexed, it is only marked as changed.
+ *
+ * \param [in] page   The page the object was added to.
+ * \param [in] object The object.
+ */
+void
+s_index_add_object (LeptonPage *page, LeptonObject *object)
+{
+  struct st_page_index *index = page->_index;
+  IndexEntry *entry;
+
+  entry = (IndexEntry*) g_hash_table_lookup (index->entries, object);
+
+  if (entry == NULL) {
+    entry = g_slice_new0 (IndexEntry);
+    entry->object = object;
+    entry->order = index->next_order++;
+    g_hash_table_insert (index->entries, object, entry);
+  }
+
+  mark_dirty (index, entry);
+}
+
+
+/*! \brief Remove an object from the spatial index of its page.
+ * \par Function Description
+ * Called just before \a object is removed from \a page.
+ *
+ * \param [in] page   The page the object is removed from.
+ * \param [in] object The object.
+ */
+void
+s_index_remove_object (LeptonPage *page, LeptonObject *object)
+{
+  struct st_page_index *index = page->_index;
+  IndexEntry *entry;
+
+  entry = (IndexEntry*) g_hash_table_lookup (index->entries, object);
+
+  if (entry == NULL) {
+    return;
+  }
+
+  unlink_entry (index, entry);
+  if (entry->dirty) {
+    g_ptr_array_remove_fast (index->dirty, entry);
+  }
+  g_hash_table_remove (index->entries, object);
+}
+
+
+/*! \brief Replace an object in the spatial index of its page.
+ * \par Function Description
+ * Makes \a new_object take over the position of \a old_object in
+ * the drawing order.  Called before \a old_object is replaced by
+ * \a new_object in the object list of \a page.
+ *
+ * \param [in] page       The page.
+ * \param [in] old_object The object being replaced.
+ * \param [in] new_object The replacing object.
+ */
+void
+s_index_replace_object (LeptonPage *page,
+                        LeptonObject *old_object,
+                        LeptonObject *new_object)
+{
+  struct st_page_index *index = page->_index;
+  IndexEntry *entry;
+
+  entry = (IndexEntry*) g_hash_table_lookup (index->entries, old_object);
+
+  if (entry == NULL || g_hash_table_contains (index->entries, new_object)) {
+    return;
+  }
+
+  g_hash_table_steal (index->entries, old_object);
+  entry->object = new_object;
+  g_hash_table_insert (index->entries, new_object, entry);
+
+  mark_dirty (index, entry);
+}
+
+
+/*! \brief Notify the spatial index that an object has changed.
+ * \par Function Description
+ * Marks the toplevel object containing \a object for recalculation
+ * of its bounds.  Does nothing if the object is not on a page.
+ *
+ * \param [in] object The changed object.
+ */
+void
+s_index_object_changed (LeptonObject *object)
+{
+  IndexEntry *entry;
+
+  while (object->parent != NULL) {
+    object = object->parent;
+  }
+
+  if (object->page == NULL || object->page->_index == NULL) {
+    return;
+  }
+
+  entry = (IndexEntry*) g_hash_table_lookup (object->page->_index->entries,
+                                             object);
+  if (entry != NULL) {
+    mark_dirty (object->page->_index, entry);
+  }
+}
+
+
+static gint
+compare_order (gconstpointer a, gconstpointer b)
+{
+  const IndexEntry *entry_a = *((const IndexEntry**) a);
+  const IndexEntry *entry_b = *((const IndexEntry**) b);
+
+  if (entry_a->order < entry_b->order) {
+    return -1;
+  }
+
+  return (entry_a->order > entry_b->order) ? 1 : 0;
+}
+
+
+/* Test whether the visible bounds of \a object intersect any of
+ * \a rects. */
+static gboolean
+object_in_regions (LeptonObject *object,
+                   LeptonBox *rects,
+                   int n_rects,
+                   gboolean include_hidden)
+{
+  int left, top, right, bottom;
+  int i;
+
+  if (!lepton_object_calculate_visible_bounds (object,
+                                               include_hidden,
+                                               &left,
+                                               &top,
+                                               &right,
+                                               &bottom)) {
+    return FALSE;
+  }
+
+  for (i = 0; i < n_rects; i++) {
+    if (right  >= rects[i].lower_x &&
+        left   <= rects[i].upper_x &&
+        top    <= rects[i].upper_y &&
+        bottom >= rects[i].lower_y) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+
+/* Add the unvisited entries of \a array to \a candidates. */
+static void
+collect_entries (struct st_page_index *index,
+                 GPtrArray *array,
+                 GPtrArray *candidates)
+{
+  guint i;
+
+  for (i = 0; i < array->len; i++) {
+    IndexEntry *entry = (IndexEntry*) g_ptr_array_index (array, i);
+
+    if (entry->stamp != index->stamp) {
+      entry->stamp = index->stamp;
+      g_ptr_array_add (candidates, entry);
+    }
+  }
+}
+
+
+/*! \brief Find the objects in given regions of a page.
+ * \par Function Description
+ * Looks up the cells of the index touched by \a rects and returns
+ * the objects listed in them whose visible bounds intersect any of
+ * the regions.  The objects are returned in the order of the
+ * object list of the page.  If the regions cover more cells than
+ * there are objects, the object list is walked instead.
+ *
+ * \param [in] page           The page.
+ * \param [in] rects          The regions to search.
+ * \param [in] n_rects        The number of regions.
+ * \param [in] include_hidden Calculate bounds of hidden objects.
+ * \return The GList of objects found.
+ */
+GList*
+s_index_objects_in_regions (LeptonPage *page,
+                            LeptonBox *rects,
+                            int n_rects,
+                            gboolean include_hidden)
+{
+  struct st_page_index *index = page->_index;
+  GPtrArray *candidates;
+  GList *list = NULL;
+  const GList *iter;
+  gint64 n_cells = 0;
+  int i;
+  guint j;
+
+  for (i = 0; i < n_rects; i++) {
+    n_cells +=
+      ((gint64) cell_coord (rects[i].upper_x) - cell_coord (rects[i].lower_x) + 1)
+      * ((gint64) cell_coord (rects[i].upper_y) - cell_coord (rects[i].lower_y) + 1);
+  }
+
+  if (n_cells > g_hash_table_size (index->entries)) {
+    for (iter = page->_object_list; iter != NULL; iter = g_list_next (iter)) {
+      LeptonObject *object = (LeptonObject*) iter->data;
+
+      if (object_in_regions (object, rects, n_rects, include_hidden)) {
+        list = g_list_prepend (list, object);
+      }
+    }
+
+    return g_list_reverse (list);
+  }
+
+  flush_dirty (index);
+
+  index->stamp++;
+  candidates = g_ptr_array_new ();
+
+  collect_entries (index, index->large, candidates);
+
+  for (i = 0; i < n_rects; i++) {
+    int column, row;
+    int first_column = cell_coord (rects[i].lower_x);
+    int last_column = cell_coord (rects[i].upper_x);
+    int first_row = cell_coord (rects[i].lower_y);
+    int last_row = cell_coord (rects[i].upper_y);
+
+    for (row = first_row; row <= last_row; row++) {
+      for (column = first_column; column <= last_column; column++) {
+        gint64 key = cell_key (column, row);
+        GPtrArray *cell = (GPtrArray*) g_hash_table_lookup (index->cells, &key);
+
+        if (cell != NULL) {
+          collect_entries (index, cell, candidates);
+        }
+      }
+    }
+  }
+
+  g_ptr_array_sort (candidates, compare_order);
+
+  for (j = candidates->len; j > 0; j--) {
+    IndexEntry *entry = (IndexEntry*) g_ptr_array_index (candidates, j - 1);
+
+    if (object_in_regions (entry->object, rects, n_rects, include_hidden)) {
+      list = g_list_prepend (list, entry->object);
+    }
+  }
+
+  g_ptr_array_free (candidates, TRUE);
+
+  return list;
+}
@@ -0,0 +1,411 @@
+/* Lepton EDA library
+ * Copyright (C) 2026 Lepton EDA Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include <config.h>
+
+#include <string.h>
+
+#include "liblepton_priv.h"
+
+/*!
+ * \file s_text_index.c
+ * \brief Trigram index of the text objects of a page.
+ *
+ * Each page keeps its text objects in an index keyed by the
+ * trigrams (sequences of three bytes) of their strings.  A text
+ * containing a given substring contains all trigrams of the
+ * substring, so the texts to check are found by looking up the
+ * rarest trigram of the substring instead of walking the whole
+ * object list.
+ *
+ * Like the spatial index, the trigram index is updated lazily.
+ * Text objects added to the page or changed are only marked, and
+ * they are indexed again on the next query.  Every text object
+ * gets a sequence number reflecting its position in the object
+ * list of the page, so that query results can be returned in the
+ * order of the list.
+ */
+
+typedef struct
+{
+  LeptonObject *object;
+  guint64 order;          /* Position in the object list */
+  gchar *string;          /* String the entry is indexed by */
+  gboolean dirty;         /* String has to be indexed again */
+} TextIndexEntry;
+
+struct st_page_text_index
+{
+  GHashTable *entries;    /* LeptonObject -> TextIndexEntry */
+  GHashTable *trigrams;   /* Trigram -> GHashTable set of TextIndexEntry */
+  GPtrArray *dirty;       /* Entries to index again */
+  guint64 next_order;
+};
+
+
+/* Pack the three bytes at \a str into a trigram key.  None of
+ * the bytes is zero, so no key is zero. */
+static gpointer
+trigram_key (const gchar *str)
+{
+  return GUINT_TO_POINTER (((guint) (guchar) str[0] << 16)
+                           | ((guint) (guchar) str[1] << 8)
+                           | (guint) (guchar) str[2]);
+}
+
+
+static void
+entry_free (TextIndexEntry *entry)
+{
+  g_free (entry->string);
+  g_slice_free (TextIndexEntry, entry);
+}
+
+
+/*! \brief Create a new empty text index.
+ *
+ * \return The new index.
+ */
+struct st_page_text_index*
+s_text_index_new ()
+{
+  struct st_page_text_index *index = g_new0 (struct st_page_text_index, 1);
+
+  index->entries = g_hash_table_new_full (NULL,
+                                          NULL,
+                                          NULL,
+                                          (GDestroyNotify) entry_free);
+  index->trigrams = g_hash_table_new_full (NULL,
+                                           NULL,
+                                           NULL,
+                                           (GDestroyNotify) g_hash_table_destroy);
+  index->dirty = g_ptr_array_new ();
+  index->next_order = 0;
+
+  return index;
+}
+
+
+/*! \brief Free a text index.
+ *
+ * \param [in] index The index to free.
+ */
+void
+s_text_index_free (struct st_page_text_index *index)
+{
+  if (index == NULL) {
+    return;
+  }
+
+  g_hash_table_destroy (index->trigrams);
+  g_hash_table_destroy (index->entries);
+  g_ptr_array_free (index->dirty, TRUE);
+  g_free (index);
+}
+
+
+/* Remove an entry from the sets of the trigrams of its string. */
+static void
+unlink_entry (struct st_page_text_index *index, TextIndexEntry *entry)
+{
+  size_t i, length;
+
+  if (entry->string == NULL) {
+    return;
+  }
+
+  length = strlen (entry->string);
+
+  for (i = 0; i + 3 <= length; i++) {
+    gpointer key = trigram_key (entry->string + i);
+    GHashTable *set = (GHashTable*) g_hash_table_lookup (index->trigrams, key);
+
+    if (set != NULL) {
+      g_hash_table_remove (set, entry);
+      if (g_hash_table_size (set) == 0) {
+        g_hash_table_remove (index->trigrams, key);
+      }
+    }
+  }
+
+  g_free (entry->string);
+  entry->string = NULL;
+}
+
+
+/* Add an entry to the sets of the trigrams of the current string
+ * of its object. */
+static void
+link_entry (struct st_page_text_index *index, TextIndexEntry *entry)
+{
+  const gchar *string = lepton_text_object_get_string (entry->object);
+  size_t i, length;
+
+  if (string == NULL) {
+    return;
+  }
+
+  entry->string = g_strdup (string);
+  length = strlen (string);
+
+  for (i = 0; i + 3 <= length; i++) {
+    gpointer key = trigram_key (string + i);
+    GHashTable *set = (GHashTable*) g_hash_table_lookup (index->trigrams, key);
+
+    if (set == NULL) {
+      set = g_hash_table_new (NULL, NULL);
+      g_hash_table_insert (index->trigrams, key, set);
+    }
+
+    g_hash_table_add (set, entry);
+  }
+}
+
+
+static void
+mark_dirty (struct st_page_text_index *index, TextIndexEntry *entry)
+{
+  if (!entry->dirty) {
+    entry->dirty = TRUE;
+    g_ptr_array_add (index->dirty, entry);
+  }
+}
+
+
+/* Bring the trigram sets up to date with the changed objects. */
+static void
+flush_dirty (struct st_page_text_index *index)
+{
+  guint i;
+
+  for (i = 0; i < index->dirty->len; i++) {
+    TextIndexEntry *entry = (TextIndexEntry*) g_ptr_array_index (index->dirty, i);
+
+    unlink_entry (index, entry);
+    link_entry (index, entry);
+    entry->dirty = FALSE;
+  }
+
+  g_ptr_array_set_size (index->dirty, 0);
+}
+
+
+/*! \brief Add an object to the text index of its page.
+ * \par Function Description
+ * Called after \a object has been appended to \a page.  Objects
+ * other than text are ignored.  If the object is already indexed,
+ * it is only marked as changed.
+ *
+ * \param [in] page   The page the object was added to.
+ * \param [in] object The object.
+ */
+void
+s_text_index_add_object (LeptonPage *page, LeptonObject *object)
+{
+  struct st_page_text_index *index = page->_text_index;
+  TextIndexEntry *entry;
+
+  if (!lepton_object_is_text (object)) {
+    return;
+  }
+
+  entry = (TextIndexEntry*) g_hash_table_lookup (index->entries, object);
+
+  if (entry == NULL) {
+    entry = g_slice_new0 (TextIndexEntry);
+    entry->object = object;
+    entry->order = index->next_order++;
+    g_hash_table_insert (index->entries, object, entry);
+  }
+
+  mark_dirty (index, entry);
+}
+
+
+/*! \brief Remove an object from the text index of its page.
+ * \par Function Description
+ * Called just before \a object is removed from \a page.
+ *
+ * \param [in] page   The page the object is removed from.
+ * \param [in] object The object.
+ */
+void
+s_text_index_remove_object (LeptonPage *page, LeptonObject *object)
+{
+  struct st_page_text_index *index = page->_text_index;
+  TextIndexEntry *entry;
+
+  entry = (TextIndexEntry*) g_hash_table_lookup (index->entries, object);
+
+  if (entry == NULL) {
+    return;
+  }
+
+  unlink_entry (index, entry);
+  if (entry->dirty) {
+    g_ptr_array_remove_fast (index->dirty, entry);
+  }
+  g_hash_table_remove (index->entries, object);
+}
+
+
+/*! \brief Replace an object in the text index of its page.
+ * \par Function Description
+ * Makes \a new_object take over the position of \a old_object in
+ * the object list order.  Called before \a old_object is replaced
+ * by \a new_object in the object list of \a page.
+ *
+ * \param [in] page       The page.
+ * \param [in] old_object The object being replaced.
+ * \param [in] new_object The replacing object.
+ */
+void
+s_text_index_replace_object (LeptonPage *page,
+                             LeptonObject *old_object,
+                             LeptonObject *new_object)
+{
+  struct st_page_text_index *index = page->_text_index;
+  TextIndexEntry *entry;
+
+  entry = (TextIndexEntry*) g_hash_table_lookup (index->entries, old_object);
+
+  if (entry == NULL
+      || !lepton_object_is_text (new_object)
+      || g_hash_table_contains (index->entries, new_object)) {
+    return;
+  }
+
+  g_hash_table_steal (index->entries, old_object);
+  entry->object = new_object;
+  g_hash_table_insert (index->entries, new_object, entry);
+
+  mark_dirty (index, entry);
+}
+
+
+/*! \brief Notify the text index that an object has changed.
+ * \par Function Description
+ * Marks \a object for indexing its string again if it is a text
+ * object on a page.  Texts inside components are not indexed.
+ *
+ * \param [in] object The changed object.
+ */
+void
+s_text_index_object_changed (LeptonObject *object)
+{
+  TextIndexEntry *entry;
+
+  if (object->page == NULL || object->page->_text_index == NULL) {
+    return;
+  }
+
+  entry = (TextIndexEntry*) g_hash_table_lookup (object->page->_text_index->entries,
+                                                 object);
+  if (entry != NULL) {
+    mark_dirty (object->page->_text_index, entry);
+  }
+}
+
+
+static gint
+compare_order (gconstpointer a, gconstpointer b)
+{
+  const TextIndexEntry *entry_a = *((const TextIndexEntry**) a);
+  const TextIndexEntry *entry_b = *((const TextIndexEntry**) b);
+
+  if (entry_a->order < entry_b->order) {
+    return -1;
+  }
+
+  return (entry_a->order > entry_b->order) ? 1 : 0;
+}
+
+
+static void
+collect_entry (gpointer key, gpointer value, gpointer user_data)
+{
+  g_ptr_array_add ((GPtrArray*) user_data, value);
+}
+
+
+/*! \brief Find the text objects of a page containing a substring.
+ * \par Function Description
+ * Looks up the trigrams of \a substring and checks only the texts
+ * having the rarest of them.  If \a substring is shorter than a
+ * trigram, all text objects of the page are checked.  The objects
+ * are returned in the order of the object list of the page.
+ *
+ * \param [in] page      The page.
+ * \param [in] substring The substring to search for.
+ * \return The GList of text objects found.
+ */
+GList*
+s_text_index_find (LeptonPage *page, const gchar *substring)
+{
+  struct st_page_text_index *index = page->_text_index;
+  GHashTable *candidates = index->entries;
+  GPtrArray *entries;
+  GList *list = NULL;
+  size_t i, length;
+  guint j;
+
+  flush_dirty (index);
+
+  length = strlen (substring);
+
+  for (i = 0; i + 3 <= length; i++) {
+    GHashTable *set =
+      (GHashTable*) g_hash_table_lookup (index->trigrams,
+                                         trigram_key (substring + i));
+
+    if (set == NULL) {
+      return NULL;
+    }
+
+    if (g_hash_table_size (set) < g_hash_table_size (candidates)) {
+      candidates = set;
+    }
+  }
+
+  entries = g_ptr_array_sized_new (g_hash_table_size (candidates));
+
+  if (candidates == index->entries) {
+    g_hash_table_foreach (candidates, collect_entry, entries);
+  } else {
+    GHashTableIter iter;
+    gpointer entry;
+
+    g_hash_table_iter_init (&iter, candidates);
+    while (g_hash_table_iter_next (&iter, &entry, NULL)) {
+      g_ptr_array_add (entries, entry);
+    }
+  }
+
+  g_ptr_array_sort (entries, compare_order);
+
+  for (j = entries->len; j > 0; j--) {
+    TextIndexEntry *entry = (TextIndexEntry*) g_ptr_array_index (entries, j - 1);
+
+    if (entry->string != NULL && strstr (entry->string, substring) != NULL) {
+      list = g_list_prepend (list, entry->object);
+    }
+  }
+
+  g_ptr_array_free (entries, TRUE);
+
+  return list;
+}
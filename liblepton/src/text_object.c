@@ -703,6 +703,7 @@ lepton_text_object_recreate (LeptonObject *o_current)
   g_return_if_fail (o_current->text != NULL);
 
   lepton_object_emit_pre_change_notify (o_current);
+  eda_renderer_invalidate_text (o_current);
   lepton_object_emit_change_notify (o_current);
 }
 
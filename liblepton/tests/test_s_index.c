@@ -0,0 +1,282 @@
+#include <liblepton.h>
+#include <version.h>
+
+/* Number of lines put on the test page. */
+#define LINE_COUNT 500
+
+static LeptonObject*
+random_line ()
+{
+  gint x0 = g_test_rand_int_range (-50000, 50000);
+  gint y0 = g_test_rand_int_range (-50000, 50000);
+  /* Most lines are short, and some span so many cells of the index
+   * that they are kept in its list of large objects. */
+  gint length = (g_test_rand_int_range (0, 10) == 0)
+    ? 200000 : g_test_rand_int_range (0, 5000);
+  gint x1 = x0 + g_test_rand_int_range (-length, length + 1);
+  gint y1 = y0 + g_test_rand_int_range (-length, length + 1);
+
+  return lepton_line_object_new (g_test_rand_int_range (0, colors_count()),
+                                 x0, y0, x1, y1);
+}
+
+/* Find the objects in the regions by walking the object list. */
+static GList*
+objects_in_regions (LeptonPage *page, LeptonBox *rects, int n_rects)
+{
+  GList *list = NULL;
+  const GList *iter;
+  int i;
+
+  for (iter = lepton_page_objects (page); iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+    gint left, top, right, bottom;
+
+    if (!lepton_object_calculate_visible_bounds (object, FALSE,
+                                                 &left, &top, &right, &bottom)) {
+      continue;
+    }
+
+    for (i = 0; i < n_rects; i++) {
+      if (right  >= rects[i].lower_x &&
+          left   <= rects[i].upper_x &&
+          top    <= rects[i].upper_y &&
+          bottom >= rects[i].lower_y) {
+        list = g_list_append (list, object);
+        break;
+      }
+    }
+  }
+
+  return list;
+}
+
+static void
+assert_lists_equal (GList *list0, GList *list1)
+{
+  g_assert_cmpint (g_list_length (list0), ==, g_list_length (list1));
+
+  for (; list0 != NULL; list0 = list0->next, list1 = list1->next) {
+    g_assert (list0->data == list1->data);
+  }
+}
+
+static void
+random_rect (LeptonBox *rect, gint size)
+{
+  rect->lower_x = g_test_rand_int_range (-60000, 60000);
+  rect->lower_y = g_test_rand_int_range (-60000, 60000);
+  rect->upper_x = rect->lower_x + g_test_rand_int_range (0, size);
+  rect->upper_y = rect->lower_y + g_test_rand_int_range (0, size);
+}
+
+/* Compare the results of the index with the ones of a list walk
+ * for random regions. */
+static void
+check_queries (LeptonPage *page)
+{
+  gint count;
+
+  for (count = 0; count < 100; count++) {
+    LeptonBox rects[2];
+    GList *expected;
+    GList *found;
+
+    random_rect (&rects[0], 10000);
+    random_rect (&rects[1], 10000);
+
+    expected = objects_in_regions (page, rects, 1);
+    found = lepton_page_objects_in_rect (page,
+                                         rects[0].lower_x,
+                                         rects[0].upper_y,
+                                         rects[0].upper_x,
+                                         rects[0].lower_y,
+                                         FALSE);
+    assert_lists_equal (expected, found);
+    g_list_free (expected);
+    g_list_free (found);
+
+    expected = objects_in_regions (page, rects, 2);
+    found = lepton_page_objects_in_regions (page, rects, 2, FALSE);
+    assert_lists_equal (expected, found);
+    g_list_free (expected);
+    g_list_free (found);
+  }
+}
+
+static LeptonPage*
+setup_page (LeptonToplevel *toplevel)
+{
+  LeptonPage *page = lepton_page_new (toplevel, "test.sch");
+  gint count;
+
+  lepton_toplevel_set_page_current (toplevel, page);
+
+  for (count = 0; count < LINE_COUNT; count++) {
+    lepton_page_append (page, random_line ());
+  }
+
+  return page;
+}
+
+static void
+teardown_page (LeptonToplevel *toplevel, LeptonPage *page)
+{
+  lepton_page_delete (toplevel, page);
+  lepton_toplevel_delete (toplevel);
+}
+
+void
+check_add ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+
+  check_queries (page);
+
+  /* Objects added after the first query. */
+  lepton_page_append (page, random_line ());
+  lepton_page_append (page, random_line ());
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_move ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  const GList *iter;
+
+  check_queries (page);
+
+  for (iter = lepton_page_objects (page); iter != NULL; iter = iter->next) {
+    if (g_test_rand_int_range (0, 4) == 0) {
+      lepton_object_translate ((LeptonObject*) iter->data,
+                               g_test_rand_int_range (-20000, 20000),
+                               g_test_rand_int_range (-20000, 20000));
+    }
+  }
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_remove ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  GList *objects;
+  GList *iter;
+
+  check_queries (page);
+
+  objects = g_list_copy ((GList*) lepton_page_objects (page));
+  for (iter = objects; iter != NULL; iter = iter->next) {
+    if (g_test_rand_int_range (0, 3) == 0) {
+      LeptonObject *object = (LeptonObject*) iter->data;
+
+      lepton_page_remove (page, object);
+      lepton_object_delete (object);
+    }
+  }
+  g_list_free (objects);
+  check_queries (page);
+
+  /* Remove objects changed since the last query. */
+  objects = g_list_copy ((GList*) lepton_page_objects (page));
+  for (iter = objects; iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (g_test_rand_int_range (0, 3) == 0) {
+      lepton_object_translate (object, 1000, 1000);
+      lepton_page_remove (page, object);
+      lepton_object_delete (object);
+    }
+  }
+  g_list_free (objects);
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_replace ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  GList *objects;
+  GList *iter;
+
+  check_queries (page);
+
+  /* The replacing objects keep the drawing order of the objects
+   * they replace. */
+  objects = g_list_copy ((GList*) lepton_page_objects (page));
+  for (iter = objects; iter != NULL; iter = iter->next) {
+    if (g_test_rand_int_range (0, 3) == 0) {
+      LeptonObject *object = (LeptonObject*) iter->data;
+
+      lepton_page_replace (page, object, random_line ());
+      lepton_object_delete (object);
+    }
+  }
+  g_list_free (objects);
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_fallback ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  gint count;
+
+  /* Regions covering more cells of the index than there are
+   * objects on the page are searched by walking the object
+   * list. */
+  for (count = 0; count < 10; count++) {
+    LeptonBox rect;
+    GList *expected;
+    GList *found;
+
+    random_rect (&rect, 1000000);
+    rect.lower_x -= 1000000;
+    rect.lower_y -= 1000000;
+
+    expected = objects_in_regions (page, &rect, 1);
+    found = lepton_page_objects_in_regions (page, &rect, 1, FALSE);
+    assert_lists_equal (expected, found);
+    g_list_free (expected);
+    g_list_free (found);
+  }
+
+  teardown_page (toplevel, page);
+}
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/geda/liblepton/s_index/add",
+                   check_add);
+
+  g_test_add_func ("/geda/liblepton/s_index/move",
+                   check_move);
+
+  g_test_add_func ("/geda/liblepton/s_index/remove",
+                   check_remove);
+
+  g_test_add_func ("/geda/liblepton/s_index/replace",
+                   check_replace);
+
+  g_test_add_func ("/geda/liblepton/s_index/fallback",
+                   check_fallback);
+
+  return g_test_run ();
+}
@@ -0,0 +1,251 @@
+#include <string.h>
+
+#include <liblepton.h>
+#include <version.h>
+
+static const gchar* strings[] =
+{
+  "",
+  "a",
+  "ab",
+  "abc",
+  "refdes=R1",
+  "refdes=R10",
+  "refdes=C1",
+  "value=10k",
+  "value=1u",
+  "footprint=0805",
+  "netname=abc",
+  "one\ntwo",
+};
+
+#define STRINGS_COUNT (sizeof (strings) / sizeof (gchar*))
+
+static const gchar* substrings[] =
+{
+  "",
+  "a",
+  "1",
+  "ab",
+  "=R",
+  "abc",
+  "R1",
+  "refdes=",
+  "refdes=R1",
+  "value=1",
+  "e\nt",
+  "missing",
+};
+
+#define SUBSTRINGS_COUNT (sizeof (substrings) / sizeof (gchar*))
+
+static LeptonObject*
+new_text (const gchar *string)
+{
+  return lepton_text_object_new (TEXT_COLOR,
+                                 0,
+                                 0,
+                                 LOWER_LEFT,
+                                 0,
+                                 string,
+                                 DEFAULT_TEXT_SIZE,
+                                 VISIBLE,
+                                 SHOW_NAME_VALUE);
+}
+
+/* Find the texts containing the substring by walking the object
+ * list. */
+static GList*
+texts_containing (LeptonPage *page, const gchar *substring)
+{
+  GList *list = NULL;
+  const GList *iter;
+
+  for (iter = lepton_page_objects (page); iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (lepton_object_is_text (object)
+        && strstr (lepton_text_object_get_string (object), substring) != NULL) {
+      list = g_list_append (list, object);
+    }
+  }
+
+  return list;
+}
+
+static void
+assert_lists_equal (GList *list0, GList *list1)
+{
+  g_assert_cmpint (g_list_length (list0), ==, g_list_length (list1));
+
+  for (; list0 != NULL; list0 = list0->next, list1 = list1->next) {
+    g_assert (list0->data == list1->data);
+  }
+}
+
+/* Compare the results of the index with the ones of a list walk
+ * for all substrings. */
+static void
+check_queries (LeptonPage *page)
+{
+  guint i;
+
+  for (i = 0; i < SUBSTRINGS_COUNT; i++) {
+    GList *expected = texts_containing (page, substrings[i]);
+    GList *found = lepton_page_texts_containing (page, substrings[i]);
+
+    assert_lists_equal (expected, found);
+    g_list_free (expected);
+    g_list_free (found);
+  }
+}
+
+static LeptonPage*
+setup_page (LeptonToplevel *toplevel)
+{
+  LeptonPage *page = lepton_page_new (toplevel, "test.sch");
+  guint i;
+
+  lepton_toplevel_set_page_current (toplevel, page);
+
+  for (i = 0; i < STRINGS_COUNT; i++) {
+    lepton_page_append (page, new_text (strings[i]));
+    /* Objects other than texts are not indexed. */
+    lepton_page_append (page, lepton_line_object_new (0, 0, 0, 100, 100));
+  }
+
+  return page;
+}
+
+static void
+teardown_page (LeptonToplevel *toplevel, LeptonPage *page)
+{
+  lepton_page_delete (toplevel, page);
+  lepton_toplevel_delete (toplevel);
+}
+
+void
+check_find ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+
+  /* Substrings shorter than a trigram are searched in all texts. */
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_replace ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  GList *objects;
+  GList *iter;
+  gint count = 0;
+
+  check_queries (page);
+
+  /* The replacing texts keep the order of the texts they
+   * replace. */
+  objects = g_list_copy ((GList*) lepton_page_objects (page));
+  for (iter = objects; iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (lepton_object_is_text (object) && (count++ % 2 == 0)) {
+      lepton_page_replace (page, object, new_text ("refdes=R100"));
+      lepton_object_delete (object);
+    }
+  }
+  g_list_free (objects);
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_change ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  const GList *iter;
+  GList *found;
+
+  check_queries (page);
+
+  /* Changed texts are indexed again by their new strings. */
+  for (iter = lepton_page_objects (page); iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (lepton_object_is_text (object)
+        && strstr (lepton_text_object_get_string (object), "refdes=") != NULL) {
+      lepton_text_object_set_string (object, "device=RESISTOR");
+      lepton_text_object_recreate (object);
+    }
+  }
+
+  found = lepton_page_texts_containing (page, "refdes=");
+  g_assert (found == NULL);
+
+  found = lepton_page_texts_containing (page, "RESISTOR");
+  g_assert_cmpint (g_list_length (found), ==, 3);
+  g_list_free (found);
+
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+void
+check_remove ()
+{
+  LeptonToplevel *toplevel = lepton_toplevel_new ();
+  LeptonPage *page = setup_page (toplevel);
+  GList *objects;
+  GList *iter;
+
+  check_queries (page);
+
+  /* Remove texts changed since the last query. */
+  objects = g_list_copy ((GList*) lepton_page_objects (page));
+  for (iter = objects; iter != NULL; iter = iter->next) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (lepton_object_is_text (object)
+        && strstr (lepton_text_object_get_string (object), "=") != NULL) {
+      lepton_text_object_set_string (object, "removed=abc");
+      lepton_text_object_recreate (object);
+      lepton_page_remove (page, object);
+      lepton_object_delete (object);
+    }
+  }
+  g_list_free (objects);
+
+  objects = lepton_page_texts_containing (page, "=");
+  g_assert (objects == NULL);
+
+  check_queries (page);
+
+  teardown_page (toplevel, page);
+}
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/geda/liblepton/s_text_index/find",
+                   check_find);
+
+  g_test_add_func ("/geda/liblepton/s_text_index/replace",
+                   check_replace);
+
+  g_test_add_func ("/geda/liblepton/s_text_index/change",
+                   check_change);
+
+  g_test_add_func ("/geda/liblepton/s_text_index/remove",
+                   check_remove);
+
+  return g_test_run ();
+}
@@ -27,6 +27,7 @@ typedef struct st_gschem_toplevel GschemToplevel;
 #include "gschem_log_widget.h"
 #include "gschem_macro_widget.h"
 #include "gschem_page_geometry.h"
+#include "schematic_render_cache.h"
 #include "gschem_page_view.h"
 #include "gschem_pin_type_combo.h"
 #include "gschem_main_window.h"
@@ -56,6 +56,18 @@ struct _GschemFindTextState
   GschemBin parent;
 
   GtkListStore *store;
+
+  /* State of the search in progress */
+  guint search_id;
+  GschemToplevel *search_window;
+  GQueue *search_queue;
+  GHashTable *search_visited;
+  gchar *search_literal;
+  GPatternSpec *search_pattern;
+  GRegex *search_regex;
+  gboolean search_descend;
+  gboolean search_include_hidden;
+  int search_count;
 };
 
 
@@ -68,6 +80,12 @@ gschem_find_text_state_find (GschemToplevel *w_current,
                              gboolean descend,
                              gboolean include_hidden);
 
+void
+gschem_find_text_state_cancel (GschemFindTextState *state);
+
+gboolean
+gschem_find_text_state_is_searching (GschemFindTextState *state);
+
 GType
 gschem_find_text_state_get_type ();
 
@@ -54,6 +54,7 @@ struct _GschemPageView
   gboolean configured;
 
   gboolean doing_pan;  /* mouse pan status flag */
+  gboolean reduced_quality;  /* adaptive quality status flag */
   int pan_x;
   int pan_y;
   int throttle;
@@ -64,11 +65,32 @@ struct _GschemPageView
   LeptonPage *_page;
 
   GHashTable *_geometry_cache;
+
+  SchematicRenderCache *_render_cache;
+
+  /* Screen region waiting to be invalidated on the next frame */
+  cairo_region_t *_dirty_region;
+  guint _dirty_flush_id;
+
+  /* Redraw debugging overlay */
+  gboolean _debug_redraw;
+  cairo_region_t *_debug_region;
+  gint64 _debug_redraw_time;
+
+  /* Latest motion event waiting to be processed on the next frame */
+  GdkEvent *_pending_motion;
+  guint _motion_flush_id;
+  gboolean _replaying_motion;
 };
 
 
 G_BEGIN_DECLS
 
+gboolean
+gschem_page_view_coalesce_motion (GschemPageView *view,
+                                  GdkEvent *event,
+                                  gboolean in_action);
+
 GtkAdjustment*
 gschem_page_view_get_hadjustment (GschemPageView *view);
 
@@ -96,6 +118,13 @@ gschem_page_view_invalidate_screen_rect (GschemPageView *view, int left, int top
 void
 gschem_page_view_invalidate_world_rect (GschemPageView *view, int left, int top, int right, int bottom);
 
+void
+gschem_page_view_invalidate_overlay_world_rect (GschemPageView *view,
+                                                int left,
+                                                int top,
+                                                int right,
+                                                int bottom);
+
 GschemPageView*
 gschem_page_view_new_with_page (LeptonPage *page);
 
@@ -109,7 +138,10 @@ void
 gschem_page_view_pan_mouse(GschemPageView *page_view, int diff_x, int diff_y);
 
 void
-gschem_page_view_pan_start(GschemPageView *page_view, int x, int y);
+gschem_page_view_pan_start(GschemPageView *page_view,
+                           int x,
+                           int y,
+                           gboolean fast_pan);
 
 void
 gschem_page_view_pan_motion (GschemPageView *view, int mousepan_gain, int x, int y);
@@ -117,6 +149,9 @@ gschem_page_view_pan_motion (GschemPageView *view, int mousepan_gain, int x, int
 gboolean
 gschem_page_view_pan_end(GschemPageView *page_view);
 
+void
+gschem_page_view_restore_quality (GschemPageView *view);
+
 void
 #ifdef ENABLE_GTK3
 gschem_page_view_redraw (GschemPageView *view,
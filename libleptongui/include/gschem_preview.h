@@ -44,7 +44,14 @@ struct _GschemPreview
   gchar *filename;
   gchar *buffer;
 
+  /* Names of the previewed library symbol and of its source */
+  gchar *symbol_source;
+  gchar *symbol_name;
+
   gboolean active;
+
+  /* Cancels the loading of the file or symbol in progress */
+  GCancellable *cancellable;
 };
 
 GType
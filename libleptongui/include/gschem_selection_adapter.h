@@ -41,6 +41,7 @@
 
 typedef struct _GschemSelectionAdapterClass GschemSelectionAdapterClass;
 typedef struct _GschemSelectionAdapter GschemSelectionAdapter;
+typedef struct _GschemSelectionSummary GschemSelectionSummary;
 
 struct _GschemSelectionAdapterClass
 {
@@ -53,6 +54,9 @@ struct _GschemSelectionAdapter
 
   LeptonSelection *selection;
   LeptonToplevel *toplevel;
+
+  /* Cached summary of the properties of the selected objects */
+  GschemSelectionSummary *summary;
 };
 
 GType
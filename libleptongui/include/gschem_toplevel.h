@@ -201,6 +201,11 @@ struct st_gschem_toplevel {
   int file_preview;       /* controls if the preview area is enabled or not */
   int enforce_hierarchy;  /* controls how much freedom user has when traversing the hierarchy */
   int fast_mousepan;      /* controls if text is completely drawn during mouse pan */
+  int adaptive_quality;   /* controls if quality is lowered during slow interactions */
+  int adaptive_quality_budget; /* redraw time in ms above which quality is lowered */
+  int level_of_detail;    /* controls if too small details are simplified */
+  int level_of_detail_text_height; /* text height in pixels below which text is simplified */
+  int debug_redraw;       /* controls if redrawn regions and redraw time are shown */
 
   int undo_levels;        /* number of undo levels stored on disk */
   int undo_control;       /* sets if undo is enabled or not */
@@ -519,6 +524,8 @@ schematic_window_set_middle_button (GschemToplevel *w_current,
                                     int button);
 int
 schematic_window_get_third_button (GschemToplevel *w_current);
+int
+schematic_window_get_fast_mousepan (GschemToplevel *w_current);
 
 void
 schematic_window_set_third_button (GschemToplevel *w_current,
@@ -23,6 +23,11 @@ extern int default_scroll_wheel;
 extern int default_file_preview;
 extern int default_enforce_hierarchy;
 extern int default_fast_mousepan;
+extern int default_adaptive_quality;
+extern int default_adaptive_quality_budget;
+extern int default_level_of_detail;
+extern int default_level_of_detail_text_height;
+extern int default_debug_redraw;
 extern int default_undo_levels;
 extern int default_undo_control;
 extern int default_undo_type;
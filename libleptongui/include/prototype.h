@@ -151,14 +151,18 @@ o_redraw_rect (GschemToplevel *w_current,
                GtkWidget *widget,
                LeptonPage *page,
                GschemPageGeometry *geometry,
-               cairo_t *cr);
+               cairo_t *cr,
+               SchematicRenderCache *cache,
+               gboolean reduced_quality);
 #else
 void
 o_redraw_rect (GschemToplevel *w_current,
                GdkDrawable *drawable,
                LeptonPage *page,
                GschemPageGeometry *geometry,
-               GdkRectangle *rectangle);
+               GdkRectangle *rectangle,
+               SchematicRenderCache *cache,
+               gboolean reduced_quality);
 #endif
 int o_invalidate_rubber(GschemToplevel *w_current);
 int o_redraw_cleanstates(GschemToplevel *w_current);
@@ -697,6 +701,7 @@ x_window_close_page (GschemToplevel *w_current,
 GschemToplevel*
 x_window_new (LeptonToplevel *toplevel);
 
+void x_window_find_text_finished (GschemFindTextState *state, int count, GschemToplevel *w_current);
 void x_window_select_object (GschemFindTextState *state, LeptonObject *object, GschemToplevel *w_current);
 void x_window_setup_scrolling (GschemToplevel *w_current, GtkWidget *scrolled);
 gboolean
@@ -0,0 +1,100 @@
+/* Lepton EDA Schematic Capture
+ * Copyright (C) 2026 Lepton EDA Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*!
+ * \file schematic_render_cache.h
+ *
+ * \brief Tile cache of the static contents of a page view
+ */
+
+#ifndef SCHEMATIC_RENDER_CACHE_H
+#define SCHEMATIC_RENDER_CACHE_H
+
+/* Size of a cached tile in screen pixels. */
+#define SCHEMATIC_RENDER_CACHE_TILE_SIZE 256
+
+/* Maximum number of tiles kept in the cache. Tiles outside the
+ * visible area are dropped when this limit is exceeded. */
+#define SCHEMATIC_RENDER_CACHE_MAX_TILES 192
+
+typedef struct _SchematicRenderCache SchematicRenderCache;
+
+/*! \brief Callback preparing the rendering of missing tiles.
+ *
+ *  Called by the thread painting the view, with the screen region
+ *  covered by the tiles about to be rendered.
+ */
+typedef void
+(*SchematicRenderCachePrepareFunc) (int x,
+                                    int y,
+                                    int width,
+                                    int height,
+                                    gpointer user_data);
+
+/*! \brief Callback rendering the static contents of a tile.
+ *
+ *  The cairo context passed to the callback has its matrix set up
+ *  to transform world coordinates to the tile pixels.  The region
+ *  is given in device (tile) coordinates.  The callback may be
+ *  called concurrently from several worker threads.
+ */
+typedef void
+(*SchematicRenderCacheDrawFunc) (cairo_t *cr,
+                                 int x,
+                                 int y,
+                                 int width,
+                                 int height,
+                                 gpointer user_data);
+
+G_BEGIN_DECLS
+
+SchematicRenderCache*
+schematic_render_cache_new ();
+
+void
+schematic_render_cache_free (SchematicRenderCache *cache);
+
+void
+schematic_render_cache_invalidate_all (SchematicRenderCache *cache);
+
+void
+schematic_render_cache_invalidate_world_rect (SchematicRenderCache *cache,
+                                              int left,
+                                              int top,
+                                              int right,
+                                              int bottom,
+                                              int bloat);
+
+void
+schematic_render_cache_snap_matrix (cairo_matrix_t *matrix);
+
+void
+schematic_render_cache_paint (SchematicRenderCache *cache,
+                              cairo_t *cr,
+                              const cairo_matrix_t *world_to_screen,
+                              guint stamp,
+                              int x,
+                              int y,
+                              int width,
+                              int height,
+                              SchematicRenderCachePrepareFunc prepare_func,
+                              SchematicRenderCacheDrawFunc draw_func,
+                              gpointer user_data);
+
+G_END_DECLS
+
+#endif /* SCHEMATIC_RENDER_CACHE_H */
@@ -48,6 +48,7 @@ GType compselect_behavior_get_type (void);
 
 typedef struct _CompselectClass CompselectClass;
 typedef struct _Compselect      Compselect;
+typedef struct _CompselectIndex CompselectIndex;
 
 
 struct _CompselectClass {
@@ -67,8 +68,15 @@ struct _Compselect {
   GtkEntry    *entry_filter;
   GtkButton   *button_clear;
   guint        filter_timeout;
+  guint        selection_timeout;
+  GtkTreeSelection *selection_changed;
+  /* Whether the selected symbol is to be placed once previewed */
+  gboolean     place_pending;
   GtkComboBox *combobox_behaviors;
 
+  /* Search index of the library view */
+  CompselectIndex *lib_index;
+
   gboolean hidden;
 };
 
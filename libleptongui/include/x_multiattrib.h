@@ -77,6 +77,11 @@ struct _Multiattrib {
 
   gulong object_list_changed_id;
 
+  /* The toplevel whose object changes are watched */
+  LeptonToplevel *toplevel;
+  /* Source id of the pending update of the dialog */
+  guint update_id;
+
   gboolean add_attr_section_expanded;
 };
 
@@ -221,6 +221,7 @@
             x_window_new
             x_window_open_page
             x_window_save_page
+            *x_window_find_text_finished
             *x_window_select_object
             x_window_set_current_page
             x_window_setup_draw_events_drawing_area
@@ -318,6 +319,7 @@
             lepton_action_create_menu_item
             lepton_menu_set_action_data
 
+            gschem_page_view_coalesce_motion
             gschem_page_view_get_page
             gschem_page_view_get_page_geometry
             gschem_page_view_invalidate_all
@@ -381,6 +383,7 @@
             schematic_window_set_rubber_visible
             schematic_window_get_selection_list
             schematic_window_get_third_button
+            schematic_window_get_fast_mousepan
             schematic_window_get_third_button_cancel
             schematic_window_get_undo_panzoom
             schematic_window_get_undo_type
@@ -622,6 +625,7 @@
 (define-lff macro_widget_show void '(*))
 
 ;;; gschem_page_view.c
+(define-lff gschem_page_view_coalesce_motion int (list '* '* int))
 (define-lff gschem_page_view_get_page '* '(*))
 (define-lff gschem_page_view_get_page_geometry '* '(*))
 (define-lff gschem_page_view_invalidate_all void '(*))
@@ -630,7 +634,7 @@
 (define-lff gschem_page_view_pan_end int '(*))
 (define-lff gschem_page_view_pan_mouse void (list '* int int))
 (define-lff gschem_page_view_pan_motion void (list '* int int int))
-(define-lff gschem_page_view_pan_start void (list '* int int))
+(define-lff gschem_page_view_pan_start void (list '* int int int))
 (define-lff gschem_page_view_SCREENtoWORLD void (list '* int int '* '*))
 (define-lff gschem_page_view_zoom_extents void '(* *))
 (define-lff schematic_page_view_grab_focus void '(*))
@@ -704,6 +708,7 @@
 (define-lff schematic_window_set_rubber_visible void (list '* int))
 (define-lff schematic_window_get_selection_list '* '(*))
 (define-lff schematic_window_get_third_button int '(*))
+(define-lff schematic_window_get_fast_mousepan int '(*))
 (define-lff schematic_window_get_third_button_cancel int '(*))
 (define-lff schematic_window_get_undo_panzoom int '(*))
 (define-lff schematic_window_get_undo_type int '(*))
@@ -776,6 +781,7 @@
 (define-lff x_window_new '* '(*))
 (define-lff x_window_open_page '* '(* *))
 (define-lff x_window_save_page int '(* * *))
+(define-lfc *x_window_find_text_finished)
 (define-lfc *x_window_select_object)
 (define-lff x_window_set_current_page void '(* *))
 (define-lff x_window_setup_draw_events_drawing_area void '(* *))
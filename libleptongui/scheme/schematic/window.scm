@@ -539,7 +539,8 @@
                         ((= middle-button MOUSEBTN_DO_PAN)
                          (gschem_page_view_pan_start *page-view
                                                      (inexact->exact (round window-x))
-                                                     (inexact->exact (round window-y))))
+                                                     (inexact->exact (round window-y))
+                                                     (schematic_window_get_fast_mousepan *window)))
 
                         ((= middle-button MOUSEBTN_DO_POPUP)
                          (i_update_menus *window)
@@ -562,13 +563,15 @@
                          ;; (third-button "mousepan")
                          (gschem_page_view_pan_start *page-view
                                                      (inexact->exact (round window-x))
-                                                     (inexact->exact (round window-y))))
+                                                     (inexact->exact (round window-y))
+                                                     (schematic_window_get_fast_mousepan *window)))
                      (if (and (eq? (schematic_window_get_third_button *window)
                                    MOUSEBTN_DO_PAN)
                               (not (true? (schematic_window_get_third_button_cancel *window))))
                          (gschem_page_view_pan_start *page-view
                                                      (inexact->exact (round window-x))
-                                                     (inexact->exact (round window-y)))
+                                                     (inexact->exact (round window-y))
+                                                     (schematic_window_get_fast_mousepan *window))
                          ;; This is the default cancel.
                          ;; Reset all draw and place actions.
                          (match current-action-mode
@@ -616,7 +619,13 @@
           (begin
             (x_stroke_record *window window-x window-y)
             FALSE)
-          (if (true? (schematic_event_skip_motion_event *event))
+          ;; Skip the event if it is superseded by a later motion
+          ;; event.  While dragging or inside an action, only the
+          ;; latest motion event is processed once per frame.
+          (if (true? (gschem_page_view_coalesce_motion
+                      *page-view
+                      *event
+                      (if (in-action? window) TRUE FALSE)))
               FALSE
 
               (let ((unsnapped-x-bv (make-bytevector (sizeof int) 0))
@@ -1076,6 +1085,10 @@ GtkApplication structure of the program (when compiled with
                                 (string->pointer "select-object")
                                 *x_window_select_object
                                 *window)
+      (schematic_signal_connect (schematic_window_get_find_text_state_widget *window)
+                                (string->pointer "search-finished")
+                                *x_window_find_text_finished
+                                *window)
       (schematic_window_set_color_edit_widget *window
                                               (color_edit_widget_new *window))
       (schematic_window_set_font_select_widget *window
@@ -28,6 +28,12 @@
 #include <liblepton/glib_compat.h>
 
 
+/* The time in microseconds spent searching in one main loop
+ * iteration, so that the user interface stays responsive while
+ * large hierarchies are searched */
+#define SEARCH_TIME_SLICE 10000
+
+
 enum
 {
   COLUMN_FILENAME,
@@ -37,54 +43,79 @@ enum
 };
 
 
+/*! \private
+ *  \brief An item of the queue of the search in progress
+ *
+ *  If \a filename is NULL, the item stands for the page \a pid to
+ *  search.  Otherwise, it stands for the subpage \a filename of
+ *  the page \a pid to load and search.
+ */
+typedef struct
+{
+  int pid;
+  gchar *filename;
+} SearchItem;
+
+
 G_DEFINE_TYPE (GschemFindTextState, gschem_find_text_state, GSCHEM_TYPE_BIN);
 
 
 typedef void (*NotifyFunc)(void*, void*);
 
 
+static void
+append_object (GschemFindTextState *state,
+               LeptonObject *object,
+               gboolean filter_text);
+
 static void
 assign_store (GschemFindTextState *state, GSList *objects, gboolean filter_text);
 
 static void
 clear_store (GschemFindTextState *state);
 
-static GSList*
-find_objects_using_pattern (GSList *pages,
-                            const char *text,
-                            gboolean include_hidden);
-
-static GSList*
-find_objects_using_regex (GSList *pages,
-                          const char *text,
-                          gboolean include_hidden);
-
-static GSList*
-find_objects_using_substring (GSList *pages,
-                              const char *text,
-                              gboolean include_hidden);
+static void
+find_objects_in_page (GschemFindTextState *state,
+                      LeptonPage *page);
 
 static GSList*
-find_objects_using_check (GSList *pages);
+find_objects_using_check (GList *pages);
 
-static GSList*
-get_pages (GschemToplevel *w_current,
-           GList *pages,
-           gboolean descend);
+static gchar*
+get_pattern_literal (const char *text);
 
 static void
 get_property (GObject *object, guint param_id, GValue *value, GParamSpec *pspec);
 
-static GList*
-get_subpages (GschemToplevel *w_current,
-              LeptonPage *page);
+static gchar*
+get_regex_literal (const char *text);
 
 static void
 object_weakref_cb (LeptonObject *object, GschemFindTextState *state);
 
+static void
+queue_subpages (GschemFindTextState *state,
+                LeptonPage *page);
+
 static void
 remove_object (GschemFindTextState *state, LeptonObject *object);
 
+static gboolean
+search_idle (gpointer user_data);
+
+static void
+search_item_free (SearchItem *item);
+
+static void
+search_page (GschemFindTextState *state,
+             LeptonPage *page);
+
+static gboolean
+search_pages (GschemFindTextState *state);
+
+static void
+search_stop (GschemFindTextState *state);
+
 static void
 select_cb (GtkTreeSelection *selection, GschemFindTextState *state);
 
@@ -97,13 +128,25 @@ set_property (GObject *object, guint param_id, const GValue *value, GParamSpec *
  *  Finds instances of a given string and displays the result inside this
  *  widget.
  *
+ *  Text objects are looked up in the text index of each page.  The
+ *  pages are searched in slices of a few milliseconds in the main
+ *  loop, so that the user interface stays responsive while large
+ *  hierarchies are searched.  The first slice is searched right
+ *  away, and the rest of the pages, if any, are searched from an
+ *  idle handler.  The objects found are appended to the store as
+ *  they are found.  When the whole search is done, the
+ *  "search-finished" signal is emitted with the total number of
+ *  objects found.  Any search still in progress is cancelled.
+ *
+ *  Symbol checks (FIND_TYPE_CHECK) are always performed at once.
+ *
  *  \param [in] state
  *  \param [in] pages a list of pages to search
  *  \param [in] type the type of find to perform
  *  \param [in] text the text to find
  *  \param [in] descend decend the page heirarchy
  *  \param [in] include_hidden Include hidden objects.
- *  \return the number of objects found
+ *  \return the number of objects found so far
  */
 int
 gschem_find_text_state_find (GschemToplevel *w_current,
@@ -114,42 +157,115 @@ gschem_find_text_state_find (GschemToplevel *w_current,
                              gboolean descend,
                              gboolean include_hidden)
 {
-  int count;
-  GSList *objects = NULL;
-  GSList *all_pages;
-  gboolean filter_text = TRUE;
+  GList *iter;
+
+  g_return_val_if_fail (state != NULL, 0);
+  g_return_val_if_fail (text != NULL, 0);
 
-  all_pages = get_pages (w_current, pages, descend);
+  gschem_find_text_state_cancel (state);
+  clear_store (state);
+
+  if (type == FIND_TYPE_CHECK) {
+    GSList *objects = NULL;
+    int count;
+
+    if (pages != NULL) {
+      objects = find_objects_using_check (pages);
+    }
+
+    assign_store (state, objects, FALSE);
+    count = g_slist_length (objects);
+    g_slist_free (objects);
+
+    return count;
+  }
 
   switch (type) {
     case FIND_TYPE_SUBSTRING:
-      objects = find_objects_using_substring (all_pages, text, include_hidden);
+      state->search_literal = g_strdup (text);
       break;
 
     case FIND_TYPE_PATTERN:
-      objects = find_objects_using_pattern (all_pages, text, include_hidden);
+      state->search_pattern = g_pattern_spec_new (text);
+      state->search_literal = get_pattern_literal (text);
       break;
 
     case FIND_TYPE_REGEX:
-      objects = find_objects_using_regex (all_pages, text, include_hidden);
-      break;
-
-    case FIND_TYPE_CHECK:
-      filter_text = FALSE;
-      objects = find_objects_using_check (all_pages);
+      state->search_regex = g_regex_new (text,
+                                         (GRegexCompileFlags) 0,
+                                         (GRegexMatchFlags) 0,
+                                         NULL);
+      if (state->search_regex == NULL) {
+        return 0;
+      }
+      state->search_literal = get_regex_literal (text);
       break;
 
     default:
-      break;
+      return 0;
   }
 
-  g_slist_free (all_pages);
+  state->search_window = w_current;
+  state->search_descend = descend;
+  state->search_include_hidden = include_hidden;
+  state->search_count = 0;
+
+  for (iter = pages; iter != NULL; iter = g_list_next (iter)) {
+    LeptonPage *page = (LeptonPage*) iter->data;
+    SearchItem *item;
+
+    if (page == NULL) {
+      g_warning ("NULL page encountered");
+      continue;
+    }
+
+    item = g_slice_new0 (SearchItem);
+    item->pid = lepton_page_get_pid (page);
+    g_queue_push_tail (state->search_queue, item);
+  }
 
-  assign_store (state, objects, filter_text);
-  count = g_slist_length (objects);
-  g_slist_free (objects);
+  if (search_pages (state)) {
+    state->search_id = g_idle_add (search_idle, state);
+  } else {
+    search_stop (state);
+  }
 
-  return count;
+  return state->search_count;
+}
+
+
+/*! \brief Cancel the search in progress
+ *
+ *  The objects found so far are left in the store.  The
+ *  "search-finished" signal is not emitted.
+ *
+ *  \param [in] state
+ */
+void
+gschem_find_text_state_cancel (GschemFindTextState *state)
+{
+  g_return_if_fail (state != NULL);
+
+  if (state->search_id != 0) {
+    g_source_remove (state->search_id);
+    state->search_id = 0;
+  }
+
+  search_stop (state);
+}
+
+
+/*! \brief Tell whether a search is in progress
+ *
+ *  \param [in] state
+ *  \return TRUE if pages are still being searched
+ */
+gboolean
+gschem_find_text_state_is_searching (GschemFindTextState *state)
+{
+  g_return_val_if_fail (state != NULL, FALSE);
+
+  return (state->search_id != 0);
 }
 
 
@@ -166,74 +282,89 @@ gschem_find_text_state_new ()
 
 
 
-/*! \brief places object in the store so the user can see them
+/*! \brief places an object in the store so the user can see it
  *
  *  \param [in] state
- *  \param [in] objects the list of objects to put in the store
+ *  \param [in] object the object to put in the store
+ *  \param [in] filter_text TRUE if the object must be a text
  */
 static void
-assign_store (GschemFindTextState *state, GSList *objects, gboolean filter_text)
+append_object (GschemFindTextState *state,
+               LeptonObject *object,
+               gboolean filter_text)
 {
-  GSList *object_iter;
+  char *basename;
+  const char *str;
+  GtkTreeIter tree_iter;
 
   g_return_if_fail (state != NULL);
   g_return_if_fail (state->store != NULL);
 
-  clear_store (state);
+  if (object == NULL) {
+    g_warning ("NULL object encountered");
+    return;
+  }
 
-  object_iter = objects;
+  if (object->page == NULL) {
+    g_warning ("NULL page encountered");
+    return;
+  }
 
-  while (object_iter != NULL) {
-    char *basename;
-    LeptonObject *object = (LeptonObject*) object_iter->data;
-    const char *str;
-    GtkTreeIter tree_iter;
+  if (filter_text && !lepton_object_is_text (object))
+  {
+    g_warning ("expecting a text object");
+    return;
+  }
 
-    object_iter = g_slist_next (object_iter);
+  if (filter_text) {
+    str = lepton_text_object_get_string (object);
+  } else {
+    str = scm_to_utf8_string (scm_call_1 (scm_c_public_ref ("schematic symbol check",
+                                                            "object-blaming-info"),
+                                          scm_from_pointer (object, NULL)));
+  }
 
-    if (object == NULL) {
-      g_warning ("NULL object encountered");
-      continue;
-    }
+  if (str == NULL) {
+    g_warning ("NULL string encountered");
+    return;
+  }
 
-    if (object->page == NULL) {
-      g_warning ("NULL page encountered");
-      continue;
-    }
+  lepton_object_weak_ref (object, (NotifyFunc) object_weakref_cb, state);
 
-    if (filter_text && !lepton_object_is_text (object))
-    {
-      g_warning ("expecting a text object");
-      continue;
-    }
+  gtk_list_store_append (state->store, &tree_iter);
 
-    if (filter_text) {
-      str = lepton_text_object_get_string (object);
-    } else {
-      str = scm_to_utf8_string (scm_call_1 (scm_c_public_ref ("schematic symbol check",
-                                                              "object-blaming-info"),
-                                            scm_from_pointer (object, NULL)));
-    }
+  basename = g_path_get_basename (lepton_page_get_filename (object->page));
 
-    if (str == NULL) {
-      g_warning ("NULL string encountered");
-      continue;
-    }
+  gtk_list_store_set (state->store,
+                      &tree_iter,
+                      COLUMN_FILENAME, basename,
+                      COLUMN_STRING, str,
+                      COLUMN_OBJECT, object,
+                      -1);
+
+  g_free (basename);
+}
 
-    lepton_object_weak_ref (object, (NotifyFunc) object_weakref_cb, state);
 
-    gtk_list_store_append (state->store, &tree_iter);
+/*! \brief places object in the store so the user can see them
+ *
+ *  \param [in] state
+ *  \param [in] objects the list of objects to put in the store
+ */
+static void
+assign_store (GschemFindTextState *state, GSList *objects, gboolean filter_text)
+{
+  GSList *object_iter;
 
-    basename = g_path_get_basename (lepton_page_get_filename (object->page));
+  g_return_if_fail (state != NULL);
+  g_return_if_fail (state->store != NULL);
 
-    gtk_list_store_set (state->store,
-                        &tree_iter,
-                        COLUMN_FILENAME, basename,
-                        COLUMN_STRING, str,
-                        COLUMN_OBJECT, object,
-                        -1);
+  clear_store (state);
 
-    g_free (basename);
+  for (object_iter = objects;
+       object_iter != NULL;
+       object_iter = g_slist_next (object_iter)) {
+    append_object (state, (LeptonObject*) object_iter->data, filter_text);
   }
 }
 
@@ -245,6 +376,17 @@ dispose (GObject *object)
 {
   GschemFindTextState *state = GSCHEM_FIND_TEXT_STATE (object);
 
+  if (state->search_queue) {
+    gschem_find_text_state_cancel (state);
+    g_queue_free (state->search_queue);
+    state->search_queue = NULL;
+  }
+
+  if (state->search_visited) {
+    g_hash_table_destroy (state->search_visited);
+    state->search_visited = NULL;
+  }
+
   if (state->store) {
     clear_store (state);
     g_object_unref (state->store);
@@ -283,6 +425,18 @@ gschem_find_text_state_class_init (GschemFindTextStateClass *klass)
                 1,                                   /* n_params     */
                 G_TYPE_POINTER
                 );
+
+  g_signal_new ("search-finished",                   /* signal_name  */
+                G_OBJECT_CLASS_TYPE (klass),         /* itype        */
+                (GSignalFlags) 0,                    /* signal_flags */
+                0,                                   /* class_offset */
+                NULL,                                /* accumulator  */
+                NULL,                                /* accu_data    */
+                g_cclosure_marshal_VOID__INT,        /* c_marshaller */
+                G_TYPE_NONE,                         /* return_type  */
+                1,                                   /* n_params     */
+                G_TYPE_INT
+                );
 }
 
 
@@ -327,223 +481,55 @@ clear_store (GschemFindTextState *state)
 }
 
 
-/*! \brief Find all text objects that match a pattern
+/*! \brief Find the text objects of a page matching the search
+ *
+ *  Looks up the texts containing the literal part of the searched
+ *  text in the text index of the page, and appends the ones
+ *  matching the whole pattern, regex or substring to the store.
  *
- *  \param pages the list of pages to search
- *  \param text the pattern to match
- *  \param include_hidden Include hidden objects.
- *  \return a list of objects that match the given pattern
+ *  \param [in] state
+ *  \param [in] page the page to search
  */
-static GSList*
-find_objects_using_pattern (GSList *pages,
-                            const char *text,
-                            gboolean include_hidden)
+static void
+find_objects_in_page (GschemFindTextState *state,
+                      LeptonPage *page)
 {
-  GSList *object_list = NULL;
-  GSList *page_iter = pages;
-  GPatternSpec *pattern;
+  GList *objects;
+  GList *iter;
 
-  g_return_val_if_fail (text != NULL, NULL);
+  objects = lepton_page_texts_containing (page, state->search_literal);
 
-  pattern = g_pattern_spec_new (text);
-
-  while (page_iter != NULL) {
-    const GList *object_iter;
-    LeptonPage *page = (LeptonPage*) page_iter->data;
-
-    page_iter = g_slist_next (page_iter);
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+    const char *str;
 
-    if (page == NULL) {
-      g_warning ("NULL page encountered");
+    if (!(lepton_text_object_is_visible (object)
+          || state->search_include_hidden)) {
       continue;
     }
 
-    object_iter = lepton_page_objects (page);
-
-    while (object_iter != NULL) {
-      LeptonObject *object = (LeptonObject*) object_iter->data;
-      const char *str;
-
-      object_iter = g_list_next (object_iter);
-
-      if (object == NULL) {
-        g_warning ("NULL object encountered");
-        continue;
-      }
-
-      if (!lepton_object_is_text (object))
-      {
-        continue;
-      }
-
-      if (!(lepton_text_object_is_visible (object) || include_hidden)) {
-        continue;
-      }
-
-      str = lepton_text_object_get_string (object);
-
-      if (str == NULL) {
-        g_warning ("NULL string encountered");
-        continue;
-      }
-
-      if (g_pattern_spec_match_string (pattern, str))
-      {
-        object_list = g_slist_prepend (object_list, object);
-      }
-    }
-  }
-
-  g_pattern_spec_free (pattern);
-
-  return g_slist_reverse (object_list);
-}
-
+    str = lepton_text_object_get_string (object);
 
-/*! \brief Find all text objects that match a regex
- *
- *  \param pages the list of pages to search
- *  \param text the regex to match
- *  \param include_hidden Include hidden objects.
- *  \return a list of objects that match the given regex
- */
-static GSList*
-find_objects_using_regex (GSList *pages,
-                          const char *text,
-                          gboolean include_hidden)
-{
-  GError *ierror = NULL;
-  GSList *object_list = NULL;
-  GSList *page_iter = pages;
-  GRegex *regex;
-
-  g_return_val_if_fail (text != NULL, NULL);
-
-  regex = g_regex_new (text,
-                       (GRegexCompileFlags) 0,
-                       (GRegexMatchFlags) 0,
-                       &ierror);
-
-  if (ierror != NULL) {
-    return NULL;
-  }
-
-  while (page_iter != NULL) {
-    const GList *object_iter;
-    LeptonPage *page = (LeptonPage*) page_iter->data;
-
-    page_iter = g_slist_next (page_iter);
-
-    if (page == NULL) {
-      g_warning ("NULL page encountered");
+    if (str == NULL) {
+      g_warning ("NULL string encountered");
       continue;
     }
 
-    object_iter = lepton_page_objects (page);
-
-    while (object_iter != NULL) {
-      LeptonObject *object = (LeptonObject*) object_iter->data;
-      const char *str;
-
-      object_iter = g_list_next (object_iter);
-
-      if (object == NULL) {
-        g_warning ("NULL object encountered");
-        continue;
-      }
-
-      if (!lepton_object_is_text (object))
-      {
-        continue;
-      }
-
-      if (!(lepton_text_object_is_visible (object) || include_hidden)) {
-        continue;
-      }
-
-      str = lepton_text_object_get_string (object);
-
-      if (str == NULL) {
-        g_warning ("NULL string encountered");
-        continue;
-      }
-
-      if (g_regex_match (regex, str, (GRegexMatchFlags) 0, NULL)) {
-        object_list = g_slist_prepend (object_list, object);
-      }
+    if (state->search_pattern != NULL
+        && !g_pattern_spec_match_string (state->search_pattern, str)) {
+      continue;
     }
-  }
 
-  g_regex_unref (regex);
-
-  return g_slist_reverse (object_list);
-}
-
-
-/*! \brief Find all text objects that contain a substring
- *
- *  \param pages the list of pages to search
- *  \param text the substring to find
- *  \param include_hidden Include hidden objects.
- *  \return a list of objects that contain the given substring
- */
-static GSList*
-find_objects_using_substring (GSList *pages,
-                              const char *text,
-                              gboolean include_hidden)
-{
-  GSList *object_list = NULL;
-  GSList *page_iter = pages;
-
-  g_return_val_if_fail (text != NULL, NULL);
-
-  while (page_iter != NULL) {
-    const GList *object_iter;
-    LeptonPage *page = (LeptonPage*) page_iter->data;
-
-    page_iter = g_slist_next (page_iter);
-
-    if (page == NULL) {
-      g_warning ("NULL page encountered");
+    if (state->search_regex != NULL
+        && !g_regex_match (state->search_regex, str, (GRegexMatchFlags) 0, NULL)) {
       continue;
     }
 
-    object_iter = lepton_page_objects (page);
-
-    while (object_iter != NULL) {
-      LeptonObject *object = (LeptonObject*) object_iter->data;
-      const char *str;
-
-      object_iter = g_list_next (object_iter);
-
-      if (object == NULL) {
-        g_warning ("NULL object encountered");
-        continue;
-      }
-
-      if (!lepton_object_is_text (object))
-      {
-        continue;
-      }
-
-      if (!(lepton_text_object_is_visible (object) || include_hidden)) {
-        continue;
-      }
-
-      str = lepton_text_object_get_string (object);
-
-      if (str == NULL) {
-        g_warning ("NULL string encountered");
-        continue;
-      }
-
-      if (strstr (str, text) != NULL) {
-        object_list = g_slist_prepend (object_list, object);
-      }
-    }
+    append_object (state, object, TRUE);
+    state->search_count++;
   }
 
-  return g_slist_reverse (object_list);
+  g_list_free (objects);
 }
 
 
@@ -585,7 +571,7 @@ scm_to_gslist (SCM list_s)
  *  \return a list of objects that are blamed
  */
 static GSList*
-find_objects_using_check (GSList *pages)
+find_objects_using_check (GList *pages)
 {
   LeptonPage *page = (LeptonPage*) pages->data;
   LeptonToplevel *toplevel = page->toplevel;
@@ -598,51 +584,33 @@ find_objects_using_check (GSList *pages)
 }
 
 
-/*! \brief obtain a list of pages for an operation
+/*! \brief Get the literal part of a glob pattern
  *
- *  Descends the heirarchy of pages, if selected, and removes duplicate pages.
+ *  Returns the longest part of the pattern without wildcards.
+ *  Every string matching the pattern contains it.
  *
- *  \param [in] pages the list of pages to begin search
- *  \param [in] descend alose locates subpages
- *  \return a list of all the pages
+ *  \param [in] text the pattern
+ *  \return the literal part of the pattern, to be freed with g_free()
  */
-static GSList*
-get_pages (GschemToplevel *w_current,
-           GList *pages,
-           gboolean descend)
+static gchar*
+get_pattern_literal (const char *text)
 {
-  GList *input_list = g_list_copy (pages);
-  GSList *output_list = NULL;
-  GHashTable *visit_list = g_hash_table_new (NULL, NULL);
-
-  while (input_list != NULL) {
-    LeptonPage *page = (LeptonPage*) input_list->data;
+  const char *best = text;
+  size_t best_length = 0;
 
-    input_list = g_list_delete_link (input_list, input_list);
+  while (*text != '\0') {
+    size_t length = strcspn (text, "*?");
 
-    if (page == NULL) {
-      g_warning ("NULL page encountered");
-      continue;
+    if (length > best_length) {
+      best = text;
+      best_length = length;
     }
 
-    /** \todo the following function becomes available in glib 2.32 */
-    /* if (g_hash_table_contains (visit_list, page)) { */
-
-    if (g_hash_table_lookup_extended (visit_list, page, NULL, NULL)) {
-      continue;
-    }
-
-    output_list = g_slist_prepend (output_list, page);
-    g_hash_table_insert (visit_list, page, NULL);
-
-    if (descend) {
-      input_list = g_list_concat (input_list, get_subpages (w_current, page));
-    }
+    text += length;
+    text += strspn (text, "*?");
   }
 
-  g_hash_table_destroy (visit_list);
-
-  return g_slist_reverse (output_list);
+  return g_strndup (best, best_length);
 }
 
 
@@ -665,21 +633,42 @@ get_property (GObject *object, guint param_id, GValue *value, GParamSpec *pspec)
 }
 
 
-/*! \brief get the subpages of a schematic page
+
+/*! \brief Get the literal part of a regex
+ *
+ *  Returns the regex itself if it has no special characters, so
+ *  that every string matching it contains it.  Otherwise returns
+ *  an empty string, which every string contains.
+ *
+ *  \param [in] text the regex
+ *  \return the literal part of the regex, to be freed with g_free()
+ */
+static gchar*
+get_regex_literal (const char *text)
+{
+  if (strpbrk (text, "\\^$.|?*+()[]{}") != NULL) {
+    return g_strdup ("");
+  }
+
+  return g_strdup (text);
+}
+
+
+/*! \brief queue the subpages of a schematic page for searching
  *
- *  if any subpages are not loaded, this function will load them.
+ *  The subpages are loaded, if needed, when they are about to be
+ *  searched.
  *
+ *  \param [in] state
  *  \param [in] page the parent page
- *  \return a list of all the subpages
  */
-static GList*
-get_subpages (GschemToplevel *w_current,
-              LeptonPage *page)
+static void
+queue_subpages (GschemFindTextState *state,
+                LeptonPage *page)
 {
   const GList *object_iter;
-  GList *page_list = NULL;
 
-  g_return_val_if_fail (page != NULL, NULL);
+  g_return_if_fail (page != NULL);
 
   object_iter = lepton_page_objects (page);
 
@@ -716,23 +705,152 @@ get_subpages (GschemToplevel *w_current,
     }
 
     filenames = g_strsplit (attrib, ",", 0);
+    g_free (attrib);
 
     if (filenames == NULL) {
       continue;
     }
 
     for (iter = filenames; *iter != NULL; iter++) {
-      LeptonPage *subpage = s_hierarchy_load_subpage (w_current, page, *iter, NULL);
+      SearchItem *item = g_slice_new0 (SearchItem);
 
-      if (subpage != NULL) {
-        page_list = g_list_prepend (page_list, subpage);
-      }
+      item->pid = lepton_page_get_pid (page);
+      item->filename = g_strdup (*iter);
+      g_queue_push_tail (state->search_queue, item);
     }
 
     g_strfreev (filenames);
   }
+}
+
+
+/*! \brief Search the next pages from the main loop
+ *
+ *  \param [in] user_data the GschemFindTextState
+ *  \return G_SOURCE_CONTINUE while pages remain to be searched
+ */
+static gboolean
+search_idle (gpointer user_data)
+{
+  GschemFindTextState *state = GSCHEM_FIND_TEXT_STATE (user_data);
+
+  if (search_pages (state)) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  state->search_id = 0;
+  search_stop (state);
+
+  g_signal_emit_by_name (state, "search-finished", state->search_count);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+/*! \brief Free an item of the search queue
+ *
+ *  \param [in] item the item
+ */
+static void
+search_item_free (SearchItem *item)
+{
+  g_free (item->filename);
+  g_slice_free (SearchItem, item);
+}
+
+
+/*! \brief Search a page, unless it has already been searched
+ *
+ *  \param [in] state
+ *  \param [in] page the page to search
+ */
+static void
+search_page (GschemFindTextState *state,
+             LeptonPage *page)
+{
+  gpointer pid = GINT_TO_POINTER (lepton_page_get_pid (page));
+
+  if (g_hash_table_contains (state->search_visited, pid)) {
+    return;
+  }
+
+  g_hash_table_add (state->search_visited, pid);
+
+  find_objects_in_page (state, page);
 
-  return g_list_reverse (page_list);
+  if (state->search_descend) {
+    queue_subpages (state, page);
+  }
+}
+
+
+/*! \brief Search pages of the queue for one time slice
+ *
+ *  Pages are referred to by their ids in the queue, so that pages
+ *  closed while the search is in progress are skipped.
+ *
+ *  \param [in] state
+ *  \return TRUE if pages remain to be searched
+ */
+static gboolean
+search_pages (GschemFindTextState *state)
+{
+  gint64 deadline = g_get_monotonic_time () + SEARCH_TIME_SLICE;
+  LeptonToplevel *toplevel = state->search_window->toplevel;
+
+  while (!g_queue_is_empty (state->search_queue)) {
+    SearchItem *item = (SearchItem*) g_queue_pop_head (state->search_queue);
+    LeptonPage *page = lepton_toplevel_search_page_by_id (toplevel->pages,
+                                                          item->pid);
+
+    if (page != NULL && item->filename != NULL) {
+      page = s_hierarchy_load_subpage (state->search_window,
+                                       page,
+                                       item->filename,
+                                       NULL);
+    }
+
+    if (page != NULL) {
+      search_page (state, page);
+    }
+
+    search_item_free (item);
+
+    if (g_get_monotonic_time () >= deadline) {
+      break;
+    }
+  }
+
+  return !g_queue_is_empty (state->search_queue);
+}
+
+
+/*! \brief Release the resources of the search in progress
+ *
+ *  \param [in] state
+ */
+static void
+search_stop (GschemFindTextState *state)
+{
+  g_queue_foreach (state->search_queue, (GFunc) search_item_free, NULL);
+  g_queue_clear (state->search_queue);
+
+  g_hash_table_remove_all (state->search_visited);
+
+  if (state->search_pattern != NULL) {
+    g_pattern_spec_free (state->search_pattern);
+    state->search_pattern = NULL;
+  }
+
+  if (state->search_regex != NULL) {
+    g_regex_unref (state->search_regex);
+    state->search_regex = NULL;
+  }
+
+  g_free (state->search_literal);
+  state->search_literal = NULL;
+
+  state->search_window = NULL;
 }
 
 
@@ -756,6 +874,9 @@ gschem_find_text_state_init (GschemFindTextState *state)
                                     G_TYPE_STRING,
                                     G_TYPE_POINTER);
 
+  state->search_queue = g_queue_new ();
+  state->search_visited = g_hash_table_new (NULL, NULL);
+
   scrolled = gtk_scrolled_window_new (NULL, NULL);
   gtk_container_add (GTK_CONTAINER (state), scrolled);
 
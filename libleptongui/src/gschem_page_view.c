@@ -44,6 +44,18 @@
 
 #define INVALIDATE_MARGIN 1
 
+/* Number of rectangles in the dirty region of a view above which
+ * the region is replaced by its extents. */
+#define DIRTY_REGION_MAX_RECTS 16
+
+/* Mouse buttons whose state marks a motion event as a drag */
+#define DRAG_BUTTON_MASK (GDK_BUTTON1_MASK | GDK_BUTTON2_MASK | GDK_BUTTON3_MASK \
+                          | GDK_BUTTON4_MASK | GDK_BUTTON5_MASK)
+
+/* Size of the label of the redraw debugging overlay */
+#define DEBUG_LABEL_WIDTH 200
+#define DEBUG_LABEL_HEIGHT 20
+
 
 
 enum
@@ -115,6 +127,12 @@ static void geometry_cache_dispose (GschemPageView *view);
 
 static void geometry_cache_finalize (GschemPageView *view);
 
+static void
+invalidate_window (GschemPageView *view);
+
+static void
+flush_pending_motion (GschemPageView *view);
+
 static GObjectClass *gschem_page_view_parent_class = NULL;
 
 
@@ -183,6 +201,29 @@ dispose (GObject *object)
 
   geometry_cache_dispose (view);
 
+  if (view->_dirty_flush_id != 0) {
+#ifdef ENABLE_GTK3
+    gtk_widget_remove_tick_callback (GTK_WIDGET (view), view->_dirty_flush_id);
+#else
+    g_source_remove (view->_dirty_flush_id);
+#endif
+    view->_dirty_flush_id = 0;
+  }
+
+  if (view->_motion_flush_id != 0) {
+#ifdef ENABLE_GTK3
+    gtk_widget_remove_tick_callback (GTK_WIDGET (view), view->_motion_flush_id);
+#else
+    g_source_remove (view->_motion_flush_id);
+#endif
+    view->_motion_flush_id = 0;
+  }
+
+  if (view->_pending_motion != NULL) {
+    gdk_event_free (view->_pending_motion);
+    view->_pending_motion = NULL;
+  }
+
   /* lastly, chain up to the parent dispose */
 
   g_return_if_fail (gschem_page_view_parent_class != NULL);
@@ -218,6 +259,26 @@ event_unrealize(GtkWidget *widget, gpointer unused)
 }
 
 
+/*! \brief Event handler for button and key events
+ *
+ *  \par Function Description
+ *  Processes the motion event still waiting for the next frame
+ *  before any other input event, so that handlers see events in
+ *  the order they arrived.
+ */
+static gboolean
+event_flush_motion (GtkWidget *widget, GdkEvent *event, gpointer unused)
+{
+  GschemPageView *view = GSCHEM_PAGE_VIEW (widget);
+
+  g_return_val_if_fail (view != NULL, FALSE);
+
+  flush_pending_motion (view);
+
+  return FALSE;
+}
+
+
 /*! \brief Event handler for window unrealized
  */
 static void
@@ -242,6 +303,17 @@ finalize (GObject *object)
 
   geometry_cache_finalize (view);
 
+  schematic_render_cache_free (view->_render_cache);
+  view->_render_cache = NULL;
+
+  cairo_region_destroy (view->_dirty_region);
+  view->_dirty_region = NULL;
+
+  if (view->_debug_region != NULL) {
+    cairo_region_destroy (view->_debug_region);
+    view->_debug_region = NULL;
+  }
+
   /* lastly, chain up to the parent finalize */
 
   g_return_if_fail (gschem_page_view_parent_class != NULL);
@@ -626,27 +698,314 @@ gschem_page_view_get_vadjustment (GschemPageView *view)
 
 
 
+/*! \brief Invalidate the dirty region of a view
+ *
+ *  \par Function Description
+ *  Passes the region accumulated since the last frame to GDK in
+ *  one go and empties it.  If the redraw debugging overlay is on,
+ *  the region is also kept for the overlay, and the area of the
+ *  previous overlay is invalidated to erase it.
+ *
+ *  \param [in,out] view The Gschem page view
+ */
+static void
+flush_dirty_region (GschemPageView *view)
+{
+  GdkWindow *window = gtk_widget_get_window (GTK_WIDGET (view));
+
+  if (window == NULL || cairo_region_is_empty (view->_dirty_region)) {
+    return;
+  }
+
+  if (view->_debug_redraw) {
+    cairo_rectangle_int_t label = { 0, 0, DEBUG_LABEL_WIDTH, DEBUG_LABEL_HEIGHT };
+    cairo_region_t *previous = view->_debug_region;
+
+    view->_debug_region = cairo_region_copy (view->_dirty_region);
+
+    if (previous != NULL) {
+      cairo_region_union (view->_dirty_region, previous);
+      cairo_region_destroy (previous);
+    }
+    cairo_region_union_rectangle (view->_dirty_region, &label);
+  }
+
+#ifdef ENABLE_GTK3
+  gdk_window_invalidate_region (window, view->_dirty_region, FALSE);
+#else
+  {
+    int i;
+    int count = cairo_region_num_rectangles (view->_dirty_region);
+
+    for (i = 0; i < count; i++) {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (view->_dirty_region, i, &rect);
+      gdk_window_invalidate_rect (window, (GdkRectangle*) &rect, FALSE);
+    }
+  }
+#endif
+
+  cairo_region_destroy (view->_dirty_region);
+  view->_dirty_region = cairo_region_create ();
+}
+
+
+#ifdef ENABLE_GTK3
+static gboolean
+flush_dirty_region_tick (GtkWidget *widget,
+                         GdkFrameClock *frame_clock,
+                         gpointer user_data)
+{
+  GschemPageView *view = GSCHEM_PAGE_VIEW (widget);
+
+  view->_dirty_flush_id = 0;
+  flush_dirty_region (view);
+
+  return G_SOURCE_REMOVE;
+}
+#else
+static gboolean
+flush_dirty_region_idle (gpointer user_data)
+{
+  GschemPageView *view = GSCHEM_PAGE_VIEW (user_data);
+
+  view->_dirty_flush_id = 0;
+  flush_dirty_region (view);
+
+  return G_SOURCE_REMOVE;
+}
+#endif
+
+
+/*! \brief Add a screen rectangle to the dirty region of a view
+ *
+ *  \par Function Description
+ *  Accumulates the rectangles to redraw instead of invalidating
+ *  them right away.  The region is flushed once per frame, from
+ *  the frame clock of the view in GTK3, or just before GTK redraws
+ *  windows in GTK2.  If the region gets too fragmented, it is
+ *  replaced by its extents.
+ *
+ *  \param [in,out] view The Gschem page view
+ *  \param [in]     rect The rectangle to redraw
+ */
+static void
+add_dirty_rect (GschemPageView *view, const cairo_rectangle_int_t *rect)
+{
+  cairo_region_union_rectangle (view->_dirty_region, rect);
+
+  if (cairo_region_num_rectangles (view->_dirty_region) > DIRTY_REGION_MAX_RECTS) {
+    cairo_rectangle_int_t extents;
+
+    cairo_region_get_extents (view->_dirty_region, &extents);
+    cairo_region_destroy (view->_dirty_region);
+    view->_dirty_region = cairo_region_create_rectangle (&extents);
+  }
+
+  if (view->_dirty_flush_id == 0) {
+#ifdef ENABLE_GTK3
+    view->_dirty_flush_id =
+      gtk_widget_add_tick_callback (GTK_WIDGET (view),
+                                    flush_dirty_region_tick,
+                                    NULL,
+                                    NULL);
+#else
+    view->_dirty_flush_id =
+      g_idle_add_full (GDK_PRIORITY_REDRAW - 1,
+                       flush_dirty_region_idle,
+                       view,
+                       NULL);
+#endif
+  }
+}
+
+
+/*! \brief Process the motion event waiting for the next frame
+ *
+ *  \par Function Description
+ *  Emits the "motion-notify-event" signal once more with the last
+ *  motion event coalesced by gschem_page_view_coalesce_motion().
+ *  The region invalidated by the handlers is flushed right away so
+ *  that it is repainted in the current frame.
+ *
+ *  \param [in,out] view The Gschem page view
+ */
+static void
+flush_pending_motion (GschemPageView *view)
+{
+  GdkEvent *event = view->_pending_motion;
+  gboolean handled = FALSE;
+
+  if (event == NULL) {
+    return;
+  }
+
+  view->_pending_motion = NULL;
+
+  view->_replaying_motion = TRUE;
+  g_signal_emit_by_name (view, "motion-notify-event", event, &handled);
+  view->_replaying_motion = FALSE;
+
+  gdk_event_free (event);
+
+  flush_dirty_region (view);
+}
+
+
+#ifdef ENABLE_GTK3
+static gboolean
+flush_pending_motion_tick (GtkWidget *widget,
+                           GdkFrameClock *frame_clock,
+                           gpointer user_data)
+{
+  GschemPageView *view = GSCHEM_PAGE_VIEW (widget);
+
+  view->_motion_flush_id = 0;
+  flush_pending_motion (view);
+
+  return G_SOURCE_REMOVE;
+}
+#else
+static gboolean
+flush_pending_motion_idle (gpointer user_data)
+{
+  GschemPageView *view = GSCHEM_PAGE_VIEW (user_data);
+
+  view->_motion_flush_id = 0;
+  flush_pending_motion (view);
+
+  return G_SOURCE_REMOVE;
+}
+#endif
+
+
+/*! \brief Coalesce motion events of a view to one per frame
+ *
+ *  \par Function Description
+ *  While the pointer is dragged with a mouse button held down, or
+ *  while an editing action is in progress, motion events may come
+ *  in much faster than the view can be redrawn.  This function
+ *  keeps a copy of \a event in place of any motion event kept
+ *  before, and arranges for it to be emitted again on the next
+ *  frame.  Thus the motion handlers run at most once per frame,
+ *  with the latest pointer position.
+ *
+ *  Otherwise, the event is skipped if there are more motion events
+ *  in the GDK event queue, see schematic_event_skip_motion_event().
+ *
+ *  The function returns TRUE if the processing of \a event should
+ *  be stopped.  It returns FALSE for events that have to be
+ *  processed right away, including the ones emitted again on the
+ *  next frame.
+ *
+ *  \param [in,out] view      The Gschem page view
+ *  \param [in]     event     The motion event
+ *  \param [in]     in_action TRUE if an editing action is in progress
+ *  \returns TRUE if the event has been deferred or skipped,
+ *           otherwise FALSE.
+ */
+gboolean
+gschem_page_view_coalesce_motion (GschemPageView *view,
+                                  GdkEvent *event,
+                                  gboolean in_action)
+{
+  GdkModifierType state = 0;
+
+  g_return_val_if_fail (view != NULL, FALSE);
+  g_return_val_if_fail (event != NULL, FALSE);
+
+  if (view->_replaying_motion
+      || gtk_widget_get_window (GTK_WIDGET (view)) == NULL)
+  {
+    return FALSE;
+  }
+
+  gdk_event_get_state (event, &state);
+
+  if (!in_action && !(state & DRAG_BUTTON_MASK)) {
+    return schematic_event_skip_motion_event (event);
+  }
+
+  if (view->_pending_motion != NULL) {
+    gdk_event_free (view->_pending_motion);
+  }
+  view->_pending_motion = gdk_event_copy (event);
+
+  if (view->_motion_flush_id == 0) {
+#ifdef ENABLE_GTK3
+    view->_motion_flush_id =
+      gtk_widget_add_tick_callback (GTK_WIDGET (view),
+                                    flush_pending_motion_tick,
+                                    NULL,
+                                    NULL);
+#else
+    view->_motion_flush_id =
+      g_idle_add_full (GDK_PRIORITY_REDRAW - 2,
+                       flush_pending_motion_idle,
+                       view,
+                       NULL);
+#endif
+  }
+
+  return TRUE;
+}
+
+
 /*! \brief Schedule redraw for the entire window
+ *
+ *  \par Function Description
+ *  Schedules redraw of the window without dropping the cached
+ *  contents of the view.  Used when only the viewport of the
+ *  view changes, e.g. when it is panned or scrolled.
  *
  *  \param [in,out] view The Gschem page view to redraw
  */
-void
-gschem_page_view_invalidate_all (GschemPageView *view)
+static void
+invalidate_window (GschemPageView *view)
 {
-  GdkWindow *window;
+  GtkAllocation allocation;
+  cairo_rectangle_int_t rect;
 
   /* this function can be called early during initialization */
   if (view == NULL) {
     return;
   }
 
-  window = gtk_widget_get_window (GTK_WIDGET (view));
+  if (gtk_widget_get_window (GTK_WIDGET (view)) == NULL) {
+    return;
+  }
+
+  gtk_widget_get_allocation (GTK_WIDGET (view), &allocation);
+
+  rect.x = 0;
+  rect.y = 0;
+  rect.width = allocation.width;
+  rect.height = allocation.height;
+
+  add_dirty_rect (view, &rect);
+}
+
 
-  if (window == NULL) {
+/*! \brief Schedule redraw for the entire window
+ *
+ *  \par Function Description
+ *  Drops all cached contents of the view and schedules its
+ *  redraw.
+ *
+ *  \param [in,out] view The Gschem page view to redraw
+ */
+void
+gschem_page_view_invalidate_all (GschemPageView *view)
+{
+  /* this function can be called early during initialization */
+  if (view == NULL) {
     return;
   }
 
-  gdk_window_invalidate_rect (window, NULL, FALSE);
+  schematic_render_cache_invalidate_all (view->_render_cache);
+
+  invalidate_window (view);
 }
 
 
@@ -664,14 +1023,11 @@ gschem_page_view_invalidate_screen_rect (GschemPageView *view, int left, int top
   int bloat;
   int cue_half_size;
   int grip_half_size;
-  GdkRectangle rect;
-  GdkWindow *window;
+  cairo_rectangle_int_t rect;
 
   g_return_if_fail (view != NULL);
 
-  window = gtk_widget_get_window (GTK_WIDGET (view));
-
-  if (window == NULL) {
+  if (gtk_widget_get_window (GTK_WIDGET (view)) == NULL) {
     return;
   }
 
@@ -684,12 +1040,17 @@ gschem_page_view_invalidate_screen_rect (GschemPageView *view, int left, int top
   rect.width = 1 + abs( left - right ) + 2 * bloat;
   rect.height = 1 + abs( top - bottom ) + 2 * bloat;
 
-  gdk_window_invalidate_rect (window, &rect, FALSE);
+  add_dirty_rect (view, &rect);
 }
 
 
 
 /*! \brief Schedule redraw of the given rectange
+ *
+ *  \par Function Description
+ *  Drops the cached contents of the view in the given world
+ *  rectangle and schedules its redraw.  Should be used whenever
+ *  objects on the page change in the rectangle.
  *
  *  \param [in,out] view   The Gschem page view to redraw
  *  \param [in]     left
@@ -699,6 +1060,49 @@ gschem_page_view_invalidate_screen_rect (GschemPageView *view, int left, int top
  */
 void
 gschem_page_view_invalidate_world_rect (GschemPageView *view, int left, int top, int right, int bottom)
+{
+  int bloat;
+  int cue_half_size;
+  int grip_half_size;
+
+  g_return_if_fail (view != NULL);
+
+  grip_half_size = GRIP_SIZE / 2;
+  cue_half_size = gschem_page_view_SCREENabs (view, CUE_BOX_SIZE);
+  bloat = MAX (grip_half_size, cue_half_size) + INVALIDATE_MARGIN;
+
+  schematic_render_cache_invalidate_world_rect (view->_render_cache,
+                                                left,
+                                                top,
+                                                right,
+                                                bottom,
+                                                bloat);
+
+  gschem_page_view_invalidate_overlay_world_rect (view, left, top, right, bottom);
+}
+
+
+
+/*! \brief Schedule redraw of the given rectange on top of cached contents
+ *
+ *  \par Function Description
+ *  Schedules redraw of the given world rectangle keeping the
+ *  cached static contents of the view.  Should be used for
+ *  things drawn over the page, such as rubberband objects, which
+ *  do not change the page itself.
+ *
+ *  \param [in,out] view   The Gschem page view to redraw
+ *  \param [in]     left
+ *  \param [in]     top
+ *  \param [in]     right
+ *  \param [in]     bottom
+ */
+void
+gschem_page_view_invalidate_overlay_world_rect (GschemPageView *view,
+                                                int left,
+                                                int top,
+                                                int right,
+                                                int bottom)
 {
   int screen_bottom = 0;
   int screen_right = 0;
@@ -738,10 +1142,23 @@ gschem_page_view_init (GschemPageView *view)
 
   geometry_cache_create (view);
 
+  view->_render_cache = schematic_render_cache_new ();
+
+  view->_dirty_region = cairo_region_create ();
+  view->_dirty_flush_id = 0;
+  view->_debug_redraw = FALSE;
+  view->_debug_region = NULL;
+  view->_debug_redraw_time = 0;
+
+  view->_pending_motion = NULL;
+  view->_motion_flush_id = 0;
+  view->_replaying_motion = FALSE;
+
   view->_page = NULL;
   view->configured = FALSE;
 
   view->doing_pan = FALSE;
+  view->reduced_quality = FALSE;
   view->pan_x = 0;
   view->pan_y = 0;
   view->throttle = 0;
@@ -767,6 +1184,26 @@ gschem_page_view_init (GschemPageView *view)
                    "toggle-hidden-text",
                    G_CALLBACK (event_toggle_hidden_text),
                    NULL);
+
+  g_signal_connect (view,
+                    "button-press-event",
+                    G_CALLBACK (event_flush_motion),
+                    NULL);
+
+  g_signal_connect (view,
+                    "button-release-event",
+                    G_CALLBACK (event_flush_motion),
+                    NULL);
+
+  g_signal_connect (view,
+                    "key-press-event",
+                    G_CALLBACK (event_flush_motion),
+                    NULL);
+
+  g_signal_connect (view,
+                    "scroll-event",
+                    G_CALLBACK (event_flush_motion),
+                    NULL);
 }
 
 
@@ -819,7 +1256,7 @@ gschem_page_view_pan_general (GschemPageView *view, int w_x, int w_y, double rel
 
   g_signal_emit_by_name (view, "update-grid-info");
   gschem_page_view_update_scroll_adjustments (view);
-  gschem_page_view_invalidate_all (view);
+  invalidate_window (view);
 }
 
 
@@ -838,7 +1275,7 @@ gschem_page_view_pan (GschemPageView *view, int w_x, int w_y)
   x_event_faked_motion (view, NULL);
 
   gschem_page_view_update_scroll_adjustments (view);
-  gschem_page_view_invalidate_all (view);
+  invalidate_window (view);
 }
 
 
@@ -889,15 +1326,24 @@ gschem_page_view_pan_mouse (GschemPageView *view, int diff_x, int diff_y)
 /*! \brief Start mouse panning in the view
  *  \par Function Description
  *  This function saves current coordinates of the mouse pointer
- *  to pan_x and pan_y  and toggles the view into pan mode.
+ *  to pan_x and pan_y  and toggles the view into pan mode.  If
+ *  \a fast_pan is TRUE, the view is drawn at reduced quality until
+ *  the panning ends.
  *
- *  \param [in,out] view  This GschemPageView
- *  \param [in]     x     The screen x coordinate
- *  \param [in]     y     The screen y coordinate
+ *  \param [in,out] view      This GschemPageView
+ *  \param [in]     x         The screen x coordinate
+ *  \param [in]     y         The screen y coordinate
+ *  \param [in]     fast_pan  Whether to pan at reduced quality
  */
-void gschem_page_view_pan_start (GschemPageView *view, int x, int y)
+void gschem_page_view_pan_start (GschemPageView *view,
+                                 int x,
+                                 int y,
+                                 gboolean fast_pan)
 {
   view->doing_pan = TRUE;
+  if (fast_pan) {
+    view->reduced_quality = TRUE;
+  }
   view->pan_x = x;
   view->pan_y = y;
   view->throttle = 0;
@@ -950,8 +1396,9 @@ gboolean
 gschem_page_view_pan_end (GschemPageView *view)
 {
   if (view->doing_pan) {
-    gschem_page_view_invalidate_all (view);
+    invalidate_window (view);
     view->doing_pan = FALSE;
+    gschem_page_view_restore_quality (view);
     return TRUE;
   } else {
     return FALSE;
@@ -960,6 +1407,26 @@ gschem_page_view_pan_end (GschemPageView *view)
 
 
 
+/*! \brief Return to full rendering quality after an interaction
+ *  \par Function Description
+ *  If the view has been drawn with reduced quality because the
+ *  interaction was too slow to redraw, drops the tiles cached at
+ *  that quality and schedules a full quality redraw of the view.
+ *
+ *  \param [in,out] view This GschemPageView
+ */
+void
+gschem_page_view_restore_quality (GschemPageView *view)
+{
+  g_return_if_fail (view != NULL);
+
+  if (view->reduced_quality) {
+    view->reduced_quality = FALSE;
+    gschem_page_view_invalidate_all (view);
+  }
+}
+
+
 /*! \brief Transform SCREEN coordinates to WORLD coordinates
  *  \par Function Description
  *  This function takes in SCREEN x/y coordinates and
@@ -1170,7 +1637,7 @@ hadjustment_value_changed (GtkAdjustment *hadjustment, GschemPageView *view)
     geometry->viewport_left = new_left;
     geometry->viewport_right = geometry->viewport_right - (current_left - new_left);
 
-    gschem_page_view_invalidate_all (view);
+    invalidate_window (view);
   }
 }
 
@@ -1443,7 +1910,7 @@ vadjustment_value_changed (GtkAdjustment *vadjustment, GschemPageView *view)
     geometry->viewport_bottom = new_bottom;
     geometry->viewport_top = geometry->viewport_top - (current_bottom - new_bottom);
 
-    gschem_page_view_invalidate_all (view);
+    invalidate_window (view);
   }
 }
 
@@ -1498,7 +1965,7 @@ gschem_page_view_zoom_extents (GschemPageView *view, const GList *objects)
 
   g_signal_emit_by_name (view, "update-grid-info");
   gschem_page_view_update_scroll_adjustments (view);
-  gschem_page_view_invalidate_all (view);
+  invalidate_window (view);
 }
 
 /*! \brief Zoom in on a single object
@@ -1560,8 +2027,64 @@ gschem_page_view_zoom_object (GschemPageView *view, LeptonObject *object)
                                      viewport_center_x + viewport_width / 2,
                                      viewport_center_y + viewport_height / 2);
 
-    gschem_page_view_invalidate_all (view);
+    invalidate_window (view);
+  }
+}
+
+
+/*! \brief Draw the redraw debugging overlay
+ *
+ *  \par Function Description
+ *  Highlights the region invalidated for the current frame and
+ *  shows the time the last redraw took.
+ *
+ *  \param [in] view     The GschemPageView object
+ *  \param [in] cr       The cairo context the view is drawn on
+ *  \param [in] offset_x The X offset of the view on \a cr
+ *  \param [in] offset_y The Y offset of the view on \a cr
+ */
+static void
+draw_debug_overlay (GschemPageView *view,
+                    cairo_t *cr,
+                    double offset_x,
+                    double offset_y)
+{
+  char label[64];
+  int i;
+
+  cairo_save (cr);
+  cairo_identity_matrix (cr);
+  cairo_translate (cr, offset_x, offset_y);
+
+  if (view->_debug_region != NULL) {
+    for (i = 0; i < cairo_region_num_rectangles (view->_debug_region); i++) {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (view->_debug_region, i, &rect);
+      cairo_rectangle (cr, rect.x + 0.5, rect.y + 0.5,
+                       rect.width - 1, rect.height - 1);
+    }
+
+    cairo_set_source_rgba (cr, 1, 0, 0, 0.15);
+    cairo_fill_preserve (cr);
+    cairo_set_source_rgba (cr, 1, 0, 0, 0.6);
+    cairo_set_line_width (cr, 1);
+    cairo_stroke (cr);
   }
+
+  g_snprintf (label, sizeof (label), "redraw: %.2f ms",
+              view->_debug_redraw_time / 1000.0);
+
+  cairo_rectangle (cr, 0, 0, DEBUG_LABEL_WIDTH, DEBUG_LABEL_HEIGHT);
+  cairo_set_source_rgba (cr, 0, 0, 0, 0.7);
+  cairo_fill (cr);
+
+  cairo_set_source_rgb (cr, 1, 1, 1);
+  cairo_set_font_size (cr, 12);
+  cairo_move_to (cr, 4, DEBUG_LABEL_HEIGHT - 6);
+  cairo_show_text (cr, label);
+
+  cairo_restore (cr);
 }
 
 
@@ -1590,7 +2113,11 @@ gschem_page_view_redraw (GschemPageView *view,
 
   page = gschem_page_view_get_page (view);
 
+  view->_debug_redraw = w_current->debug_redraw;
+
   if (page != NULL) {
+    gint64 start_time = g_get_monotonic_time ();
+
     geometry = gschem_page_view_get_page_geometry (view);
 
     g_return_if_fail (view != NULL);
@@ -1600,14 +2127,48 @@ gschem_page_view_redraw (GschemPageView *view,
                    GTK_WIDGET(view),
                    page,
                    geometry,
-                   cr);
+                   cr,
+                   view->_render_cache,
+                   view->reduced_quality);
 #else
     o_redraw_rect (w_current,
                    gtk_widget_get_window (GTK_WIDGET(view)),
                    page,
                    geometry,
-                   &(event->area));
+                   &(event->area),
+                   view->_render_cache,
+                   view->reduced_quality);
 #endif
+
+    view->_debug_redraw_time = g_get_monotonic_time () - start_time;
+
+    /* If redrawing takes too long while the user interacts with
+     * the view, lower the rendering quality until the interaction
+     * ends. */
+    if (w_current->adaptive_quality
+        && (w_current->inside_action || view->doing_pan)
+        && view->_debug_redraw_time > w_current->adaptive_quality_budget * 1000)
+    {
+      view->reduced_quality = TRUE;
+    }
+
+    if (view->_debug_redraw) {
+#ifdef ENABLE_GTK3
+      gint wx, wy;
+
+      gtk_widget_translate_coordinates (GTK_WIDGET (view),
+                                        gtk_widget_get_toplevel (GTK_WIDGET (view)),
+                                        0, 0, &wx, &wy);
+      draw_debug_overlay (view, cr, wx, wy);
+#else
+      cairo_t *cr = gdk_cairo_create (gtk_widget_get_window (GTK_WIDGET (view)));
+
+      gdk_cairo_rectangle (cr, &(event->area));
+      cairo_clip (cr);
+      draw_debug_overlay (view, cr, 0, 0);
+      cairo_destroy (cr);
+#endif
+    }
   }
 }
 
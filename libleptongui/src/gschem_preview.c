@@ -40,10 +40,14 @@
 
 #define OVER_ZOOM_FACTOR 0.1
 
+/*! Maximum number of files and symbols kept in the preview cache */
+#define PREVIEW_CACHE_SIZE 32
+
 
 enum {
   PROP_FILENAME=1,
   PROP_BUFFER,
+  PROP_SYMBOL,
   PROP_ACTIVE
 };
 
@@ -59,6 +63,293 @@ static void preview_get_property (GObject *object,
                                   GParamSpec *pspec);
 static void preview_dispose (GObject *self);
 static void preview_finalize (GObject *self);
+static void preview_update (GschemPreview *preview);
+
+
+/*! \brief Contents of a previewed file or library symbol
+ *  \par
+ *  Entries are shared by all the preview widgets, so that the
+ *  files and symbols shown once are neither read again from disk
+ *  while they are left unchanged, nor parsed again.  The previews
+ *  show copies of the objects of the entries.
+ */
+typedef struct
+{
+  gchar *filename;   /* The file name given to the preview, or the
+                        key of the symbol */
+  gchar *path;       /* The normalized file name */
+  gchar *command;    /* The command printing the symbol, if any */
+  guint64 mtime;     /* The modification time of the file */
+  gchar *contents;   /* The contents of the file */
+  gsize size;        /* The size of the contents */
+  gboolean parsed;   /* Whether the contents have been parsed */
+  GList *objects;    /* The objects read from the contents */
+  gchar *message;    /* The error message of the parsing, if any */
+} PreviewCacheEntry;
+
+/*! File name or symbol key -> PreviewCacheEntry */
+static GHashTable *preview_cache = NULL;
+
+/*! File names of the preview cache, most recently used first */
+static GQueue *preview_cache_lru = NULL;
+
+
+/*! \brief Free an entry of the preview cache.
+ */
+static void
+preview_cache_entry_free (PreviewCacheEntry *entry)
+{
+  if (entry == NULL) {
+    return;
+  }
+
+  g_free (entry->filename);
+  g_free (entry->path);
+  g_free (entry->command);
+  g_free (entry->contents);
+  lepton_object_list_delete (entry->objects);
+  g_free (entry->message);
+  g_slice_free (PreviewCacheEntry, entry);
+}
+
+
+/*! \brief Get the key of a library symbol in the preview cache.
+ *  \par Function Description
+ *  The returned string should be freed when no longer needed.
+ *
+ *  \param [in] preview The preview widget showing the symbol.
+ *  \return The key of the symbol.
+ */
+static gchar*
+preview_symbol_key (GschemPreview *preview)
+{
+  return g_strdup_printf ("clib:%s/%s",
+                          preview->symbol_source,
+                          preview->symbol_name);
+}
+
+
+/*! \brief Look up a file or symbol in the preview cache.
+ *  \par Function Description
+ *  Marks the entry found as the most recently used one.
+ *
+ *  \param [in] filename The file name or the symbol key.
+ *  \return The entry found, or NULL if it is not cached.
+ */
+static PreviewCacheEntry*
+preview_cache_lookup (const gchar *filename)
+{
+  PreviewCacheEntry *entry;
+  GList *link;
+
+  if (preview_cache == NULL) {
+    return NULL;
+  }
+
+  entry = (PreviewCacheEntry*) g_hash_table_lookup (preview_cache, filename);
+
+  if (entry != NULL) {
+    link = g_queue_find (preview_cache_lru, entry->filename);
+    g_queue_unlink (preview_cache_lru, link);
+    g_queue_push_head_link (preview_cache_lru, link);
+  }
+
+  return entry;
+}
+
+
+/*! \brief Add a file or symbol to the preview cache.
+ *  \par Function Description
+ *  Replaces any previous entry of the same file or symbol.  The least
+ *  recently used entries are dropped when the cache is full.  The
+ *  cache takes ownership of \a entry.
+ *
+ *  \param [in] entry The entry to add.
+ */
+static void
+preview_cache_insert (PreviewCacheEntry *entry)
+{
+  PreviewCacheEntry *old;
+
+  if (preview_cache == NULL) {
+    preview_cache =
+      g_hash_table_new_full (g_str_hash,
+                             g_str_equal,
+                             NULL,
+                             (GDestroyNotify) preview_cache_entry_free);
+    preview_cache_lru = g_queue_new ();
+  }
+
+  old = (PreviewCacheEntry*) g_hash_table_lookup (preview_cache,
+                                                  entry->filename);
+  if (old != NULL) {
+    g_queue_remove (preview_cache_lru, old->filename);
+    g_hash_table_remove (preview_cache, old->filename);
+  }
+
+  while (g_queue_get_length (preview_cache_lru) >= PREVIEW_CACHE_SIZE) {
+    g_hash_table_remove (preview_cache, g_queue_pop_tail (preview_cache_lru));
+  }
+
+  g_hash_table_insert (preview_cache, entry->filename, entry);
+  g_queue_push_head (preview_cache_lru, entry->filename);
+}
+
+
+/*! \brief Read a previewed file in a worker thread.
+ *  \par Function Description
+ *  Normalizes the file name and gets the modification time of the
+ *  file.  The contents are read only if the modification time
+ *  differs from the one of the cached copy of the file, if any.
+ *  In that case the returned entry has no contents.
+ *
+ *  Only GIO is used here, the objects of the preview are created
+ *  back in the main thread.
+ *
+ *  \param [in] task         The task.
+ *  \param [in] source_object The preview widget.
+ *  \param [in] task_data    The entry to fill, having the file name
+ *                           and the modification time of the
+ *                           cached copy set.
+ *  \param [in] cancellable  The cancellable of the task.
+ */
+static void
+preview_load_thread (GTask *task,
+                     gpointer source_object,
+                     gpointer task_data,
+                     GCancellable *cancellable)
+{
+  PreviewCacheEntry *request = (PreviewCacheEntry*) task_data;
+  PreviewCacheEntry *entry;
+  GFileInfo *info;
+  GFile *file;
+  GError *err = NULL;
+
+  entry = g_slice_new0 (PreviewCacheEntry);
+  entry->filename = g_strdup (request->filename);
+  entry->path = f_normalize_filename (request->filename, &err);
+
+  if (entry->path == NULL) {
+    preview_cache_entry_free (entry);
+    g_task_return_error (task, err);
+    return;
+  }
+
+  file = g_file_new_for_path (entry->path);
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                            G_FILE_QUERY_INFO_NONE,
+                            cancellable,
+                            &err);
+
+  if (info != NULL) {
+    entry->mtime =
+      g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+    g_object_unref (info);
+
+    if (entry->mtime != request->mtime) {
+      g_file_load_contents (file,
+                            cancellable,
+                            &entry->contents,
+                            &entry->size,
+                            NULL,
+                            &err);
+    }
+  }
+
+  g_object_unref (file);
+
+  if (err != NULL) {
+    preview_cache_entry_free (entry);
+    g_task_return_error (task, err);
+    return;
+  }
+
+  g_task_return_pointer (task,
+                         entry,
+                         (GDestroyNotify) preview_cache_entry_free);
+}
+
+
+/*! \brief Fetch the data of a library symbol in a worker thread.
+ *  \par Function Description
+ *  Reads the file of a symbol of a directory source, or runs the
+ *  command printing a symbol of a command source.  Errors are
+ *  returned instead of being logged, since the log is only written
+ *  to in the main thread.
+ *
+ *  \param [in] task          The task.
+ *  \param [in] source_object The preview widget.
+ *  \param [in] task_data     The request, having either the file
+ *                            name or the command of the symbol set.
+ *  \param [in] cancellable   The cancellable of the task.
+ */
+static void
+preview_fetch_symbol_thread (GTask *task,
+                             gpointer source_object,
+                             gpointer task_data,
+                             GCancellable *cancellable)
+{
+  PreviewCacheEntry *request = (PreviewCacheEntry*) task_data;
+  PreviewCacheEntry *entry;
+  GError *err = NULL;
+
+  entry = g_slice_new0 (PreviewCacheEntry);
+  entry->filename = g_strdup (request->filename);
+
+  if (request->command != NULL) {
+    gint exit_status;
+
+    if (g_spawn_command_line_sync (request->command,
+                                   &entry->contents,
+                                   NULL,
+                                   &exit_status,
+                                   &err)) {
+      g_spawn_check_exit_status (exit_status, &err);
+    }
+  }
+  else {
+    GFile *file = g_file_new_for_path (request->path);
+
+    g_file_load_contents (file,
+                          cancellable,
+                          &entry->contents,
+                          &entry->size,
+                          NULL,
+                          &err);
+    g_object_unref (file);
+  }
+
+  if (err != NULL) {
+    preview_cache_entry_free (entry);
+    g_task_return_error (task, err);
+    return;
+  }
+
+  entry->size = strlen (entry->contents);
+
+  g_task_return_pointer (task,
+                         entry,
+                         (GDestroyNotify) preview_cache_entry_free);
+}
+
+
+/*! \brief Get the library symbol of the preview.
+ *  \par Function Description
+ *  The symbol is looked up again by the names of its source and of
+ *  itself, since the component library may have been refreshed
+ *  since the symbol has been given to the preview.
+ *
+ *  \param [in] preview The preview widget.
+ *  \return The symbol, or NULL if it is no longer in the library.
+ */
+static const CLibSymbol*
+preview_get_symbol (GschemPreview *preview)
+{
+  const CLibSource *source = s_clib_get_source_by_name (preview->symbol_source);
+
+  return s_clib_source_get_symbol_by_name (source, preview->symbol_name);
+}
 
 
 /*! \brief get the filename for the current page
@@ -142,19 +433,471 @@ preview_callback_button_press (GtkWidget *widget,
 }
 
 
+/*! \brief Show a message in the preview page.
+ *
+ *  \param [in] page    The preview page.
+ *  \param [in] message The message to show.
+ */
+static void
+preview_show_message (LeptonPage *page,
+                      const gchar *message)
+{
+  lepton_page_append (page,
+                      lepton_text_object_new (2,
+                                              100,
+                                              100,
+                                              LOWER_MIDDLE,
+                                              0,
+                                              message,
+                                              10,
+                                              VISIBLE,
+                                              SHOW_NAME_VALUE));
+}
+
+
+/*! \brief Zoom the preview to the extents of its objects.
+ *
+ *  \param [in] preview The preview widget.
+ */
+static void
+preview_zoom_extents (GschemPreview *preview)
+{
+  int left, top, right, bottom;
+  int width, height;
+
+  GschemPageView *preview_view = GSCHEM_PAGE_VIEW (preview);
+  LeptonPage *preview_page = gschem_page_view_get_page (preview_view);
+
+  if (world_get_object_glist_bounds (lepton_page_objects (preview_page),
+                                     /* Do not include hidden text. */
+                                     FALSE,
+                                     &left, &top,
+                                     &right, &bottom)) {
+    /* Clamp the canvas size to the extents of the page being previewed */
+    width = right - left;
+    height = bottom - top;
+
+    GschemPageGeometry *geometry = gschem_page_view_get_page_geometry (preview_view);
+    geometry->world_left   = left   - ((double)width  * OVER_ZOOM_FACTOR);
+    geometry->world_right  = right  + ((double)width  * OVER_ZOOM_FACTOR);
+    geometry->world_top    = top    - ((double)height * OVER_ZOOM_FACTOR);
+    geometry->world_bottom = bottom + ((double)height * OVER_ZOOM_FACTOR);
+  }
+
+  /* display current page (possibly empty) */
+  gschem_page_view_zoom_extents (preview_view, NULL);
+}
+
+
+/*! \brief Finish updating the preview.
+ *  \par Function Description
+ *  Zooms the preview to its contents and emits the "loaded"
+ *  signal.
+ *
+ *  \param [in] preview The preview widget.
+ */
+static void
+preview_loaded (GschemPreview *preview)
+{
+  preview_zoom_extents (preview);
+
+  g_signal_emit_by_name (preview, "loaded");
+}
+
+
+/*! \brief Parse the contents of a cache entry.
+ *  \par Function Description
+ *  The objects read are kept in the entry, only their copies are
+ *  added to the preview pages.
+ *
+ *  \param [in] page  The preview page.
+ *  \param [in] entry The cache entry.
+ *  \param [in] name  The name of the contents used in messages.
+ */
+static void
+preview_parse_entry (LeptonPage *page,
+                     PreviewCacheEntry *entry,
+                     const gchar *name)
+{
+  GError *err = NULL;
+
+  entry->objects = o_read_buffer (page, NULL,
+                                  entry->contents, entry->size,
+                                  name, &err);
+
+  if (err != NULL) {
+    entry->message = g_strdup (err->message);
+    g_error_free (err);
+  }
+
+  entry->parsed = TRUE;
+}
+
+
+/*! \brief Add copies of the objects of a cache entry to the preview page.
+ *
+ *  \param [in] page  The preview page.
+ *  \param [in] entry The parsed cache entry.
+ */
+static void
+preview_show_entry (LeptonPage *page,
+                    PreviewCacheEntry *entry)
+{
+  if (entry->message != NULL) {
+    preview_show_message (page, entry->message);
+  }
+  else {
+    lepton_page_append_list (page, o_glist_copy_all (entry->objects, NULL));
+  }
+
+  lepton_page_set_changed (page, 0);
+}
+
+
+/*! \brief Read the contents of a previewed file into the preview page.
+ *  \par Function Description
+ *  Does the same as f_open() with the #F_OPEN_RC and
+ *  #F_OPEN_RESTORE_CWD flags, using the contents of the file
+ *  already read.  The contents are parsed only the first time the
+ *  cached file is shown.
+ *
+ *  \param [in] page  The preview page.
+ *  \param [in] entry The cached file.
+ */
+static void
+preview_read_file (LeptonPage *page,
+                   PreviewCacheEntry *entry)
+{
+  GError *err = NULL;
+  gchar *saved_cwd;
+  gchar *file_directory;
+
+  lepton_page_set_filename (page, entry->path);
+
+  if (entry->parsed) {
+    preview_show_entry (page, entry);
+    return;
+  }
+
+  saved_cwd = g_get_current_dir ();
+  file_directory = g_path_get_dirname (entry->path);
+
+  /* Load the gafrc of the directory of the file as f_open() does */
+  if (chdir (file_directory)) {
+    /* Error occurred with chdir */
+  }
+
+  g_rc_parse_local (page->toplevel, "gafrc", file_directory, &err);
+  if (err != NULL) {
+    if (!g_error_matches (err, G_FILE_ERROR, G_FILE_ERROR_NOENT) &&
+        !g_error_matches (err, EDA_ERROR, EDA_ERROR_RC_TWICE)) {
+      g_message ("%s", err->message);
+    }
+    g_clear_error (&err);
+  }
+
+  preview_parse_entry (page, entry, entry->path);
+  preview_show_entry (page, entry);
+
+  if (chdir (saved_cwd)) {
+    /* Error occurred with chdir */
+  }
+
+  g_free (file_directory);
+  g_free (saved_cwd);
+}
+
+
+/*! \brief Show the data of the library symbol of the preview.
+ *  \par Function Description
+ *  The parsed symbol is taken from the preview cache if its data
+ *  have not changed since it has been cached.
+ *
+ *  \param [in] preview The preview widget.
+ *  \param [in] data    The data of the symbol.  The function takes
+ *                      ownership of it.
+ */
+static void
+preview_read_symbol (GschemPreview *preview,
+                     gchar *data)
+{
+  LeptonPage *preview_page = gschem_page_view_get_page (GSCHEM_PAGE_VIEW (preview));
+  gchar *key = preview_symbol_key (preview);
+  PreviewCacheEntry *cached = preview_cache_lookup (key);
+
+  if ((cached == NULL) || (strcmp (cached->contents, data) != 0)) {
+    cached = g_slice_new0 (PreviewCacheEntry);
+    cached->filename = key;
+    cached->contents = data;
+    cached->size = strlen (data);
+    preview_cache_insert (cached);
+
+    preview_parse_entry (preview_page, cached, preview->symbol_name);
+  }
+  else {
+    g_free (key);
+    g_free (data);
+  }
+
+  preview_show_entry (preview_page, cached);
+}
+
+
+/*! \brief Cancel the loading of a file in progress, if any.
+ *
+ *  \param [in] preview The preview widget.
+ */
+static void
+preview_cancel_load (GschemPreview *preview)
+{
+  if (preview->cancellable != NULL) {
+    g_cancellable_cancel (preview->cancellable);
+    g_clear_object (&preview->cancellable);
+  }
+}
+
+
+/*! \brief Show a file read by a worker thread.
+ *  \par Function Description
+ *  Called in the main thread when the worker thread is done.
+ *  Replaces the placeholder in the preview page with the objects
+ *  of the file, and adds the file to the preview cache.  Does
+ *  nothing if the loading has been cancelled, which happens when
+ *  the preview is updated again or destroyed meanwhile.
+ */
+static void
+preview_load_ready (GObject *source_object,
+                    GAsyncResult *result,
+                    gpointer user_data)
+{
+  GschemPreview *preview = GSCHEM_PREVIEW (source_object);
+  PreviewCacheEntry *entry;
+  PreviewCacheEntry *cached = NULL;
+  LeptonPage *preview_page;
+  GError *err = NULL;
+
+  entry = (PreviewCacheEntry*) g_task_propagate_pointer (G_TASK (result),
+                                                         &err);
+
+  if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free (err);
+    return;
+  }
+
+  g_clear_object (&preview->cancellable);
+
+  preview_page = gschem_page_view_get_page (GSCHEM_PAGE_VIEW (preview));
+
+  if (preview_page == NULL) {
+    g_clear_error (&err);
+    preview_cache_entry_free (entry);
+    return;
+  }
+
+  if (err == NULL) {
+    if (entry->contents != NULL) {
+      preview_cache_insert (entry);
+      cached = entry;
+    }
+    else {
+      cached = preview_cache_lookup (entry->filename);
+      preview_cache_entry_free (entry);
+
+      /* The cached copy has been dropped meanwhile, read it again. */
+      if (cached == NULL) {
+        preview_update (preview);
+        return;
+      }
+    }
+  }
+
+  lepton_page_delete_objects (preview_page);
+
+  if (err == NULL) {
+    preview_read_file (preview_page, cached);
+  }
+  else {
+    preview_show_message (preview_page, err->message);
+    g_error_free (err);
+  }
+
+  preview_loaded (preview);
+}
+
+
+/*! \brief Show a library symbol fetched by a worker thread.
+ *  \par Function Description
+ *  Called in the main thread when the worker thread is done.  Adds
+ *  the data of the symbol to the symbol cache of the component
+ *  library, so that placing the symbol does not fetch it again,
+ *  and replaces the placeholder in the preview page with the
+ *  symbol.  Does nothing if the fetching has been cancelled.
+ */
+static void
+preview_fetch_symbol_ready (GObject *source_object,
+                            GAsyncResult *result,
+                            gpointer user_data)
+{
+  GschemPreview *preview = GSCHEM_PREVIEW (source_object);
+  PreviewCacheEntry *entry;
+  const CLibSymbol *symbol;
+  LeptonPage *preview_page;
+  GError *err = NULL;
+
+  entry = (PreviewCacheEntry*) g_task_propagate_pointer (G_TASK (result),
+                                                         &err);
+
+  if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free (err);
+    return;
+  }
+
+  g_clear_object (&preview->cancellable);
+
+  preview_page = gschem_page_view_get_page (GSCHEM_PAGE_VIEW (preview));
+
+  if (preview_page == NULL) {
+    g_clear_error (&err);
+    preview_cache_entry_free (entry);
+    return;
+  }
+
+  lepton_page_delete_objects (preview_page);
+
+  if (err == NULL) {
+    symbol = preview_get_symbol (preview);
+    if (symbol != NULL) {
+      s_clib_symbol_set_cached_data (symbol, entry->contents);
+    }
+
+    preview_read_symbol (preview, entry->contents);
+    entry->contents = NULL;
+    preview_cache_entry_free (entry);
+  }
+  else {
+    g_message (_("Failed to load symbol data [%1$s] from source [%2$s]: %3$s"),
+               preview->symbol_name, preview->symbol_source, err->message);
+    preview_show_message (preview_page, err->message);
+    g_error_free (err);
+  }
+
+  preview_loaded (preview);
+}
+
+
+/*! \brief Start loading the file of the preview.
+ *  \par Function Description
+ *  The file is read by a worker thread, so that slow disks do not
+ *  block the user interface.  A placeholder is shown meanwhile.
+ *  The contents of the most recently previewed files are cached
+ *  and read again only if the files have been modified.
+ *
+ *  \param [in] preview The preview widget.
+ */
+static void
+preview_load (GschemPreview *preview)
+{
+  LeptonPage *preview_page = gschem_page_view_get_page (GSCHEM_PAGE_VIEW (preview));
+  PreviewCacheEntry *request = g_slice_new0 (PreviewCacheEntry);
+  PreviewCacheEntry *cached = preview_cache_lookup (preview->filename);
+  GTask *task;
+
+  request->filename = g_strdup (preview->filename);
+  request->mtime = (cached != NULL) ? cached->mtime : G_MAXUINT64;
+
+  preview_show_message (preview_page, _("Loading..."));
+
+  preview->cancellable = g_cancellable_new ();
+
+  task = g_task_new (preview,
+                     preview->cancellable,
+                     preview_load_ready,
+                     NULL);
+  g_task_set_task_data (task,
+                        request,
+                        (GDestroyNotify) preview_cache_entry_free);
+  g_task_run_in_thread (task, preview_load_thread);
+  g_object_unref (task);
+}
+
+
+/*! \brief Start loading the library symbol of the preview.
+ *  \par Function Description
+ *  Symbols whose data are in the symbol cache of the component
+ *  library are shown at once.  The data of the other symbols of
+ *  directory and command sources are fetched by a worker thread,
+ *  and a placeholder is shown meanwhile.  The data of symbols of
+ *  Scheme sources are fetched at once, since Guile procedures can
+ *  only be called in the main thread.
+ *
+ *  \param [in] preview The preview widget.
+ *  \return TRUE if the symbol is being fetched by a worker thread.
+ */
+static gboolean
+preview_load_symbol (GschemPreview *preview)
+{
+  LeptonPage *preview_page = gschem_page_view_get_page (GSCHEM_PAGE_VIEW (preview));
+  const CLibSymbol *symbol = preview_get_symbol (preview);
+  PreviewCacheEntry *request;
+  gchar *data;
+  GTask *task;
+
+  if (symbol == NULL) {
+    return FALSE;
+  }
+
+  data = s_clib_symbol_get_cached_data (symbol);
+
+  request = g_slice_new0 (PreviewCacheEntry);
+  request->path = s_clib_symbol_get_filename (symbol);
+  request->command = s_clib_symbol_get_command (symbol);
+
+  if ((data == NULL) && (request->path == NULL) && (request->command == NULL)) {
+    data = s_clib_symbol_get_data (symbol);
+  }
+
+  if ((data != NULL) || ((request->path == NULL) && (request->command == NULL))) {
+    preview_cache_entry_free (request);
+
+    if (data != NULL) {
+      preview_read_symbol (preview, data);
+    }
+    return FALSE;
+  }
+
+  request->filename = preview_symbol_key (preview);
+
+  preview_show_message (preview_page, _("Loading..."));
+
+  preview->cancellable = g_cancellable_new ();
+
+  task = g_task_new (preview,
+                     preview->cancellable,
+                     preview_fetch_symbol_ready,
+                     NULL);
+  g_task_set_task_data (task,
+                        request,
+                        (GDestroyNotify) preview_cache_entry_free);
+  g_task_run_in_thread (task, preview_fetch_symbol_thread);
+  g_object_unref (task);
+
+  return TRUE;
+}
+
+
 /*! \brief Updates the preview widget.
  *  \par Function Description
  *  This function updates the preview: if the preview is active and a
- *  filename has been given, it opens the file and displays
- *  it. Otherwise it displays a blank page.
+ *  filename or a library symbol has been given, it starts loading it
+ *  and displays it when it is ready. If a buffer has been given, it
+ *  displays it at once. Otherwise it displays a blank page.  The
+ *  "loaded" signal is emitted once the contents are displayed.
  *
  *  \param [in] preview The preview widget.
  */
 static void
 preview_update (GschemPreview *preview)
 {
-  int left, top, right, bottom;
-  int width, height;
   GError * err = NULL;
 
   GschemPageView *preview_view = GSCHEM_PAGE_VIEW (preview);
@@ -166,7 +909,7 @@ preview_update (GschemPreview *preview)
     return;
   }
 
-  LeptonToplevel *preview_toplevel = preview_page->toplevel;
+  preview_cancel_load (preview);
 
   /* delete old preview */
   lepton_page_delete_objects (preview_page);
@@ -174,14 +917,15 @@ preview_update (GschemPreview *preview)
   if (preview->active) {
     g_assert ((preview->filename == NULL) || (preview->buffer == NULL));
     if (preview->filename != NULL) {
-      /* open up file in current page */
-      f_open (preview_toplevel,
-              preview_page,
-              preview->filename,
-              F_OPEN_RC | F_OPEN_RESTORE_CWD,
-              NULL);
-      /* test value returned by f_open... - Fix me */
-      /* we should display something if there an error occured - Fix me */
+      /* read the file in a worker thread */
+      preview_load (preview);
+      preview_zoom_extents (preview);
+      return;
+    }
+    if ((preview->symbol_name != NULL) && preview_load_symbol (preview)) {
+      /* the symbol is fetched in a worker thread */
+      preview_zoom_extents (preview);
+      return;
     }
     if (preview->buffer != NULL) {
       /* Load the data buffer */
@@ -193,39 +937,13 @@ preview_update (GschemPreview *preview)
         lepton_page_append_list (preview_page, objects);
       }
       else {
-        lepton_page_append (preview_page,
-                            lepton_text_object_new (2,
-                                                    100,
-                                                    100,
-                                                    LOWER_MIDDLE,
-                                                    0,
-                                                    err->message,
-                                                    10,
-                                                    VISIBLE,
-                                                    SHOW_NAME_VALUE));
+        preview_show_message (preview_page, err->message);
         g_error_free(err);
       }
     }
   }
 
-  if (world_get_object_glist_bounds (lepton_page_objects (preview_page),
-                                     /* Do not include hidden text. */
-                                     FALSE,
-                                     &left, &top,
-                                     &right, &bottom)) {
-    /* Clamp the canvas size to the extents of the page being previewed */
-    width = right - left;
-    height = bottom - top;
-
-    GschemPageGeometry *geometry = gschem_page_view_get_page_geometry (preview_view);
-    geometry->world_left   = left   - ((double)width  * OVER_ZOOM_FACTOR);
-    geometry->world_right  = right  + ((double)width  * OVER_ZOOM_FACTOR);
-    geometry->world_top    = top    - ((double)height * OVER_ZOOM_FACTOR);
-    geometry->world_bottom = bottom + ((double)height * OVER_ZOOM_FACTOR);
-  }
-
-  /* display current page (possibly empty) */
-  gschem_page_view_zoom_extents (preview_view, NULL);
+  preview_loaded (preview);
 }
 
 
@@ -253,6 +971,12 @@ gschem_preview_class_init (GschemPreviewClass *klass)
                          "",
                          NULL,
                          G_PARAM_WRITABLE));
+  g_object_class_install_property (
+    gobject_class, PROP_SYMBOL,
+    g_param_spec_pointer ("symbol",
+                          "",
+                          "",
+                          G_PARAM_WRITABLE));
   g_object_class_install_property(
     gobject_class, PROP_ACTIVE,
     g_param_spec_boolean ("active",
@@ -261,7 +985,16 @@ gschem_preview_class_init (GschemPreviewClass *klass)
                           FALSE,
                           G_PARAM_READWRITE));
 
-
+  g_signal_new ("loaded",
+                G_OBJECT_CLASS_TYPE (klass),
+                (GSignalFlags) (G_SIGNAL_RUN_LAST), /*signal_flags */
+                0, /*class_offset */
+                NULL, /* accumulator */
+                NULL, /* accu_data */
+                g_cclosure_marshal_VOID__VOID,
+                G_TYPE_NONE,
+                0 /* n_params */
+                );
 }
 
 
@@ -338,6 +1071,11 @@ gschem_preview_init (GschemPreview *preview)
   preview->filename = NULL;
   preview->buffer   = NULL;
 
+  preview->symbol_source = NULL;
+  preview->symbol_name   = NULL;
+
+  preview->cancellable = NULL;
+
   gschem_page_view_set_page (GSCHEM_PAGE_VIEW (preview),
                              lepton_page_new (preview->preview_w_current->toplevel,
                                               "preview"));
@@ -352,6 +1090,56 @@ gschem_preview_init (GschemPreview *preview)
                          );
 }
 
+/*! \brief Forget the library symbol of the preview.
+ *
+ *  \param [in] preview The preview widget.
+ */
+static void
+preview_clear_symbol (GschemPreview *preview)
+{
+  g_free (preview->symbol_source);
+  g_free (preview->symbol_name);
+  preview->symbol_source = NULL;
+  preview->symbol_name = NULL;
+}
+
+
+/*! \brief Set the library symbol of the preview.
+ *  \par Function Description
+ *  Only the names of the symbol and of its source are kept, so that
+ *  a refresh of the component library does not leave the preview
+ *  with a dangling symbol.
+ *
+ *  \param [in] preview The preview widget.
+ *  \param [in] symbol  The symbol, or NULL.
+ */
+static void
+preview_set_symbol (GschemPreview *preview,
+                    const CLibSymbol *symbol)
+{
+  GObject *object = G_OBJECT (preview);
+
+  if (preview->filename != NULL) {
+    g_free (preview->filename);
+    preview->filename = NULL;
+    g_object_notify (object, "filename");
+  }
+  if (preview->buffer != NULL) {
+    g_free (preview->buffer);
+    preview->buffer = NULL;
+    g_object_notify (object, "buffer");
+  }
+
+  preview_clear_symbol (preview);
+
+  if (symbol != NULL) {
+    preview->symbol_source =
+      g_strdup (s_clib_source_get_name (s_clib_symbol_get_source (symbol)));
+    preview->symbol_name = g_strdup (s_clib_symbol_get_name (symbol));
+  }
+}
+
+
 static void
 preview_set_property (GObject *object,
                       guint property_id,
@@ -370,6 +1158,7 @@ preview_set_property (GObject *object,
           preview->buffer = NULL;
           g_object_notify (object, "buffer");
         }
+        preview_clear_symbol (preview);
         g_free (preview->filename);
         preview->filename = g_strdup (g_value_get_string (value));
         break;
@@ -380,10 +1169,16 @@ preview_set_property (GObject *object,
           preview->filename = NULL;
           g_object_notify (object, "filename");
         }
+        preview_clear_symbol (preview);
         g_free (preview->buffer);
         preview->buffer = g_strdup (g_value_get_string (value));
         break;
 
+      case PROP_SYMBOL:
+        preview_set_symbol (preview,
+                            (const CLibSymbol*) g_value_get_pointer (value));
+        break;
+
       case PROP_ACTIVE:
         preview->active = g_value_get_boolean (value);
         preview_update (preview);
@@ -422,6 +1217,8 @@ preview_dispose (GObject *self)
   GschemPreview *preview = GSCHEM_PREVIEW (self);
   GschemToplevel *preview_w_current = preview->preview_w_current;
 
+  preview_cancel_load (preview);
+
   if (preview_w_current != NULL) {
     preview_w_current->drawing_area = NULL;
 
@@ -440,6 +1237,7 @@ preview_finalize (GObject *self)
 
   g_free (preview->filename);
   g_free (preview->buffer);
+  preview_clear_symbol (preview);
 
   G_OBJECT_CLASS (gschem_preview_parent_class)->finalize (self);
 }
@@ -24,6 +24,11 @@
  */
 
 #include <config.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
 #include "gschem.h"
 
 /*! \private
@@ -61,6 +66,9 @@ G_DEFINE_TYPE (GschemSelectionAdapter,
 static void
 gschem_selection_adapter_class_init (GschemSelectionAdapterClass *klass);
 
+static void
+finalize (GObject *object);
+
 static GList*
 get_selection_iter (GschemSelectionAdapter *adapter);
 
@@ -70,210 +78,373 @@ get_property (GObject *object, guint param_id, GValue *value, GParamSpec *pspec)
 static void
 gschem_selection_adapter_init (GschemSelectionAdapter *adapter);
 
+static int
+object_changed (void *user_data, LeptonObject *object);
+
+static int
+object_pre_changed (void *user_data, LeptonObject *object);
+
 static void
 selection_changed (LeptonList *selection,
                    GschemSelectionAdapter *adapter);
+
+static void
+selection_item_added (LeptonList *selection,
+                      LeptonObject *object,
+                      GschemSelectionAdapter *adapter);
+
+static void
+selection_item_removed (LeptonList *selection,
+                        LeptonObject *object,
+                        GschemSelectionAdapter *adapter);
+
 static void
 set_property (GObject *object, guint param_id, const GValue *value, GParamSpec *pspec);
 
 
 
-/*! \brief Get the cap style from the selection
+/*! \private
+ *  \brief Properties summarized over the selection
+ */
+enum
+{
+  SUMMARY_CAP_STYLE,
+  SUMMARY_DASH_LENGTH,
+  SUMMARY_DASH_SPACE,
+  SUMMARY_FILL_ANGLE1,
+  SUMMARY_FILL_ANGLE2,
+  SUMMARY_FILL_PITCH1,
+  SUMMARY_FILL_PITCH2,
+  SUMMARY_FILL_TYPE,
+  SUMMARY_FILL_WIDTH,
+  SUMMARY_LINE_TYPE,
+  SUMMARY_LINE_WIDTH,
+  SUMMARY_OBJECT_COLOR,
+  SUMMARY_PIN_TYPE,
+  SUMMARY_TEXT_ALIGNMENT,
+  SUMMARY_TEXT_COLOR,
+  SUMMARY_TEXT_ROTATION,
+  SUMMARY_TEXT_SIZE,
+  SUMMARY_COUNT
+};
+
+/*! \private
+ *  \brief Summary of one property over the selected objects
+ */
+typedef struct
+{
+  int value;  /* The value of the first object counted */
+  int count;  /* The number of objects counted having this value */
+  int total;  /* The number of objects counted */
+} SummaryValue;
+
+/*! \private
+ *  \brief Summary of the properties of the selected objects
+ */
+struct _GschemSelectionSummary
+{
+  /* TRUE if the summary matches the selection */
+  gboolean valid;
+
+  /* TRUE if the summary has already been updated for the change
+   * of the selection being notified */
+  gboolean updated;
+
+  /* The object being selected, between the pre-change and change
+   * notifications of its selected flag */
+  LeptonObject *selecting_object;
+
+  SummaryValue values[SUMMARY_COUNT];
+
+  /* The number of selected text objects, and the text object if
+   * there is only one */
+  int text_count;
+  LeptonObject *text_object;
+};
+
+
+
+/*! \private
+ *  \brief Count or uncount a property value in a summary
  *
- *  \param [in] adapter This adapter
+ *  \param [in,out] summary The summary of the property
+ *  \param [in]     value   The value of the property of an object
+ *  \param [in]     add     TRUE to count the value, FALSE to uncount it
+ *  \return FALSE if the summary can no longer tell the value of
+ *          the property, otherwise TRUE.
+ */
+static gboolean
+summary_value_count (SummaryValue *summary, int value, gboolean add)
+{
+  if (add) {
+    if (summary->total == 0) {
+      summary->value = value;
+      summary->count = 0;
+    }
+    if (summary->value == value) {
+      summary->count++;
+    }
+    summary->total++;
+  } else if (summary->total > 0) {
+    if (summary->value == value) {
+      summary->count--;
+    }
+    summary->total--;
+
+    /* The remaining values are unknown */
+    if ((summary->count == 0) && (summary->total > 0)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+
+
+/*! \private
+ *  \brief Count or uncount the properties of an object in a summary
  *
- *  \retval NO_SELECTION    No objects are selected
- *  \retval MULTIPLE_VALUES Multiple objects with different cap styles are selected
- *  \retval others          The cap style of the selected objects
+ *  \param [in,out] summary The summary of the selection
+ *  \param [in]     object  The object
+ *  \param [in]     add     TRUE to count the object, FALSE to uncount it
+ *  \return FALSE if the summary has to be computed again, otherwise TRUE.
  */
-int
-gschem_selection_adapter_get_cap_style (GschemSelectionAdapter *adapter)
+static gboolean
+summary_count_object (GschemSelectionSummary *summary,
+                      LeptonObject *object,
+                      gboolean add)
 {
-  gint cap_style = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
+  gboolean success = TRUE;
+  LeptonStrokeCapType cap_style;
+  LeptonStrokeType line_type;
+  gint line_width;
+  gint dash_length;
+  gint dash_space;
+  LeptonFillType fill_type;
+  gint fill_width;
+  gint pitch1;
+  gint angle1;
+  gint pitch2;
+  gint angle2;
+  SummaryValue *values = summary->values;
+
+  if (object == NULL) {
+    return TRUE;
+  }
 
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    LeptonStrokeCapType temp_cap_style;
-    gint temp_dash_length;
-    gint temp_dash_space;
-    LeptonStrokeType temp_line_type;
-    gint temp_line_width;
+  if (lepton_object_get_line_options (object,
+                                      &cap_style,
+                                      &line_type,
+                                      &line_width,
+                                      &dash_length,
+                                      &dash_space))
+  {
+    success &= summary_value_count (&values[SUMMARY_CAP_STYLE], cap_style, add);
+    success &= summary_value_count (&values[SUMMARY_LINE_TYPE], line_type, add);
+    success &= summary_value_count (&values[SUMMARY_LINE_WIDTH], line_width, add);
+    success &= summary_value_count (&values[SUMMARY_DASH_LENGTH], dash_length, add);
+    success &= summary_value_count (&values[SUMMARY_DASH_SPACE], dash_space, add);
+  }
 
-    success = lepton_object_get_line_options (object,
-                                              &temp_cap_style,
-                                              &temp_line_type,
-                                              &temp_line_width,
-                                              &temp_dash_length,
-                                              &temp_dash_space);
+  if (lepton_object_get_fill_options (object,
+                                      &fill_type,
+                                      &fill_width,
+                                      &pitch1,
+                                      &angle1,
+                                      &pitch2,
+                                      &angle2))
+  {
+    success &= summary_value_count (&values[SUMMARY_FILL_TYPE], fill_type, add);
+    success &= summary_value_count (&values[SUMMARY_FILL_WIDTH], fill_width, add);
+    success &= summary_value_count (&values[SUMMARY_FILL_PITCH1], pitch1, add);
+    success &= summary_value_count (&values[SUMMARY_FILL_ANGLE1], angle1, add);
+    success &= summary_value_count (&values[SUMMARY_FILL_PITCH2], pitch2, add);
+    success &= summary_value_count (&values[SUMMARY_FILL_ANGLE2], angle2, add);
+  }
 
-    if (success) {
-      if (cap_style < 0) {
-        cap_style = temp_cap_style;
-      }
-      else if (cap_style != temp_cap_style) {
-        cap_style = MULTIPLE_VALUES;
-        break;
+  if (lepton_object_is_arc (object)  ||
+      lepton_object_is_box (object)  ||
+      lepton_object_is_bus (object)  ||
+      lepton_object_is_net (object)  ||
+      lepton_object_is_line (object) ||
+      lepton_object_is_path (object) ||
+      lepton_object_is_text (object) ||
+      lepton_object_is_circle (object))
+  {
+    success &= summary_value_count (&values[SUMMARY_OBJECT_COLOR],
+                                    lepton_object_get_color (object),
+                                    add);
+  }
+
+  if (lepton_object_is_pin (object)) {
+    success &= summary_value_count (&values[SUMMARY_PIN_TYPE],
+                                    object->pin_type,
+                                    add);
+  }
+
+  if (lepton_object_is_text (object)) {
+    success &= summary_value_count (&values[SUMMARY_TEXT_ALIGNMENT],
+                                    lepton_text_object_get_alignment (object),
+                                    add);
+    success &= summary_value_count (&values[SUMMARY_TEXT_COLOR],
+                                    lepton_object_get_color (object),
+                                    add);
+    success &= summary_value_count (&values[SUMMARY_TEXT_ROTATION],
+                                    lepton_text_object_get_angle (object),
+                                    add);
+    success &= summary_value_count (&values[SUMMARY_TEXT_SIZE],
+                                    lepton_text_object_get_size (object),
+                                    add);
+
+    if (add) {
+      summary->text_count++;
+      summary->text_object = object;
+    } else {
+      summary->text_count--;
+
+      /* The remaining text object is unknown */
+      if (summary->text_count == 1) {
+        success = FALSE;
       }
     }
-
-    iter = g_list_next (iter);
   }
 
-  return cap_style;
+  return success;
 }
 
 
 
-/*! \brief Get the dash_length from the selection
+/*! \private
+ *  \brief Get the summary of the properties of the selection
  *
- *  \param [in] adapter This adapter
+ *  \par Function Description
+ *  Computes the summary of all properties in one pass over the
+ *  selection if it is not up to date, and returns it.
  *
- *  \retval NO_SELECTION    No objects are selected
- *  \retval MULTIPLE_VALUES Multiple objects with different dash lengths are selected
- *  \retval others          The dash length of the selected objects
+ *  \param [in] adapter This adapter
+ *  \return The summary of the selection [transfer none]
  */
-int
-gschem_selection_adapter_get_dash_length (GschemSelectionAdapter *adapter)
+static GschemSelectionSummary*
+get_summary (GschemSelectionAdapter *adapter)
 {
-  gint dash_length = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
+  GschemSelectionSummary *summary = adapter->summary;
 
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    LeptonStrokeCapType temp_cap_style;
-    gint temp_dash_length;
-    gint temp_dash_space;
-    LeptonStrokeType temp_line_type;
-    gint temp_line_width;
+  if (!summary->valid) {
+    GList *iter;
 
-    success = lepton_object_get_line_options (object,
-                                              &temp_cap_style,
-                                              &temp_line_type,
-                                              &temp_line_width,
-                                              &temp_dash_length,
-                                              &temp_dash_space);
+    memset (summary->values, 0, sizeof (summary->values));
+    summary->text_count = 0;
+    summary->text_object = NULL;
 
-    if (success) {
-      if (dash_length < 0) {
-        dash_length = temp_dash_length;
-      }
-      else if (dash_length != temp_dash_length) {
-        dash_length = MULTIPLE_VALUES;
-        break;
-      }
+    for (iter = get_selection_iter (adapter);
+         iter != NULL;
+         iter = g_list_next (iter)) {
+      summary_count_object (summary, (LeptonObject*) iter->data, TRUE);
     }
 
-    iter = g_list_next (iter);
+    summary->valid = TRUE;
   }
 
-  return dash_length;
+  return summary;
 }
 
 
 
-/*! \brief Get the dash space from the selection
+/*! \private
+ *  \brief Get the summarized value of a property of the selection
  *
- *  \param [in] adapter This adapter
+ *  \param [in] adapter  This adapter
+ *  \param [in] property The property, one of the SUMMARY_* values
  *
- *  \retval NO_SELECTION    No objects are selected
- *  \retval MULTIPLE_VALUES Multiple objects with different dash spacings are selected
- *  \retval others          The dash spacing of the selected objects
+ *  \retval NO_SELECTION    No objects having the property are selected
+ *  \retval MULTIPLE_VALUES Multiple objects with different values are selected
+ *  \retval others          The value of the property of the selected objects
  */
-int
-gschem_selection_adapter_get_dash_space (GschemSelectionAdapter *adapter)
+static int
+get_summary_value (GschemSelectionAdapter *adapter, int property)
 {
-  gint dash_space = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
+  SummaryValue *value;
 
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    LeptonStrokeCapType temp_cap_style;
-    gint temp_dash_length;
-    gint temp_dash_space;
-    LeptonStrokeType temp_line_type;
-    gint temp_line_width;
+  g_return_val_if_fail (adapter != NULL, NO_SELECTION);
 
-    success = lepton_object_get_line_options (object,
-                                              &temp_cap_style,
-                                              &temp_line_type,
-                                              &temp_line_width,
-                                              &temp_dash_length,
-                                              &temp_dash_space);
+  value = &get_summary (adapter)->values[property];
 
-    if (success) {
-      if (dash_space < 0) {
-        dash_space = temp_dash_space;
-      }
-      else if (dash_space != temp_dash_space) {
-        dash_space = MULTIPLE_VALUES;
-        break;
-      }
-    }
+  if (value->total == 0) {
+    return NO_SELECTION;
+  }
 
-    iter = g_list_next (iter);
+  if (value->count != value->total) {
+    return MULTIPLE_VALUES;
   }
 
-  return dash_space;
+  return value->value;
 }
 
 
 
-/*! \brief Get the first fill line angle of the selected objects
+/*! \private
+ *  \brief Mark the summary of the selection as out of date
+ *
+ *  \param [in] adapter This adapter
+ */
+static void
+invalidate_summary (GschemSelectionAdapter *adapter)
+{
+  adapter->summary->valid = FALSE;
+}
+
+
+
+/*! \brief Get the cap style from the selection
  *
  *  \param [in] adapter This adapter
  *
  *  \retval NO_SELECTION    No objects are selected
- *  \retval MULTIPLE_VALUES Multiple objects with different fill line angles are selected
- *  \retval others          The fill line angle of the selected objects
+ *  \retval MULTIPLE_VALUES Multiple objects with different cap styles are selected
+ *  \retval others          The cap style of the selected objects
  */
 int
-gschem_selection_adapter_get_fill_angle1 (GschemSelectionAdapter *adapter)
+gschem_selection_adapter_get_cap_style (GschemSelectionAdapter *adapter)
 {
-  gint fill_angle = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
+  return get_summary_value (adapter, SUMMARY_CAP_STYLE);
+}
 
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
 
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
 
+/*! \brief Get the dash_length from the selection
+ *
+ *  \param [in] adapter This adapter
+ *
+ *  \retval NO_SELECTION    No objects are selected
+ *  \retval MULTIPLE_VALUES Multiple objects with different dash lengths are selected
+ *  \retval others          The dash length of the selected objects
+ */
+int
+gschem_selection_adapter_get_dash_length (GschemSelectionAdapter *adapter)
+{
+  return get_summary_value (adapter, SUMMARY_DASH_LENGTH);
+}
 
-    if (success) {
-      if (fill_angle < 0) {
-        fill_angle = temp_angle1;
-      }
-      else if (fill_angle != temp_angle1) {
-        fill_angle = MULTIPLE_VALUES;
-        break;
-      }
-    }
 
-    iter = g_list_next (iter);
-  }
 
-  return fill_angle;
+/*! \brief Get the dash space from the selection
+ *
+ *  \param [in] adapter This adapter
+ *
+ *  \retval NO_SELECTION    No objects are selected
+ *  \retval MULTIPLE_VALUES Multiple objects with different dash spacings are selected
+ *  \retval others          The dash spacing of the selected objects
+ */
+int
+gschem_selection_adapter_get_dash_space (GschemSelectionAdapter *adapter)
+{
+  return get_summary_value (adapter, SUMMARY_DASH_SPACE);
 }
 
 
 
-/*! \brief Get the second fill line angle of the selected objects
+/*! \brief Get the first fill line angle of the selected objects
  *
  *  \param [in] adapter This adapter
  *
@@ -282,44 +453,25 @@ gschem_selection_adapter_get_fill_angle1 (GschemSelectionAdapter *adapter)
  *  \retval others          The fill line angle of the selected objects
  */
 int
-gschem_selection_adapter_get_fill_angle2 (GschemSelectionAdapter *adapter)
+gschem_selection_adapter_get_fill_angle1 (GschemSelectionAdapter *adapter)
 {
-  gint fill_angle = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
-
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
-
+  return get_summary_value (adapter, SUMMARY_FILL_ANGLE1);
+}
 
-    if (success) {
-      if (fill_angle < 0) {
-        fill_angle = temp_angle2;
-      }
-      else if (fill_angle != temp_angle2) {
-        fill_angle = MULTIPLE_VALUES;
-        break;
-      }
-    }
 
-    iter = g_list_next (iter);
-  }
 
-  return fill_angle;
+/*! \brief Get the second fill line angle of the selected objects
+ *
+ *  \param [in] adapter This adapter
+ *
+ *  \retval NO_SELECTION    No objects are selected
+ *  \retval MULTIPLE_VALUES Multiple objects with different fill line angles are selected
+ *  \retval others          The fill line angle of the selected objects
+ */
+int
+gschem_selection_adapter_get_fill_angle2 (GschemSelectionAdapter *adapter)
+{
+  return get_summary_value (adapter, SUMMARY_FILL_ANGLE2);
 }
 
 
@@ -335,42 +487,7 @@ gschem_selection_adapter_get_fill_angle2 (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_fill_pitch1 (GschemSelectionAdapter *adapter)
 {
-  gint fill_pitch = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
-
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
-
-
-    if (success) {
-      if (fill_pitch < 0) {
-        fill_pitch = temp_pitch1;
-      }
-      else if (fill_pitch != temp_pitch1) {
-        fill_pitch = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return fill_pitch;
+  return get_summary_value (adapter, SUMMARY_FILL_PITCH1);
 }
 
 
@@ -386,42 +503,7 @@ gschem_selection_adapter_get_fill_pitch1 (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_fill_pitch2 (GschemSelectionAdapter *adapter)
 {
-  gint fill_pitch = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
-
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
-
-
-    if (success) {
-      if (fill_pitch < 0) {
-        fill_pitch = temp_pitch2;
-      }
-      else if (fill_pitch != temp_pitch2) {
-        fill_pitch = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return fill_pitch;
+  return get_summary_value (adapter, SUMMARY_FILL_PITCH2);
 }
 
 
@@ -437,42 +519,7 @@ gschem_selection_adapter_get_fill_pitch2 (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_fill_type (GschemSelectionAdapter *adapter)
 {
-  gint fill_type = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
-
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
-
-
-    if (success) {
-      if (fill_type < 0) {
-        fill_type = temp_fill_type;
-      }
-      else if (fill_type != temp_fill_type) {
-        fill_type = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return fill_type;
+  return get_summary_value (adapter, SUMMARY_FILL_TYPE);
 }
 
 
@@ -485,93 +532,26 @@ gschem_selection_adapter_get_fill_type (GschemSelectionAdapter *adapter)
  *  \retval MULTIPLE_VALUES Multiple objects with different fill line widths are selected
  *  \retval others          The fill line width of the selected objects
  */
-int
-gschem_selection_adapter_get_fill_width (GschemSelectionAdapter *adapter)
-{
-  gint fill_width = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    gint temp_angle1;
-    gint temp_angle2;
-    LeptonFillType temp_fill_type;
-    gint temp_pitch1;
-    gint temp_pitch2;
-    gint temp_width;
-
-    success = lepton_object_get_fill_options (object,
-                                              &temp_fill_type,
-                                              &temp_width,
-                                              &temp_pitch1,
-                                              &temp_angle1,
-                                              &temp_pitch2,
-                                              &temp_angle2);
-
-
-    if (success) {
-      if (fill_width < 0) {
-        fill_width = temp_width;
-      }
-      else if (fill_width != temp_width) {
-        fill_width = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return fill_width;
-}
-
-
-
-/*! \brief Get the line_type from the selection
- *
- *  \param [in] adapter This adapter
- *
- *  \retval NO_SELECTION    No objects are selected
- *  \retval MULTIPLE_VALUES Multiple objects with different line types are selected
- *  \retval others          The line type of the selected objects
- */
-int
-gschem_selection_adapter_get_line_type (GschemSelectionAdapter *adapter)
-{
-  gint line_type = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    LeptonStrokeCapType temp_cap_style;
-    gint temp_dash_length;
-    gint temp_dash_space;
-    LeptonStrokeType temp_line_type;
-    gint temp_line_width;
-
-    success = lepton_object_get_line_options (object,
-                                              &temp_cap_style,
-                                              &temp_line_type,
-                                              &temp_line_width,
-                                              &temp_dash_length,
-                                              &temp_dash_space);
+int
+gschem_selection_adapter_get_fill_width (GschemSelectionAdapter *adapter)
+{
+  return get_summary_value (adapter, SUMMARY_FILL_WIDTH);
+}
 
-    if (success) {
-      if (line_type < 0) {
-        line_type = temp_line_type;
-      }
-      else if (line_type != temp_line_type) {
-        line_type = MULTIPLE_VALUES;
-        break;
-      }
-    }
 
-    iter = g_list_next (iter);
-  }
 
-  return line_type;
+/*! \brief Get the line_type from the selection
+ *
+ *  \param [in] adapter This adapter
+ *
+ *  \retval NO_SELECTION    No objects are selected
+ *  \retval MULTIPLE_VALUES Multiple objects with different line types are selected
+ *  \retval others          The line type of the selected objects
+ */
+int
+gschem_selection_adapter_get_line_type (GschemSelectionAdapter *adapter)
+{
+  return get_summary_value (adapter, SUMMARY_LINE_TYPE);
 }
 
 
@@ -587,39 +567,7 @@ gschem_selection_adapter_get_line_type (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_line_width (GschemSelectionAdapter *adapter)
 {
-  gint line_width = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-    gboolean success;
-    LeptonStrokeCapType temp_cap_style;
-    gint temp_dash_length;
-    gint temp_dash_space;
-    LeptonStrokeType temp_line_type;
-    gint temp_line_width;
-
-    success = lepton_object_get_line_options (object,
-                                              &temp_cap_style,
-                                              &temp_line_type,
-                                              &temp_line_width,
-                                              &temp_dash_length,
-                                              &temp_dash_space);
-
-    if (success) {
-      if (line_width < 0) {
-        line_width = temp_line_width;
-      }
-      else if (line_width != temp_line_width) {
-        line_width = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return line_width;
+  return get_summary_value (adapter, SUMMARY_LINE_WIDTH);
 }
 
 
@@ -635,48 +583,7 @@ gschem_selection_adapter_get_line_width (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_object_color (GschemSelectionAdapter *adapter)
 {
-  int color = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    iter = g_list_next (iter);
-    if ((object != NULL) &&
-        (lepton_object_is_arc (object)  ||
-         lepton_object_is_box (object)  ||
-         lepton_object_is_bus (object)  ||
-         lepton_object_is_net (object)  ||
-         lepton_object_is_line (object) ||
-         lepton_object_is_path (object) ||
-         lepton_object_is_text (object) ||
-         lepton_object_is_circle (object)))
-    {
-      color = lepton_object_get_color (object);
-      break;
-    }
-  }
-
-  /* Check if all other objects have the same properties */
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    if ((object != NULL) &&
-        (lepton_object_is_arc (object)  ||
-         lepton_object_is_box (object)  ||
-         lepton_object_is_line (object) ||
-         lepton_object_is_path (object) ||
-         lepton_object_is_text (object) ||
-         lepton_object_is_circle (object)))
-    {
-      if (color != lepton_object_get_color (object)) {
-        color = MULTIPLE_VALUES;
-        break;
-      }
-    }
-    iter = g_list_next (iter);
-  }
-
-  return color;
+  return get_summary_value (adapter, SUMMARY_OBJECT_COLOR);
 }
 
 
@@ -692,34 +599,7 @@ gschem_selection_adapter_get_object_color (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_pin_type (GschemSelectionAdapter *adapter)
 {
-  int type = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    iter = g_list_next (iter);
-    if (lepton_object_is_pin (object))
-    {
-      type = object->pin_type;
-      break;
-    }
-  }
-
-  /* Check if all other objects have the same properties */
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    if (lepton_object_is_pin (object))
-    {
-      if (type != object->pin_type) {
-        type = MULTIPLE_VALUES;
-        break;
-      }
-    }
-    iter = g_list_next (iter);
-  }
-
-  return type;
+  return get_summary_value (adapter, SUMMARY_PIN_TYPE);
 }
 
 
@@ -750,29 +630,7 @@ gschem_selection_adapter_get_selection (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_text_alignment (GschemSelectionAdapter *adapter)
 {
-  gint alignment = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-
-    if (lepton_object_is_text (object))
-    {
-      int temp_alignment = lepton_text_object_get_alignment (object);
-
-      if (alignment < 0) {
-        alignment = temp_alignment;
-      }
-      else if (alignment != temp_alignment) {
-        alignment = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return alignment;
+  return get_summary_value (adapter, SUMMARY_TEXT_ALIGNMENT);
 }
 
 
@@ -788,34 +646,7 @@ gschem_selection_adapter_get_text_alignment (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_text_color (GschemSelectionAdapter *adapter)
 {
-  int color = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    iter = g_list_next (iter);
-    if (lepton_object_is_text (object))
-    {
-      color = lepton_object_get_color (object);
-      break;
-    }
-  }
-
-  /* Check if all other objects have the same properties */
-
-  while (iter != NULL) {
-    LeptonObject* object = (LeptonObject *) iter->data;
-    if (lepton_object_is_text (object))
-    {
-      if (color != lepton_object_get_color (object)) {
-        color = MULTIPLE_VALUES;
-        break;
-      }
-    }
-    iter = g_list_next (iter);
-  }
-
-  return color;
+  return get_summary_value (adapter, SUMMARY_TEXT_COLOR);
 }
 
 
@@ -831,29 +662,7 @@ gschem_selection_adapter_get_text_color (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_text_rotation (GschemSelectionAdapter *adapter)
 {
-  gint angle = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-
-    if (lepton_object_is_text (object))
-    {
-      int temp_angle = lepton_text_object_get_angle (object);
-
-      if (angle < 0) {
-        angle = temp_angle;
-      }
-      else if (angle != temp_angle) {
-        angle = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return angle;
+  return get_summary_value (adapter, SUMMARY_TEXT_ROTATION);
 }
 
 
@@ -869,29 +678,7 @@ gschem_selection_adapter_get_text_rotation (GschemSelectionAdapter *adapter)
 int
 gschem_selection_adapter_get_text_size (GschemSelectionAdapter *adapter)
 {
-  gint size = NO_SELECTION;
-  GList *iter = get_selection_iter (adapter);
-
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
-
-    if (lepton_object_is_text (object))
-    {
-      int temp_size = lepton_text_object_get_size (object);
-
-      if (size < 0) {
-        size = temp_size;
-      }
-      else if (size != temp_size) {
-        size = MULTIPLE_VALUES;
-        break;
-      }
-    }
-
-    iter = g_list_next (iter);
-  }
-
-  return size;
+  return get_summary_value (adapter, SUMMARY_TEXT_SIZE);
 }
 
 
@@ -905,26 +692,17 @@ gschem_selection_adapter_get_text_size (GschemSelectionAdapter *adapter)
 const char*
 gschem_selection_adapter_get_text_string (GschemSelectionAdapter *adapter)
 {
-  const char *string = NULL;
-  GList *iter = get_selection_iter (adapter);
+  GschemSelectionSummary *summary;
 
-  while (iter != NULL) {
-    LeptonObject *object = (LeptonObject*) iter->data;
+  g_return_val_if_fail (adapter != NULL, NULL);
 
-    if (lepton_object_is_text (object))
-    {
-      if (string == NULL) {
-        string = lepton_text_object_get_string (object);
-      } else {
-        string = NULL;
-        break;
-      }
-    }
+  summary = get_summary (adapter);
 
-    iter = g_list_next (iter);
+  if (summary->text_count != 1) {
+    return NULL;
   }
 
-  return string;
+  return lepton_text_object_get_string (summary->text_object);
 }
 
 
@@ -1010,6 +788,8 @@ gschem_selection_adapter_set_fill_angle1 (GschemSelectionAdapter *adapter, int a
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-angle1");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1069,6 +849,8 @@ gschem_selection_adapter_set_fill_angle2 (GschemSelectionAdapter *adapter, int a
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-angle2");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1130,6 +912,8 @@ gschem_selection_adapter_set_fill_pitch1 (GschemSelectionAdapter *adapter, int p
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-pitch1");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1189,6 +973,8 @@ gschem_selection_adapter_set_fill_pitch2 (GschemSelectionAdapter *adapter, int p
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-pitch2");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1250,6 +1036,8 @@ gschem_selection_adapter_set_fill_type (GschemSelectionAdapter *adapter, int fil
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-angle1");
   g_object_notify (G_OBJECT (adapter), "fill-angle2");
   g_object_notify (G_OBJECT (adapter), "fill-pitch1");
@@ -1315,6 +1103,8 @@ gschem_selection_adapter_set_fill_width (GschemSelectionAdapter *adapter, int fi
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "fill-width");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1372,6 +1162,8 @@ gschem_selection_adapter_set_line_type (GschemSelectionAdapter *adapter, int lin
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "line-type");
   g_object_notify (G_OBJECT (adapter), "dash-length");
   g_object_notify (G_OBJECT (adapter), "dash-space");
@@ -1431,6 +1223,8 @@ gschem_selection_adapter_set_line_width (GschemSelectionAdapter *adapter, int li
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "line-width");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1488,6 +1282,8 @@ gschem_selection_adapter_set_dash_length (GschemSelectionAdapter *adapter, int d
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "dash-length");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1545,6 +1341,8 @@ gschem_selection_adapter_set_dash_space (GschemSelectionAdapter *adapter, int da
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "dash-space");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1602,6 +1400,8 @@ gschem_selection_adapter_set_cap_style (GschemSelectionAdapter *adapter, int cap
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "cap-style");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1623,6 +1423,8 @@ gschem_selection_adapter_set_object_color (GschemSelectionAdapter *adapter, int
   lepton_object_list_set_color (lepton_list_get_glist (adapter->selection),
                                 color);
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "object-color");
   g_object_notify (G_OBJECT (adapter), "text-color");
 
@@ -1659,6 +1461,8 @@ gschem_selection_adapter_set_pin_type (GschemSelectionAdapter *adapter, int type
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "pin-type");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1682,14 +1486,33 @@ gschem_selection_adapter_set_selection (GschemSelectionAdapter *adapter,
                                           (gpointer) selection_changed,
                                           adapter);
 
+    g_signal_handlers_disconnect_by_func (adapter->selection,
+                                          (gpointer) selection_item_added,
+                                          adapter);
+
+    g_signal_handlers_disconnect_by_func (adapter->selection,
+                                          (gpointer) selection_item_removed,
+                                          adapter);
+
     g_object_unref (adapter->selection);
   }
 
   adapter->selection = selection;
+  invalidate_summary (adapter);
 
   if (adapter->selection != NULL) {
     g_object_ref (adapter->selection);
 
+    g_signal_connect (adapter->selection,
+                      "item-added",
+                      G_CALLBACK (selection_item_added),
+                      adapter);
+
+    g_signal_connect (adapter->selection,
+                      "item-removed",
+                      G_CALLBACK (selection_item_removed),
+                      adapter);
+
     g_signal_connect (adapter->selection,
                       "changed",
                       G_CALLBACK (selection_changed),
@@ -1741,6 +1564,8 @@ gschem_selection_adapter_set_text_alignment (GschemSelectionAdapter *adapter, in
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "text-alignment");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1774,6 +1599,8 @@ gschem_selection_adapter_set_text_color (GschemSelectionAdapter *adapter, int co
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "object-color");
   g_object_notify (G_OBJECT (adapter), "text-color");
 
@@ -1810,6 +1637,8 @@ gschem_selection_adapter_set_text_rotation (GschemSelectionAdapter *adapter, int
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "text-rotation");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1845,6 +1674,8 @@ gschem_selection_adapter_set_text_size (GschemSelectionAdapter *adapter, int siz
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "text-size");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1891,6 +1722,8 @@ gschem_selection_adapter_set_text_string (GschemSelectionAdapter *adapter, const
     iter = g_list_next (iter);
   }
 
+  invalidate_summary (adapter);
+
   g_object_notify (G_OBJECT (adapter), "text-string");
 
   g_signal_emit_by_name (adapter, "handle-undo");
@@ -1909,7 +1742,21 @@ gschem_selection_adapter_set_toplevel (GschemSelectionAdapter *adapter,
 {
   g_return_if_fail (adapter != NULL);
 
+  if (adapter->toplevel != NULL) {
+    lepton_object_remove_change_notify (adapter->toplevel,
+                                        object_pre_changed,
+                                        object_changed,
+                                        adapter);
+  }
+
   adapter->toplevel = toplevel;
+
+  if (adapter->toplevel != NULL) {
+    lepton_object_add_change_notify (adapter->toplevel,
+                                     object_pre_changed,
+                                     object_changed,
+                                     adapter);
+  }
 }
 
 
@@ -1922,6 +1769,8 @@ gschem_selection_adapter_set_toplevel (GschemSelectionAdapter *adapter,
 static void
 gschem_selection_adapter_class_init (GschemSelectionAdapterClass *klass)
 {
+  G_OBJECT_CLASS (klass)->finalize = finalize;
+
   G_OBJECT_CLASS (klass)->get_property = get_property;
   G_OBJECT_CLASS (klass)->set_property = set_property;
 
@@ -2259,6 +2108,147 @@ get_property (GObject *object, guint param_id, GValue *value, GParamSpec *pspec)
 static void
 gschem_selection_adapter_init (GschemSelectionAdapter *adapter)
 {
+  adapter->summary = g_new0 (GschemSelectionSummary, 1);
+}
+
+
+
+/*! \private
+ *  \brief Finalize the adapter
+ *
+ *  \param [in] object This adapter
+ */
+static void
+finalize (GObject *object)
+{
+  GschemSelectionAdapter *adapter = GSCHEM_SELECTION_ADAPTER (object);
+
+  if (adapter->toplevel != NULL) {
+    lepton_object_remove_change_notify (adapter->toplevel,
+                                        object_pre_changed,
+                                        object_changed,
+                                        adapter);
+    adapter->toplevel = NULL;
+  }
+
+  if (adapter->selection != NULL) {
+    g_signal_handlers_disconnect_by_data (adapter->selection, adapter);
+    g_object_unref (adapter->selection);
+    adapter->selection = NULL;
+  }
+
+  g_free (adapter->summary);
+  adapter->summary = NULL;
+
+  G_OBJECT_CLASS (gschem_selection_adapter_parent_class)->finalize (object);
+}
+
+
+
+/*! \private
+ *  \brief Signal handler for when an object is added to the selection
+ *
+ *  \par Function Description
+ *  Counts the properties of the object in the summary of the
+ *  selection, so that it need not be computed again.
+ *
+ *  \param [in] selection The selection that changed
+ *  \param [in] object    The object added
+ *  \param [in] adapter   This adapter
+ */
+static void
+selection_item_added (LeptonList *selection,
+                      LeptonObject *object,
+                      GschemSelectionAdapter *adapter)
+{
+  g_return_if_fail (adapter != NULL);
+
+  if (adapter->summary->valid) {
+    summary_count_object (adapter->summary, object, TRUE);
+    adapter->summary->updated = TRUE;
+  }
+}
+
+
+
+/*! \private
+ *  \brief Signal handler for when an object is removed from the selection
+ *
+ *  \par Function Description
+ *  Uncounts the properties of the object from the summary of the
+ *  selection.  If the summary can no longer tell the properties of
+ *  the remaining objects, it is computed again when needed.
+ *
+ *  \param [in] selection The selection that changed
+ *  \param [in] object    The object removed
+ *  \param [in] adapter   This adapter
+ */
+static void
+selection_item_removed (LeptonList *selection,
+                        LeptonObject *object,
+                        GschemSelectionAdapter *adapter)
+{
+  g_return_if_fail (adapter != NULL);
+
+  if (adapter->summary->valid) {
+    adapter->summary->valid =
+      summary_count_object (adapter->summary, object, FALSE);
+    adapter->summary->updated = TRUE;
+  }
+}
+
+
+
+/*! \private
+ *  \brief Object pre-change notification handler
+ *
+ *  \par Function Description
+ *  Remembers an unselected object about to change, so that
+ *  object_changed() can tell whether the change is only its
+ *  selection.
+ *
+ *  \param [in] user_data This adapter
+ *  \param [in] object    The object about to change
+ *  \return Always 0.
+ */
+static int
+object_pre_changed (void *user_data, LeptonObject *object)
+{
+  GschemSelectionAdapter *adapter = GSCHEM_SELECTION_ADAPTER (user_data);
+
+  adapter->summary->selecting_object = object->selected ? NULL : object;
+
+  return 0;
+}
+
+
+
+/*! \private
+ *  \brief Object change notification handler
+ *
+ *  \par Function Description
+ *  Marks the summary of the selection as out of date when one of
+ *  the selected objects is modified.  Objects which have just been
+ *  selected are not taken into account, as they are counted in the
+ *  summary when they are added to the selection.
+ *
+ *  \param [in] user_data This adapter
+ *  \param [in] object    The modified object
+ *  \return Always 0.
+ */
+static int
+object_changed (void *user_data, LeptonObject *object)
+{
+  GschemSelectionAdapter *adapter = GSCHEM_SELECTION_ADAPTER (user_data);
+  gboolean selecting = (object == adapter->summary->selecting_object);
+
+  adapter->summary->selecting_object = NULL;
+
+  if (object->selected && !selecting) {
+    invalidate_summary (adapter);
+  }
+
+  return 0;
 }
 
 
@@ -2281,6 +2271,13 @@ selection_changed (LeptonList *selection,
   g_return_if_fail (selection != NULL);
   g_return_if_fail (adapter->selection == selection);
 
+  /* Changes of the selection other than adding or removing a
+   * single object are not tracked */
+  if (!adapter->summary->updated) {
+    invalidate_summary (adapter);
+  }
+  adapter->summary->updated = FALSE;
+
   g_object_notify (G_OBJECT (adapter), "cap-style");
   g_object_notify (G_OBJECT (adapter), "dash-length");
   g_object_notify (G_OBJECT (adapter), "dash-space");
@@ -322,6 +322,11 @@ GschemToplevel *gschem_toplevel_new ()
   w_current->file_preview = 0;
   w_current->enforce_hierarchy = 0;
   w_current->fast_mousepan = 0;
+  w_current->adaptive_quality = 0;
+  w_current->adaptive_quality_budget = 0;
+  w_current->level_of_detail = 0;
+  w_current->level_of_detail_text_height = 0;
+  w_current->debug_redraw = 0;
   w_current->undo_levels = 0;
   w_current->undo_control = 0;
   w_current->undo_type = 0;
@@ -1933,6 +1938,20 @@ schematic_window_set_middle_button (GschemToplevel *w_current,
 }
 
 
+/*! \brief Get schematic window's field 'fast_mousepan'.
+ *
+ *  \param [in] w_current The schematic window.
+ *  \return The value of the field 'fast_mousepan'.
+ */
+int
+schematic_window_get_fast_mousepan (GschemToplevel *w_current)
+{
+  g_return_val_if_fail (w_current != NULL, 0);
+
+  return w_current->fast_mousepan;
+}
+
+
 /*! \brief Get schematic window's field 'third_button'.
  *
  *  \param [in] w_current The schematic window.
@@ -188,7 +188,9 @@ void i_action_stop (GschemToplevel *w_current)
  *  \par Function Description
  *  Checks if the current action state has been changed (an action
  *  was started or finished) and informs the bottom widget to make
- *  it update the status text color accordingly
+ *  it update the status text color accordingly.  When an action is
+ *  finished, the current page view is redrawn at full quality if
+ *  its rendering quality has been lowered during the action.
  *
  *  \param [in] w_current GschemToplevel structure
  */
@@ -198,6 +200,15 @@ void i_action_update_status (GschemToplevel *w_current, gboolean inside_action)
     w_current->inside_action = inside_action;
     gschem_bottom_widget_set_status_text_color (GSCHEM_BOTTOM_WIDGET (w_current->bottom_widget),
                                                 inside_action);
+
+    if (!inside_action) {
+      GschemPageView *page_view =
+        gschem_toplevel_get_current_page_view (w_current);
+
+      if (page_view != NULL) {
+        gschem_page_view_restore_quality (page_view);
+      }
+    }
   }
 }
 
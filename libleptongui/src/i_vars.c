@@ -43,6 +43,11 @@ int   default_scroll_wheel = SCROLL_WHEEL_CLASSIC;
 int   default_file_preview = TRUE;
 int   default_enforce_hierarchy = TRUE;
 int   default_fast_mousepan = FALSE;
+int   default_adaptive_quality = FALSE;
+int   default_adaptive_quality_budget = 40;
+int   default_level_of_detail = TRUE;
+int   default_level_of_detail_text_height = 4;
+int   default_debug_redraw = FALSE;
 int   default_undo_levels = 20;
 int   default_undo_control = TRUE;
 int   default_undo_type = UNDO_DISK;
@@ -274,6 +279,25 @@ i_vars_set (GschemToplevel* w_current)
   cfg_read_bool ("schematic.gui", "fast-mousepan",
                  default_fast_mousepan, &w_current->fast_mousepan);
 
+  cfg_read_bool ("schematic.gui", "adaptive-quality",
+                 default_adaptive_quality, &w_current->adaptive_quality);
+
+  cfg_read_int_with_check ("schematic.gui", "adaptive-quality-budget",
+                           default_adaptive_quality_budget,
+                           &w_current->adaptive_quality_budget,
+                           &cfg_check_int_greater_0);
+
+  cfg_read_bool ("schematic.gui", "level-of-detail",
+                 default_level_of_detail, &w_current->level_of_detail);
+
+  cfg_read_int_with_check ("schematic.gui", "level-of-detail-text-height",
+                           default_level_of_detail_text_height,
+                           &w_current->level_of_detail_text_height,
+                           &cfg_check_int_greater_eq_0);
+
+  cfg_read_bool ("schematic.gui", "debug-redraw",
+                 default_debug_redraw, &w_current->debug_redraw);
+
   cfg_read_int_with_check ("schematic.undo", "undo-levels",
                            default_undo_levels, &w_current->undo_levels,
                            &cfg_check_int_greater_0);
@@ -36,11 +36,11 @@ void o_arc_invalidate_rubber (GschemToplevel *w_current)
 
   /* FIXME: This isn't a tight bounding box */
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          w_current->first_wx - w_current->distance,
-                                          w_current->first_wy - w_current->distance,
-                                          w_current->first_wx + w_current->distance,
-                                          w_current->first_wy + w_current->distance);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  w_current->first_wx - w_current->distance,
+                                                  w_current->first_wy - w_current->distance,
+                                                  w_current->first_wx + w_current->distance,
+                                                  w_current->first_wy + w_current->distance);
 }
 
 /*! \brief Start process to input a new arc.
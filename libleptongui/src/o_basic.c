@@ -31,10 +31,329 @@ extern LeptonColorMap display_outline_colors;
  * readability issues
  */
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Data passed to draw_static_region(). */
+typedef struct
+{
+  GschemToplevel *w_current;
+  LeptonPage *page;
+  EdaRenderer *renderer;
+  int bloat;
+
+  /* Snapshot used by draw_static_tile(), see prepare_static_tiles() */
+  cairo_matrix_t world_to_device;
+  GPtrArray *objects;
+  int render_flags;
+  cairo_antialias_t antialias;
+  GArray *color_map;
+  gchar *font_name;
+  double lod_text_height;
+} StaticRegionData;
+
+
+/*! \brief Paint the background of a region
+ *
+ *  \param [in] cr The cairo context to paint on.
+ */
+static void
+paint_background (cairo_t *cr)
+{
+  LeptonColor *color = x_color_lookup (BACKGROUND_COLOR);
+
+  cairo_set_source_rgba (cr,
+                         lepton_color_get_red_double (color),
+                         lepton_color_get_green_double (color),
+                         lepton_color_get_blue_double (color),
+                         lepton_color_get_alpha_double (color));
+  cairo_paint (cr);
+}
+
+
+/*! \brief Get the world rectangle of a device region
+ *
+ *  \param [in]  world_to_device The world to device matrix.
+ *  \param [in]  x               The left device coordinate of the region.
+ *  \param [in]  y               The top device coordinate of the region.
+ *  \param [in]  width           The width of the region.
+ *  \param [in]  height          The height of the region.
+ *  \param [in]  bloat           The margin to add, in device units.
+ *  \param [out] world_rect      The world rectangle.
+ */
+static void
+region_to_world_rect (const cairo_matrix_t *world_to_device,
+                      int x,
+                      int y,
+                      int width,
+                      int height,
+                      int bloat,
+                      LeptonBox *world_rect)
+{
+  cairo_matrix_t device_to_world = *world_to_device;
+
+  double lower_x = x - bloat;
+  double lower_y = y + height + bloat;
+  double upper_x = x + width + bloat;
+  double upper_y = y - bloat;
+
+  cairo_matrix_invert (&device_to_world);
+  cairo_matrix_transform_point (&device_to_world, &lower_x, &lower_y);
+  cairo_matrix_transform_point (&device_to_world, &upper_x, &upper_y);
+
+  world_rect->lower_x = floor (lower_x);
+  world_rect->lower_y = floor (lower_y);
+  world_rect->upper_x = ceil (upper_x);
+  world_rect->upper_y = ceil (upper_y);
+}
+
+
+/*! \brief Draw the static contents of a region
  *  \par Function Description
+ *  Paints the background, the grid and all objects on the page
+ *  which are neither selected nor hidden during an action.  This
+ *  is the part of the view which does not change while the user
+ *  moves things around, and which may therefore be cached by
+ *  SchematicRenderCache.
  *
+ *  \param [in] cr        The cairo context with world to device matrix.
+ *  \param [in] x         The left device coordinate of the region.
+ *  \param [in] y         The top device coordinate of the region.
+ *  \param [in] width     The width of the region.
+ *  \param [in] height    The height of the region.
+ *  \param [in] user_data The StaticRegionData structure.
+ */
+static void
+draw_static_region (cairo_t *cr,
+                    int x,
+                    int y,
+                    int width,
+                    int height,
+                    gpointer user_data)
+{
+  StaticRegionData *data = (StaticRegionData*) user_data;
+  GschemToplevel *w_current = data->w_current;
+  EdaRenderer *renderer = data->renderer;
+  cairo_matrix_t world_to_device;
+  LeptonBox world_rect;
+  GList *obj_list;
+  GList *iter;
+
+  if (eda_renderer_get_cairo_context (renderer) != cr) {
+    g_object_set (G_OBJECT (renderer), "cairo-context", cr, NULL);
+  }
+
+  paint_background (cr);
+
+  /* Draw grid lines */
+  x_grid_draw_region (w_current, cr, x, y, width, height);
+
+  cairo_get_matrix (cr, &world_to_device);
+  region_to_world_rect (&world_to_device, x, y, width, height,
+                        data->bloat, &world_rect);
+
+  obj_list =
+    lepton_page_objects_in_regions (data->page,
+                                    &world_rect,
+                                    1,
+                                    gschem_toplevel_get_show_hidden_text (w_current));
+
+  /* First pass -- render non-selected objects */
+  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *o_current = (LeptonObject*) iter->data;
+
+    if (!(o_current->dont_redraw
+          || lepton_object_get_selected (o_current)))
+    {
+      eda_renderer_draw (renderer, o_current);
+    }
+  }
+
+  /* Second pass -- render cues */
+  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *o_current = (LeptonObject*) iter->data;
+
+    if (!(o_current->dont_redraw
+          || lepton_object_get_selected (o_current)))
+    {
+      eda_renderer_draw_cues (renderer, o_current);
+    }
+  }
+
+  g_list_free (obj_list);
+}
+
+
+/*! \brief Collect the objects needed to render missing tiles
+ *  \par Function Description
+ *  Called by SchematicRenderCache in the main thread before the
+ *  missing tiles are rendered.  Queries the page for the objects
+ *  in the region and keeps the ones draw_static_tile() has to
+ *  draw.  Querying the page updates the bounds of the objects, so
+ *  it can't be done by the worker threads.
+ *
+ *  \param [in] x         The left device coordinate of the region.
+ *  \param [in] y         The top device coordinate of the region.
+ *  \param [in] width     The width of the region.
+ *  \param [in] height    The height of the region.
+ *  \param [in] user_data The StaticRegionData structure.
+ */
+static void
+prepare_static_tiles (int x,
+                      int y,
+                      int width,
+                      int height,
+                      gpointer user_data)
+{
+  StaticRegionData *data = (StaticRegionData*) user_data;
+  LeptonBox world_rect;
+  GList *obj_list;
+  GList *iter;
+
+  region_to_world_rect (&data->world_to_device, x, y, width, height,
+                        data->bloat, &world_rect);
+
+  obj_list =
+    lepton_page_objects_in_regions (data->page,
+                                    &world_rect,
+                                    1,
+                                    gschem_toplevel_get_show_hidden_text (data->w_current));
+
+  data->objects = g_ptr_array_new ();
+
+  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *o_current = (LeptonObject*) iter->data;
+
+    if (!(o_current->dont_redraw
+          || lepton_object_get_selected (o_current)))
+    {
+      g_ptr_array_add (data->objects, o_current);
+    }
+  }
+
+  g_list_free (obj_list);
+}
+
+
+/*! \brief Draw the static contents of a cached tile
+ *  \par Function Description
+ *  Does the same as draw_static_region(), but may run in a worker
+ *  thread of SchematicRenderCache.  It uses its own renderer and
+ *  only reads the snapshot made by prepare_static_tiles().
+ *
+ *  \param [in] cr        The cairo context with world to device matrix.
+ *  \param [in] x         The left device coordinate of the region.
+ *  \param [in] y         The top device coordinate of the region.
+ *  \param [in] width     The width of the region.
+ *  \param [in] height    The height of the region.
+ *  \param [in] user_data The StaticRegionData structure.
+ */
+static void
+draw_static_tile (cairo_t *cr,
+                  int x,
+                  int y,
+                  int width,
+                  int height,
+                  gpointer user_data)
+{
+  StaticRegionData *data = (StaticRegionData*) user_data;
+  cairo_matrix_t world_to_device;
+  LeptonBox world_rect;
+  EdaRenderer *renderer;
+  GPtrArray *visible;
+  guint i;
+
+  renderer = eda_renderer_new (cr, NULL);
+  g_object_set (G_OBJECT (renderer),
+                "render-flags", data->render_flags,
+                "lod-text-height", data->lod_text_height,
+                "color-map", data->color_map,
+                "font-name", data->font_name,
+                NULL);
+
+  cairo_set_antialias (cr, data->antialias);
+
+  paint_background (cr);
+
+  /* Draw grid lines */
+  x_grid_draw_region (data->w_current, cr, x, y, width, height);
+
+  cairo_get_matrix (cr, &world_to_device);
+  region_to_world_rect (&world_to_device, x, y, width, height,
+                        data->bloat, &world_rect);
+
+  visible = g_ptr_array_new ();
+
+  for (i = 0; i < data->objects->len; i++) {
+    LeptonObject *o_current =
+      (LeptonObject*) g_ptr_array_index (data->objects, i);
+
+    if (o_current->bounds.max_x >= world_rect.lower_x
+        && o_current->bounds.min_x <= world_rect.upper_x
+        && o_current->bounds.max_y >= world_rect.lower_y
+        && o_current->bounds.min_y <= world_rect.upper_y)
+    {
+      g_ptr_array_add (visible, o_current);
+    }
+  }
+
+  /* First pass -- render non-selected objects */
+  for (i = 0; i < visible->len; i++) {
+    eda_renderer_draw (renderer, (LeptonObject*) g_ptr_array_index (visible, i));
+  }
+
+  /* Second pass -- render cues */
+  for (i = 0; i < visible->len; i++) {
+    eda_renderer_draw_cues (renderer, (LeptonObject*) g_ptr_array_index (visible, i));
+  }
+
+  g_ptr_array_free (visible, TRUE);
+  g_object_unref (renderer);
+}
+
+
+/*! \brief Summarize settings affecting the static contents of a view
+ *  \par Function Description
+ *  Returns a value which changes whenever a setting changes that
+ *  affects how the cached static contents of the view look.  The
+ *  render cache drops its tiles when the value changes.
+ *
+ *  \param [in] w_current    The GschemToplevel object.
+ *  \param [in] render_flags The renderer flags.
+ *  \return The stamp value.
+ */
+static guint
+render_cache_stamp (GschemToplevel *w_current, int render_flags)
+{
+  guint stamp = render_flags;
+
+  stamp = stamp * 31 + gschem_options_get_grid_mode (w_current->options);
+  stamp = stamp * 31 + gschem_options_get_snap_size (w_current->options);
+  stamp = stamp * 31 + w_current->dots_grid_mode;
+  stamp = stamp * 31 + w_current->dots_grid_dot_size;
+  stamp = stamp * 31 + w_current->dots_grid_fixed_threshold;
+  stamp = stamp * 31 + w_current->mesh_grid_display_threshold;
+  stamp = stamp * 31 + w_current->level_of_detail_text_height;
+
+  return stamp;
+}
+
+
+/*! \brief Redraw a region of a page view
+ *  \par Function Description
+ *  Draws the static contents of the page (background, grid and
+ *  unselected objects), and then the selection, grips and
+ *  rubberband objects of a running action on top of them.
+ *
+ *  If \a cache is not NULL, the static contents are composited
+ *  from its tiles, and only tiles invalidated since the last
+ *  redraw are rendered again.  In that case the world to screen
+ *  matrix is snapped to whole pixels so that the rest of the
+ *  drawing is aligned with the tiles.
+ *
+ *  \param [in] w_current The GschemToplevel object.
+ *  \param [in] page      The page to draw.
+ *  \param [in] geometry  The geometry of the view.
+ *  \param [in] cache     The render cache of the view, or NULL.
+ *  \param [in] reduced_quality Whether to draw texts and pictures as
+ *                              outlines and without antialiasing.
  */
 #ifdef ENABLE_GTK3
 void
@@ -42,13 +361,17 @@ o_redraw_rect (GschemToplevel *w_current,
                GtkWidget *widget,
                LeptonPage *page,
                GschemPageGeometry *geometry,
-               cairo_t *cr)
+               cairo_t *cr,
+               SchematicRenderCache *cache,
+               gboolean reduced_quality)
 #else
 void o_redraw_rect (GschemToplevel *w_current,
                     GdkDrawable *drawable,
                     LeptonPage *page,
                     GschemPageGeometry *geometry,
-                    GdkRectangle *rectangle)
+                    GdkRectangle *rectangle,
+                    SchematicRenderCache *cache,
+                    gboolean reduced_quality)
 #endif
 {
   gboolean draw_selected;
@@ -56,13 +379,14 @@ void o_redraw_rect (GschemToplevel *w_current,
   double cue_half_size;
   int bloat;
   double dummy = 0.0;
-  GList *obj_list;
   GList *iter;
-  LeptonBox *world_rect;
   EdaRenderer *renderer;
   int render_flags;
+  guint stamp;
   GArray *render_color_map = NULL;
   GArray *render_outline_color_map = NULL;
+  cairo_matrix_t world_to_screen;
+  StaticRegionData static_data;
 #ifndef ENABLE_GTK3
   cairo_t *cr;
 #endif
@@ -78,64 +402,58 @@ void o_redraw_rect (GschemToplevel *w_current,
 
   cairo_save (cr);
 #endif
-  cairo_set_matrix (cr, gschem_page_geometry_get_world_to_screen_matrix (geometry));
+  world_to_screen = *gschem_page_geometry_get_world_to_screen_matrix (geometry);
+  if (cache != NULL) {
+    schematic_render_cache_snap_matrix (&world_to_screen);
+  }
+  cairo_set_matrix (cr, &world_to_screen);
 
   grip_half_size = GRIP_SIZE / 2;
   cue_half_size = CUE_BOX_SIZE;
   cairo_user_to_device (cr, &cue_half_size, &dummy);
   bloat = MAX (grip_half_size, (int)cue_half_size);
 
-
-  world_rect = g_new (LeptonBox, 1);
-
 #ifdef ENABLE_GTK3
   gint wx, wy;
   gtk_widget_translate_coordinates (w_current->drawing_area,
                                     gtk_widget_get_toplevel (w_current->drawing_area),
                                     0, 0, &wx, &wy);
 
-  gint x = 0;
-  gint y = 0;
   gint width = gtk_widget_get_allocated_width (GTK_WIDGET (widget));
   gint height = gtk_widget_get_allocated_height (GTK_WIDGET (widget));
 
-  double lower_x = x - bloat;
-  double lower_y = y + height + bloat;
-  double upper_x = x + width + bloat;
-  double upper_y = y - bloat;
+  /* The region to redraw in device coordinates */
+  int region_x = wx;
+  int region_y = wy;
+  int region_width = width;
+  int region_height = height;
 #else
-  double lower_x = rectangle->x - bloat;
-  double lower_y = rectangle->y + rectangle->height + bloat;
-  double upper_x = rectangle->x + rectangle->width + bloat;
-  double upper_y = rectangle->y - bloat;
+  int region_x = rectangle->x;
+  int region_y = rectangle->y;
+  int region_width = rectangle->width;
+  int region_height = rectangle->height;
 #endif
 
-  cairo_device_to_user (cr, &lower_x, &lower_y);
-  cairo_device_to_user (cr, &upper_x, &upper_y);
-
-  world_rect->lower_x = floor (lower_x);
-  world_rect->lower_y = floor (lower_y);
-  world_rect->upper_x = ceil (upper_x);
-  world_rect->upper_y = ceil (upper_y);
-
   gboolean show_hidden_text =
     gschem_toplevel_get_show_hidden_text (w_current);
 
-  obj_list = lepton_page_objects_in_regions (page,
-                                             world_rect,
-                                             1,
-                                             show_hidden_text);
-
-  g_free (world_rect);
-
   /* Set up renderer based on configuration in w_current */
   render_flags = EDA_RENDERER_FLAG_HINTING;
   if (show_hidden_text)
     render_flags |= EDA_RENDERER_FLAG_TEXT_HIDDEN;
-  if (w_current->fast_mousepan &&
-      gschem_toplevel_get_current_page_view(w_current)->doing_pan)
+  if (w_current->level_of_detail)
+    render_flags |= EDA_RENDERER_FLAG_LEVEL_OF_DETAIL;
+
+  /* Reduced quality is left out of the cache stamp: the tiles drawn
+   * at reduced quality are dropped when the interaction ends, see
+   * gschem_page_view_restore_quality(). */
+  stamp = render_cache_stamp (w_current, render_flags);
+
+  if (reduced_quality) {
     render_flags |= (EDA_RENDERER_FLAG_TEXT_OUTLINE
                      | EDA_RENDERER_FLAG_PICTURE_OUTLINE);
+    cairo_set_antialias (cr, CAIRO_ANTIALIAS_NONE);
+  }
 
   /* This color map is used for "normal" rendering. */
   render_color_map =
@@ -157,35 +475,65 @@ void o_redraw_rect (GschemToplevel *w_current,
                 "cairo-context", cr,
                 "grip-size", ((double) grip_half_size * geometry->to_world_x_constant),
                 "render-flags", render_flags,
+                "lod-text-height", (double) w_current->level_of_detail_text_height,
                 "color-map", render_color_map,
                 NULL);
 
-  /* Paint background */
-  LeptonColor *color = x_color_lookup (BACKGROUND_COLOR);
-
-  cairo_set_source_rgba (cr,
-                         lepton_color_get_red_double (color),
-                         lepton_color_get_green_double (color),
-                         lepton_color_get_blue_double (color),
-                         lepton_color_get_alpha_double (color));
-
 #ifdef ENABLE_GTK3
   double cx=wx, cy=wy;
   cairo_device_to_user_distance (cr, &cx, &cy);
   cairo_translate (cr, cx, cy);
 #endif
-  cairo_paint (cr);
 
-  /* Draw grid lines */
-#ifdef ENABLE_GTK3
-  x_grid_draw_region (w_current, cr,
-                      wx, wy,
-                      width, height);
-#else
-  x_grid_draw_region (w_current, cr,
-                      rectangle->x, rectangle->y,
-                      rectangle->width, rectangle->height);
-#endif
+  static_data.w_current = w_current;
+  static_data.page = page;
+  static_data.renderer = renderer;
+  static_data.bloat = bloat;
+  static_data.objects = NULL;
+  static_data.font_name = NULL;
+  static_data.render_flags = render_flags;
+  static_data.antialias = cairo_get_antialias (cr);
+  static_data.color_map = render_color_map;
+  static_data.lod_text_height = w_current->level_of_detail_text_height;
+
+  if (cache != NULL) {
+    cairo_matrix_t world_to_device;
+
+    cairo_get_matrix (cr, &world_to_device);
+    static_data.world_to_device = world_to_device;
+    g_object_get (G_OBJECT (renderer),
+                  "font-name", &static_data.font_name,
+                  NULL);
+
+    cairo_save (cr);
+    cairo_identity_matrix (cr);
+
+    schematic_render_cache_paint (cache,
+                                  cr,
+                                  &world_to_device,
+                                  stamp,
+                                  region_x,
+                                  region_y,
+                                  region_width,
+                                  region_height,
+                                  prepare_static_tiles,
+                                  draw_static_tile,
+                                  &static_data);
+
+    cairo_restore (cr);
+
+    if (static_data.objects != NULL) {
+      g_ptr_array_free (static_data.objects, TRUE);
+    }
+    g_free (static_data.font_name);
+  } else {
+    draw_static_region (cr,
+                        region_x,
+                        region_y,
+                        region_width,
+                        region_height,
+                        &static_data);
+  }
 
   SchematicActionMode action_mode =
     schematic_window_get_action_mode (w_current);
@@ -194,28 +542,6 @@ void o_redraw_rect (GschemToplevel *w_current,
   draw_selected = !(w_current->inside_action &&
                     (action_mode == MOVEMODE));
 
-  /* First pass -- render non-selected objects */
-  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
-    LeptonObject *o_current = (LeptonObject*) iter->data;
-
-    if (!(o_current->dont_redraw
-          || lepton_object_get_selected (o_current)))
-    {
-      eda_renderer_draw (renderer, o_current);
-    }
-  }
-
-  /* Second pass -- render cues */
-  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
-    LeptonObject *o_current = (LeptonObject*) iter->data;
-
-    if (!(o_current->dont_redraw
-          || lepton_object_get_selected (o_current)))
-    {
-      eda_renderer_draw_cues (renderer, o_current);
-    }
-  }
-
   /* Second pass -- render selected objects, cues & grips. This is
    * done in a separate pass to non-selected items to make sure that
    * the selection and grips are never obscured by other objects. */
@@ -313,7 +639,6 @@ void o_redraw_rect (GschemToplevel *w_current,
     }
   }
 
-  g_list_free (obj_list);
   g_object_unref (G_OBJECT (renderer));
   g_array_free (render_color_map, TRUE);
   g_array_free (render_outline_color_map, TRUE);
@@ -126,9 +126,12 @@ find_single_object (GschemToplevel *w_current, LeptonObject *object,
  *  Tests for OBJECTS hit at a given set of coordinates. If
  *  change_selection is TRUE, it updates the page's selection.
  *
- *  Find operations resume searching after the last object which was
- *  found, so multiple find operations at the same point will cycle
- *  through any objects on top of each other at this location.
+ *  Only the objects found by a query of the page's spatial index
+ *  around the given point are tested.  They are tested in the
+ *  order they are drawn.  Find operations resume searching after
+ *  the last object which was found, so multiple find operations at
+ *  the same point will cycle through any objects on top of each
+ *  other at this location.
  *
  *  \param [in] w_current         The GschemToplevel object.
  *  \param [in] w_x               The X coordinate to test (in world coords).
@@ -147,47 +150,59 @@ gboolean o_find_object (GschemToplevel *w_current, int w_x, int w_y,
   g_return_val_if_fail (toplevel != NULL, FALSE);
 
   int w_slack;
-  const GList *iter = NULL;
+  GList *candidates;
+  GList *start;
+  GList *iter;
 
   w_slack = gschem_page_view_WORLDabs (page_view, w_current->select_slack_pixels);
 
   LeptonPage *active_page = schematic_window_get_active_page (w_current);
 
-  /* Decide whether to iterate over all object or start at the last
-     found object. If there is more than one object below the
-     (w_x/w_y) position, this will select the next object below the
-     position point. You can change the selected object by clicking
-     at the same place multiple times. */
+  /* Only objects whose bounds are within the slack distance from
+     the point can be hit. */
+  candidates =
+    lepton_page_objects_in_rect (active_page,
+                                 w_x - w_slack,
+                                 w_y - w_slack,
+                                 w_x + w_slack,
+                                 w_y + w_slack,
+                                 gschem_toplevel_get_show_hidden_text (w_current));
+
+  /* Decide whether to iterate over all candidates or start after
+     the last found object. If there is more than one object below
+     the (w_x/w_y) position, this will select the next object below
+     the position point. You can change the selected object by
+     clicking at the same place multiple times. */
+  start = NULL;
   if (active_page->object_lastplace != NULL) {
-    /* NB: g_list_find doesn't declare its input const, so we cast */
-    iter = g_list_find ((GList *)lepton_page_objects (active_page),
-                        active_page->object_lastplace);
-    iter = g_list_next (iter);
+    start = g_list_find (candidates, active_page->object_lastplace);
+    if (start != NULL) {
+      start = g_list_next (start);
+    }
   }
 
   /* do first search (if we found any objects after the last found object) */
-  while (iter != NULL) {
+  for (iter = start; iter != NULL; iter = g_list_next (iter)) {
     LeptonObject *o_current = (LeptonObject*) iter->data;
     if (find_single_object (w_current, o_current,
                             w_x, w_y, w_slack, change_selection)) {
+      g_list_free (candidates);
       return TRUE;
     }
-    iter = g_list_next (iter);
   }
 
-  /* now search from the beginning up until the object_lastplace */
-  for (iter = lepton_page_objects (active_page);
-       iter != NULL; iter = g_list_next (iter)) {
+  /* now search from the beginning up until where the first loop started */
+  for (iter = candidates; iter != start; iter = g_list_next (iter)) {
     LeptonObject *o_current = (LeptonObject*) iter->data;
     if (find_single_object (w_current, o_current,
                             w_x, w_y, w_slack, change_selection)) {
+      g_list_free (candidates);
       return TRUE;
     }
-    /* break once we've inspected up to where we started the first loop */
-    if (o_current == active_page->object_lastplace)
-      break;
   }
 
+  g_list_free (candidates);
+
   /* didn't find anything.... reset lastplace */
   active_page->object_lastplace = NULL;
 
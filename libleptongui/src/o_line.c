@@ -34,11 +34,11 @@ void o_line_invalidate_rubber (GschemToplevel *w_current)
 
   GschemPageView *page_view = gschem_toplevel_get_current_page_view (w_current);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          w_current->first_wx,
-                                          w_current->first_wy,
-                                          w_current->second_wx,
-                                          w_current->second_wy);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  w_current->first_wx,
+                                                  w_current->first_wy,
+                                                  w_current->second_wx,
+                                                  w_current->second_wy);
 }
 
 /*! \brief Start process to input a new line.
@@ -435,11 +435,11 @@ void o_move_invalidate_rubber (GschemToplevel *w_current, int drawing)
             dy2 = w_current->second_wy - w_current->first_wy;
           }
 
-          gschem_page_view_invalidate_world_rect (page_view,
-                                                  object->line->x[0] + dx1,
-                                                  object->line->y[0] + dy1,
-                                                  object->line->x[1] + dx2,
-                                                  object->line->y[1] + dy2);
+          gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                          object->line->x[0] + dx1,
+                                                          object->line->y[0] + dy1,
+                                                          object->line->x[1] + dx2,
+                                                          object->line->y[1] + dy2);
       }
     }
   }
@@ -197,11 +197,44 @@ void o_net_guess_direction(GschemToplevel *w_current,
   g_list_free (object_list);
 }
 
+/*! \brief Collect the connectible objects of a list
+ *  \par Function Description
+ *  Prepends the pins, nets and buses in \a objects, and the ones
+ *  inside of components in \a objects, to \a list.
+ *
+ *  \param [in] list    The list to prepend to.
+ *  \param [in] objects The objects to look through.
+ *  \return The new list.
+ */
+static GList*
+magnetic_candidates (GList *list, const GList *objects)
+{
+  const GList *iter;
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *object = (LeptonObject*) iter->data;
+
+    if (lepton_object_is_pin (object)
+        || lepton_object_is_net (object)
+        || lepton_object_is_bus (object)) {
+      list = g_list_prepend (list, object);
+    }
+    else if (lepton_object_is_component (object)) {
+      list = magnetic_candidates (list,
+                                  lepton_component_object_get_contents (object));
+    }
+  }
+
+  return list;
+}
+
 /*! \brief find the closest possible location to connect to
  *  \par Function Description
- *  This function calculates the distance to all connectable objects
- *  and searches the closest connection point.
- *  It searches for pins, nets and busses.
+ *  This function calculates the distance to the connectable objects
+ *  near the pointer and searches the closest connection point.
+ *  It searches for pins, nets and busses.  Only the objects found
+ *  by the spatial index of the page within the largest magnetic
+ *  reach are considered.
  *
  *  The connection point is stored in GschemToplevel->magnetic_wx and
  *  GschemToplevel->magnetic_wy. If no connection is found. Both variables
@@ -216,7 +249,7 @@ void o_net_find_magnetic(GschemToplevel *w_current,
   int magnetic_reach = 0;
   LeptonObject *o_current;
   LeptonObject *o_magnetic = NULL;
-  GList *object_list, *iter1, *iter2;
+  GList *near_objects, *object_list, *iter;
 
   GschemPageView *page_view = gschem_toplevel_get_current_page_view (w_current);
   g_return_if_fail (page_view != NULL);
@@ -231,91 +264,97 @@ void o_net_find_magnetic(GschemToplevel *w_current,
   magnetic_reach = MAX(MAGNETIC_PIN_REACH, MAGNETIC_NET_REACH);
   magnetic_reach = MAX(magnetic_reach, MAGNETIC_BUS_REACH);
 
-  object_list = g_list_append (NULL, page->connectible_list);
-
-  for (iter1 = object_list; iter1 != NULL; iter1 = g_list_next(iter1)) {
-    for (iter2 = (GList*) iter1->data; iter2 != NULL; iter2 = g_list_next(iter2)) {
-      int left, top, right, bottom;
-      o_current = (LeptonObject*) iter2->data;
-
-      if (!lepton_object_calculate_visible_bounds (o_current,
-                                                   FALSE,
-                                                   &left,
-                                                   &top,
-                                                   &right,
-                                                   &bottom) ||
-          !visible (w_current, left, top, right, bottom))
-        continue; /* skip invisible objects */
+  near_objects =
+    lepton_page_objects_near_point (page,
+                                    w_x,
+                                    w_y,
+                                    gschem_page_view_WORLDabs (page_view,
+                                                               magnetic_reach),
+                                    FALSE);
+  object_list = g_list_reverse (magnetic_candidates (NULL, near_objects));
+  g_list_free (near_objects);
+
+  for (iter = object_list; iter != NULL; iter = g_list_next (iter)) {
+    int left, top, right, bottom;
+    o_current = (LeptonObject*) iter->data;
+
+    if (!lepton_object_calculate_visible_bounds (o_current,
+                                                 FALSE,
+                                                 &left,
+                                                 &top,
+                                                 &right,
+                                                 &bottom) ||
+        !visible (w_current, left, top, right, bottom))
+      continue; /* skip invisible objects */
+
+    if (lepton_object_is_pin (o_current))
+    {
+      min_x = o_current->line->x[o_current->whichend];
+      min_y = o_current->line->y[o_current->whichend];
 
-      if (lepton_object_is_pin (o_current))
-      {
-        min_x = o_current->line->x[o_current->whichend];
-        min_y = o_current->line->y[o_current->whichend];
+      mindist = hypot(w_x - min_x, w_y - min_y);
+      weight = mindist / MAGNETIC_PIN_WEIGHT;
+    }
 
-        mindist = hypot(w_x - min_x, w_y - min_y);
-        weight = mindist / MAGNETIC_PIN_WEIGHT;
+    else if (lepton_object_is_net (o_current)
+             || lepton_object_is_bus (o_current))
+    {
+      /* we have 3 possible points to connect:
+         2 endpoints and 1 midpoint point */
+      x1 = o_current->line->x[0];
+      y1 = o_current->line->y[0];
+      x2 = o_current->line->x[1];
+      y2 = o_current->line->y[1];
+      /* endpoint tests */
+      dist1 = hypot(w_x - x1, w_y - y1);
+      dist2 = hypot(w_x - x2, w_y - y2);
+      if (dist1 < dist2) {
+        min_x = x1;
+        min_y = y1;
+        mindist = dist1;
+      }
+      else {
+        min_x = x2;
+        min_y = y2;
+        mindist = dist2;
       }
 
-      else if (lepton_object_is_net (o_current)
-               || lepton_object_is_bus (o_current))
-      {
-        /* we have 3 possible points to connect:
-           2 endpoints and 1 midpoint point */
-        x1 = o_current->line->x[0];
-        y1 = o_current->line->y[0];
-        x2 = o_current->line->x[1];
-        y2 = o_current->line->y[1];
-        /* endpoint tests */
-        dist1 = hypot(w_x - x1, w_y - y1);
-        dist2 = hypot(w_x - x2, w_y - y2);
-        if (dist1 < dist2) {
+      /* midpoint tests */
+      if ((x1 == x2)  /* vertical net */
+          && ((y1 >= w_y && w_y >= y2)
+              || (y2 >= w_y && w_y >= y1))) {
+        if (abs(w_x - x1) < mindist) {
+          mindist = abs(w_x - x1);
           min_x = x1;
-          min_y = y1;
-          mindist = dist1;
-        }
-        else {
-          min_x = x2;
-          min_y = y2;
-          mindist = dist2;
-        }
-
-        /* midpoint tests */
-        if ((x1 == x2)  /* vertical net */
-            && ((y1 >= w_y && w_y >= y2)
-                || (y2 >= w_y && w_y >= y1))) {
-          if (abs(w_x - x1) < mindist) {
-            mindist = abs(w_x - x1);
-            min_x = x1;
-            min_y = w_y;
-          }
-        }
-        if ((y1 == y2)  /* horitontal net */
-            && ((x1 >= w_x && w_x >= x2)
-                || (x2 >= w_x && w_x >= x1))) {
-          if (abs(w_y - y1) < mindist) {
-            mindist = abs(w_y - y1);
-            min_x = w_x;
-            min_y = y1;
-          }
+          min_y = w_y;
         }
-
-        if (lepton_object_is_bus (o_current))
-          weight = mindist / MAGNETIC_BUS_WEIGHT;
-        else /* OBJ_NET */
-          weight = mindist / MAGNETIC_NET_WEIGHT;
       }
-      else { /* neither pin nor net or bus */
-        continue;
+      if ((y1 == y2)  /* horitontal net */
+          && ((x1 >= w_x && w_x >= x2)
+              || (x2 >= w_x && w_x >= x1))) {
+        if (abs(w_y - y1) < mindist) {
+          mindist = abs(w_y - y1);
+          min_x = w_x;
+          min_y = y1;
+        }
       }
 
-      if (o_magnetic == NULL
-          || weight < min_weight) {
-        minbest = mindist;
-        min_weight = weight;
-        o_magnetic = o_current;
-        w_current->magnetic_wx = min_x;
-        w_current->magnetic_wy = min_y;
-      }
+      if (lepton_object_is_bus (o_current))
+        weight = mindist / MAGNETIC_BUS_WEIGHT;
+      else /* OBJ_NET */
+        weight = mindist / MAGNETIC_NET_WEIGHT;
+    }
+    else { /* neither pin nor net or bus */
+      continue;
+    }
+
+    if (o_magnetic == NULL
+        || weight < min_weight) {
+      minbest = mindist;
+      min_weight = weight;
+      o_magnetic = o_current;
+      w_current->magnetic_wx = min_x;
+      w_current->magnetic_wy = min_y;
     }
   }
 
@@ -741,17 +780,17 @@ void o_net_invalidate_rubber (GschemToplevel *w_current)
     }
   }
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          w_current->first_wx,
-                                          w_current->first_wy,
-                                          w_current->second_wx,
-                                          w_current->second_wy);
-
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          w_current->second_wx,
-                                          w_current->second_wy,
-                                          w_current->third_wx,
-                                          w_current->third_wy);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  w_current->first_wx,
+                                                  w_current->first_wy,
+                                                  w_current->second_wx,
+                                                  w_current->second_wy);
+
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  w_current->second_wx,
+                                                  w_current->second_wy,
+                                                  w_current->third_wx,
+                                                  w_current->third_wy);
 }
 
 
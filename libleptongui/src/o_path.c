@@ -328,11 +328,11 @@ o_path_invalidate_rubber (GschemToplevel *w_current)
   min_y = MIN (min_y, w_current->second_wy);
   max_y = MAX (max_y, w_current->second_wy);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          min_x,
-                                          min_y,
-                                          max_x,
-                                          max_y);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  min_x,
+                                                  min_y,
+                                                  max_x,
+                                                  max_y);
 
   w_current->temp_path->num_sections -= added_sections;
 }
@@ -587,11 +587,11 @@ o_path_invalidate_rubber_grips (GschemToplevel *w_current)
   path_rubber_bbox (w_current, NULL,
                     &min_x, &max_y, &max_x, &min_y);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          min_x,
-                                          min_y,
-                                          max_x,
-                                          max_y);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  min_x,
+                                                  min_y,
+                                                  max_x,
+                                                  max_y);
 }
 
 
@@ -256,11 +256,11 @@ void o_picture_invalidate_rubber (GschemToplevel *w_current)
   GschemPageView *page_view = gschem_toplevel_get_current_page_view (w_current);
   g_return_if_fail (page_view != NULL);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          GET_PICTURE_LEFT (w_current),
-                                          GET_PICTURE_TOP (w_current),
-                                          GET_PICTURE_LEFT (w_current) + GET_PICTURE_WIDTH (w_current),
-                                          GET_PICTURE_TOP (w_current) + GET_PICTURE_HEIGHT (w_current));
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  GET_PICTURE_LEFT (w_current),
+                                                  GET_PICTURE_TOP (w_current),
+                                                  GET_PICTURE_LEFT (w_current) + GET_PICTURE_WIDTH (w_current),
+                                                  GET_PICTURE_TOP (w_current) + GET_PICTURE_HEIGHT (w_current));
 }
 
 /*! \brief Draw temporary picture while dragging edge.
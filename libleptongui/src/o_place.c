@@ -258,11 +258,11 @@ void o_place_invalidate_rubber (GschemToplevel *w_current, int drawing)
                                  &right,
                                  &bottom);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          left + diff_x,
-                                          top + diff_y,
-                                          right + diff_x,
-                                          bottom + diff_y);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  left + diff_x,
+                                                  top + diff_y,
+                                                  right + diff_x,
+                                                  bottom + diff_y);
 }
 
 
@@ -360,11 +360,11 @@ void o_select_box_invalidate_rubber (GschemToplevel *w_current)
   GschemPageView *page_view = gschem_toplevel_get_current_page_view (w_current);
   g_return_if_fail (page_view != NULL);
 
-  gschem_page_view_invalidate_world_rect (page_view,
-                                          w_current->first_wx,
-                                          w_current->first_wy,
-                                          w_current->second_wx,
-                                          w_current->second_wy);
+  gschem_page_view_invalidate_overlay_world_rect (page_view,
+                                                  w_current->first_wx,
+                                                  w_current->first_wy,
+                                                  w_current->second_wx,
+                                                  w_current->second_wy);
 }
 
 /*! \todo Finish function documentation!!!
@@ -389,7 +389,8 @@ void o_select_box_search(GschemToplevel *w_current)
   int SHIFTKEY = w_current->SHIFTKEY;
   int CONTROLKEY = w_current->CONTROLKEY;
   int left, right, top, bottom;
-  const GList *iter;
+  GList *objects;
+  GList *iter;
   gboolean show_hidden_text =
     gschem_toplevel_get_show_hidden_text (w_current);
 
@@ -400,35 +401,23 @@ void o_select_box_search(GschemToplevel *w_current)
 
   LeptonPage *active_page = schematic_window_get_active_page (w_current);
 
-  iter = lepton_page_objects (active_page);
-  while (iter != NULL) {
+  /* Hidden text is only selected if it is shown */
+  objects = lepton_page_objects_inside_rect (active_page,
+                                             left,
+                                             top,
+                                             right,
+                                             bottom,
+                                             show_hidden_text);
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
     o_current = (LeptonObject*) iter->data;
-    /* only select visible objects */
-    if (!lepton_object_is_text (o_current) ||
-        lepton_text_object_is_visible (o_current) ||
-        show_hidden_text)
-    {
-      int cleft, ctop, cright, cbottom;
-
-      if (lepton_object_calculate_visible_bounds (o_current,
-                                                  show_hidden_text,
-                                                  &cleft,
-                                                  &ctop,
-                                                  &cright,
-                                                  &cbottom) &&
-          cleft   >= left &&
-          cright  <= right  &&
-          ctop    >= top  &&
-          cbottom <= bottom)
-      {
 
-        o_select_object(w_current, o_current, MULTIPLE, count);
-        count++;
-      }
-    }
-    iter = g_list_next (iter);
+    o_select_object(w_current, o_current, MULTIPLE, count);
+    count++;
   }
 
+  g_list_free (objects);
+
   /* if there were no objects to be found in select box, count will be */
   /* zero, and you need to deselect anything remaining (except when the */
   /* shift or control keys are pressed) */
@@ -0,0 +1,542 @@
+/* Lepton EDA Schematic Capture
+ * Copyright (C) 2026 Lepton EDA Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*!
+ * \file schematic_render_cache.c
+ *
+ * \brief Tile cache of the static contents of a page view
+ *
+ * The static contents of a page view (background, grid and
+ * unselected objects) are rendered into fixed size tiles.  The
+ * tiles are aligned to the world origin in screen pixel space, so
+ * a tile rendered once remains usable while the view is panned.
+ * The cache is keyed by the zoom level of the view and by a stamp
+ * summarizing the other rendering settings.  When either changes,
+ * all tiles are dropped.
+ *
+ * Tiles are invalidated by world rectangles when page contents
+ * change.  Anything drawn on top of the static contents (selection,
+ * grips, rubberband objects) is never cached and has to be drawn
+ * by the caller after schematic_render_cache_paint().
+ *
+ * When several tiles are missing, they are rendered concurrently
+ * by a pool of worker threads into image surfaces, which are then
+ * composited by the calling thread.  The calling thread waits for
+ * the workers, so the tile drawing function may read any data
+ * which only the calling thread modifies.
+ */
+
+#include <config.h>
+
+#include <math.h>
+
+#include "gschem.h"
+
+
+/* Tiles rendered together for one paint request. */
+typedef struct
+{
+  cairo_matrix_t matrix;
+  SchematicRenderCacheDrawFunc draw_func;
+  gpointer user_data;
+
+  GMutex mutex;
+  GCond done;
+  guint pending;
+} TileBatch;
+
+/* A tile to be rendered by a worker thread. */
+typedef struct
+{
+  TileBatch *batch;
+  int column;
+  int row;
+  cairo_surface_t *surface;
+} TileJob;
+
+static GThreadPool *tile_pool = NULL;
+
+
+struct _SchematicRenderCache
+{
+  /* Tile key -> cairo_surface_t */
+  GHashTable *tiles;
+
+  /* Zoom level and rendering settings the tiles are valid for */
+  gboolean configured;
+  double scale_x;
+  double scale_y;
+  guint stamp;
+};
+
+
+static gint64*
+tile_key_new (int column, int row)
+{
+  gint64 *key = g_new (gint64, 1);
+
+  *key = ((gint64) column << 32) | (guint32) row;
+
+  return key;
+}
+
+
+static int
+tile_key_column (const gint64 *key)
+{
+  return (int) (*key >> 32);
+}
+
+
+static int
+tile_key_row (const gint64 *key)
+{
+  return (int) (gint32) (*key & 0xffffffff);
+}
+
+
+/*! \brief Create a new tile cache
+ *
+ *  \return A new, empty tile cache
+ */
+SchematicRenderCache*
+schematic_render_cache_new ()
+{
+  SchematicRenderCache *cache = g_new0 (SchematicRenderCache, 1);
+
+  cache->tiles = g_hash_table_new_full (g_int64_hash,
+                                        g_int64_equal,
+                                        g_free,
+                                        (GDestroyNotify) cairo_surface_destroy);
+  cache->configured = FALSE;
+
+  return cache;
+}
+
+
+/*! \brief Free a tile cache and all its tiles
+ *
+ *  \param [in] cache The tile cache
+ */
+void
+schematic_render_cache_free (SchematicRenderCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+
+  g_hash_table_destroy (cache->tiles);
+  g_free (cache);
+}
+
+
+/*! \brief Drop all tiles of a cache
+ *
+ *  \param [in] cache The tile cache
+ */
+void
+schematic_render_cache_invalidate_all (SchematicRenderCache *cache)
+{
+  g_return_if_fail (cache != NULL);
+
+  g_hash_table_remove_all (cache->tiles);
+}
+
+
+/*! \brief Drop the tiles touching a world rectangle
+ *
+ *  \par Function Description
+ *  Converts the world rectangle into the pixel space of the tiles
+ *  using the zoom level the tiles were rendered at, expands it by
+ *  \a bloat pixels and drops all tiles intersecting the result.
+ *
+ *  \param [in] cache  The tile cache
+ *  \param [in] left   The left world coordinate
+ *  \param [in] top    The top world coordinate
+ *  \param [in] right  The right world coordinate
+ *  \param [in] bottom The bottom world coordinate
+ *  \param [in] bloat  The margin to add, in pixels
+ */
+void
+schematic_render_cache_invalidate_world_rect (SchematicRenderCache *cache,
+                                              int left,
+                                              int top,
+                                              int right,
+                                              int bottom,
+                                              int bloat)
+{
+  GHashTableIter iter;
+  gpointer key;
+  int first_column, last_column;
+  int first_row, last_row;
+
+  g_return_if_fail (cache != NULL);
+
+  if (!cache->configured || g_hash_table_size (cache->tiles) == 0) {
+    return;
+  }
+
+  double x1 = cache->scale_x * left;
+  double x2 = cache->scale_x * right;
+  double y1 = cache->scale_y * top;
+  double y2 = cache->scale_y * bottom;
+
+  first_column = floor ((MIN (x1, x2) - bloat) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  last_column  = floor ((MAX (x1, x2) + bloat) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  first_row    = floor ((MIN (y1, y2) - bloat) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  last_row     = floor ((MAX (y1, y2) + bloat) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+
+  g_hash_table_iter_init (&iter, cache->tiles);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    int column = tile_key_column ((gint64*) key);
+    int row = tile_key_row ((gint64*) key);
+
+    if (column >= first_column && column <= last_column &&
+        row >= first_row && row <= last_row) {
+      g_hash_table_iter_remove (&iter);
+    }
+  }
+}
+
+
+/*! \brief Round the translation of a world to screen matrix
+ *
+ *  \par Function Description
+ *  Tiles can only be composited without resampling at whole pixel
+ *  offsets.  Anything drawn on top of the cached contents must
+ *  use a matrix snapped by this function to stay aligned with it.
+ *
+ *  \param [in,out] matrix The world to screen matrix
+ */
+void
+schematic_render_cache_snap_matrix (cairo_matrix_t *matrix)
+{
+  g_return_if_fail (matrix != NULL);
+
+  matrix->x0 = round (matrix->x0);
+  matrix->y0 = round (matrix->y0);
+}
+
+
+/* Render a tile into \a surface.  May be called from any thread,
+ * if \a surface is an image surface. */
+static void
+render_tile (cairo_surface_t *surface,
+             const cairo_matrix_t *world_to_screen,
+             int column,
+             int row,
+             SchematicRenderCacheDrawFunc draw_func,
+             gpointer user_data)
+{
+  cairo_t *tile_cr;
+  cairo_matrix_t tile_matrix = *world_to_screen;
+
+  tile_matrix.x0 = - (double) column * SCHEMATIC_RENDER_CACHE_TILE_SIZE;
+  tile_matrix.y0 = - (double) row * SCHEMATIC_RENDER_CACHE_TILE_SIZE;
+
+  tile_cr = cairo_create (surface);
+  cairo_set_matrix (tile_cr, &tile_matrix);
+
+  draw_func (tile_cr,
+             0,
+             0,
+             SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+             SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+             user_data);
+
+  cairo_destroy (tile_cr);
+}
+
+
+static void
+render_tile_job (gpointer data, gpointer user_data)
+{
+  TileJob *job = (TileJob*) data;
+  TileBatch *batch = job->batch;
+
+  render_tile (job->surface,
+               &batch->matrix,
+               job->column,
+               job->row,
+               batch->draw_func,
+               batch->user_data);
+
+  g_mutex_lock (&batch->mutex);
+  batch->pending--;
+  if (batch->pending == 0) {
+    g_cond_signal (&batch->done);
+  }
+  g_mutex_unlock (&batch->mutex);
+}
+
+
+/*! \brief Render tiles concurrently
+ *
+ *  \par Function Description
+ *  Renders each of \a jobs into a new image surface, using the
+ *  worker pool, and waits until all of them are done.  If there
+ *  is only one job, or the pool can't be created, the tiles are
+ *  rendered by the calling thread.
+ */
+static void
+render_tiles (GPtrArray *jobs,
+              const cairo_matrix_t *world_to_screen,
+              SchematicRenderCacheDrawFunc draw_func,
+              gpointer user_data)
+{
+  TileBatch batch;
+  guint i;
+
+  batch.matrix = *world_to_screen;
+  batch.draw_func = draw_func;
+  batch.user_data = user_data;
+  batch.pending = jobs->len;
+  g_mutex_init (&batch.mutex);
+  g_cond_init (&batch.done);
+
+  for (i = 0; i < jobs->len; i++) {
+    TileJob *job = (TileJob*) g_ptr_array_index (jobs, i);
+    job->batch = &batch;
+    job->surface = cairo_image_surface_create (CAIRO_FORMAT_RGB24,
+                                               SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+                                               SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  }
+
+  if (jobs->len > 1 && tile_pool == NULL && g_get_num_processors () > 1) {
+    tile_pool = g_thread_pool_new (render_tile_job,
+                                   NULL,
+                                   g_get_num_processors (),
+                                   FALSE,
+                                   NULL);
+  }
+
+  if (jobs->len > 1 && tile_pool != NULL) {
+    for (i = 0; i < jobs->len; i++) {
+      g_thread_pool_push (tile_pool, g_ptr_array_index (jobs, i), NULL);
+    }
+
+    g_mutex_lock (&batch.mutex);
+    while (batch.pending > 0) {
+      g_cond_wait (&batch.done, &batch.mutex);
+    }
+    g_mutex_unlock (&batch.mutex);
+  } else {
+    for (i = 0; i < jobs->len; i++) {
+      render_tile_job (g_ptr_array_index (jobs, i), NULL);
+    }
+  }
+
+  g_cond_clear (&batch.done);
+  g_mutex_clear (&batch.mutex);
+}
+
+
+/* Drop tiles outside of the given range if the cache has grown
+ * too large. */
+static void
+evict_tiles (SchematicRenderCache *cache,
+             int first_column,
+             int last_column,
+             int first_row,
+             int last_row)
+{
+  GHashTableIter iter;
+  gpointer key;
+
+  if (g_hash_table_size (cache->tiles) <= SCHEMATIC_RENDER_CACHE_MAX_TILES) {
+    return;
+  }
+
+  g_hash_table_iter_init (&iter, cache->tiles);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    int column = tile_key_column ((gint64*) key);
+    int row = tile_key_row ((gint64*) key);
+
+    if (column < first_column || column > last_column ||
+        row < first_row || row > last_row) {
+      g_hash_table_iter_remove (&iter);
+    }
+  }
+}
+
+
+/*! \brief Paint a screen region from the cached tiles
+ *
+ *  \par Function Description
+ *  Composites the tiles covering the given region onto \a cr.
+ *  Missing tiles are rendered first by calling \a draw_func,
+ *  possibly from several worker threads at once.  Before that,
+ *  \a prepare_func, if not NULL, is called by the calling thread
+ *  with the screen rectangle covered by the missing tiles, so that
+ *  it can collect whatever the drawing function needs.  The matrix
+ *  of \a cr has to map screen pixels to its device space (usually
+ *  it is the identity matrix).
+ *
+ *  If the zoom level of \a world_to_screen or \a stamp differ
+ *  from the ones the cached tiles were rendered with, all the
+ *  tiles are dropped.
+ *
+ *  \param [in] cache           The tile cache
+ *  \param [in] cr              The cairo context to paint on
+ *  \param [in] world_to_screen The world to screen matrix of the view
+ *  \param [in] stamp           Summary of the rendering settings
+ *  \param [in] x               The left screen coordinate of the region
+ *  \param [in] y               The top screen coordinate of the region
+ *  \param [in] width           The width of the region
+ *  \param [in] height          The height of the region
+ *  \param [in] prepare_func    The function preparing tile rendering, or NULL
+ *  \param [in] draw_func       The function rendering a tile
+ *  \param [in] user_data       The data passed to \a draw_func
+ */
+void
+schematic_render_cache_paint (SchematicRenderCache *cache,
+                              cairo_t *cr,
+                              const cairo_matrix_t *world_to_screen,
+                              guint stamp,
+                              int x,
+                              int y,
+                              int width,
+                              int height,
+                              SchematicRenderCachePrepareFunc prepare_func,
+                              SchematicRenderCacheDrawFunc draw_func,
+                              gpointer user_data)
+{
+  cairo_matrix_t matrix;
+  int column, first_column, last_column;
+  int row, first_row, last_row;
+  GPtrArray *jobs;
+  guint i;
+
+  g_return_if_fail (cache != NULL);
+  g_return_if_fail (cr != NULL);
+  g_return_if_fail (world_to_screen != NULL);
+  g_return_if_fail (draw_func != NULL);
+
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  matrix = *world_to_screen;
+  schematic_render_cache_snap_matrix (&matrix);
+
+  if (!cache->configured
+      || cache->scale_x != matrix.xx
+      || cache->scale_y != matrix.yy
+      || cache->stamp != stamp) {
+    g_hash_table_remove_all (cache->tiles);
+    cache->scale_x = matrix.xx;
+    cache->scale_y = matrix.yy;
+    cache->stamp = stamp;
+    cache->configured = TRUE;
+  }
+
+  first_column = floor ((x - matrix.x0) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  last_column  = floor ((x + width - 1 - matrix.x0) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  first_row    = floor ((y - matrix.y0) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+  last_row     = floor ((y + height - 1 - matrix.y0) / SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+
+  /* Render the missing tiles */
+  jobs = g_ptr_array_new_with_free_func (g_free);
+
+  for (row = first_row; row <= last_row; row++) {
+    for (column = first_column; column <= last_column; column++) {
+      gint64 key = ((gint64) column << 32) | (guint32) row;
+
+      if (!g_hash_table_contains (cache->tiles, &key)) {
+        TileJob *job = g_new0 (TileJob, 1);
+        job->column = column;
+        job->row = row;
+        g_ptr_array_add (jobs, job);
+      }
+    }
+  }
+
+  if (jobs->len > 0) {
+    int min_column = G_MAXINT, max_column = G_MININT;
+    int min_row = G_MAXINT, max_row = G_MININT;
+
+    for (i = 0; i < jobs->len; i++) {
+      TileJob *job = (TileJob*) g_ptr_array_index (jobs, i);
+      min_column = MIN (min_column, job->column);
+      max_column = MAX (max_column, job->column);
+      min_row = MIN (min_row, job->row);
+      max_row = MAX (max_row, job->row);
+    }
+
+    if (prepare_func != NULL) {
+      prepare_func (min_column * SCHEMATIC_RENDER_CACHE_TILE_SIZE + matrix.x0,
+                    min_row * SCHEMATIC_RENDER_CACHE_TILE_SIZE + matrix.y0,
+                    (max_column - min_column + 1) * SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+                    (max_row - min_row + 1) * SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+                    user_data);
+    }
+
+    render_tiles (jobs, &matrix, draw_func, user_data);
+
+    /* Keep the tiles in surfaces matching the target, which are
+     * usually faster to composite than image surfaces. */
+    for (i = 0; i < jobs->len; i++) {
+      TileJob *job = (TileJob*) g_ptr_array_index (jobs, i);
+      cairo_surface_t *surface =
+        cairo_surface_create_similar (cairo_get_target (cr),
+                                      CAIRO_CONTENT_COLOR,
+                                      SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+                                      SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+      cairo_t *tile_cr = cairo_create (surface);
+
+      cairo_set_source_surface (tile_cr, job->surface, 0, 0);
+      cairo_set_operator (tile_cr, CAIRO_OPERATOR_SOURCE);
+      cairo_paint (tile_cr);
+      cairo_destroy (tile_cr);
+      cairo_surface_destroy (job->surface);
+
+      g_hash_table_insert (cache->tiles,
+                           tile_key_new (job->column, job->row),
+                           surface);
+    }
+  }
+
+  g_ptr_array_free (jobs, TRUE);
+
+  cairo_save (cr);
+  cairo_rectangle (cr, x, y, width, height);
+  cairo_clip (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+
+  for (row = first_row; row <= last_row; row++) {
+    for (column = first_column; column <= last_column; column++) {
+      gint64 key = ((gint64) column << 32) | (guint32) row;
+      cairo_surface_t *surface =
+        (cairo_surface_t*) g_hash_table_lookup (cache->tiles, &key);
+
+      double tile_x = (double) column * SCHEMATIC_RENDER_CACHE_TILE_SIZE + matrix.x0;
+      double tile_y = (double) row * SCHEMATIC_RENDER_CACHE_TILE_SIZE + matrix.y0;
+
+      cairo_set_source_surface (cr, surface, tile_x, tile_y);
+      cairo_rectangle (cr,
+                       tile_x,
+                       tile_y,
+                       SCHEMATIC_RENDER_CACHE_TILE_SIZE,
+                       SCHEMATIC_RENDER_CACHE_TILE_SIZE);
+      cairo_fill (cr);
+    }
+  }
+
+  cairo_restore (cr);
+
+  evict_tiles (cache, first_column, last_column, first_row, last_row);
+}
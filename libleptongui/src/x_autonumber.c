@@ -99,9 +99,10 @@ struct autonumber_text_t {
   /* variables used while autonumbering */
   gchar * current_searchtext;
   gint root_page;      /* flag whether its the root page or not */
-  GList *used_numbers; /* list of used numbers */
-  GList *free_slots;   /* list of FREE_SLOT objects */
-  GList *used_slots;   /* list of USED_SLOT objects */
+  GHashTable *used_numbers; /* set of used numbers */
+  gint free_number;          /* lowest number that may be free */
+  GHashTable *free_slots;   /* symbolname -> GSequence of free AUTONUMBER_SLOTs */
+  GHashTable *used_slots;   /* set of used AUTONUMBER_SLOTs */
 };
 
 typedef struct autonumber_slot_t AUTONUMBER_SLOT;
@@ -117,19 +118,6 @@ struct autonumber_slot_t {
 /* ***** BACK-END CODE ***************************************************** */
 
 /********** compare functions for g_list_sort, ... ***********************/
-/*! \brief GCompareFunc function to sort a list with g_list_sort().
- *  \par Function Description
- *  Compares the integer values of the gconstpointers a and b.
- *  \return -1 if a<b, 1 if a>b, 0 if a==b
- */
-gint autonumber_sort_numbers(gconstpointer a, gconstpointer b) {
-  if (GPOINTER_TO_INT(a) < GPOINTER_TO_INT(b))
-    return -1;
-  if (GPOINTER_TO_INT(a) > GPOINTER_TO_INT(b))
-    return 1;
-  return 0;
-}
-
 /*! \brief GCompareFunc function to sort text objects by there location
  *  \par Function Description
  *  This function takes two <B>LeptonObject*</B> arguments and compares the
@@ -239,34 +227,55 @@ int autonumber_sort_diagonal(gconstpointer a, gconstpointer b) {
   return 0;
 }
 
-/*! \brief GCompareFunc function to acces <B>AUTONUMBER_SLOT</B> object in a GList
+/*! \brief GHashFunc function for <B>AUTONUMBER_SLOT</B> objects
  *  \par Function Description
- *  This function takes two <B>AUTONUMBER_SLOT*</B> arguments and compares them.
- *  Sorting criteria is are the AUTONUMBER_SLOT members: first the symbolname, than the
- *  number and last the slotnr.
- *  If the number or the slotnr is set to zero it acts as a wildcard.
- *  The function is used as GCompareFunc by GList functions.
+ *  Hashes all the AUTONUMBER_SLOT members: the symbolname, the number
+ *  and the slotnr.
+ *  The function is used as GHashFunc for the set of used slots.
  */
-gint freeslot_compare(gconstpointer a, gconstpointer b)
+guint autonumber_slot_hash(gconstpointer a)
 {
-  AUTONUMBER_SLOT *aa, *bb;
-  gint res;
-  aa = (AUTONUMBER_SLOT *) a;  bb = (AUTONUMBER_SLOT *) b;
+  const AUTONUMBER_SLOT *aa = (const AUTONUMBER_SLOT *) a;
+
+  return g_str_hash(aa->symbolname) ^ (guint) (aa->number * 31 + aa->slotnr);
+}
+
+/*! \brief GEqualFunc function for <B>AUTONUMBER_SLOT</B> objects
+ *  \par Function Description
+ *  Two slots are equal if the symbolname, the number and the slotnr
+ *  are equal.
+ *  The function is used as GEqualFunc for the set of used slots.
+ */
+gboolean autonumber_slot_equal(gconstpointer a, gconstpointer b)
+{
+  const AUTONUMBER_SLOT *aa = (const AUTONUMBER_SLOT *) a;
+  const AUTONUMBER_SLOT *bb = (const AUTONUMBER_SLOT *) b;
+
+  return (aa->number == bb->number
+          && aa->slotnr == bb->slotnr
+          && strcmp(aa->symbolname, bb->symbolname) == 0);
+}
 
-  if ((res = strcmp(aa->symbolname, bb->symbolname)) != 0)
-    return res;
+/*! \brief GCompareDataFunc function to sort <B>AUTONUMBER_SLOT</B> objects
+ *  \par Function Description
+ *  This function takes two <B>AUTONUMBER_SLOT*</B> arguments of the same
+ *  symbol and compares them.
+ *  Sorting criteria are the AUTONUMBER_SLOT members: first the number and
+ *  then the slotnr.
+ *  The function is used as GCompareDataFunc by the GSequence of free
+ *  slots of a symbol.
+ */
+gint freeslot_compare(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const AUTONUMBER_SLOT *aa = (const AUTONUMBER_SLOT *) a;
+  const AUTONUMBER_SLOT *bb = (const AUTONUMBER_SLOT *) b;
 
-  /* aa->symbolname == bb->symbolname */
-  if (aa->number == 0 || bb->number == 0)
-    return 0;
   if (aa->number > bb->number)
     return 1;
   if (aa->number < bb->number)
     return -1;
 
   /* aa->number == bb->number */
-  if (aa->slotnr == 0 || bb->slotnr == 0)
-    return 0;
   if (aa->slotnr > bb->slotnr)
     return 1;
   if (aa->slotnr < bb->slotnr)
@@ -275,44 +284,95 @@ gint freeslot_compare(gconstpointer a, gconstpointer b)
   return 0;
 }
 
-/*! \brief Prints a <B>GList</B> of <B>AUTONUMBER_SLOT</B> elements
+/*! \brief Get the free slots of a symbol
  *  \par Function Description
- *  This function prints the elements of a GList that contains <B>AUTONUMBER_SLOT</B> elements
- *  It is only used for debugging purposes.
+ *  Returns the GSequence of the free slots of the symbol
+ *  <B>symbolname</B>, sorted by number and slotnr. If there is none
+ *  yet, it is created when <B>create</B> is TRUE.
+ *  \return the GSequence of <B>AUTONUMBER_SLOT</B> or NULL.
  */
-void freeslot_print(GList *list) {
-  GList *item;
-  AUTONUMBER_SLOT *fs;
-
-  printf("freeslot_print(): symname, number, slot\n");
-  for (item = list; item != NULL; item = g_list_next(item)) {
-    fs = (AUTONUMBER_SLOT*) item ->data;
-    printf("  %s, %d, %d\n",fs->symbolname, fs->number, fs->slotnr);
+GSequence *autonumber_get_free_slots(AUTONUMBER_TEXT *autotext,
+                                     const gchar *symbolname,
+                                     gboolean create)
+{
+  GSequence *free_slots;
+
+  free_slots = (GSequence*) g_hash_table_lookup(autotext->free_slots, symbolname);
+
+  if (free_slots == NULL && create) {
+    free_slots = g_sequence_new(g_free);
+    g_hash_table_insert(autotext->free_slots, g_strdup(symbolname), free_slots);
   }
+
+  return free_slots;
 }
 
+/*! \brief Adds a free slot of a symbol to the database
+ *  \par Function Description
+ *  The free slots of each symbol are kept sorted, so that the slot
+ *  with the lowest number and slotnr is used first.
+ */
+void autonumber_add_free_slot(AUTONUMBER_TEXT *autotext,
+                              const gchar *symbolname,
+                              gint number,
+                              gint slotnr)
+{
+  AUTONUMBER_SLOT *slot = g_new(AUTONUMBER_SLOT,1);
+
+  slot->symbolname = (gchar*) symbolname;
+  slot->number = number;
+  slot->slotnr = slotnr;
+
+  g_sequence_insert_sorted(autonumber_get_free_slots(autotext, symbolname, TRUE),
+                           slot,
+                           freeslot_compare,
+                           NULL);
+}
+
+
+/*! \brief Function to create the databases of used parts
+ *  \par Function Descriptions
+ *  Creates empty sets of used numbers, used slots and free slots.
+ */
+void autonumber_init_database (AUTONUMBER_TEXT *autotext)
+{
+  autotext->used_numbers = g_hash_table_new(NULL, NULL);
+  autotext->free_number = autotext->startnum;
+  autotext->free_slots = g_hash_table_new_full(g_str_hash,
+                                               g_str_equal,
+                                               g_free,
+                                               (GDestroyNotify) g_sequence_free);
+  autotext->used_slots = g_hash_table_new_full(autonumber_slot_hash,
+                                               autonumber_slot_equal,
+                                               g_free,
+                                               NULL);
+}
 
 /*! \brief Function to clear the databases of used parts
  *  \par Function Descriptions
- *  Just remove the list of used numbers, used slots and free slots.
+ *  Just empty the sets of used numbers, used slots and free slots.
  */
 void autonumber_clear_database (AUTONUMBER_TEXT *autotext)
 {
   /* cleanup everything for the next searchtext */
-  if (autotext->used_numbers != NULL) {
-    g_list_free(autotext->used_numbers);
-    autotext->used_numbers = NULL;
-  }
-  if (autotext->free_slots != NULL) {
-    g_list_foreach(autotext->free_slots, (GFunc) g_free, NULL);
-    g_list_free(autotext->free_slots);
-    autotext->free_slots = NULL;
-  }
-  if (autotext->used_slots != NULL) {
-    g_list_foreach(autotext->used_slots, (GFunc) g_free, NULL);
-    g_list_free(autotext->used_slots);
-    autotext->used_slots = NULL;
-  }
+  g_hash_table_remove_all(autotext->used_numbers);
+  autotext->free_number = autotext->startnum;
+  g_hash_table_remove_all(autotext->free_slots);
+  g_hash_table_remove_all(autotext->used_slots);
+}
+
+/*! \brief Function to destroy the databases of used parts
+ *  \par Function Descriptions
+ *  Frees the sets of used numbers, used slots and free slots.
+ */
+void autonumber_free_database (AUTONUMBER_TEXT *autotext)
+{
+  g_hash_table_destroy(autotext->used_numbers);
+  autotext->used_numbers = NULL;
+  g_hash_table_destroy(autotext->free_slots);
+  autotext->free_slots = NULL;
+  g_hash_table_destroy(autotext->used_slots);
+  autotext->used_slots = NULL;
 }
 
 /*! \brief Function to test, whether the LeptonObject matches the autotext criterias
@@ -378,29 +438,30 @@ gint autonumber_match(AUTONUMBER_TEXT *autotext, LeptonObject *o_current, gint *
 }
 
 
-/*! \brief Creates a list of already numbered objects and slots
+/*! \brief Creates a database of already numbered objects and slots
  *  \par Function Description
  *  This function collects the used numbers of a single schematic page.
- *  The used element numbers are stored in a GList container
+ *  The used element numbers are stored in a hash set
  *  inside the <B>AUTONUMBER_TEXT</B> struct.
  *  The slotting container is a little bit different. It stores free slots of
  *  multislotted symbols, that were used only partially.
  *  The criterias are derivated from the autonumber dialog entries.
+ *  Only the text objects containing the current searchtext are
+ *  looked up, using the text index of the page.
  */
-void autonumber_get_used(GschemToplevel *w_current, AUTONUMBER_TEXT *autotext)
+void autonumber_get_used(AUTONUMBER_TEXT *autotext, LeptonPage *page)
 {
   gint number, numslots, slotnr, i;
   LeptonObject *o_current, *o_parent;
   AUTONUMBER_SLOT *slot;
-  GList *slot_item;
+  GSequence *free_slots;
+  GSequenceIter *slot_item;
   char *numslot_str, *slot_str;
-  const GList *iter;
+  GList *objects, *iter;
 
-  LeptonPage *active_page = schematic_window_get_active_page (w_current);
+  objects = lepton_page_texts_containing (page, autotext->current_searchtext);
 
-  for (iter = lepton_page_objects (active_page);
-       iter != NULL;
-       iter = g_list_next (iter)) {
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
     o_current = (LeptonObject*) iter->data;
     if (autonumber_match(autotext, o_current, &number) == AUTONUMBER_RESPECT) {
       /* check slot and maybe add it to the lists */
@@ -421,64 +482,63 @@ void autonumber_get_used(GschemToplevel *w_current, AUTONUMBER_TEXT *autotext)
             }
             else {
               sscanf(slot_str, " %d", &slotnr);
+              g_free(slot_str);
               slot = g_new(AUTONUMBER_SLOT,1);
               slot->number = number;
               slot->slotnr = slotnr;
               slot->symbolname = lepton_component_object_get_basename (o_parent);
 
 
-              slot_item = g_list_find_custom(autotext->used_slots,
-                                             slot,
-                                             (GCompareFunc) freeslot_compare);
-              if (slot_item != NULL) { /* duplicate slot in used_slots */
+              if (g_hash_table_contains(autotext->used_slots, slot)) {
+                /* duplicate slot in used_slots */
                 g_message (_("duplicate slot may cause problems: "
                              "[symbolname=%1$s, number=%2$d, slot=%3$d]"),
                            slot->symbolname, slot->number, slot->slotnr);
                 g_free(slot);
               }
               else {
-                autotext->used_slots = g_list_insert_sorted(autotext->used_slots,
-                                                            slot,
-                                                            (GCompareFunc) freeslot_compare);
-
-                slot_item = g_list_find_custom(autotext->free_slots,
-                                               slot,
-                                               (GCompareFunc) freeslot_compare);
+                g_hash_table_add(autotext->used_slots, slot);
+
+                free_slots = autonumber_get_free_slots(autotext,
+                                                       slot->symbolname,
+                                                       TRUE);
+                slot_item = g_sequence_lookup(free_slots,
+                                              slot,
+                                              freeslot_compare,
+                                              NULL);
                 if (slot_item == NULL) {
-                  /* insert all slots to the list, except of the current one */
+                  /* insert all slots to the database, except of the current one */
                   for (i=1; i <= numslots; i++) {
                     if (i != slotnr) {
-                      slot = (AUTONUMBER_SLOT*) g_memdup2 (slot, sizeof (AUTONUMBER_SLOT));
-                      slot->slotnr = i;
-                      autotext->free_slots = g_list_insert_sorted(autotext->free_slots,
-                                                                  slot,
-                                                                  (GCompareFunc) freeslot_compare);
+                      autonumber_add_free_slot(autotext, slot->symbolname, number, i);
                     }
                   }
                 }
                 else {
-                  g_free(slot_item->data);
-                  autotext->free_slots = g_list_delete_link(autotext->free_slots, slot_item);
+                  g_sequence_remove(slot_item);
                 }
               }
             }
           }
         }
       }
-      /* put number into the used list */
-      autotext->used_numbers = g_list_insert_sorted(autotext->used_numbers,
-                                                    GINT_TO_POINTER(number),
-                                                    (GCompareFunc) autonumber_sort_numbers);
+      /* put number into the used set */
+      g_hash_table_add(autotext->used_numbers, GINT_TO_POINTER(number));
     }
   }
+
+  g_list_free (objects);
 }
 
 
 /*! \brief Gets or generates free numbers for the autonumbering process.
  *  \par Function Description
  *  This function gets or generates new numbers for the <B>LeptonObject o_current</B>.
- *  It uses the element numbers <B>used_numbers</B> and the list of the free slots
+ *  It uses the element numbers <B>used_numbers</B> and the free slots
  *  <B>free_slots</B> of the <B>AUTONUMBER_TEXT</B> struct.
+ *  Numbers are never removed from <B>used_numbers</B> while
+ *  autonumbering, so the lowest free number only grows and is
+ *  remembered in <B>free_number</B> between calls.
  *  \return
  *  The new number is returned into the <B>number</B> parameter.
  *  <B>slot</B> is set if autoslotting is active, else it is set to zero.
@@ -486,57 +546,46 @@ void autonumber_get_used(GschemToplevel *w_current, AUTONUMBER_TEXT *autotext)
 void autonumber_get_new_numbers(AUTONUMBER_TEXT *autotext, LeptonObject *o_current,
                                 gint *number, gint *slot)
 {
-  GList *item;
   gint new_number, numslots, i;
   AUTONUMBER_SLOT *freeslot;
   LeptonObject *o_parent = NULL;
-  GList *freeslot_item;
+  GSequence *free_slots;
+  GSequenceIter *freeslot_item;
   gchar *numslot_str;
 
-  new_number = autotext->startnum;
-
   /* Check for slots first */
   /* 1. are there any unused slots in the database? */
   o_parent = lepton_object_get_attached_to (o_current);
   if (autotext->slotting && o_parent != NULL) {
-    freeslot = g_new(AUTONUMBER_SLOT,1);
-    freeslot->symbolname = lepton_component_object_get_basename (o_parent);
-    freeslot->number = 0;
-    freeslot->slotnr = 0;
-    freeslot_item = g_list_find_custom(autotext->free_slots,
-                                       freeslot,
-                                       (GCompareFunc) freeslot_compare);
-    g_free(freeslot);
+    free_slots =
+      autonumber_get_free_slots(autotext,
+                                lepton_component_object_get_basename (o_parent),
+                                FALSE);
     /* Yes! -> remove from database, apply it */
-    if (freeslot_item != NULL) {
-      freeslot = (AUTONUMBER_SLOT*) freeslot_item->data;
-      *number = freeslot->number;
-      *slot = freeslot->slotnr;
-      g_free(freeslot);
-      autotext->free_slots = g_list_delete_link(autotext->free_slots, freeslot_item);
-
-      return;
+    if (free_slots != NULL) {
+      freeslot_item = g_sequence_get_begin_iter(free_slots);
+      if (!g_sequence_iter_is_end(freeslot_item)) {
+        freeslot = (AUTONUMBER_SLOT*) g_sequence_get(freeslot_item);
+        *number = freeslot->number;
+        *slot = freeslot->slotnr;
+        g_sequence_remove(freeslot_item);
+
+        return;
+      }
     }
   }
 
   /* get a new number */
-  item = autotext->used_numbers;
-  while (1) {
-    while (item != NULL && GPOINTER_TO_INT(item->data) < new_number)
-      item = g_list_next(item);
+  while (g_hash_table_contains(autotext->used_numbers,
+                               GINT_TO_POINTER(autotext->free_number)))
+    autotext->free_number++;
 
-    if (item == NULL || GPOINTER_TO_INT(item->data) > new_number)
-      break;
-    else  /* new_number == item->data */
-      new_number++;
-  }
+  new_number = autotext->free_number;
   *number = new_number;
   *slot = 0;
 
-  /* insert the new number to the used list */
-  autotext->used_numbers = g_list_insert_sorted(autotext->used_numbers,
-                                                GINT_TO_POINTER(new_number),
-                                                (GCompareFunc) autonumber_sort_numbers);
+  /* insert the new number to the used set */
+  g_hash_table_add(autotext->used_numbers, GINT_TO_POINTER(new_number));
 
   /* 3. is o_current a slotted object ? */
   if ((autotext->slotting) && o_parent != NULL) {
@@ -549,13 +598,10 @@ void autonumber_get_new_numbers(AUTONUMBER_TEXT *autotext, LeptonObject *o_curre
         /* Yes! -> new number and slot=1; add the other slots to the database */
         *slot = 1;
         for (i=2; i <=numslots; i++) {
-          freeslot = g_new(AUTONUMBER_SLOT,1);
-          freeslot->symbolname = lepton_component_object_get_basename (o_parent);
-          freeslot->number = new_number;
-          freeslot->slotnr = i;
-          autotext->free_slots = g_list_insert_sorted(autotext->free_slots,
-                                                      freeslot,
-                                                      (GCompareFunc) freeslot_compare);
+          autonumber_add_free_slot(autotext,
+                                   lepton_component_object_get_basename (o_parent),
+                                   new_number,
+                                   i);
         }
       }
     }
@@ -642,6 +688,8 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
   GList *pages;
   GList *searchtext_list=NULL;
   GList *text_item, *obj_item, *page_item;
+  GList *objects;
+  GHashTable *searchtext_set;
   LeptonObject *o_current;
   GschemToplevel *w_current;
   gchar *searchtext;
@@ -650,7 +698,6 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
   gint number, slot;
   size_t i;
   GList *o_list = NULL;
-  const GList *iter;
   LeptonPage *active_page = NULL;
 
   w_current = autotext->w_current;
@@ -658,6 +705,7 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
   autotext->current_searchtext = NULL;
   autotext->root_page = 1;
   autotext->used_numbers = NULL;
+  autotext->free_number = autotext->startnum;
   autotext->free_slots = NULL;
   autotext->used_slots = NULL;
 
@@ -692,48 +740,47 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
   else if (g_str_has_suffix(scope_text,"*") == TRUE) {
     /* strip of the "*" */
     searchtext = g_strndup(scope_text, strlen(scope_text)-1);
+    searchtext_set = g_hash_table_new (g_str_hash, g_str_equal);
     /* collect all the possible searchtexts in all pages of the hierarchy */
     for (page_item = pages; page_item != NULL; page_item = g_list_next(page_item)) {
-      lepton_toplevel_goto_page (w_current->toplevel, (LeptonPage*) page_item->data);
-      gschem_toplevel_page_changed (w_current);
-      /* iterate over all objects an look for matching searchtext's */
-      for (iter = lepton_page_objects (active_page);
-           iter != NULL;
-           iter = g_list_next (iter)) {
-        o_current = (LeptonObject*) iter->data;
-        if (lepton_object_is_text (o_current))
+      /* look up the texts containing the searchtext in the page index */
+      objects = lepton_page_texts_containing ((LeptonPage*) page_item->data,
+                                              searchtext);
+      for (obj_item = objects; obj_item != NULL; obj_item = g_list_next (obj_item)) {
+        o_current = (LeptonObject*) obj_item->data;
+        if (autotext->scope_number == SCOPE_HIERARCHY
+            || autotext->scope_number == SCOPE_PAGE
+            || ((autotext->scope_number == SCOPE_SELECTED)
+                && (lepton_object_get_selected (o_current))))
         {
-          if (autotext->scope_number == SCOPE_HIERARCHY
-              || autotext->scope_number == SCOPE_PAGE
-              || ((autotext->scope_number == SCOPE_SELECTED)
-                  && (lepton_object_get_selected (o_current))))
-          {
-            const gchar *str = lepton_text_object_get_string (o_current);
-            if (g_str_has_prefix (str, searchtext)) {
-              /* the beginnig of the current text matches with the searchtext now */
-              /* strip of the trailing [0-9?] chars and add it too the searchtext */
-              for (i = strlen (str)-1;
-                   (i >= strlen(searchtext))
-                     && (str[i] == '?'
-                         || isdigit( (int) (str[i]) ));
-                   i--)
-                ; /* void */
-
-              new_searchtext = g_strndup (str, i+1);
-              if (g_list_find_custom(searchtext_list, new_searchtext,
-                                     (GCompareFunc) strcmp) == NULL ) {
-                searchtext_list = g_list_append(searchtext_list, new_searchtext);
-              }
-              else {
-                g_free(new_searchtext);
-              }
+          const gchar *str = lepton_text_object_get_string (o_current);
+          if (g_str_has_prefix (str, searchtext)) {
+            /* the beginnig of the current text matches with the searchtext now */
+            /* strip of the trailing [0-9?] chars and add it too the searchtext */
+            for (i = strlen (str)-1;
+                 (i >= strlen(searchtext))
+                   && (str[i] == '?'
+                       || isdigit( (int) (str[i]) ));
+                 i--)
+              ; /* void */
+
+            new_searchtext = g_strndup (str, i+1);
+            if (!g_hash_table_contains (searchtext_set, new_searchtext)) {
+              g_hash_table_add (searchtext_set, new_searchtext);
+              searchtext_list = g_list_prepend(searchtext_list, new_searchtext);
+            }
+            else {
+              g_free(new_searchtext);
             }
           }
         }
       }
+      g_list_free (objects);
       if (autotext->scope_number == SCOPE_SELECTED || autotext->scope_number == SCOPE_PAGE)
         break; /* search only in the first page */
     }
+    searchtext_list = g_list_reverse (searchtext_list);
+    g_hash_table_destroy (searchtext_set);
     g_free(searchtext);
   }
   else {
@@ -741,6 +788,8 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
     return;
   }
 
+  autonumber_init_database(autotext);
+
   /* Step3: iterate over the search items in the list */
   for (text_item=searchtext_list; text_item !=NULL; text_item=g_list_next(text_item)) {
     autotext->current_searchtext = (gchar*) text_item->data;
@@ -752,10 +801,7 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
             && autotext->scope_overwrite)) {
         for (page_item = pages; page_item != NULL; page_item = g_list_next(page_item)) {
           autotext->root_page = (pages->data == page_item->data);
-          lepton_toplevel_goto_page (w_current->toplevel,
-                                     (LeptonPage*) page_item->data);
-          gschem_toplevel_page_changed (w_current);
-          autonumber_get_used(w_current, autotext);
+          autonumber_get_used(autotext, (LeptonPage*) page_item->data);
         }
       }
     }
@@ -768,20 +814,22 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
       autotext->root_page = (pages->data == page_item->data);
       /* build a page database if we're numbering pagebypage or selection only*/
       if (autotext->scope_skip == SCOPE_PAGE || autotext->scope_skip == SCOPE_SELECTED) {
-        autonumber_get_used(w_current, autotext);
+        autonumber_get_used(autotext, (LeptonPage*) page_item->data);
       }
 
       /* RENUMBER CODE FOR ONE PAGE AND ONE SEARCHTEXT*/
       /* 1. get objects to renumber */
-      for (iter = lepton_page_objects (active_page);
-           iter != NULL;
-           iter = g_list_next (iter)) {
-        o_current = (LeptonObject*) iter->data;
+      objects = lepton_page_texts_containing ((LeptonPage*) page_item->data,
+                                              autotext->current_searchtext);
+      for (obj_item = objects; obj_item != NULL; obj_item = g_list_next (obj_item)) {
+        o_current = (LeptonObject*) obj_item->data;
         if (autonumber_match(autotext, o_current, &number) == AUTONUMBER_RENUMBER) {
           /* put number into the used list */
-          o_list = g_list_append(o_list, o_current);
+          o_list = g_list_prepend(o_list, o_current);
         }
       }
+      g_list_free (objects);
+      o_list = g_list_reverse (o_list);
 
       /* 2. sort object list */
       switch (autotext->order) {
@@ -830,6 +878,7 @@ void autonumber_text_autonumber(AUTONUMBER_TEXT *autotext)
     }
     autonumber_clear_database(autotext);   /* cleanup */
   }
+  autonumber_free_database(autotext);
 
   /* cleanup and redraw all*/
   g_list_foreach(searchtext_list, (GFunc) g_free, NULL);
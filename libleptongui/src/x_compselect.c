@@ -51,6 +51,18 @@
  */
 #define COMPSELECT_FILTER_INTERVAL 200
 
+/*! \def COMPSELECT_SELECTION_INTERVAL
+ *  \brief The time interval between selection and actual preview
+ *
+ *  This constant is the time-lag between a change of the selected
+ *  symbol and the update of the preview and of the attributes. It
+ *  helps reduce the number of symbols loaded as user scrolls
+ *  through the views with the keyboard.
+ *
+ *  Unit is milliseconds.
+ */
+#define COMPSELECT_SELECTION_INTERVAL 100
+
 
 enum compselect_view {
   VIEW_INUSE=0,
@@ -299,6 +311,10 @@ static void compselect_get_property    (GObject *object,
                                         guint property_id,
                                         GValue *value,
                                         GParamSpec *pspec);
+static void compselect_flush_selection (Compselect *compselect);
+static void
+compselect_callback_tree_selection_changed (GtkTreeSelection *selection,
+                                            gpointer          user_data);
 
 
 
@@ -332,65 +348,347 @@ static gboolean is_symbol(GtkTreeModel *tree_model, GtkTreeIter *iter)
   return result;
 }
 
-/*! \brief Determines visibility of items of the library treeview.
+/*! \brief A symbol of the library in the search index */
+typedef struct
+{
+  gchar *key;          /* The symbol name in uppercase */
+  CLibSymbol *symbol;  /* The symbol */
+  gint source;         /* The index of the parent source */
+} CompselectIndexSymbol;
+
+/*! \brief A source row of the library view in the search index */
+typedef struct
+{
+  CLibSource *source;  /* The source, or NULL for a directory
+                          having no symbols */
+  gchar *text;         /* The name of the row */
+  gint parent;         /* The index of the parent source, or -1 */
+} CompselectIndexSource;
+
+/*! \brief Search index of the library view
+ *  \par
+ *  The index keeps the sources and the uppercase names of all
+ *  symbols of the component library, and the symbols matching the
+ *  current filter text.  The sources are kept in the order of the
+ *  rows of the view, each one after its parent.  When a filter
+ *  text is given, the model of the view is built from the matches
+ *  only, so that neither the whole library is walked nor the rows
+ *  of the symbols not matching are expanded.
+ */
+struct _CompselectIndex
+{
+  GArray *symbols;   /* Array of CompselectIndexSymbol */
+  GArray *sources;   /* Array of CompselectIndexSource */
+  GArray *matches;   /* Indices of the symbols matching text */
+  gchar *text;       /* The current filter text in uppercase */
+  GtkTreeStore *store;  /* The store of the whole library, or NULL
+                           if it has not been built yet */
+};
+
+
+/*! \brief Create an empty search index of the library view. */
+static CompselectIndex*
+compselect_index_new ()
+{
+  CompselectIndex *index = g_new0 (CompselectIndex, 1);
+
+  index->symbols = g_array_new (FALSE, FALSE, sizeof (CompselectIndexSymbol));
+  index->sources = g_array_new (FALSE, FALSE, sizeof (CompselectIndexSource));
+  index->matches = g_array_new (FALSE, FALSE, sizeof (guint));
+  index->text = g_strdup ("");
+  index->store = NULL;
+
+  return index;
+}
+
+
+/*! \brief Free a search index of the library view. */
+static void
+compselect_index_free (CompselectIndex *index)
+{
+  guint i;
+
+  if (index == NULL) {
+    return;
+  }
+
+  for (i = 0; i < index->symbols->len; i++) {
+    g_free (g_array_index (index->symbols, CompselectIndexSymbol, i).key);
+  }
+
+  for (i = 0; i < index->sources->len; i++) {
+    g_free (g_array_index (index->sources, CompselectIndexSource, i).text);
+  }
+
+  if (index->store != NULL) {
+    g_object_unref (index->store);
+  }
+
+  g_array_free (index->symbols, TRUE);
+  g_array_free (index->sources, TRUE);
+  g_array_free (index->matches, TRUE);
+  g_free (index->text);
+  g_free (index);
+}
+
+
+/*! \brief Add a source row to the search index.
+ *  \returns The index of the source.
+ */
+static gint
+compselect_index_add_source (CompselectIndex *index,
+                             CLibSource *source,
+                             const gchar *text,
+                             gint parent)
+{
+  CompselectIndexSource row;
+
+  row.source = source;
+  row.text = g_strdup (text);
+  row.parent = parent;
+  g_array_append_val (index->sources, row);
+
+  return index->sources->len - 1;
+}
+
+
+/*! \brief Add a symbol to the search index. */
+static void
+compselect_index_add_symbol (CompselectIndex *index,
+                             CLibSymbol *symbol,
+                             gint source)
+{
+  CompselectIndexSymbol row;
+
+  row.key = g_ascii_strup (s_clib_symbol_get_name (symbol), -1);
+  row.symbol = symbol;
+  row.source = source;
+  g_array_append_val (index->symbols, row);
+}
+
+
+/*! \brief Build a store of the library view from the search index.
+ *  \par Function Description
+ *  The columns of the store are the source or symbol, its name,
+ *  and whether it is a symbol.  If \a matches is not NULL, only the
+ *  symbols it lists and the sources having any of them below are
+ *  added to the store.  Otherwise the whole library is added.
+ *
+ *  \param [in] index   The search index of the library view.
+ *  \param [in] matches Increasing indices of the symbols to add, or
+ *                      NULL.
+ *  \returns The new store.
+ */
+static GtkTreeStore*
+compselect_index_build_store (CompselectIndex *index,
+                              GArray *matches)
+{
+  GtkTreeStore *store;
+  GtkTreeIter *iters = g_new (GtkTreeIter, index->sources->len);
+  gboolean *shown = g_new0 (gboolean, index->sources->len);
+  guint n_symbols = (matches != NULL) ? matches->len : index->symbols->len;
+  guint i;
+  gint j;
+
+  store = gtk_tree_store_new (3, G_TYPE_POINTER,
+                                 G_TYPE_STRING,
+                                 G_TYPE_BOOLEAN);
+
+  if (matches == NULL) {
+    for (i = 0; i < index->sources->len; i++) {
+      shown[i] = TRUE;
+    }
+  } else {
+    for (i = 0; i < matches->len; i++) {
+      guint n = g_array_index (matches, guint, i);
+
+      for (j = g_array_index (index->symbols, CompselectIndexSymbol, n).source;
+           j >= 0 && !shown[j];
+           j = g_array_index (index->sources, CompselectIndexSource, j).parent) {
+        shown[j] = TRUE;
+      }
+    }
+  }
+
+  /* Sources are added first, so that the subdirectories of a
+   * source come before its symbols. */
+  for (i = 0; i < index->sources->len; i++) {
+    CompselectIndexSource *source =
+      &g_array_index (index->sources, CompselectIndexSource, i);
+
+    if (!shown[i]) {
+      continue;
+    }
+
+    gtk_tree_store_append (store, &iters[i],
+                           (source->parent >= 0) ? &iters[source->parent] : NULL);
+    gtk_tree_store_set (store, &iters[i],
+                        0, source->source,
+                        1, source->text,
+                        2, FALSE,
+                        -1);
+  }
+
+  for (i = 0; i < n_symbols; i++) {
+    guint n = (matches != NULL) ? g_array_index (matches, guint, i) : i;
+    CompselectIndexSymbol *symbol =
+      &g_array_index (index->symbols, CompselectIndexSymbol, n);
+    GtkTreeIter iter;
+
+    gtk_tree_store_append (store, &iter, &iters[symbol->source]);
+    gtk_tree_store_set (store, &iter,
+                        0, symbol->symbol,
+                        1, s_clib_symbol_get_name (symbol->symbol),
+                        2, TRUE,
+                        -1);
+  }
+
+  g_free (shown);
+  g_free (iters);
+
+  return store;
+}
+
+
+/*! \brief Get the model of the library view for the filter text.
+ *  \par Function Description
+ *  If the filter text is empty, returns the store of the whole
+ *  library, which is built only once.  Otherwise returns a new
+ *  store of the matching symbols.
+ *
+ *  \param [in] index The search index of the library view.
+ *  \returns A new reference to the model.
+ */
+static GtkTreeModel*
+compselect_index_get_model (CompselectIndex *index)
+{
+  if (*index->text != '\0') {
+    return (GtkTreeModel*) compselect_index_build_store (index,
+                                                         index->matches);
+  }
+
+  if (index->store == NULL) {
+    index->store = compselect_index_build_store (index, NULL);
+  }
+
+  return (GtkTreeModel*) g_object_ref (index->store);
+}
+
+
+/*! \brief Filter the library view.
  *  \par Function Description
- *  This is the function used to filter entries of the component
- *  selection tree.
+ *  Finds the symbols whose names contain \a text, ignoring case.
+ *  The text may contain the wildcards '*' and '?'.  If \a text is
+ *  empty, the whole library is shown.
+ *
+ *  If \a text extends the previous filter text, only the symbols
+ *  matching the previous text are checked, since no other symbol
+ *  can match the new one.
  *
- *  \param [in] model The current selection in the treeview.
- *  \param [in] iter  An iterator on a component or folder in the tree.
- *  \param [in] data  The component selection dialog.
- *  \returns TRUE if item should be visible, FALSE otherwise.
+ *  \param [in] index The search index of the library view.
+ *  \param [in] text  The filter text.
+ *  \returns FALSE if the filter text has not changed.
  */
 static gboolean
-lib_model_filter_visible_func (GtkTreeModel *model,
-                                      GtkTreeIter  *iter,
-                                      gpointer      data)
+compselect_index_filter (CompselectIndex *index,
+                         const gchar *text)
 {
-  Compselect *compselect = (Compselect*)data;
-  CLibSymbol *sym;
-  const gchar *compname;
-  gchar *compname_upper, *text_upper, *pattern;
-  const gchar *text;
-  gboolean ret;
-
-  g_assert (IS_COMPSELECT (data));
-
-  text = gtk_entry_get_text (compselect->entry_filter);
-  if (g_ascii_strcasecmp (text, "") == 0) {
-    return TRUE;
+  gchar *upper = g_ascii_strup (text, -1);
+  GPatternSpec *pattern = NULL;
+  GArray *matches;
+  gboolean literal = (strpbrk (upper, "*?") == NULL);
+  gboolean narrowing;
+  guint i;
+
+  if (strcmp (upper, index->text) == 0) {
+    g_free (upper);
+    return FALSE;
   }
 
-  /* If this is a source, only display it if it has children that
-   * match */
-  if (!is_symbol (model, iter)) {
-    GtkTreeIter iter2;
+  matches = g_array_new (FALSE, FALSE, sizeof (guint));
 
-    ret = FALSE;
-    if (gtk_tree_model_iter_children (model, &iter2, iter))
-      do {
-        if (lib_model_filter_visible_func (model, &iter2, data)) {
-          ret = TRUE;
-          break;
-        }
-      } while (gtk_tree_model_iter_next (model, &iter2));
+  if (!literal) {
+    gchar *glob = g_strconcat ("*", upper, "*", NULL);
+    pattern = g_pattern_spec_new (glob);
+    g_free (glob);
+  }
+
+  narrowing = (*index->text != '\0')
+    && (g_str_has_prefix (upper, index->text)
+        || g_str_has_suffix (upper, index->text)
+        || (literal
+            && strpbrk (index->text, "*?") == NULL
+            && strstr (upper, index->text) != NULL));
+
+  if (*upper == '\0') {
+    /* The whole library is shown */
+  } else if (narrowing) {
+    for (i = 0; i < index->matches->len; i++) {
+      guint n = g_array_index (index->matches, guint, i);
+      const gchar *key =
+        g_array_index (index->symbols, CompselectIndexSymbol, n).key;
+
+      if (literal ? (strstr (key, upper) != NULL)
+                  : g_pattern_match_string (pattern, key)) {
+        g_array_append_val (matches, n);
+      }
+    }
   } else {
-    gtk_tree_model_get (model, iter,
-                        0, &sym,
-                        -1);
-    compname = s_clib_symbol_get_name (sym);
-    /* Do a case insensitive comparison, converting the strings
-       to uppercase */
-    compname_upper = g_ascii_strup (compname, -1);
-    text_upper = g_ascii_strup (text, -1);
-    pattern = g_strconcat ("*", text_upper, "*", NULL);
-    ret = g_pattern_match_simple (pattern, compname_upper);
-    g_free (compname_upper);
-    g_free (text_upper);
-    g_free (pattern);
+    for (i = 0; i < index->symbols->len; i++) {
+      const gchar *key =
+        g_array_index (index->symbols, CompselectIndexSymbol, i).key;
+
+      if (literal ? (strstr (key, upper) != NULL)
+                  : g_pattern_match_string (pattern, key)) {
+        g_array_append_val (matches, i);
+      }
+    }
+  }
+
+  if (pattern != NULL) {
+    g_pattern_spec_free (pattern);
   }
 
-  return ret;
+  g_array_free (index->matches, TRUE);
+  index->matches = matches;
+  g_free (index->text);
+  index->text = upper;
+
+  return TRUE;
+}
+
+
+/*! \brief Set the model of the library view for the filter text.
+ *  \par Function Description
+ *  Replaces the model of the library view with the one for the
+ *  current filter text of the search index.  If the filter text is
+ *  not empty, all rows are expanded, which are only the rows of
+ *  the matching symbols and of their sources.
+ *
+ *  \param [in] compselect The component selection dialog.
+ */
+static void
+compselect_update_lib_model (Compselect *compselect)
+{
+  GtkTreeModel *model = compselect_index_get_model (compselect->lib_index);
+  GtkTreeSelection *selection =
+    gtk_tree_view_get_selection (compselect->libtreeview);
+
+  /* Keep the current symbol while the model changes */
+  g_signal_handlers_block_by_func (selection,
+                                   (gpointer) compselect_callback_tree_selection_changed,
+                                   compselect);
+
+  gtk_tree_view_set_model (compselect->libtreeview, model);
+  g_object_unref (model);
+
+  if (*compselect->lib_index->text != '\0') {
+    gtk_tree_view_expand_all (compselect->libtreeview);
+  }
+
+  g_signal_handlers_unblock_by_func (selection,
+                                     (gpointer) compselect_callback_tree_selection_changed,
+                                     compselect);
 }
 
 
@@ -419,6 +717,8 @@ tree_row_activated (GtkTreeView       *tree_view,
   gtk_tree_model_get_iter (model, &iter, path);
 
   if (is_symbol (model, &iter)) {
+    /* Let the symbol be placed before hiding the dialog */
+    compselect_flush_selection (compselect);
     gtk_dialog_response (GTK_DIALOG (compselect),
                          COMPSELECT_RESPONSE_HIDE);
     return;
@@ -536,31 +836,62 @@ update_attributes_model (Compselect *compselect,
   g_list_free (o_attrlist);
 }
 
-/*! \brief Handles changes in the treeview selection.
+/*! \brief Updates the dialog for the symbol loaded by the preview.
  *  \par Function Description
- *  This is the callback function that is called every time the user
- *  select a row in either component treeview of the dialog.
+ *  Called when the preview widget has shown the selected symbol.
+ *  It updates the attributes of the dialog, and if the selection
+ *  has not been placed yet, emits the dialog's <B>response</B>
+ *  signal to let its parent know that a component has been
+ *  selected.  Since the preview has added the data of the symbol
+ *  to the symbol cache, the placement does not fetch them again.
  *
+ *  \param [in] preview    The preview widget.
+ *  \param [in] user_data  The component selection dialog.
+ */
+static void
+compselect_preview_loaded (GschemPreview *preview,
+                           gpointer       user_data)
+{
+  Compselect *compselect = COMPSELECT (user_data);
+
+  /* update the attributes with the toplevel of the preview widget*/
+  update_attributes_model (compselect,
+                           preview->preview_w_current);
+
+  if (!compselect->place_pending) {
+    return;
+  }
+  compselect->place_pending = FALSE;
+
+  /* signal a component has been selected to parent of dialog */
+  g_signal_emit_by_name (compselect,
+                         "response",
+                         COMPSELECT_RESPONSE_PLACE,
+                         NULL);
+}
+
+/*! \brief Updates the dialog for the selected symbol.
+ *  \par Function Description
  *  If the selection is not a selection of a component (a directory
  *  name), it does nothing. Otherwise it retrieves the #CLibSymbol
  *  from the model.
  *
- *  It then emits the dialog's <B>apply</B> signal to let its parent
- *  know that a component has been selected.
+ *  It then gives the symbol to the preview widget, which may fetch
+ *  it in a worker thread.  The rest of the dialog is updated once
+ *  the preview has loaded the symbol, see
+ *  compselect_preview_loaded().
  *
- *  \param [in] selection The current selection in the treeview.
- *  \param [in] user_data The component selection dialog.
+ *  \param [in] compselect The component selection dialog.
+ *  \param [in] selection  The current selection in the treeview.
  */
 static void
-compselect_callback_tree_selection_changed (GtkTreeSelection *selection,
-                                            gpointer          user_data)
+compselect_update_selection (Compselect       *compselect,
+                             GtkTreeSelection *selection)
 {
   GtkTreeView *view;
   GtkTreeModel *model;
   GtkTreeIter iter;
-  Compselect *compselect = (Compselect*)user_data;
   const CLibSymbol *sym = NULL;
-  gchar *buffer = NULL;
 
   if (gtk_tree_selection_get_selected (selection, &model, &iter)) {
 
@@ -571,27 +902,96 @@ compselect_callback_tree_selection_changed (GtkTreeSelection *selection,
          /* Tree view needs to check that we're at a symbol node */
 
       gtk_tree_model_get (model, &iter, 0, &sym, -1);
-      buffer = s_clib_symbol_get_data (sym);
     }
   }
 
-  /* update the preview with new symbol data */
+  compselect->place_pending = TRUE;
+
+  /* update the preview with the new symbol */
   g_object_set (compselect->preview,
-                "buffer", buffer,
-                "active", (buffer != NULL),
+                "symbol", sym,
+                "active", (sym != NULL),
                 NULL);
+}
 
-  /* update the attributes with the toplevel of the preview widget*/
-  update_attributes_model (compselect,
-                           compselect->preview->preview_w_current);
+/*! \brief Updates the dialog for the selected symbol at once.
+ *  \par Function Description
+ *  Does the pending update of the dialog for a change of the
+ *  selection, if any.
+ *
+ *  \param [in] compselect The component selection dialog.
+ */
+static void
+compselect_flush_selection (Compselect *compselect)
+{
+  if (compselect->selection_timeout == 0) {
+    return;
+  }
 
-  /* signal a component has been selected to parent of dialog */
-  g_signal_emit_by_name (compselect,
-                         "response",
-                         COMPSELECT_RESPONSE_PLACE,
-                         NULL);
+  g_source_remove (compselect->selection_timeout);
+  compselect->selection_timeout = 0;
 
-  g_free (buffer);
+  compselect_update_selection (compselect, compselect->selection_changed);
+
+  /* Do not wait for the preview to place the symbol */
+  if (compselect->place_pending) {
+    compselect->place_pending = FALSE;
+    g_signal_emit_by_name (compselect,
+                           "response",
+                           COMPSELECT_RESPONSE_PLACE,
+                           NULL);
+  }
+}
+
+/*! \brief Updates the dialog for the selected symbol.
+ *  \par Function Description
+ *  This is the timeout function for the changes of the selection
+ *  in the trees of the dialog.
+ *
+ *  \param [in] data The component selection dialog.
+ *  \returns FALSE to remove the timeout.
+ */
+static gboolean
+compselect_selection_timeout (gpointer data)
+{
+  Compselect *compselect = COMPSELECT (data);
+
+  /* resets the source id in compselect */
+  compselect->selection_timeout = 0;
+
+  compselect_update_selection (compselect, compselect->selection_changed);
+
+  /* return FALSE to remove the source */
+  return FALSE;
+}
+
+/*! \brief Handles changes in the treeview selection.
+ *  \par Function Description
+ *  This is the callback function that is called every time the user
+ *  select a row in either component treeview of the dialog.
+ *
+ *  The dialog is updated after COMPSELECT_SELECTION_INTERVAL
+ *  milliseconds, so that only the last of the rows selected in a
+ *  row is loaded and previewed.
+ *
+ *  \param [in] selection The current selection in the treeview.
+ *  \param [in] user_data The component selection dialog.
+ */
+static void
+compselect_callback_tree_selection_changed (GtkTreeSelection *selection,
+                                            gpointer          user_data)
+{
+  Compselect *compselect = (Compselect*)user_data;
+
+  /* Cancel any pending update for the previous selection */
+  if (compselect->selection_timeout != 0)
+    g_source_remove (compselect->selection_timeout);
+
+  compselect->selection_changed = selection;
+  compselect->selection_timeout =
+    g_timeout_add (COMPSELECT_SELECTION_INTERVAL,
+                   compselect_selection_timeout,
+                   compselect);
 }
 
 /*! \brief Requests re-evaluation of the filter.
@@ -609,23 +1009,16 @@ static gboolean
 compselect_filter_timeout (gpointer data)
 {
   Compselect *compselect = COMPSELECT (data);
-  GtkTreeModel *model;
+  const gchar *text = gtk_entry_get_text (compselect->entry_filter);
 
   /* resets the source id in compselect */
   compselect->filter_timeout = 0;
 
-  model = gtk_tree_view_get_model (compselect->libtreeview);
-
-  if (model != NULL) {
-    const gchar *text = gtk_entry_get_text (compselect->entry_filter);
-    gtk_tree_model_filter_refilter ((GtkTreeModelFilter*)model);
-    if (strcmp (text, "") != 0) {
-      /* filter text not-empty */
-      gtk_tree_view_expand_all (compselect->libtreeview);
-    } else {
-      /* filter text is empty, collapse expanded tree */
-      gtk_tree_view_collapse_all (compselect->libtreeview);
-    }
+  /* Only the rows of the matching symbols are expanded.  The model
+   * of the whole library is shown collapsed when the filter text
+   * is empty. */
+  if (compselect_index_filter (compselect->lib_index, text)) {
+    compselect_update_lib_model (compselect);
   }
 
   /* return FALSE to remove the source */
@@ -751,10 +1144,10 @@ create_inuse_tree_model (Compselect *compselect)
   return (GtkTreeModel*)store;
 }
 
-/* \brief Helper function for create_lib_tree_model. */
+/* \brief Helper function for create_lib_index. */
 
-static void populate_component_store(GtkTreeStore *store, GList **srclist,
-                                     GtkTreeIter *parent, const char *prefix)
+static void index_component_sources (CompselectIndex *index, GList **srclist,
+                                     const char *prefix, gint parent_source)
 {
   CLibSource *source = (CLibSource *)(*srclist)->data;
   const char *name = s_clib_source_get_name (source);
@@ -824,13 +1217,8 @@ static void populate_component_store(GtkTreeStore *store, GList **srclist,
     }
   }
 
-  GtkTreeIter iter;
-  gtk_tree_store_append (store, &iter, parent);
-  gtk_tree_store_set (store, &iter,
-                      0, source,
-                      1, text,
-                      2, FALSE,
-                      -1);
+  gint source_id = compselect_index_add_source (index, source, text,
+                                                parent_source);
   free(text);
 
   /* Look ahead, adding subdirectories. */
@@ -838,57 +1226,49 @@ static void populate_component_store(GtkTreeStore *store, GList **srclist,
          strncmp(s_clib_source_get_name ((CLibSource *)new_srclist->data),
                  new_prefix, strlen(new_prefix)) == 0) {
     *srclist = new_srclist;
-    populate_component_store(store, srclist, &iter, new_prefix);
+    index_component_sources (index, srclist, new_prefix, source_id);
     new_srclist = g_list_next (*srclist);
   }
   free(new_prefix);
 
-  /* populate symbols */
+  /* index symbols */
   GList *symhead, *symlist;
-  GtkTreeIter iter2;
   symhead = s_clib_source_get_symbols (source);
   for (symlist = symhead;
        symlist != NULL;
        symlist = g_list_next (symlist)) {
-
-    gtk_tree_store_append (store, &iter2, &iter);
-    gtk_tree_store_set (store, &iter2,
-                        0, symlist->data,
-                        1, s_clib_symbol_get_name ((CLibSymbol *)symlist->data),
-                        2, TRUE,
-                        -1);
+    compselect_index_add_symbol (index, (CLibSymbol *) symlist->data,
+                                 source_id);
   }
   g_list_free (symhead);
 }
 
-/* \brief Create the tree model for the "Library" view.
+/* \brief Create the search index of the "Library" view.
  * \par Function Description
- * Creates a tree where the branches are the available component
- * sources and the leaves are the symbols.
+ * Indexes the available component sources and their symbols,
+ * which are the branches and the leaves of the tree of the view.
+ * The model of the view is built from the index, see
+ * compselect_index_get_model().
  */
-static GtkTreeModel*
-create_lib_tree_model (Compselect *compselect)
+static void
+create_lib_index (Compselect *compselect)
 {
-  GtkTreeStore *store;
   GList *srchead, *srclist;
   LeptonPage *active_page = schematic_window_get_active_page (GSCHEM_DIALOG(compselect)->w_current);
   EdaConfig *cfg = eda_config_get_context_for_path (lepton_page_get_filename (active_page));
   gboolean sort = eda_config_get_boolean (cfg, "schematic.library", "sort", NULL);
 
-  store = (GtkTreeStore*)gtk_tree_store_new (3, G_TYPE_POINTER,
-                                                G_TYPE_STRING,
-                                                G_TYPE_BOOLEAN);
+  compselect_index_free (compselect->lib_index);
+  compselect->lib_index = compselect_index_new ();
 
-  /* populate component store */
+  /* index component sources */
   srchead = s_clib_get_sources (sort);
   for (srclist = srchead;
        srclist != NULL;
        srclist = g_list_next (srclist)) {
-    populate_component_store(store, &srclist, NULL, "/");
+    index_component_sources (compselect->lib_index, &srclist, "/", -1);
   }
   g_list_free (srchead);
-
-  return (GtkTreeModel*)store;
 }
 
 /* \brief On-demand refresh of the component library.
@@ -901,45 +1281,22 @@ compselect_callback_refresh_library (GtkButton *button, gpointer user_data)
 {
   Compselect *compselect = COMPSELECT (user_data);
   GtkTreeModel *model;
-  GtkTreeSelection *selection;
 
   /* Rescan the libraries for symbols */
   s_clib_refresh ();
 
-  /* Refresh the "Library" view */
-  g_object_unref (gtk_tree_view_get_model (compselect->libtreeview));
-  model = (GtkTreeModel *)
-    g_object_new (GTK_TYPE_TREE_MODEL_FILTER,
-                  "child-model", create_lib_tree_model (compselect),
-                  "virtual-root", NULL,
-                  NULL);
-
-  gtk_tree_model_filter_set_visible_func ((GtkTreeModelFilter*)model,
-                                          lib_model_filter_visible_func,
-                                          compselect,
-                                          NULL);
-
-  /* Block handling selection updated for duration of model changes */
-  selection = gtk_tree_view_get_selection (compselect->libtreeview);
-  g_signal_handlers_block_by_func (selection,
-                                   (gpointer) compselect_callback_tree_selection_changed,
-                                   compselect);
-
-  /* Update the view model with signals blocked */
-  gtk_tree_view_set_model (compselect->libtreeview, model);
+  /* Refresh the "Library" view, applying the current filter to
+   * the new index */
+  create_lib_index (compselect);
+  compselect_index_filter (compselect->lib_index,
+                           gtk_entry_get_text (compselect->entry_filter));
+  compselect_update_lib_model (compselect);
 
   /* Refresh the "In Use" view */
   g_object_unref (gtk_tree_view_get_model (compselect->inusetreeview));
   model = create_inuse_tree_model (compselect);
 
-  /* Here we can update the model without blocking signals
-   * as this is the second (final) tree view we are updating */
   gtk_tree_view_set_model (compselect->inusetreeview, model);
-
-  /* Unblock & fire handler for libtreeview selection */
-  g_signal_handlers_unblock_by_func (selection,
-                                     (gpointer) compselect_callback_tree_selection_changed,
-                                     compselect);
 }
 
 /*! \brief Creates the treeview for the "In Use" view. */
@@ -1070,7 +1427,7 @@ create_lib_treeview (Compselect *compselect)
 {
   GtkWidget *libtreeview, *vbox, *scrolled_win, *label,
     *hbox, *entry, *button;
-  GtkTreeModel *child_model, *model;
+  GtkTreeModel *model;
   GtkTreeSelection *selection;
   GtkCellRenderer *renderer;
   GtkTreeViewColumn *column;
@@ -1095,11 +1452,8 @@ create_lib_treeview (Compselect *compselect)
 #endif
                                    NULL));
 
-  child_model  = create_lib_tree_model (compselect);
-  model = (GtkTreeModel*)g_object_new (GTK_TYPE_TREE_MODEL_FILTER,
-                                       "child-model",  child_model,
-                                       "virtual-root", NULL,
-                                       NULL);
+  create_lib_index (compselect);
+  model = compselect_index_get_model (compselect->lib_index);
 
   scrolled_win = GTK_WIDGET (
     g_object_new (GTK_TYPE_SCROLLED_WINDOW,
@@ -1117,6 +1471,7 @@ create_lib_treeview (Compselect *compselect)
                                           "rules-hint", TRUE,
                                           "headers-visible", FALSE,
                                           NULL));
+  g_object_unref (model);
 
   g_signal_connect (libtreeview,
                     "row-activated",
@@ -1193,12 +1548,6 @@ create_lib_treeview (Compselect *compselect)
 
   gtk_label_set_mnemonic_widget (GTK_LABEL (label), entry);
 
-  /* now that that we have an entry, set the filter func of model */
-  gtk_tree_model_filter_set_visible_func ((GtkTreeModelFilter*)model,
-                                          lib_model_filter_visible_func,
-                                          compselect,
-                                          NULL);
-
   /* add the filter entry to the filter area */
   gtk_box_pack_start (GTK_BOX (hbox), entry,
                       TRUE, TRUE, 0);
@@ -1206,6 +1555,8 @@ create_lib_treeview (Compselect *compselect)
   compselect->entry_filter = GTK_ENTRY (entry);
   /* and init the event source for component filter */
   compselect->filter_timeout = 0;
+  compselect->selection_timeout = 0;
+  compselect->selection_changed = NULL;
 
   /* create the erase button for filter entry */
   button = GTK_WIDGET (g_object_new (GTK_TYPE_BUTTON,
@@ -1545,6 +1896,10 @@ compselect_constructor (GType type,
                 "width-request",  160,
                 "height-request", 120,
                 NULL);
+  g_signal_connect (preview,
+                    "loaded",
+                    G_CALLBACK (compselect_preview_loaded),
+                    compselect);
 
   gtk_paned_pack1 (GTK_PANED (vpaned), frame, FALSE, FALSE);
 
@@ -1607,6 +1962,14 @@ compselect_finalize (GObject *object)
     compselect->filter_timeout = 0;
   }
 
+  if (compselect->selection_timeout != 0) {
+    g_source_remove (compselect->selection_timeout);
+    compselect->selection_timeout = 0;
+  }
+
+  compselect_index_free (compselect->lib_index);
+  compselect->lib_index = NULL;
+
   G_OBJECT_CLASS (compselect_parent_class)->finalize (object);
 }
 
@@ -30,6 +30,189 @@
 
 #define MESH_COARSE_GRID_MULTIPLIER  5
 
+/* Extra pixels rendered on each side of a grid stripe, so that
+ * panning doesn't require it to be rebuilt. */
+#define GRID_STRIPE_MARGIN           2048
+
+
+/* A grid stripe is a one pixel wide mask with the pixels set where
+ * grid lines cross one axis of the screen.  Painting a color through
+ * a horizontal stripe, repeated vertically, draws all the vertical
+ * grid lines at once; a vertical stripe draws the horizontal ones.
+ * Dots are drawn at the intersections of both.  The stripes are kept
+ * until the zoom level or the grid spacing change. */
+typedef struct
+{
+  gboolean vertical;
+
+  /* Parameters the stripe was rendered for */
+  double scale;
+  double offset;
+  int incr;
+  int skip_multiplier;
+
+  /* Range of covered pixels, relative to the integer part of the
+   * axis translation of the world to screen matrix */
+  int first;
+  int length;
+
+  cairo_surface_t *surface;
+} GridStripe;
+
+enum
+{
+  STRIPE_DOTS_X,
+  STRIPE_DOTS_Y,
+  STRIPE_MESH_MINOR_X,
+  STRIPE_MESH_MINOR_Y,
+  STRIPE_MESH_MAJOR_X,
+  STRIPE_MESH_MAJOR_Y,
+  N_GRID_STRIPES
+};
+
+G_LOCK_DEFINE_STATIC (grid_stripes);
+
+static GridStripe grid_stripes[N_GRID_STRIPES] =
+{
+  { FALSE }, { TRUE }, { FALSE }, { TRUE }, { FALSE }, { TRUE }
+};
+
+
+/*! \brief Render the pixels of a grid stripe
+ *
+ *  \par Function Description
+ *  Sets the pixels of the stripe surface at the screen positions of
+ *  the grid lines, rounded the same way as single grid elements
+ *  used to be.  If \a skip_multiplier is not 0, every line whose
+ *  index is a multiple of it is omitted, as it is drawn by a
+ *  coarser grid.
+ */
+static void
+render_grid_stripe (GridStripe *stripe)
+{
+  unsigned char *data;
+  int stride, step;
+  double world1, world2;
+  long k, k_first, k_last;
+
+  stripe->surface =
+    cairo_image_surface_create (CAIRO_FORMAT_A8,
+                                stripe->vertical ? 1 : stripe->length,
+                                stripe->vertical ? stripe->length : 1);
+
+  cairo_surface_flush (stripe->surface);
+  data = cairo_image_surface_get_data (stripe->surface);
+  stride = cairo_image_surface_get_stride (stripe->surface);
+  step = stripe->vertical ? stride : 1;
+
+  world1 = (stripe->first - stripe->offset) / stripe->scale;
+  world2 = (stripe->first + stripe->length - stripe->offset) / stripe->scale;
+
+  k_first = floor (MIN (world1, world2) / stripe->incr) - 1;
+  k_last = ceil (MAX (world1, world2) / stripe->incr) + 1;
+
+  for (k = k_first; k <= k_last; k++) {
+    if (stripe->skip_multiplier != 0 && k % stripe->skip_multiplier == 0) {
+      continue;
+    }
+
+    int pixel = floor (stripe->scale * k * stripe->incr + stripe->offset + 0.5)
+      - stripe->first;
+
+    if (pixel >= 0 && pixel < stripe->length) {
+      data[pixel * step] = 0xff;
+    }
+  }
+
+  cairo_surface_mark_dirty (stripe->surface);
+}
+
+
+/*! \brief Get a pattern painting grid lines along one axis
+ *
+ *  \par Function Description
+ *  Returns a repeating pattern made of the grid stripe \a index,
+ *  aligned to the world origin, for painting with the identity
+ *  matrix.  The stripe is rebuilt only if the zoom level, the grid
+ *  spacing, or the sub-pixel part of the translation have changed,
+ *  or if it doesn't cover the requested range of pixels.
+ *
+ *  \param [in] index            The stripe to use.
+ *  \param [in] user_to_device   The world to screen matrix.
+ *  \param [in] start            The first screen pixel to cover.
+ *  \param [in] end              The screen pixel past the last one to cover.
+ *  \param [in] incr             The grid spacing in world units.
+ *  \param [in] skip_multiplier  Multiplier of lines to omit, or 0.
+ *  \returns A new reference to the pattern.
+ */
+static cairo_pattern_t*
+get_grid_stripe_pattern (int index,
+                         cairo_matrix_t *user_to_device,
+                         int start,
+                         int end,
+                         int incr,
+                         int skip_multiplier)
+{
+  GridStripe *stripe = &grid_stripes[index];
+  cairo_pattern_t *pattern;
+  cairo_matrix_t matrix;
+  double scale, translation, offset;
+  int base;
+
+  if (stripe->vertical) {
+    scale = user_to_device->yy;
+    translation = user_to_device->y0;
+  } else {
+    scale = user_to_device->xx;
+    translation = user_to_device->x0;
+  }
+
+  base = (int) floor (translation);
+  offset = translation - base;
+  start -= base;
+  end -= base;
+
+  G_LOCK (grid_stripes);
+
+  if (stripe->surface == NULL
+      || stripe->scale != scale
+      || stripe->offset != offset
+      || stripe->incr != incr
+      || stripe->skip_multiplier != skip_multiplier
+      || start < stripe->first
+      || end > stripe->first + stripe->length) {
+
+    if (stripe->surface != NULL) {
+      cairo_surface_destroy (stripe->surface);
+    }
+
+    stripe->scale = scale;
+    stripe->offset = offset;
+    stripe->incr = incr;
+    stripe->skip_multiplier = skip_multiplier;
+    stripe->first = start - GRID_STRIPE_MARGIN;
+    stripe->length = end - start + 2 * GRID_STRIPE_MARGIN;
+
+    render_grid_stripe (stripe);
+  }
+
+  pattern = cairo_pattern_create_for_surface (stripe->surface);
+
+  if (stripe->vertical) {
+    cairo_matrix_init_translate (&matrix, 0, -(base + stripe->first));
+  } else {
+    cairo_matrix_init_translate (&matrix, -(base + stripe->first), 0);
+  }
+
+  G_UNLOCK (grid_stripes);
+
+  cairo_pattern_set_matrix (pattern, &matrix);
+  cairo_pattern_set_extend (pattern, CAIRO_EXTEND_REPEAT);
+  cairo_pattern_set_filter (pattern, CAIRO_FILTER_NEAREST);
+
+  return pattern;
+}
+
 
 /*! \brief Query the spacing in world coordinates at which the dots grid is drawn.
  *
@@ -111,6 +294,34 @@ draw_dots_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
                          lepton_color_get_alpha_double (color));
 
   cairo_matrix_t user_to_device_matrix;
+  cairo_get_matrix (cr, &user_to_device_matrix);
+
+  if (w_current->dots_grid_dot_size == 1) {
+    cairo_pattern_t *columns =
+      get_grid_stripe_pattern (STRIPE_DOTS_X, &user_to_device_matrix,
+                               x - 1, x + width + 1, incr, 0);
+    cairo_pattern_t *rows =
+      get_grid_stripe_pattern (STRIPE_DOTS_Y, &user_to_device_matrix,
+                               y - 1, y + height + 1, incr, 0);
+
+    cairo_save (cr);
+    cairo_identity_matrix (cr);
+    cairo_rectangle (cr, x, y, width, height);
+    cairo_clip (cr);
+
+    /* Dots are where grid columns and grid rows intersect */
+    cairo_push_group (cr);
+    cairo_mask (cr, columns);
+    cairo_pop_group_to_source (cr);
+    cairo_mask (cr, rows);
+
+    cairo_restore (cr);
+
+    cairo_pattern_destroy (columns);
+    cairo_pattern_destroy (rows);
+    return;
+  }
+
   double x_start = x - 1;
   double y_start = y + height + 1;
   double x_end = x + width + 1;
@@ -122,7 +333,6 @@ draw_dots_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
   cairo_device_to_user (cr, &x_start, &y_start);
   cairo_device_to_user (cr, &x_end, &y_end);
 
-  cairo_get_matrix (cr, &user_to_device_matrix);
   cairo_save (cr);
   cairo_identity_matrix (cr);
 
@@ -133,6 +343,7 @@ draw_dots_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
   xe = ceil (x_end);
   ye = ceil (y_end);
 
+  /* Bigger dots are round, so they are drawn one by one */
   for (j = ys; j < ye; j = j + incr) {
     for (i = xs; i < xe; i = i + incr) {
       x1 = i;
@@ -140,15 +351,11 @@ draw_dots_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
 
       cairo_matrix_transform_point (&user_to_device_matrix, &x1, &y1);
 
-      if (w_current->dots_grid_dot_size == 1) {
-        cairo_rectangle (cr, round (x1), round (y1), 1, 1);
-      } else {
-        cairo_move_to (cr, round (x1), round (y1));
-        cairo_arc (cr, round (x1), round (y1),
-                   dot_size/2,
-                   0,
-                   2*M_PI);
-      }
+      cairo_move_to (cr, round (x1), round (y1));
+      cairo_arc (cr, round (x1), round (y1),
+                 dot_size/2,
+                 0,
+                 2*M_PI);
     }
   }
 
@@ -159,32 +366,19 @@ draw_dots_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
 
 /*! \brief Helper function for draw_mesh_grid_region
  */
-static void draw_mesh (GschemToplevel *w_current,
-                       cairo_t *cr,
+static void draw_mesh (cairo_t *cr,
                        cairo_matrix_t *user_to_device_matrix,
                        LeptonColor *color,
-                       int x_start, int y_start, int x_end, int y_end,
-                       int incr, int coarse_mult)
+                       int x, int y, int width, int height,
+                       int incr, int coarse_mult,
+                       int x_stripe, int y_stripe)
 {
-  int i, j;
-  double x1, y1, x2, y2;
-  int next_coarse_x, next_coarse_y;
-  int coarse_incr = incr * coarse_mult;
-
-  /* figure starting grid coordinates, work by taking the start
-   * and end coordinates and rounding down to the nearest increment */
-  x_start -= (x_start % incr);
-  y_start -= (y_start % incr);
-
-  if (coarse_incr == 0) {
-    next_coarse_x = x_start - 1; /* Ensures we never hit this when looping */
-    next_coarse_y = y_start - 1; /* Ensures we never hit this when looping */
-  } else {
-    next_coarse_x = x_start - (x_start % coarse_incr);
-    next_coarse_y = y_start - (y_start % coarse_incr);
-    if (next_coarse_x < x_start) next_coarse_x += coarse_incr;
-    if (next_coarse_y < y_start) next_coarse_y += coarse_incr;
-  }
+  cairo_pattern_t *vertical_lines =
+    get_grid_stripe_pattern (x_stripe, user_to_device_matrix,
+                             x - 1, x + width + 1, incr, coarse_mult);
+  cairo_pattern_t *horizontal_lines =
+    get_grid_stripe_pattern (y_stripe, user_to_device_matrix,
+                             y - 1, y + height + 1, incr, coarse_mult);
 
   cairo_set_source_rgba (cr,
                          lepton_color_get_red_double (color),
@@ -192,52 +386,11 @@ static void draw_mesh (GschemToplevel *w_current,
                          lepton_color_get_blue_double (color),
                          lepton_color_get_alpha_double (color));
 
-  cairo_set_line_width (cr, 1.);
-  cairo_set_line_cap (cr, CAIRO_LINE_CAP_SQUARE);
-
-  for (j = y_start; j < y_end; j = j + incr) {
-
-    /* Skip lines which will be drawn in the coarser grid */
-    if (j == next_coarse_y) {
-      next_coarse_y += coarse_incr;
-      continue;
-    }
-
-    x1 = x_start;
-    y1 = j;
-    x2 = x_end;
-    y2 = j;
-
-    cairo_matrix_transform_point (user_to_device_matrix, &x1, &y1);
-    cairo_matrix_transform_point (user_to_device_matrix, &x2, &y2);
-
-    cairo_move_to (cr, (int)(x1+0.5), (int)(y1+0.5));
-    cairo_line_to (cr, (int)(x2+0.5), (int)(y2+0.5));
+  cairo_mask (cr, horizontal_lines);
+  cairo_mask (cr, vertical_lines);
 
-    cairo_stroke (cr);
-  }
-
-  for (i = x_start; i < x_end; i = i + incr) {
-
-    /* Skip lines which will be drawn in the coarser grid */
-    if (j == next_coarse_y) {
-      next_coarse_y += coarse_incr;
-      continue;
-    }
-
-    x1 = i;
-    y1 = y_start;
-    x2 = i;
-    y2 = y_end;
-
-    cairo_matrix_transform_point (user_to_device_matrix, &x1, &y1);
-    cairo_matrix_transform_point (user_to_device_matrix, &x2, &y2);
-
-    cairo_move_to (cr, (int)(x1+0.5), (int)(y1+0.5));
-    cairo_line_to (cr, (int)(x2+0.5), (int)(y2+0.5));
-
-    cairo_stroke (cr);
-  }
+  cairo_pattern_destroy (vertical_lines);
+  cairo_pattern_destroy (horizontal_lines);
 }
 
 
@@ -301,43 +454,33 @@ draw_mesh_grid_region (GschemToplevel *w_current, cairo_t *cr, int x, int y, int
 
   if (coarse_increment >= threshold) {
     cairo_matrix_t user_to_device_matrix;
-    double x_start = x - 1;
-    double y_start = y + height + 1;
-    double x_end = x + width + 1;
-    double y_end = y - 1;
-
-    cairo_device_to_user (cr, &x_start, &y_start);
-    cairo_device_to_user (cr, &x_end, &y_end);
 
     cairo_get_matrix (cr, &user_to_device_matrix);
     cairo_save (cr);
     cairo_identity_matrix (cr);
-    cairo_translate (cr, 0.5, 0.5);
+    cairo_rectangle (cr, x, y, width, height);
+    cairo_clip (cr);
 
     /* Draw the fine grid if its on-screen spacing is large enough */
     if (snap_size >= threshold) {
-      draw_mesh (w_current,
-                 cr,
+      draw_mesh (cr,
                  &user_to_device_matrix,
                  x_color_lookup (MESH_GRID_MINOR_COLOR),
-                 floor (x_start),
-                 floor (y_start),
-                 ceil (x_end),
-                 ceil (y_end),
+                 x, y, width, height,
                  snap_size,
-                 MESH_COARSE_GRID_MULTIPLIER);
+                 MESH_COARSE_GRID_MULTIPLIER,
+                 STRIPE_MESH_MINOR_X,
+                 STRIPE_MESH_MINOR_Y);
     }
 
-    draw_mesh (w_current,
-               cr,
+    draw_mesh (cr,
                &user_to_device_matrix,
                x_color_lookup (MESH_GRID_MAJOR_COLOR),
-               floor (x_start),
-               floor (y_start),
-               ceil (x_end),
-               ceil (y_end),
+               x, y, width, height,
                coarse_increment,
-               0);
+               0,
+               STRIPE_MESH_MAJOR_X,
+               STRIPE_MESH_MAJOR_Y);
 
     cairo_restore (cr);
   }
@@ -735,12 +735,115 @@ static void x_image_convert_to_greyscale(GdkPixbuf *pixbuf)
   }
 }
 
-/*! \todo Finish function documentation!!!
- *  \brief
+#ifdef ENABLE_GTK3
+
+/* Minimum height of a band rendered by a separate thread. */
+#define IMAGE_BAND_MIN_HEIGHT 64
+
+/*! \brief A horizontal band of an exported image. */
+typedef struct
+{
+  cairo_matrix_t matrix;  /* World to band pixels matrix */
+  int width;
+  int y;
+  int height;
+
+  GList *objects;         /* Objects to draw, shared by all bands */
+  int render_flags;
+  GArray *color_map;
+  const gchar *font_name;
+
+  cairo_surface_t *surface;
+} ImageBand;
+
+
+/*! \brief Render a band of an exported image
  *  \par Function Description
+ *  Renders the objects of \a band into a new image surface, using
+ *  a renderer of its own.  The function only reads the objects, so
+ *  it may run in a separate thread while the main thread waits.
  *
+ *  \param [in] data The ImageBand structure.
+ *  \return NULL.
+ */
+static gpointer
+x_image_render_band (gpointer data)
+{
+  ImageBand *band = (ImageBand*) data;
+  cairo_matrix_t band_to_world;
+  EdaRenderer *renderer;
+  cairo_t *cr;
+  GList *iter;
+
+  double lower_x = 0;
+  double lower_y = band->height;
+  double upper_x = band->width;
+  double upper_y = 0;
+
+  band->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                              band->width,
+                                              band->height);
+  cr = cairo_create (band->surface);
+  cairo_set_matrix (cr, &band->matrix);
+
+  band_to_world = band->matrix;
+  cairo_matrix_invert (&band_to_world);
+  cairo_matrix_transform_point (&band_to_world, &lower_x, &lower_y);
+  cairo_matrix_transform_point (&band_to_world, &upper_x, &upper_y);
+
+  renderer = eda_renderer_new (cr, NULL);
+  g_object_set (G_OBJECT (renderer),
+                "render-flags", band->render_flags,
+                "color-map", band->color_map,
+                NULL);
+
+  if (band->font_name != NULL) {
+    g_object_set (renderer, "font-name", band->font_name, NULL);
+  }
+
+  /* Paint background */
+  LeptonColor *color = x_color_lookup (BACKGROUND_COLOR);
+
+  cairo_set_source_rgba (cr,
+                         lepton_color_get_red_double (color),
+                         lepton_color_get_green_double (color),
+                         lepton_color_get_blue_double (color),
+                         lepton_color_get_alpha_double (color));
+
+  cairo_paint (cr);
+
+  for (iter = band->objects; iter != NULL; iter = g_list_next (iter)) {
+    LeptonObject *o_current = (LeptonObject*) iter->data;
+
+    if (!o_current->dont_redraw
+        && o_current->bounds.max_x >= floor (lower_x)
+        && o_current->bounds.min_x <= ceil (upper_x)
+        && o_current->bounds.max_y >= floor (lower_y)
+        && o_current->bounds.min_y <= ceil (upper_y)) {
+      eda_renderer_draw (renderer, o_current);
+    }
+  }
+
+  g_object_unref (G_OBJECT (renderer));
+  cairo_destroy (cr);
+
+  return NULL;
+}
+
+
+/*! \brief Render a page view into a pixbuf
+ *  \par Function Description
+ *  Renders the contents of the current page view scaled to the
+ *  given size.  The image is split into horizontal bands which are
+ *  rendered concurrently, each by its own thread, and then put
+ *  together by the calling thread.
+ *
+ *  \param [in] w_current The GschemToplevel object.
+ *  \param [in] width     The width of the image.
+ *  \param [in] height    The height of the image.
+ *  \param [in] is_color  FALSE to convert the image to greyscale.
+ *  \return The new pixbuf.
  */
-#ifdef ENABLE_GTK3
 GdkPixbuf
 *x_image_get_pixbuf (GschemToplevel *w_current, int width, int height, gboolean is_color)
 {
@@ -751,11 +854,13 @@ GdkPixbuf
   GschemPageGeometry *old_geometry, *new_geometry;
 
   GList *obj_list;
-  GList *iter;
   LeptonBox *world_rect;
-  EdaRenderer *renderer;
   int render_flags;
   GArray *render_color_map = NULL;
+  ImageBand *bands;
+  GThread **threads;
+  int band_count;
+  int i;
 
   cairo_surface_t *cs;
   cairo_t *cr;
@@ -829,44 +934,60 @@ GdkPixbuf
   render_color_map =
     g_array_append_vals (render_color_map, display_colors, colors_count());
 
-  /* Set up renderer */
-  renderer = eda_renderer_new (NULL, NULL);
-  g_object_set (G_OBJECT (renderer),
-                "cairo-context", cr,
-                "render-flags", render_flags,
-                "color-map", render_color_map,
-                NULL);
-
   EdaConfig *cfg = eda_config_get_context_for_path (".");
   gchar *fontstr = eda_config_get_string (cfg, "schematic.gui", "font", NULL);
 
-  if (fontstr != NULL) {
-    g_object_set (renderer, "font-name", fontstr, NULL);
-    g_free (fontstr);
+  /* Split the image into bands */
+  band_count = MIN ((int) g_get_num_processors (),
+                    height / IMAGE_BAND_MIN_HEIGHT);
+  band_count = MAX (band_count, 1);
+
+  bands = g_new0 (ImageBand, band_count);
+  threads = g_new0 (GThread*, band_count);
+
+  for (i = 0; i < band_count; i++) {
+    ImageBand *band = &bands[i];
+
+    band->y = height * i / band_count;
+    band->height = height * (i + 1) / band_count - band->y;
+    band->width = width;
+    cairo_get_matrix (cr, &band->matrix);
+    band->matrix.y0 -= band->y;
+    band->objects = obj_list;
+    band->render_flags = render_flags;
+    band->color_map = render_color_map;
+    band->font_name = fontstr;
   }
 
-  /* Paint background */
-  LeptonColor *color = x_color_lookup (BACKGROUND_COLOR);
-
-  cairo_set_source_rgba (cr,
-                         lepton_color_get_red_double (color),
-                         lepton_color_get_green_double (color),
-                         lepton_color_get_blue_double (color),
-                         lepton_color_get_alpha_double (color));
-
-  cairo_paint (cr);
-  cairo_destroy (cr);
+  /* Render the first band in this thread, and the others in
+   * threads of their own. */
+  for (i = 1; i < band_count; i++) {
+    threads[i] = g_thread_new ("image-band", x_image_render_band, &bands[i]);
+  }
+  x_image_render_band (&bands[0]);
 
-  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
-    LeptonObject *o_current = (LeptonObject*) iter->data;
+  /* Put the bands together */
+  cairo_identity_matrix (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
 
-    if (!o_current->dont_redraw) {
-      eda_renderer_draw (renderer, o_current);
+  for (i = 0; i < band_count; i++) {
+    if (threads[i] != NULL) {
+      g_thread_join (threads[i]);
     }
+
+    cairo_set_source_surface (cr, bands[i].surface, 0, bands[i].y);
+    cairo_rectangle (cr, 0, bands[i].y, width, bands[i].height);
+    cairo_fill (cr);
+    cairo_surface_destroy (bands[i].surface);
   }
 
+  cairo_destroy (cr);
+  cairo_surface_flush (cs);
+
+  g_free (threads);
+  g_free (bands);
+  g_free (fontstr);
   g_list_free (obj_list);
-  g_object_unref (G_OBJECT (renderer));
   g_array_free (render_color_map, TRUE);
 
   gschem_page_geometry_free (new_geometry);
@@ -916,6 +1037,9 @@ GdkPixbuf
 
   gschem_options_set_grid_mode (new_w_current.options, GRID_MODE_NONE);
 
+  /* Exported images are always rendered with full detail. */
+  new_w_current.level_of_detail = FALSE;
+
   /*! \bug Need to handle image color setting properly.
    *       See gEDA Launchpad bug 1086530.
    *
@@ -949,7 +1073,9 @@ GdkPixbuf
                  window,
                  toplevel.page_current,
                  new_geometry,
-                 &rect);
+                 &rect,
+                 NULL,
+                 FALSE);
 
   gschem_page_geometry_free (new_geometry);
 
@@ -24,6 +24,7 @@
 
 
 static void multiattrib_update (Multiattrib *multiattrib);
+static void multiattrib_queue_update (Multiattrib *multiattrib);
 
 static gboolean
 snv_shows_name (int snv)
@@ -479,6 +480,7 @@ enum {
   COLUMN_IDENTICAL_SHOW_NAME,
   COLUMN_IDENTICAL_SHOW_VALUE,
   COLUMN_ATTRIBUTE_GEDALIST,
+  COLUMN_KEY,
   NUM_COLUMNS
 };
 
@@ -685,24 +687,27 @@ multiattrib_action_copy_attribute_to_all (Multiattrib *multiattrib,
 {
   GschemToplevel *w_current = GSCHEM_DIALOG (multiattrib)->w_current;
   GList *iter;
-  GList *objects_needing_add;
+  GHashTable *objects_having_attrib;
 
-  objects_needing_add = g_list_copy (lepton_list_get_glist (multiattrib->object_list));
+  /* Collect the objects which already have this attribute */
+  objects_having_attrib = g_hash_table_new (NULL, NULL);
 
-  /* Remove objects which already have this attribute from the list */
   for (iter = attr_list;
        iter != NULL;
        iter = g_list_next (iter)) {
     LeptonObject *o_attrib = (LeptonObject *)iter->data;
 
-    objects_needing_add = g_list_remove (objects_needing_add,
-                                         lepton_object_get_attached_to (o_attrib));
+    g_hash_table_add (objects_having_attrib,
+                      lepton_object_get_attached_to (o_attrib));
   }
 
-  for (iter = objects_needing_add; iter != NULL; iter = g_list_next (iter)) {
+  for (iter = lepton_list_get_glist (multiattrib->object_list);
+       iter != NULL;
+       iter = g_list_next (iter)) {
     LeptonObject *object = (LeptonObject*) iter->data;
 
-    if (is_multiattrib_object (object)) {
+    if (is_multiattrib_object (object) &&
+        !g_hash_table_contains (objects_having_attrib, object)) {
 
       /* Pick the first instance to copy from */
       LeptonObject *attrib_to_copy = (LeptonObject*) attr_list->data;
@@ -722,6 +727,8 @@ multiattrib_action_copy_attribute_to_all (Multiattrib *multiattrib,
     }
   }
 
+  g_hash_table_destroy (objects_having_attrib);
+
   schematic_window_active_page_changed (w_current);
   o_undo_savestate_old (w_current, UNDO_ALL);
 }
@@ -1811,6 +1818,75 @@ multiattrib_geometry_restore (GschemDialog *dialog, EdaConfig *cfg, gchar *group
 }
 
 
+/*! \brief Update the dialog from the main loop
+ *
+ *  \par Function Description
+ *
+ *  Idle handler doing the update requested by
+ *  multiattrib_queue_update().
+ *
+ *  \param [in] user_data  The multi-attribute editor dialog.
+ *  \returns FALSE to remove the idle source.
+ */
+static gboolean
+multiattrib_update_idle (gpointer user_data)
+{
+  Multiattrib *multiattrib = MULTIATTRIB (user_data);
+
+  multiattrib->update_id = 0;
+  multiattrib_update (multiattrib);
+
+  return FALSE;
+}
+
+
+/*! \brief Request an update of the dialog
+ *
+ *  \par Function Description
+ *
+ *  The update is done once the main loop is idle, so that many
+ *  changes of the selection or of the attributes in a row, such
+ *  as selecting objects with a box, cause one update only.
+ *
+ *  \param [in] multiattrib  The multi-attribute editor dialog.
+ */
+static void
+multiattrib_queue_update (Multiattrib *multiattrib)
+{
+  if (multiattrib->update_id == 0) {
+    multiattrib->update_id = g_idle_add (multiattrib_update_idle,
+                                         multiattrib);
+  }
+}
+
+
+/*! \brief Object change notification handler
+ *
+ *  \par Function Description
+ *
+ *  Requests an update of the dialog when a selected object, or an
+ *  attribute attached to one, is modified.
+ *
+ *  \param [in] user_data  The multi-attribute editor dialog.
+ *  \param [in] object     The modified object.
+ *  \returns Always 0.
+ */
+static int
+object_changed_cb (void *user_data, LeptonObject *object)
+{
+  Multiattrib *multiattrib = MULTIATTRIB (user_data);
+  LeptonObject *attached_to = lepton_object_get_attached_to (object);
+
+  if (multiattrib->object_list != NULL &&
+      (object->selected ||
+       (attached_to != NULL && attached_to->selected))) {
+    multiattrib_queue_update (multiattrib);
+  }
+
+  return 0;
+}
+
+
 /*! \brief Update the multiattrib editor dialog when its object list changes.
  *
  *  \par Function Description
@@ -1821,7 +1897,7 @@ multiattrib_geometry_restore (GschemDialog *dialog, EdaConfig *cfg, gchar *group
 static void
 object_list_changed_cb (LeptonList *object_list, Multiattrib *multiattrib)
 {
-  multiattrib_update (multiattrib);
+  multiattrib_queue_update (multiattrib);
 }
 
 
@@ -1860,6 +1936,17 @@ object_list_weak_ref_cb (gpointer data, GObject *where_the_object_was)
 static void
 connect_object_list (Multiattrib *multiattrib, LeptonList *object_list)
 {
+  GschemToplevel *w_current = GSCHEM_DIALOG (multiattrib)->w_current;
+
+  /* Watch the changes of attributes of the selected objects */
+  if (multiattrib->toplevel == NULL && w_current != NULL) {
+    multiattrib->toplevel = gschem_toplevel_get_toplevel (w_current);
+    lepton_object_add_change_notify (multiattrib->toplevel,
+                                     NULL,
+                                     object_changed_cb,
+                                     multiattrib);
+  }
+
   multiattrib->object_list = object_list;
   if (multiattrib->object_list != NULL) {
     g_object_weak_ref (G_OBJECT (multiattrib->object_list),
@@ -1870,8 +1957,8 @@ connect_object_list (Multiattrib *multiattrib, LeptonList *object_list)
                         "changed",
                         G_CALLBACK (object_list_changed_cb),
                         multiattrib);
-    /* Synthesise a object_list changed update to refresh the view */
-    object_list_changed_cb (multiattrib->object_list, multiattrib);
+    /* Refresh the view at once */
+    multiattrib_update (multiattrib);
   } else {
     /* Call an update to set the sensitivities */
     multiattrib_update (multiattrib);
@@ -1916,6 +2003,19 @@ multiattrib_finalize (GObject *object)
 {
   Multiattrib *multiattrib = MULTIATTRIB(object);
 
+  if (multiattrib->update_id != 0) {
+    g_source_remove (multiattrib->update_id);
+    multiattrib->update_id = 0;
+  }
+
+  if (multiattrib->toplevel != NULL) {
+    lepton_object_remove_change_notify (multiattrib->toplevel,
+                                        NULL,
+                                        object_changed_cb,
+                                        multiattrib);
+    multiattrib->toplevel = NULL;
+  }
+
   disconnect_object_list (multiattrib);
   G_OBJECT_CLASS (multiattrib_parent_class)->finalize (object);
 }
@@ -2043,7 +2143,8 @@ multiattrib_init (Multiattrib *multiattrib)
                                              G_TYPE_BOOLEAN,  /* COLUMN_IDENTICAL_VISIBILITY */
                                              G_TYPE_BOOLEAN,  /* COLUMN_IDENTICAL_SHOW_NAME */
                                              G_TYPE_BOOLEAN,  /* COLUMN_IDENTICAL_SHOW_VALUE */
-                                             G_TYPE_OBJECT);  /* COLUMN_ATTRIBUTE_GEDALIST */
+                                             G_TYPE_OBJECT,   /* COLUMN_ATTRIBUTE_GEDALIST */
+                                             G_TYPE_STRING);  /* COLUMN_KEY */
 
   /*   - create a scrolled window for the treeview */
   scrolled_win = GTK_WIDGET (
@@ -2503,16 +2604,78 @@ typedef struct {
   gboolean identical_show_name;
   gboolean identical_show_value;
 
-  LeptonList *attribute_gedalist;
+  /* The underlying attributes, in reverse order until the row
+   * is added to the model */
+  GList *attribs;
+
+  /* Identifies the row of the model across updates */
+  char *key;
 } MODEL_ROW;
 
+/*! \brief Create a MODEL_ROW record for an attribute
+ *
+ *  \par Function Description
+ *
+ *  The record describes the attribute alone.  Its key is derived
+ *  from the name of the attribute and \a nth_with_name, unless \a
+ *  key is given.
+ *
+ *  \param [in] a_current      The attribute.
+ *  \param [in] nth_with_name  The number of preceding attributes
+ *                             having the same name.
+ *  \param [in] key            The key of the row, or NULL.
+ *  \returns  A new MODEL_ROW record.
+ */
+static MODEL_ROW *
+model_row_new (LeptonObject *a_current, int nth_with_name, char *key)
+{
+  MODEL_ROW *m_row = g_new0 (MODEL_ROW, 1);
+
+  m_row->inherited = o_attrib_is_inherited (a_current);
+  m_row->name  = g_strdup (lepton_text_object_get_name (a_current));
+  m_row->value = g_strdup (lepton_text_object_get_value (a_current));
+  m_row->visibility = lepton_text_object_is_visible (a_current);
+  m_row->show_name_value = lepton_text_object_get_show (a_current);
+  m_row->nth_with_name = nth_with_name;
+
+  /* The following fields are always true for a single LeptonObject */
+  m_row->present_in_all = TRUE;
+  m_row->identical_value = TRUE;
+  m_row->identical_visibility = TRUE;
+  m_row->identical_show_name = TRUE;
+  m_row->identical_show_value = TRUE;
+
+  m_row->attribs = g_list_prepend (NULL, a_current);
+
+  m_row->key = (key != NULL) ? key
+    : g_strdup_printf ("%d:%d:%s",
+                       m_row->inherited, nth_with_name, m_row->name);
+
+  return m_row;
+}
+
+/*! \brief Free a MODEL_ROW record
+ *
+ *  \param [in] m_row  The MODEL_ROW record.
+ */
+static void
+model_row_free (MODEL_ROW *m_row)
+{
+  g_list_free (m_row->attribs);
+  g_free (m_row->name);
+  g_free (m_row->value);
+  g_free (m_row->key);
+  g_free (m_row);
+}
+
 /*! \brief For a given LeptonObject, produce a GList of MODEL_ROW records
  *
  *  \par Function Description
  *
  *  The main purpose of this function is to provide the "nth_with_name"
  *  count which we need to merge the attribute lists of various objects
- *  together.
+ *  together.  The attributes seen so far are counted by name in a
+ *  hash table.
  *
  *  \param [in] multiattrib  The multi-attribute editor dialog
  *  \param [in] object       The LeptonObject * whos attributes we are processing
@@ -2524,48 +2687,37 @@ object_attributes_to_model_rows (Multiattrib *multiattrib, LeptonObject *object)
   GList *model_rows = NULL;
   GList *a_iter;
   GList *object_attribs = o_attrib_return_attribs (object);
+  GHashTable *name_counts[2];
+
+  /* Attached and inherited attributes are counted separately */
+  name_counts[0] = g_hash_table_new (g_str_hash, g_str_equal);
+  name_counts[1] = g_hash_table_new (g_str_hash, g_str_equal);
 
   for (a_iter = object_attribs; a_iter != NULL;
        a_iter = g_list_next (a_iter)) {
 
     LeptonObject *a_current = (LeptonObject*) a_iter->data;
-    MODEL_ROW *m_row = g_new0 (MODEL_ROW, 1);
-    GList *m_iter;
-
-    m_row->inherited = o_attrib_is_inherited (a_current);
-    m_row->name  = g_strdup (lepton_text_object_get_name (a_current));
-    m_row->value = g_strdup (lepton_text_object_get_value (a_current));
-    m_row->visibility = lepton_text_object_is_visible (a_current);
-    m_row->show_name_value = lepton_text_object_get_show (a_current);
-    m_row->nth_with_name = 0; /* Provisional value until we check below */
-
-    /* The following fields are always true for a single LeptonObject */
-    m_row->present_in_all = TRUE;
-    m_row->identical_value = TRUE;
-    m_row->identical_visibility = TRUE;
-    m_row->identical_show_name = TRUE;
-    m_row->identical_show_value = TRUE;
-
-    m_row->attribute_gedalist = lepton_list_new ();
-    lepton_list_add (m_row->attribute_gedalist, a_current);
-
-    /* Search already processed attributes to see if we need to bump m_row->nth_with_name */
-    for (m_iter = model_rows;
-         m_iter != NULL;
-         m_iter = g_list_next (m_iter)) {
-      MODEL_ROW *m_compare = (MODEL_ROW*) m_iter->data;
-      if (strcmp (m_compare->name, m_row->name) == 0 &&
-          m_compare->inherited == m_row->inherited) {
-        m_row->nth_with_name = m_row->nth_with_name + 1;
-      }
-    }
+    const char *name = lepton_text_object_get_name (a_current);
+    GHashTable *counts = name_counts[o_attrib_is_inherited (a_current) ? 1 : 0];
+    int nth_with_name;
+    MODEL_ROW *m_row;
 
-    model_rows = g_list_append (model_rows, m_row);
+    /* Number of already processed attributes with the same name */
+    nth_with_name = GPOINTER_TO_INT (g_hash_table_lookup (counts, name));
+
+    m_row = model_row_new (a_current, nth_with_name, NULL);
+
+    g_hash_table_insert (counts, m_row->name,
+                         GINT_TO_POINTER (nth_with_name + 1));
+
+    model_rows = g_list_prepend (model_rows, m_row);
   }
 
+  g_hash_table_destroy (name_counts[0]);
+  g_hash_table_destroy (name_counts[1]);
   g_list_free (object_attribs);
 
-  return model_rows;
+  return g_list_reverse (model_rows);
 }
 
 /*! \brief Produce a GList of MODEL_ROW records for all attribute objects in our LeptonList
@@ -2593,7 +2745,6 @@ lone_attributes_to_model_rows (Multiattrib *multiattrib)
        o_iter != NULL;
        o_iter = g_list_next (o_iter)) {
     LeptonObject *object = (LeptonObject*) o_iter->data;
-    MODEL_ROW *m_row;
 
     /* Consider a selected text object might be an attribute */
     if (!lepton_object_is_attrib (object))
@@ -2603,28 +2754,80 @@ lone_attributes_to_model_rows (Multiattrib *multiattrib)
 
     multiattrib->num_lone_attribs_in_list ++;
 
-    m_row = g_new0 (MODEL_ROW, 1);
-    m_row->inherited = o_attrib_is_inherited (object);
-    m_row->name = g_strdup (lepton_text_object_get_name (object));
-    m_row->value = g_strdup (lepton_text_object_get_value (object));
-    m_row->visibility = lepton_text_object_is_visible (object);
-    m_row->show_name_value = lepton_text_object_get_show (object);
-    m_row->nth_with_name = 0; /* All selected attributes are treated individually */
+    /* All selected attributes are treated individually */
+    model_rows = g_list_prepend (model_rows,
+                                 model_row_new (object, 0,
+                                                g_strdup_printf ("%p", object)));
+  }
 
-    /* The following fields are always true for a single attribute */
-    m_row->present_in_all = TRUE;
-    m_row->identical_value = TRUE;
-    m_row->identical_visibility = TRUE;
-    m_row->identical_show_name = TRUE;
-    m_row->identical_show_value = TRUE;
+  return g_list_reverse (model_rows);
+}
 
-    m_row->attribute_gedalist = lepton_list_new ();
-    lepton_list_add (m_row->attribute_gedalist, object);
+/*! \brief Check if a row of the liststore already shows a MODEL_ROW
+ *
+ *  \param [in] model  The liststore.
+ *  \param [in] iter   The row of the liststore.
+ *  \param [in] m_row  The MODEL_ROW record.
+ *  \returns  TRUE if the row does not need to be updated.
+ */
+static gboolean
+model_row_is_shown (GtkTreeModel *model,
+                    GtkTreeIter *iter,
+                    MODEL_ROW *m_row)
+{
+  gboolean inherited, visibility, present_in_all;
+  gboolean identical_value, identical_visibility;
+  gboolean identical_show_name, identical_show_value;
+  int show_name_value;
+  char *name, *value;
+  LeptonList *attr_list;
+  GList *a_iter, *b_iter;
+  gboolean result;
+
+  gtk_tree_model_get (model, iter,
+                      COLUMN_INHERITED,            &inherited,
+                      COLUMN_NAME,                 &name,
+                      COLUMN_VALUE,                &value,
+                      COLUMN_VISIBILITY,           &visibility,
+                      COLUMN_SHOW_NAME_VALUE,      &show_name_value,
+                      COLUMN_PRESENT_IN_ALL,       &present_in_all,
+                      COLUMN_IDENTICAL_VALUE,      &identical_value,
+                      COLUMN_IDENTICAL_VISIBILITY, &identical_visibility,
+                      COLUMN_IDENTICAL_SHOW_NAME,  &identical_show_name,
+                      COLUMN_IDENTICAL_SHOW_VALUE, &identical_show_value,
+                      COLUMN_ATTRIBUTE_GEDALIST,   &attr_list,
+                      -1);
+
+  result = (inherited == m_row->inherited
+            && visibility == m_row->visibility
+            && show_name_value == m_row->show_name_value
+            && present_in_all == m_row->present_in_all
+            && identical_value == m_row->identical_value
+            && identical_visibility == m_row->identical_visibility
+            && identical_show_name == m_row->identical_show_name
+            && identical_show_value == m_row->identical_show_value
+            && g_strcmp0 (name, m_row->name) == 0
+            && g_strcmp0 (value, m_row->value) == 0);
 
-    model_rows = g_list_append (model_rows, m_row);
+  /* Compare the underlying attributes */
+  a_iter = (attr_list == NULL) ? NULL : lepton_list_get_glist (attr_list);
+  b_iter = m_row->attribs;
+
+  while (result && a_iter != NULL && b_iter != NULL) {
+    result = (a_iter->data == b_iter->data);
+    a_iter = g_list_next (a_iter);
+    b_iter = g_list_next (b_iter);
   }
 
-  return model_rows;
+  result = result && (a_iter == NULL) && (b_iter == NULL);
+
+  if (attr_list != NULL) {
+    g_object_unref (attr_list);
+  }
+  g_free (name);
+  g_free (value);
+
+  return result;
 }
 
 /*! \brief Populate the multiattrib editor dialog's liststore
@@ -2634,6 +2837,11 @@ lone_attributes_to_model_rows (Multiattrib *multiattrib)
  *  Consumes the GList of MODEL_ROW data, populating the dialog's liststore.
  *  The function frees / consumes the GList and MODEL_ROW data.
  *
+ *  The liststore is updated in place: rows are matched with the
+ *  MODEL_ROW records through their keys, so that only the rows
+ *  which are new, gone or changed are inserted, removed or set.
+ *  The other rows, and the cursor of the view, are left alone.
+ *
  *  \param [in] multiattrib  The multi-attribute editor dialog.
  *  \param [in] model_rows   A GList of MODEL_ROW data.
  */
@@ -2642,26 +2850,94 @@ multiattrib_populate_liststore (Multiattrib *multiattrib,
                                 GList *model_rows)
 {
   GtkListStore *liststore;
+  GtkTreeModel *model;
   GtkTreeIter tree_iter;
+  GHashTable *new_rows;
+  GHashTable *old_rows;
   GList *m_iter;
+  gboolean valid;
 
-  /* Clear the existing list of attributes */
   liststore = (GtkListStore*)gtk_tree_view_get_model (multiattrib->treeview);
-  gtk_list_store_clear (liststore);
+  model = GTK_TREE_MODEL (liststore);
 
+  new_rows = g_hash_table_new (g_str_hash, g_str_equal);
+  for (m_iter = model_rows;
+       m_iter != NULL;
+       m_iter = g_list_next (m_iter)) {
+    MODEL_ROW *model_row = (MODEL_ROW*) m_iter->data;
+    g_hash_table_insert (new_rows, model_row->key, model_row);
+  }
+
+  /* Remove the rows which are gone, and remember the others by key.
+   * Iterators of a liststore persist while the row exists. */
+  old_rows = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                    g_free, (GDestroyNotify) gtk_tree_iter_free);
+  valid = gtk_tree_model_get_iter_first (model, &tree_iter);
+  while (valid) {
+    char *key;
+
+    gtk_tree_model_get (model, &tree_iter, COLUMN_KEY, &key, -1);
+
+    if (key == NULL ||
+        !g_hash_table_contains (new_rows, key) ||
+        g_hash_table_contains (old_rows, key)) {
+      g_free (key);
+      valid = gtk_list_store_remove (liststore, &tree_iter);
+    } else {
+      g_hash_table_insert (old_rows, key, gtk_tree_iter_copy (&tree_iter));
+      valid = gtk_tree_model_iter_next (model, &tree_iter);
+    }
+  }
+
+  /* Walk the new rows in order, reusing the existing rows */
+  valid = gtk_tree_model_get_iter_first (model, &tree_iter);
   for (m_iter = model_rows;
        m_iter != NULL;
        m_iter = g_list_next (m_iter)) {
 
     MODEL_ROW *model_row = (MODEL_ROW*) m_iter->data;
+    LeptonList *attr_list;
+    GtkTreeIter *old_iter;
+    GtkTreeIter row_iter;
 
+    model_row->attribs = g_list_reverse (model_row->attribs);
     model_row->present_in_all =
-      ((int) g_list_length (lepton_list_get_glist (model_row->attribute_gedalist))
+      ((int) g_list_length (model_row->attribs)
        == multiattrib->total_num_in_list);
 
-    gtk_list_store_append (liststore, &tree_iter);
+    old_iter = (GtkTreeIter*) g_hash_table_lookup (old_rows, model_row->key);
+
+    if (old_iter != NULL) {
+      char *key = NULL;
+
+      row_iter = *old_iter;
+
+      if (valid) {
+        gtk_tree_model_get (model, &tree_iter, COLUMN_KEY, &key, -1);
+      }
+
+      /* Move the row to its new position if needed */
+      if (g_strcmp0 (key, model_row->key) != 0) {
+        gtk_list_store_move_before (liststore, &row_iter,
+                                    valid ? &tree_iter : NULL);
+      } else {
+        valid = gtk_tree_model_iter_next (model, &tree_iter);
+      }
+      g_free (key);
+
+      if (model_row_is_shown (model, &row_iter, model_row)) {
+        continue;
+      }
+    } else {
+      gtk_list_store_insert_before (liststore, &row_iter,
+                                    valid ? &tree_iter : NULL);
+    }
+
+    attr_list = lepton_list_new ();
+    lepton_list_add_glist (attr_list, model_row->attribs);
+
     gtk_list_store_set (liststore,
-                        &tree_iter,
+                        &row_iter,
                         COLUMN_INHERITED,            model_row->inherited,
                         COLUMN_NAME,                 model_row->name,
                         COLUMN_VALUE,                model_row->value,
@@ -2672,14 +2948,18 @@ multiattrib_populate_liststore (Multiattrib *multiattrib,
                         COLUMN_IDENTICAL_VISIBILITY, model_row->identical_visibility,
                         COLUMN_IDENTICAL_SHOW_NAME,  model_row->identical_show_name,
                         COLUMN_IDENTICAL_SHOW_VALUE, model_row->identical_show_value,
-                        COLUMN_ATTRIBUTE_GEDALIST,   model_row->attribute_gedalist,
+                        COLUMN_ATTRIBUTE_GEDALIST,   attr_list,
+                        COLUMN_KEY,                  model_row->key,
                         -1);
 
     /* Drop our ref on the LeptonList so it is freed when the model has done with it */
-    g_object_unref (model_row->attribute_gedalist);
+    g_object_unref (attr_list);
   }
 
-  g_list_foreach (model_rows, (GFunc) g_free, NULL);
+  g_hash_table_destroy (old_rows);
+  g_hash_table_destroy (new_rows);
+
+  g_list_foreach (model_rows, (GFunc) model_row_free, NULL);
   g_list_free (model_rows);
 }
 
@@ -2767,8 +3047,15 @@ multiattrib_update (Multiattrib *multiattrib)
   gboolean list_sensitive;
   gboolean add_sensitive;
   GList *model_rows = NULL;
+  GHashTable *rows_by_key;
   const char *component_title_name = NULL;
 
+  /* This update supersedes any pending one */
+  if (multiattrib->update_id != 0) {
+    g_source_remove (multiattrib->update_id);
+    multiattrib->update_id = 0;
+  }
+
   show_inherited =
     gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (multiattrib->show_inherited));
 
@@ -2779,6 +3066,9 @@ multiattrib_update (Multiattrib *multiattrib)
   multiattrib->num_buses_in_list        = 0;
   multiattrib->num_lone_attribs_in_list = 0;
 
+  /* Rows of the model by key, to merge identical attributes */
+  rows_by_key = g_hash_table_new (g_str_hash, g_str_equal);
+
   /* populate the store with attributes */
   for (o_iter = multiattrib->object_list == NULL ? NULL : lepton_list_get_glist (multiattrib->object_list);
        o_iter != NULL;
@@ -2823,25 +3113,19 @@ multiattrib_update (Multiattrib *multiattrib)
 
       MODEL_ROW *object_row = (MODEL_ROW*) or_iter->data;
       MODEL_ROW *model_row;
-      GList *mr_iter;
-      gboolean found = FALSE;
 
       /* Skip over inherited attributes if we don't want to show them */
-      if (!show_inherited && object_row->inherited)
+      if (!show_inherited && object_row->inherited) {
+        model_row_free (object_row);
         continue;
-
-      /* Search our list of attributes to see if we already encountered */
-      for (mr_iter = model_rows;
-           mr_iter != NULL && found == FALSE;
-           mr_iter = g_list_next (mr_iter)) {
-        model_row = (MODEL_ROW*) mr_iter->data;
-        if (strcmp (model_row->name, object_row->name) == 0 &&
-            model_row->nth_with_name == object_row->nth_with_name &&
-            model_row->inherited == object_row->inherited)
-          found = TRUE;
       }
 
-      if (found) {
+      /* Look up the attributes already encountered with the same
+       * name, rank and inheritance */
+      model_row = (MODEL_ROW*) g_hash_table_lookup (rows_by_key,
+                                                    object_row->key);
+
+      if (model_row != NULL) {
         /* Name matches a previously found attribute */
         /* Check if the rest of its properties match the one we have stored... */
 
@@ -2859,19 +3143,19 @@ multiattrib_update (Multiattrib *multiattrib)
             snv_shows_value (object_row->show_name_value))
           model_row->identical_show_value = FALSE;
 
-        /* Add the underlying attribute to the row's LeptonList of attributes */
-        lepton_list_add_glist (model_row->attribute_gedalist,
-                             lepton_list_get_glist (object_row->attribute_gedalist));
+        /* Add the underlying attribute to the row's list of attributes */
+        model_row->attribs = g_list_prepend (model_row->attribs,
+                                             object_row->attribs->data);
 
-        g_object_unref (object_row->attribute_gedalist);
-        g_free (object_row);
+        model_row_free (object_row);
 
       } else {
         /*
          * The attribute name doesn't match any previously found
          * attribute, so add the model row entry describing it to the list.
          */
-        model_rows = g_list_append (model_rows, object_row);
+        g_hash_table_insert (rows_by_key, object_row->key, object_row);
+        model_rows = g_list_prepend (model_rows, object_row);
       }
     }
 
@@ -2879,6 +3163,9 @@ multiattrib_update (Multiattrib *multiattrib)
     g_list_free (object_rows);
   }
 
+  g_hash_table_destroy (rows_by_key);
+  model_rows = g_list_reverse (model_rows);
+
   if (multiattrib->total_num_in_list == 0) {
 
     /* If the selection contains no high level objects we can edit,
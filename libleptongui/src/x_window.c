@@ -163,10 +163,13 @@ x_window_find_text (GtkWidget *widget, gint response, GschemToplevel *w_current)
 {
   gint close = FALSE;
   int count;
+  GschemFindTextState *state;
 
   g_return_if_fail (w_current != NULL);
   g_return_if_fail (w_current->toplevel != NULL);
 
+  state = GSCHEM_FIND_TEXT_STATE (w_current->find_text_state);
+
   gboolean show_hidden_text =
     gschem_toplevel_get_show_hidden_text (w_current);
 
@@ -174,14 +177,20 @@ x_window_find_text (GtkWidget *widget, gint response, GschemToplevel *w_current)
   case GTK_RESPONSE_OK:
     count = gschem_find_text_state_find (
         w_current,
-        GSCHEM_FIND_TEXT_STATE (w_current->find_text_state),
+        state,
         lepton_list_get_glist (w_current->toplevel->pages),
         gschem_find_text_widget_get_find_type (GSCHEM_FIND_TEXT_WIDGET (w_current->find_text_widget)),
         gschem_find_text_widget_get_find_text_string (GSCHEM_FIND_TEXT_WIDGET (w_current->find_text_widget)),
         gschem_find_text_widget_get_descend (GSCHEM_FIND_TEXT_WIDGET (w_current->find_text_widget)),
         show_hidden_text);
 
-    if (count > 0)
+    if (gschem_find_text_state_is_searching (state))
+    {
+      /* Show the results as they are found, and keep the find
+       * widget open so that the search can be cancelled. */
+      x_widgets_show_find_text_state (w_current);
+    }
+    else if (count > 0)
     {
       x_widgets_show_find_text_state (w_current);
       close = TRUE;
@@ -191,6 +200,7 @@ x_window_find_text (GtkWidget *widget, gint response, GschemToplevel *w_current)
 
   case GTK_RESPONSE_CANCEL:
   case GTK_RESPONSE_DELETE_EVENT:
+    gschem_find_text_state_cancel (state);
     close = TRUE;
     break;
 
@@ -243,6 +253,32 @@ x_window_show_text (GtkWidget *widget, gint response, GschemToplevel *w_current)
 }
 
 
+/*! \brief Handle the end of a Find Text search.
+ *  \par Function Description
+ *  Called when a search that went on in the background is done.
+ *  If any text has been found, closes the find text widget as if
+ *  the search had finished at once.
+ *
+ *  \param [in] state     The find text state widget.
+ *  \param [in] count     The number of objects found.
+ *  \param [in] w_current The schematic window.
+ */
+void
+x_window_find_text_finished (GschemFindTextState *state,
+                             int count,
+                             GschemToplevel *w_current)
+{
+  g_return_if_fail (w_current != NULL);
+
+  if (count > 0)
+  {
+    gtk_widget_grab_focus (w_current->drawing_area);
+    gtk_widget_hide (w_current->find_text_widget);
+  }
+}
+
+
+
 void
 x_window_select_object (GschemFindTextState *state,
                         LeptonObject *object,
@@ -31,7 +31,7 @@
 (define %cli (basename (car (program-arguments))))
 (define %rest-args (cdr (program-arguments)))
 (define %commands
-  '("shell" "config" "export"))
+  '("shell" "config" "export" "serve" "client"))
 
 (define (run-help-prompt)
   (format (current-error-port)
@@ -64,6 +64,8 @@ Commonly-used commands (type `lepton-cli <cmd> --help' for usage):
   shell          Scheme REPL for interactive Lepton EDA data processing
   config         Edit Lepton EDA configuration
   export         Export Lepton EDA files in various image formats.
+  serve          Run a server executing commands sent by clients
+  client         Run a command in the server
 
 Report bugs at <~A>
 Lepton EDA homepage: <~A>
@@ -112,20 +114,11 @@ Lepton EDA homepage: <~A>
        (lambda (op seeds)
          (check-command op)
          (let ((prog-name
-                (if (string= op "shell")
-                    (or (getenv "LEPTON_SHELL")
-                        (string-append %lepton-bindir
-                                       file-name-separator-string
-                                       "lepton-shell"))
-                    (if (string= op "config")
-                        (or (getenv "LEPTON_CONFIG")
-                            (string-append %lepton-bindir
-                                           file-name-separator-string
-                                           "lepton-config"))
-                        (or (getenv "LEPTON_EXPORT")
-                            (string-append %lepton-bindir
-                                           file-name-separator-string
-                                           "lepton-export"))))))
+                (or (getenv (string-append "LEPTON_" (string-upcase op)))
+                    (string-append %lepton-bindir
+                                   file-name-separator-string
+                                   "lepton-"
+                                   op))))
            (apply execle
                   prog-name
                   (environ)
@@ -0,0 +1,143 @@
+;;; Lepton EDA command-line utility
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+;;; This program only forwards its command line to the server
+;;; started by `lepton-cli serve', and therefore does not load
+;;; liblepton.
+
+(use-modules (ice-9 binary-ports)
+             (ice-9 match)
+             (srfi srfi-11)
+             (lepton gettext)
+             (lepton server protocol))
+
+
+(define cmd (basename (car (program-arguments))))
+(define cmd-args (cdr (program-arguments)))
+
+(define (client-usage)
+  (format #t (G_ "Usage: ~A [OPTION ...] COMMAND [ARGS ...]
+
+Run a lepton-cli COMMAND, such as `netlist' or `export', in the
+server started by `lepton-cli serve'.
+
+  -s, --socket=FILE  connect to the server listening on FILE
+  -t, --time         report the time the server spent on the command
+  -h, --help         display usage information and exit
+
+Report bugs at <https://github.com/lepton-eda/lepton-eda/issues>
+Lepton EDA homepage: <https://github.com/lepton-eda/lepton-eda>
+")
+          cmd)
+  (exit 0))
+
+(define (help-message)
+  (format (current-error-port)
+          (G_ "\nRun `lepton-cli client --help' for more information.\n"))
+  (exit 1))
+
+
+;;; Parse command-line arguments.  Arguments following the command
+;;; are passed to it as is, so only the options preceding it are
+;;; processed.  Returns three values: the socket file name, whether
+;;; timing has been requested, and the command line to run.
+(define (parse-commandline)
+  (let loop ((args cmd-args)
+             (socket #f)
+             (time? #f))
+    (match args
+      (((or "-h" "--help") . _)
+       (client-usage))
+      (((or "-t" "--time") . rest)
+       (loop rest socket #t))
+      (((or "-s" "--socket") filename . rest)
+       (loop rest filename time?))
+      (((? (lambda (arg) (string-prefix? "--socket=" arg)) arg) . rest)
+       (loop rest (string-drop arg (string-length "--socket=")) time?))
+      (("--" . rest)
+       (values socket time? rest))
+      (((? (lambda (arg) (string-prefix? "-" arg)) arg) . _)
+       (format (current-error-port) (G_ "ERROR: Unknown option ~A.\n") arg)
+       (help-message))
+      (_ (values socket time? args)))))
+
+
+(define (connect-to-server filename)
+  (let ((sock (socket PF_UNIX SOCK_STREAM 0)))
+    (catch 'system-error
+      (lambda ()
+        (connect sock AF_UNIX filename)
+        sock)
+      (lambda (key subr message args rest)
+        (format (current-error-port)
+                (G_ "ERROR: Failed to connect to server at ~S: ~?\n")
+                filename
+                message
+                args)
+        (exit 1)))))
+
+
+;;; Sends the command line ARGS to the server, copies the output
+;;; of the command to the standard output and error ports, and
+;;; exits with the exit status of the command.
+(define (run-command filename args time?)
+  (let ((sock (connect-to-server filename)))
+    (write-datum-frame sock 'request (list (getcwd) (environ) args))
+    (let loop ()
+      (let-values (((type payload) (read-frame sock)))
+        (case type
+          ((stdout stderr)
+           (let ((port (if (eq? type 'stdout)
+                           (current-output-port)
+                           (current-error-port))))
+             (put-bytevector port payload)
+             (force-output port))
+           (loop))
+          ((exit)
+           (match (frame-datum payload)
+             ((status seconds)
+              (when time?
+                (format (current-error-port)
+                        (G_ "~A: ~,3F s\n")
+                        (string-join args)
+                        seconds))
+              (exit status))))
+          (else
+           (format (current-error-port)
+                   (G_ "ERROR: Connection to server closed unexpectedly.\n"))
+           (exit 1)))))))
+
+
+(define %cli-gettext-domain "lepton-cli")
+
+(define (main)
+  ;; Localization.
+  (bindtextdomain %cli-gettext-domain %lepton-localedir)
+  (textdomain %cli-gettext-domain)
+  (bind-textdomain-codeset %cli-gettext-domain "UTF-8")
+  (setlocale LC_ALL "")
+  (setlocale LC_NUMERIC "C")
+
+  (let-values (((socket time? args) (parse-commandline)))
+    (when (null? args)
+      (format (current-error-port)
+              (G_ "ERROR: You must specify a command to run.\n"))
+      (help-message))
+    (run-command (or socket (default-server-socket)) args time?)))
+
+;;; Run the program.
+(main)
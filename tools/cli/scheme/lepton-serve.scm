@@ -0,0 +1,204 @@
+;;; Lepton EDA command-line utility
+;;; Copyright (C) 2022 Lepton EDA Contributors
+;;;
+;;; This program is free software; you can redistribute it and/or modify
+;;; it under the terms of the GNU General Public License as published by
+;;; the Free Software Foundation; either version 2 of the License, or
+;;; (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, write to the Free Software
+;;; Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+(use-modules (srfi srfi-1)
+             (lepton ffi)
+             (lepton gettext)
+             (lepton page)
+             (lepton rc)
+             (lepton server)
+             (lepton server protocol)
+             (lepton srfi-37)
+             (lepton toplevel)
+             (lepton version)
+             (netlist backend))
+
+;;; Initialize liblepton library.
+(liblepton_init)
+(unless (getenv "LEPTON_INHIBIT_RC_FILES")
+  (register-data-dirs))
+
+
+(define cmd (basename (car (program-arguments))))
+(define cmd-args (cdr (program-arguments)))
+
+;;; Commands run by the server, and the programs running them.
+(define (program-filename env-name name)
+  (or (getenv env-name)
+      (string-append %lepton-bindir file-name-separator-string name)))
+
+(define %commands
+  `(("netlist" . ,(program-filename "LEPTON_NETLIST" "lepton-netlist"))
+    ("export" . ,(program-filename "LEPTON_EXPORT" "lepton-export"))))
+
+;;; Modules used by the programs above.  They are loaded by the
+;;; server so that requests don't have to load them again.
+(define %preloaded-modules
+  '((geda deprecated)
+    (ice-9 getopt-long)
+    (lepton color-map)
+    (lepton library)
+    (lepton log)
+    (lepton object)
+    (lepton page)
+    (lepton toplevel)
+    (netlist)
+    (netlist option)
+    (netlist schematic)))
+
+
+(define (serve-usage)
+  (format #t (G_ "Usage: ~A [OPTION ...]
+
+Run a server executing lepton-cli commands on requests sent by
+`lepton-cli client'.  The server loads Scheme modules, netlist
+backends, and component libraries once, and runs each request in a
+separate process starting with them.
+
+  -s, --socket=FILE    listen on the socket FILE
+  -j, --jobs=N         run at most N requests at the same time
+  -p, --preload=FILE   load the libraries and symbols used by the
+                       schematic FILE at startup; they are
+                       available to all requests, so use it only
+                       for the project the server is run for
+  -h, --help           display usage information and exit
+  -V, --version        display version information and exit
+
+Commands served: ~A.
+
+Report bugs at ~A
+Lepton EDA homepage: ~A
+")
+          cmd
+          (string-join (map car %commands) ", ")
+          (lepton-version-ref 'bugs)
+          (lepton-version-ref 'url))
+  (exit 0))
+
+(define (help-message)
+  (format (current-error-port)
+          (G_ "\nRun `lepton-cli serve --help' for more information.\n"))
+  (exit 1))
+
+
+;;; Parse command-line arguments.  Returns an association list of
+;;; the options given.
+(define (parse-commandline)
+  (args-fold
+   cmd-args
+   (list
+    (option '(#\s "socket") #t #f
+            (lambda (opt name arg seeds)
+              (acons 'socket arg seeds)))
+    (option '(#\j "jobs") #t #f
+            (lambda (opt name arg seeds)
+              (let ((jobs (string->number arg)))
+                (unless (and (integer? jobs) (positive? jobs))
+                  (format (current-error-port)
+                          (G_ "ERROR: Bad argument '~A' to ~A option.\n")
+                          arg
+                          "-j,--jobs")
+                  (help-message))
+                (acons 'jobs jobs seeds))))
+    (option '(#\p "preload") #t #f
+            (lambda (opt name arg seeds)
+              (acons 'preload arg seeds)))
+    (option '(#\h "help") #f #f
+            (lambda (opt name arg seeds)
+              (serve-usage)))
+    (option '(#\V "version") #f #f
+            (lambda (opt name arg seeds)
+              (display-lepton-version #:print-name #t #:copyright #t)
+              (exit 0))))
+   (lambda (opt name arg seeds)
+     (format (current-error-port)
+             (G_ "ERROR: Unknown option ~A.\n")
+             (if (char? name)
+                 (string-append "-" (char-set->string (char-set name)))
+                 (string-append "--" name)))
+     (help-message))
+   (lambda (op seeds)
+     (format (current-error-port)
+             (G_ "ERROR: Unexpected argument ~S.\n")
+             op)
+     (help-message))
+   '()))
+
+
+;;; Reads the rc files of the directory of the schematic FILENAME,
+;;; and the schematic itself, so that the component libraries it
+;;; uses are scanned and its symbols are cached.  The libraries
+;;; stay registered in the server, so all requests see them: the
+;;; server is meant to be run for one project.
+(define (preload-schematic! filename)
+  (let ((cwd (getcwd)))
+    (catch #t
+      (lambda ()
+        (chdir (dirname filename))
+        (parse-rc "lepton-cli" "gafrc")
+        (chdir cwd)
+        (close-page! (file->page filename)))
+      (lambda (key subr message args rest)
+        (chdir cwd)
+        (format (current-error-port)
+                (G_ "WARNING: Failed to preload ~S: ~?\n")
+                filename
+                message
+                args)))))
+
+
+(define (warm-up! schematics)
+  (for-each resolve-module %preloaded-modules)
+  ;; Load module backends.
+  (lookup-module-backends)
+  (with-toplevel
+   (make-toplevel)
+   (lambda ()
+     (unless (getenv "LEPTON_INHIBIT_RC_FILES")
+       (parse-rc "lepton-cli" "gafrc"))
+     (for-each preload-schematic! schematics))))
+
+
+(define %cli-gettext-domain "lepton-cli")
+
+(define (main)
+  ;; Localization.
+  (bindtextdomain %cli-gettext-domain %lepton-localedir)
+  (textdomain %cli-gettext-domain)
+  (bind-textdomain-codeset %cli-gettext-domain "UTF-8")
+  (setlocale LC_ALL "")
+  (setlocale LC_NUMERIC "C")
+
+  (let* ((options (parse-commandline))
+         (filename (or (assq-ref options 'socket)
+                       (default-server-socket)))
+         (jobs (or (assq-ref options 'jobs)
+                   (current-processor-count)))
+         (schematics (reverse (filter-map (lambda (x)
+                                            (and (eq? (car x) 'preload)
+                                                 (cdr x)))
+                                          options))))
+    (warm-up! schematics)
+    (catch #t
+      (lambda ()
+        (run-server filename %commands #:max-jobs jobs))
+      (lambda (key subr message args rest)
+        (format (current-error-port) (G_ "ERROR: ~?\n") message args)
+        (exit 1)))))
+
+;;; Run the program.
+(main)
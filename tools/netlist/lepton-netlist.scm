@@ -56,6 +56,8 @@
     (post-load (single-char #\m) (value #t))
     (eval-code (single-char #\c) (value #t))
     (interactive (single-char #\i))
+    (jobs (single-char #\j) (value #t))
+    (watch (value #f))
     (help (single-char #\h))
     (version (single-char #\V))))
 